@@ -35,6 +35,10 @@ Configuration::Configuration(int argc, char *argv[]) {
     cmd.AddValue("blockOffset", "The 1st page slice starts with the block with blockOffset", blockOffset);
     cmd.AddValue("timOffset", "Offset in number of Beacon Intervals from the DTIM that carries the first page slice of the page", timOffset);
     cmd.AddValue("Outputpath", "files path of each stations", OutputPath);
+    cmd.AddValue("sweepSeeds", "number of seeds to run each RAW config file with, starting from seed", sweepSeeds);
+    cmd.AddValue("sweepRAWConfigFiles", "comma separated RAW config files to sweep over", sweepRAWConfigFiles);
+    cmd.AddValue("workers", "number of replications of a sweep run at the same time (0 for one per processor)", workers);
+    cmd.AddValue("sweepOutput", "file collecting the results of the replications of a sweep", sweepOutput);
 
 /*
     cmd.AddValue("SlotFormat", "format of NRawSlotCount, -1 will auto calculate based on raw slot num", SlotFormat);
@@ -136,6 +136,16 @@ struct Configuration {
 
 	uint16_t CoolDownPeriod = 4; //60
 
+	/*
+	 * Parameter sweep: every RAW config file is run with sweepSeeds seeds
+	 * starting from seed, by worker processes forked from this one
+	 * */
+	uint32_t sweepSeeds = 1;
+	string sweepRAWConfigFiles = ""; // comma separated, empty for RAWConfigFile only
+	uint32_t workers = 0; // 0 for one per processor
+	string sweepOutput = "./OptimalRawGroup/sweep.txt";
+	string runSuffix = ""; // added to the names of the files of a replication
+
 	Configuration();
 	Configuration(int argc, char *argv[]);
 
@@ -388,6 +388,27 @@ void RawSlotTrace(uint8_t oldValue, uint8_t newValue) {
 void configureNodes(NodeContainer& wifiStaNode, NetDeviceContainer& staDevice) {
 	cout << "Configuring STA Node trace sources..." << endl;
 
+	// the paths are parsed once, only the node index changes between STAs
+	const std::string dev = "/NodeList/%/DeviceList/0/$ns3::WifiNetDevice/";
+	const std::string mac = dev + "Mac/$ns3::RegularWifiMac/$ns3::StaWifiMac/";
+	const Config::CompiledPath assoc(mac + "Assoc");
+	const Config::CompiledPath deAssoc(mac + "DeAssoc");
+	const Config::CompiledPath nrOfTransmissions(mac + "NrOfTransmissionsDuringRAWSlot");
+	const Config::CompiledPath packetDropped(mac + "PacketDropped");
+	const Config::CompiledPath collision(mac + "Collision");
+	const Config::CompiledPath crossRawBoundary(mac + "TransmissionWillCrossRAWBoundary");
+	const Config::CompiledPath phyTxBegin(dev + "Phy/PhyTxBegin");
+	const Config::CompiledPath phyTxEnd(dev + "Phy/PhyTxEnd");
+	const Config::CompiledPath phyTxDrop(dev + "Phy/PhyTxDropWithReason");
+	const Config::CompiledPath phyRxBegin(dev + "Phy/PhyRxBegin");
+	const Config::CompiledPath phyRxEnd(dev + "Phy/PhyRxEnd");
+	const Config::CompiledPath phyRxDrop(dev + "Phy/PhyRxDropWithReason");
+	const Config::CompiledPath macTxRtsFailed(dev + "RemoteStationManager/MacTxRtsFailed");
+	const Config::CompiledPath macTxDataFailed(dev + "RemoteStationManager/MacTxDataFailed");
+	const Config::CompiledPath macTxFinalRtsFailed(dev + "RemoteStationManager/MacTxFinalRtsFailed");
+	const Config::CompiledPath macTxFinalDataFailed(dev + "RemoteStationManager/MacTxFinalDataFailed");
+	const Config::CompiledPath phyState(dev + "Phy/State/State");
+
 	for (uint32_t i = 0; i < config.Nsta; i++) {
 
 		cout << "Hooking up trace sources for STA " << i << endl;
@@ -400,88 +421,39 @@ void configureNodes(NodeContainer& wifiStaNode, NetDeviceContainer& staDevice) {
 
 		nodes.push_back(n);
 		// hook up Associated and Deassociated events
-		Config::Connect(
-				"/NodeList/" + std::to_string(i)
-						+ "/DeviceList/0/$ns3::WifiNetDevice/Mac/$ns3::RegularWifiMac/$ns3::StaWifiMac/Assoc",
-				MakeCallback(&NodeEntry::SetAssociation, n));
-		Config::Connect(
-				"/NodeList/" + std::to_string(i)
-						+ "/DeviceList/0/$ns3::WifiNetDevice/Mac/$ns3::RegularWifiMac/$ns3::StaWifiMac/DeAssoc",
-				MakeCallback(&NodeEntry::UnsetAssociation, n));
-		Config::Connect(
-				"/NodeList/" + std::to_string(i)
-						+ "/DeviceList/0/$ns3::WifiNetDevice/Mac/$ns3::RegularWifiMac/$ns3::StaWifiMac/NrOfTransmissionsDuringRAWSlot",
+		assoc.Connect(i, MakeCallback(&NodeEntry::SetAssociation, n));
+		deAssoc.Connect(i, MakeCallback(&NodeEntry::UnsetAssociation, n));
+		nrOfTransmissions.Connect(i,
 				MakeCallback(
 						&NodeEntry::OnNrOfTransmissionsDuringRAWSlotChanged,
 						n));	//not implem
 
 		//Config::Connect("/NodeList/" + std::to_string(i) + "/DeviceList/0/$ns3::WifiNetDevice/Mac/$ns3::RegularWifiMac/$ns3::StaWifiMac/S1gBeaconMissed", MakeCallback(&NodeEntry::OnS1gBeaconMissed, n));
 
-		Config::Connect(
-				"/NodeList/" + std::to_string(i)
-						+ "/DeviceList/0/$ns3::WifiNetDevice/Mac/$ns3::RegularWifiMac/$ns3::StaWifiMac/PacketDropped",
-				MakeCallback(&NodeEntry::OnMacPacketDropped, n));
-		Config::Connect(
-				"/NodeList/" + std::to_string(i)
-						+ "/DeviceList/0/$ns3::WifiNetDevice/Mac/$ns3::RegularWifiMac/$ns3::StaWifiMac/Collision",
-				MakeCallback(&NodeEntry::OnCollision, n));
-		Config::Connect(
-				"/NodeList/" + std::to_string(i)
-						+ "/DeviceList/0/$ns3::WifiNetDevice/Mac/$ns3::RegularWifiMac/$ns3::StaWifiMac/TransmissionWillCrossRAWBoundary",
+		packetDropped.Connect(i, MakeCallback(&NodeEntry::OnMacPacketDropped, n));
+		collision.Connect(i, MakeCallback(&NodeEntry::OnCollision, n));
+		crossRawBoundary.Connect(i,
 				MakeCallback(&NodeEntry::OnTransmissionWillCrossRAWBoundary,
 						n)); //?
 
 		// hook up TX
-		Config::Connect(
-				"/NodeList/" + std::to_string(i)
-						+ "/DeviceList/0/$ns3::WifiNetDevice/Phy/PhyTxBegin",
-				MakeCallback(&NodeEntry::OnPhyTxBegin, n));
-		Config::Connect(
-				"/NodeList/" + std::to_string(i)
-						+ "/DeviceList/0/$ns3::WifiNetDevice/Phy/PhyTxEnd",
-				MakeCallback(&NodeEntry::OnPhyTxEnd, n));
-		Config::Connect(
-				"/NodeList/" + std::to_string(i)
-						+ "/DeviceList/0/$ns3::WifiNetDevice/Phy/PhyTxDropWithReason",
-				MakeCallback(&NodeEntry::OnPhyTxDrop, n)); //?
+		phyTxBegin.Connect(i, MakeCallback(&NodeEntry::OnPhyTxBegin, n));
+		phyTxEnd.Connect(i, MakeCallback(&NodeEntry::OnPhyTxEnd, n));
+		phyTxDrop.Connect(i, MakeCallback(&NodeEntry::OnPhyTxDrop, n)); //?
 
 		// hook up RX
-		Config::Connect(
-				"/NodeList/" + std::to_string(i)
-						+ "/DeviceList/0/$ns3::WifiNetDevice/Phy/PhyRxBegin",
-				MakeCallback(&NodeEntry::OnPhyRxBegin, n));
-		Config::Connect(
-				"/NodeList/" + std::to_string(i)
-						+ "/DeviceList/0/$ns3::WifiNetDevice/Phy/PhyRxEnd",
-				MakeCallback(&NodeEntry::OnPhyRxEnd, n));
-		Config::Connect(
-				"/NodeList/" + std::to_string(i)
-						+ "/DeviceList/0/$ns3::WifiNetDevice/Phy/PhyRxDropWithReason",
-				MakeCallback(&NodeEntry::OnPhyRxDrop, n));
+		phyRxBegin.Connect(i, MakeCallback(&NodeEntry::OnPhyRxBegin, n));
+		phyRxEnd.Connect(i, MakeCallback(&NodeEntry::OnPhyRxEnd, n));
+		phyRxDrop.Connect(i, MakeCallback(&NodeEntry::OnPhyRxDrop, n));
 
 		// hook up MAC traces
-		Config::Connect(
-				"/NodeList/" + std::to_string(i)
-						+ "/DeviceList/0/$ns3::WifiNetDevice/RemoteStationManager/MacTxRtsFailed",
-				MakeCallback(&NodeEntry::OnMacTxRtsFailed, n)); //?
-		Config::Connect(
-				"/NodeList/" + std::to_string(i)
-						+ "/DeviceList/0/$ns3::WifiNetDevice/RemoteStationManager/MacTxDataFailed",
-				MakeCallback(&NodeEntry::OnMacTxDataFailed, n));
-		Config::Connect(
-				"/NodeList/" + std::to_string(i)
-						+ "/DeviceList/0/$ns3::WifiNetDevice/RemoteStationManager/MacTxFinalRtsFailed",
-				MakeCallback(&NodeEntry::OnMacTxFinalRtsFailed, n)); //?
-		Config::Connect(
-				"/NodeList/" + std::to_string(i)
-						+ "/DeviceList/0/$ns3::WifiNetDevice/RemoteStationManager/MacTxFinalDataFailed",
-				MakeCallback(&NodeEntry::OnMacTxFinalDataFailed, n)); //?
+		macTxRtsFailed.Connect(i, MakeCallback(&NodeEntry::OnMacTxRtsFailed, n)); //?
+		macTxDataFailed.Connect(i, MakeCallback(&NodeEntry::OnMacTxDataFailed, n));
+		macTxFinalRtsFailed.Connect(i, MakeCallback(&NodeEntry::OnMacTxFinalRtsFailed, n)); //?
+		macTxFinalDataFailed.Connect(i, MakeCallback(&NodeEntry::OnMacTxFinalDataFailed, n)); //?
 
 		// hook up PHY State change
-		Config::Connect(
-				"/NodeList/" + std::to_string(i)
-						+ "/DeviceList/0/$ns3::WifiNetDevice/Phy/State/State",
-				MakeCallback(&NodeEntry::OnPhyStateChange, n));
+		phyState.Connect(i, MakeCallback(&NodeEntry::OnPhyStateChange, n));
 
 	}
 }
@@ -1169,9 +1141,48 @@ int main(int argc, char *argv[]) {
 	//LogComponentEnable ("StaWifiMac", LOG_DEBUG);
 	//LogComponentEnable ("EdcaTxopN", LOG_DEBUG);
 
-	bool OutputPosition = true;
 	config = Configuration(argc, argv);
 
+	if (config.sweepSeeds > 1 || config.sweepRAWConfigFiles != "")
+	{
+		std::istringstream files(config.sweepRAWConfigFiles);
+		string file;
+		while (std::getline(files, file, ','))
+			if (file != "")
+				sweepRAWConfigFiles.push_back(file);
+		if (sweepRAWConfigFiles.empty())
+			sweepRAWConfigFiles.push_back(config.RAWConfigFile);
+
+		SweepRunner runner;
+		runner.SetWorkers(config.workers);
+		uint32_t replications = sweepRAWConfigFiles.size() * config.sweepSeeds;
+		std::cout << "Running " << replications << " replications on "
+				<< runner.GetWorkers() << " workers..." << std::endl;
+		uint32_t failed = runner.Run(replications,
+				MakeCallback(&runSweepReplication), config.sweepOutput);
+		std::cout << failed << " replications failed, results in "
+				<< config.sweepOutput << std::endl;
+		return failed == 0 ? 0 : 1;
+	}
+
+	runSimulation(0);
+	return 0;
+}
+
+// Runs in a worker process forked by the SweepRunner, which has its own
+// copy of the globals. Writes one line to results:
+// seed, RAW config file, stations, packets sent, delivered, echoed and
+// the delivered payload throughput in Mbit/s
+void runSweepReplication(uint32_t index, std::ostream &results) {
+	config.RAWConfigFile = sweepRAWConfigFiles[index / config.sweepSeeds];
+	config.seed += index % config.sweepSeeds;
+	config.runSuffix = "_run" + std::to_string(index);
+	runSimulation(&results);
+}
+
+void runSimulation(std::ostream *results) {
+	bool OutputPosition = true;
+
 	config.rps = configureRAW(config.rps, config.RAWConfigFile);
 	config.Nsta = config.NRawSta;
 
@@ -1184,7 +1195,7 @@ int main(int argc, char *argv[]) {
 			+ std::to_string(config.NRawSlotNum) + "slots_"
 			+ std::to_string(config.payloadSize) + "payload_"
 			+ std::to_string(config.totaltraffic) + "Mbps_"
-			+ std::to_string(config.BeaconInterval) + "BI" + ".nss";
+			+ std::to_string(config.BeaconInterval) + "BI" + config.runSuffix + ".nss";
 
 	stats = Statistics(config.Nsta);
 	eventManager = SimulationEventManager(config.visualizerIP,
@@ -1516,10 +1527,15 @@ int main(int argc, char *argv[]) {
 	}
 	cout << "total packet loss % "
 			<< 100 - 100. * totalPacketsEchoed / totalSentPackets << endl;
+	if (results)
+		*results << config.seed << "\t" << config.RAWConfigFile << "\t"
+				<< config.Nsta << "\t" << totalSentPackets << "\t"
+				<< totalSuccessfulPackets << "\t" << totalPacketsEchoed << "\t"
+				<< pay * 8. / (config.simulationTime * 1000000.0) << endl;
 	Simulator::Destroy();
 
     ofstream risultati;
-    string addressresults = config.OutputPath + "moreinfo.txt";
+    string addressresults = config.OutputPath + "moreinfo" + config.runSuffix + ".txt";
     risultati.open(addressresults.c_str(), ios::out | ios::trunc);
 
     risultati << "Sta node#,distance,timerx(notassociated),timeidle(notassociated),timetx(notassociated),timesleep(notassociated),timecollision(notassociated)" << std::endl;
@@ -1542,5 +1558,4 @@ int main(int argc, char *argv[]) {
     }
     
     risultati.close();
-	return 0;
 }
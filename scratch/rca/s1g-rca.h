@@ -56,6 +56,8 @@ vector<NodeEntry*> nodes;
 vector<long> transmissionsPerTIMGroupAndSlotFromAPSinceLastInterval;
 vector<long> transmissionsPerTIMGroupAndSlotFromSTASinceLastInterval;
 
+vector<string> sweepRAWConfigFiles;
+
 ApplicationContainer serverApp;
 uint32_t AppStartTime = 0;
 uint32_t ApStopTime = 0;
@@ -100,6 +102,8 @@ void updateNodesQueueLength();
 int getSTAIdFromAddress(Ipv4Address from);
 
 int main(int argc, char** argv);
+void runSimulation(std::ostream *results);
+void runSweepReplication(uint32_t index, std::ostream &results);
 
 void sendStatistics(bool schedule);
 
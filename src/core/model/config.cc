@@ -26,6 +26,7 @@
 #include "pointer.h"
 #include "log.h"
 
+#include <algorithm>
 #include <sstream>
 
 /**
@@ -149,133 +150,183 @@ MatchContainer::DisconnectWithoutContext (std::string name, const CallbackBase &
 } // namespace Config
 
 
-/** Helper to test if an array entry matches a config path specification. */
-class ArrayMatcher
-{
-public:
-  /**
-   * Construct from a Config path specification.
-   *
-   * \param [in] element The Config path specification.
-   */
-  ArrayMatcher (std::string element);
-  /**
-   * Test if a specific index matches the Config Path.
-   *
-   * \param [in] i The index.
-   * \returns \c true if the index matches the Config Path.
-   */
-  bool Matches (uint32_t i) const;
-private:
-  /**
-   * Convert a string to an \c uint32_t.
-   *
-   * \param [in] str The string.
-   * \param [in] value The location to store the \c uint32_t.
-   * \returns \c true if the string could be converted.
-   */
-  bool StringToUint32 (std::string str, uint32_t *value) const;
-  /** The Config path element. */
-  std::string m_element;
-};
-
+namespace Config {
 
-ArrayMatcher::ArrayMatcher (std::string element)
-  : m_element (element)
+/**
+ * Convert a string to an \c uint32_t.
+ *
+ * \param [in] str The string.
+ * \param [in] value The location to store the \c uint32_t.
+ * \returns \c true if the string could be converted.
+ */
+static bool
+StringToUint32 (std::string str, uint32_t *value)
 {
-  NS_LOG_FUNCTION (this << element);
+  NS_LOG_FUNCTION (str << value);
+  std::istringstream iss;
+  iss.str (str);
+  iss >> (*value);
+  return !iss.bad () && !iss.fail ();
 }
-bool
-ArrayMatcher::Matches (uint32_t i) const
+
+/**
+ * Parse the index ranges of a Config path element:
+ * \c *, an index, an index range \c [min-max], or alternatives of these
+ * separated by \c |.
+ *
+ * \param [in] element The Config path element.
+ * \param [in,out] parsed The parsed element, whose ranges are appended to.
+ */
+static void
+ParseArray (std::string element, CompiledPath::Element *parsed)
 {
-  NS_LOG_FUNCTION (this << i);
-  if (m_element == "*")
+  NS_LOG_FUNCTION (element << parsed);
+  if (element == "*")
     {
-      NS_LOG_DEBUG ("Array "<<i<<" matches *");
-      return true;
+      parsed->matchAll = true;
+      return;
     }
   std::string::size_type tmp;
-  tmp = m_element.find ("|");
+  tmp = element.find ("|");
   if (tmp != std::string::npos)
     {
-      std::string left = m_element.substr (0, tmp-0);
-      std::string right = m_element.substr (tmp+1, m_element.size () - (tmp + 1));
-      ArrayMatcher matcher = ArrayMatcher (left);
-      if (matcher.Matches (i))
-        {
-          NS_LOG_DEBUG ("Array "<<i<<" matches "<<left);
-          return true;
-        }
-      matcher = ArrayMatcher (right);
-      if (matcher.Matches (i))
-        {
-          NS_LOG_DEBUG ("Array "<<i<<" matches "<<right);
-          return true;
-        }
-      NS_LOG_DEBUG ("Array "<<i<<" does not match "<<m_element);
-      return false;
+      ParseArray (element.substr (0, tmp-0), parsed);
+      ParseArray (element.substr (tmp+1, element.size () - (tmp + 1)), parsed);
+      return;
     }
-  std::string::size_type leftBracket = m_element.find ("[");
-  std::string::size_type rightBracket = m_element.find ("]");
-  std::string::size_type dash = m_element.find ("-");
-  if (leftBracket == 0 && rightBracket == m_element.size () - 1 &&
+  std::string::size_type leftBracket = element.find ("[");
+  std::string::size_type rightBracket = element.find ("]");
+  std::string::size_type dash = element.find ("-");
+  if (leftBracket == 0 && rightBracket == element.size () - 1 &&
       dash > leftBracket && dash < rightBracket)
     {
-      std::string lowerBound = m_element.substr (leftBracket + 1, dash - (leftBracket + 1));
-      std::string upperBound = m_element.substr (dash + 1, rightBracket - (dash + 1));
+      std::string lowerBound = element.substr (leftBracket + 1, dash - (leftBracket + 1));
+      std::string upperBound = element.substr (dash + 1, rightBracket - (dash + 1));
       uint32_t min;
       uint32_t max;
-      if (StringToUint32 (lowerBound, &min) && 
+      if (StringToUint32 (lowerBound, &min) &&
           StringToUint32 (upperBound, &max) &&
-          i >= min && i <= max)
+          min <= max)
         {
-          NS_LOG_DEBUG ("Array "<<i<<" matches "<<m_element);
-          return true;
+          parsed->ranges.push_back (std::make_pair (min, max));
+        }
+      return;
+    }
+  uint32_t value;
+  if (StringToUint32 (element, &value))
+    {
+      parsed->ranges.push_back (std::make_pair (value, value));
+    }
+}
+
+CompiledPath::Element::Element (std::string name)
+  : name (name),
+    isIndex (name == "%"),
+    isGetObject (name.find ("$") == 0),
+    hasTid (false),
+    matchAll (isIndex)
+{
+  NS_LOG_FUNCTION (this << name);
+  if (isGetObject)
+    {
+      hasTid = TypeId::LookupByNameFailSafe (name.substr (1, name.size () - 1), &tid);
+    }
+  if (isIndex)
+    {
+      return;
+    }
+  ParseArray (name, this);
+  // Sort and merge the ranges, so that the indices are visited in order
+  std::sort (ranges.begin (), ranges.end ());
+  std::vector<std::pair<uint32_t, uint32_t> > merged;
+  for (std::vector<std::pair<uint32_t, uint32_t> >::const_iterator i = ranges.begin (); i != ranges.end (); i++)
+    {
+      if (!merged.empty () && (merged.back ().second == 0xffffffff || i->first <= merged.back ().second + 1))
+        {
+          merged.back ().second = std::max (merged.back ().second, i->second);
         }
       else
         {
-          NS_LOG_DEBUG ("Array "<<i<<" does not "<<m_element);
-          return false;
+          merged.push_back (*i);
         }
     }
-  uint32_t value;
-  if (StringToUint32 (m_element, &value) &&
-      i == value)
+  ranges.swap (merged);
+}
+
+bool
+CompiledPath::Element::Matches (uint32_t i) const
+{
+  NS_LOG_FUNCTION (this << i);
+  if (matchAll)
     {
-      NS_LOG_DEBUG ("Array "<<i<<" matches "<<m_element);
+      NS_LOG_DEBUG ("Array "<<i<<" matches "<<name);
       return true;
     }
-  NS_LOG_DEBUG ("Array "<<i<<" does not match "<<m_element);
+  for (std::vector<std::pair<uint32_t, uint32_t> >::const_iterator j = ranges.begin (); j != ranges.end (); j++)
+    {
+      if (i >= j->first && i <= j->second)
+        {
+          NS_LOG_DEBUG ("Array "<<i<<" matches "<<name);
+          return true;
+        }
+    }
+  NS_LOG_DEBUG ("Array "<<i<<" does not match "<<name);
   return false;
 }
 
-bool
-ArrayMatcher::StringToUint32 (std::string str, uint32_t *value) const
+std::vector<CompiledPath::Element>
+CompiledPath::Compile (std::string path)
 {
-  NS_LOG_FUNCTION (this << str << value);
-  std::istringstream iss;
-  iss.str (str);
-  iss >> (*value);
-  return !iss.bad () && !iss.fail ();
+  NS_LOG_FUNCTION (path);
+
+  // ensure that we start and end with a '/'
+  std::string::size_type tmp = path.find ("/");
+  if (tmp != 0)
+    {
+      // no slash at start
+      path = "/" + path;
+    }
+  tmp = path.find_last_of ("/");
+  if (tmp != (path.size () - 1))
+    {
+      // no slash at end
+      path = path + "/";
+    }
+
+  std::vector<Element> elements;
+  std::string::size_type start = 1;
+  std::string::size_type next;
+  while ((next = path.find ("/", start)) != std::string::npos)
+    {
+      elements.push_back (Element (path.substr (start, next - start)));
+      start = next + 1;
+    }
+  return elements;
 }
 
+} // namespace Config
+
+
 /**
- * Abstract class to parse Config paths into object references.
+ * Abstract class to resolve compiled Config paths into object references.
  */
 class Resolver
 {
 public:
   /**
-   * Construct from a base Config path.
+   * Construct from the elements of a Config path.
    *
-   * \param [in] path The Config path.
+   * \param [in] elements The Config path elements.
+   * \param [in] index The index to substitute for the placeholder,
+   *        or 0 to match all the indices.
    */
-  Resolver (std::string path);
+  Resolver (const std::vector<Config::CompiledPath::Element> &elements,
+            const uint32_t *index);
   /** Destructor. */
   virtual ~Resolver ();
 
   /**
-   * Parse the stored Config path into an object reference,
+   * Resolve the Config path into object references,
    * beginning at the indicated root object.
    *
    * \param [in] root The object corresponding to the current position in
@@ -284,23 +335,31 @@ public:
   void Resolve (Ptr<Object> root);
   
 private:
-  /** Ensure the Config path starts and ends with a '/'. */
-  void Canonicalize (void);
   /**
-   * Parse the next element in the Config path.
+   * Resolve the next element in the Config path.
    *
-   * \param [in] path The remaining portion of the Config path.
+   * \param [in] next The index of the next element.
    * \param [in] root The object corresponding to the current positon
    *                  in the Config path.
    */
-  void DoResolve (std::string path, Ptr<Object> root);
+  void DoResolve (std::size_t next, Ptr<Object> root);
   /**
-   * Parse an index on the Config path.
+   * Resolve an index on the Config path.
    *
-   * \param [in] path The remaining Config path.
-   * \param [in,out] vector The resulting list of matching objects.
+   * \param [in] next The index of the element holding the index.
+   * \param [in] root The object holding the container.
+   * \param [in] info The container attribute.
    */
-  void DoArrayResolve (std::string path, const ObjectPtrContainerValue &vector);
+  void DoArrayResolve (std::size_t next, Ptr<Object> root,
+                       const struct TypeId::AttributeInformation &info);
+  /**
+   * Resolve the rest of the path below one element of a container.
+   *
+   * \param [in] next The index of the element following the index.
+   * \param [in] index The index of the object in the container.
+   * \param [in] object The object.
+   */
+  void DoArrayResolveOne (std::size_t next, uint32_t index, Ptr<Object> object);
   /**
    * Handle one object found on the path.
    *
@@ -313,6 +372,13 @@ private:
    * \returns The current Config path.
    */
   std::string GetResolvedPath (void) const;
+  /**
+   * Get the name of an element, with the index substituted.
+   *
+   * \param [in] element The element.
+   * \returns The name of the element.
+   */
+  std::string GetName (const Config::CompiledPath::Element &element) const;
   /**
    * Handle one found object.
    *
@@ -323,46 +389,33 @@ private:
 
   /** Current list of path tokens. */
   std::vector<std::string> m_workStack;
-  /** The Config path. */
-  std::string m_path;
+  /** The Config path elements. */
+  const std::vector<Config::CompiledPath::Element> &m_elements;
+  /** The index substituted for the placeholder, if any. */
+  bool m_hasIndex;
+  /** The index substituted for the placeholder. */
+  uint32_t m_index;
 };
 
-Resolver::Resolver (std::string path)
-  : m_path (path)
+Resolver::Resolver (const std::vector<Config::CompiledPath::Element> &elements,
+                    const uint32_t *index)
+  : m_elements (elements),
+    m_hasIndex (index != 0),
+    m_index (index != 0 ? *index : 0)
 {
-  NS_LOG_FUNCTION (this << path);
-  Canonicalize ();
+  NS_LOG_FUNCTION (this << &elements << index);
 }
 Resolver::~Resolver ()
 {
   NS_LOG_FUNCTION (this);
 }
-void
-Resolver::Canonicalize (void)
-{
-  NS_LOG_FUNCTION (this);
-
-  // ensure that we start and end with a '/'
-  std::string::size_type tmp = m_path.find ("/");
-  if (tmp != 0)
-    {
-      // no slash at start
-      m_path = "/" + m_path;
-    }
-  tmp = m_path.find_last_of ("/");
-  if (tmp != (m_path.size () - 1))
-    {
-      // no slash at end
-      m_path = m_path + "/";
-    }
-}
 
 void 
 Resolver::Resolve (Ptr<Object> root)
 {
   NS_LOG_FUNCTION (this << root);
 
-  DoResolve (m_path, root);
+  DoResolve (0, root);
 }
 
 std::string
@@ -378,6 +431,18 @@ Resolver::GetResolvedPath (void) const
   return fullPath;
 }
 
+std::string
+Resolver::GetName (const Config::CompiledPath::Element &element) const
+{
+  if (element.isIndex && m_hasIndex)
+    {
+      std::ostringstream oss;
+      oss << m_index;
+      return oss.str ();
+    }
+  return element.name;
+}
+
 void 
 Resolver::DoResolveOne (Ptr<Object> object)
 {
@@ -388,13 +453,11 @@ Resolver::DoResolveOne (Ptr<Object> object)
 }
 
 void
-Resolver::DoResolve (std::string path, Ptr<Object> root)
+Resolver::DoResolve (std::size_t next, Ptr<Object> root)
 {
-  NS_LOG_FUNCTION (this << path << root);
-  NS_ASSERT ((path.find ("/")) == 0);
-  std::string::size_type next = path.find ("/", 1);
+  NS_LOG_FUNCTION (this << next << root);
 
-  if (next == std::string::npos)
+  if (next == m_elements.size ())
     {
       //
       // If root is zero, we're beginning to see if we can use the object name 
@@ -410,8 +473,8 @@ Resolver::DoResolve (std::string path, Ptr<Object> root)
         }
       return;
     }
-  std::string item = path.substr (1, next-1);
-  std::string pathLeft = path.substr (next, path.size ()-next);
+  const Config::CompiledPath::Element &element = m_elements[next];
+  std::string item = GetName (element);
 
   //
   // If root is zero, we're beginning to see if we can use the object name 
@@ -422,11 +485,10 @@ Resolver::DoResolve (std::string path, Ptr<Object> root)
   //
   if (root == 0)
     {
-      std::string::size_type offset = path.find ("/Names");
-      if (offset == 0)
+      if (item.compare (0, 5, "Names") == 0)
         {
           m_workStack.push_back (item);
-          DoResolve (pathLeft, root);
+          DoResolve (next + 1, root);
           m_workStack.pop_back ();
           return;
         }
@@ -443,7 +505,7 @@ Resolver::DoResolve (std::string path, Ptr<Object> root)
     {
       NS_LOG_DEBUG ("Name system resolved item = " << item << " to " << namedObject);
       m_workStack.push_back (item);
-      DoResolve (pathLeft, namedObject);
+      DoResolve (next + 1, namedObject);
       m_workStack.pop_back ();
       return;
     }
@@ -459,13 +521,13 @@ Resolver::DoResolve (std::string path, Ptr<Object> root)
     {
       return;
     }
-  std::string::size_type dollarPos = item.find ("$");
-  if (dollarPos == 0)
+  if (element.isGetObject)
     {
       // This is a call to GetObject
       std::string tidString = item.substr (1, item.size () - 1);
       NS_LOG_DEBUG ("GetObject="<<tidString<<" on path="<<GetResolvedPath ());
-      TypeId tid = TypeId::LookupByName (tidString);
+      // an unknown TypeId is reported as soon as it is used
+      TypeId tid = element.hasTid ? element.tid : TypeId::LookupByName (tidString);
       Ptr<Object> object = root->GetObject<Object> (tid);
       if (object == 0)
         {
@@ -473,7 +535,7 @@ Resolver::DoResolve (std::string path, Ptr<Object> root)
           return;
         }
       m_workStack.push_back (item);
-      DoResolve (pathLeft, object);
+      DoResolve (next + 1, object);
       m_workStack.pop_back ();
     }
   else 
@@ -512,7 +574,7 @@ Resolver::DoResolve (std::string path, Ptr<Object> root)
                     }
                   foundMatch = true;
                   m_workStack.push_back (info.name);
-                  DoResolve (pathLeft, object);
+                  DoResolve (next + 1, object);
                   m_workStack.pop_back ();
                 }
               // attempt to cast to an object vector.
@@ -520,12 +582,10 @@ Resolver::DoResolve (std::string path, Ptr<Object> root)
                 dynamic_cast<const ObjectPtrContainerChecker *> (PeekPointer (info.checker));
               if (vectorChecker != 0)
                 {
-                  NS_LOG_DEBUG ("GetAttribute(vector)="<<info.name<<" on path="<<GetResolvedPath () << pathLeft);
+                  NS_LOG_DEBUG ("GetAttribute(vector)="<<info.name<<" on path="<<GetResolvedPath ());
                   foundMatch = true;
-                  ObjectPtrContainerValue vector;
-                  root->GetAttribute (info.name, vector);
                   m_workStack.push_back (info.name);
-                  DoArrayResolve (pathLeft, vector);
+                  DoArrayResolve (next + 1, root, info);
                   m_workStack.pop_back ();
                 }
               // this could be anything else and we don't know what to do with it.
@@ -544,34 +604,82 @@ Resolver::DoResolve (std::string path, Ptr<Object> root)
 }
 
 void 
-Resolver::DoArrayResolve (std::string path, const ObjectPtrContainerValue &container)
+Resolver::DoArrayResolve (std::size_t next, Ptr<Object> root,
+                          const struct TypeId::AttributeInformation &info)
 {
-  NS_LOG_FUNCTION(this << path << &container);
-  NS_ASSERT (path != "");
-  NS_ASSERT ((path.find ("/")) == 0);
-  std::string::size_type next = path.find ("/", 1);
-  if (next == std::string::npos)
+  NS_LOG_FUNCTION (this << next << root << info.name);
+  if (next == m_elements.size ())
     {
       return;
     }
-  std::string item = path.substr (1, next-1);
-  std::string pathLeft = path.substr (next, path.size ()-next);
+  const Config::CompiledPath::Element &element = m_elements[next];
 
-  ArrayMatcher matcher = ArrayMatcher (item);
+  //
+  // When the index of each object of the container is its position, only
+  // visit the positions matched, without copying the container.
+  //
+  const ObjectPtrContainerAccessor *accessor =
+    dynamic_cast<const ObjectPtrContainerAccessor *> (PeekPointer (info.accessor));
+  uint32_t n;
+  if (accessor != 0 && accessor->IsIndexedByPosition () &&
+      (info.flags & TypeId::ATTR_GET) && accessor->GetN (PeekPointer (root), &n))
+    {
+      std::vector<std::pair<uint32_t, uint32_t> > all;
+      const std::vector<std::pair<uint32_t, uint32_t> > *ranges = &element.ranges;
+      if (element.isIndex && m_hasIndex)
+        {
+          all.push_back (std::make_pair (m_index, m_index));
+          ranges = &all;
+        }
+      else if (element.matchAll)
+        {
+          if (n > 0)
+            {
+              all.push_back (std::make_pair (0, n - 1));
+            }
+          ranges = &all;
+        }
+      for (std::vector<std::pair<uint32_t, uint32_t> >::const_iterator j = ranges->begin ();
+           j != ranges->end () && j->first < n; j++)
+        {
+          uint32_t last = std::min (j->second, n - 1);
+          for (uint32_t i = j->first; ; i++)
+            {
+              uint32_t index;
+              Ptr<Object> object = accessor->GetAt (PeekPointer (root), i, &index);
+              DoArrayResolveOne (next + 1, index, object);
+              if (i == last)
+                {
+                  break;
+                }
+            }
+        }
+      return;
+    }
+
+  ObjectPtrContainerValue container;
+  root->GetAttribute (info.name, container);
   ObjectPtrContainerValue::Iterator it;
   for (it = container.Begin (); it != container.End (); ++it)
     {
-      if (matcher.Matches ((*it).first))
+      if ((element.isIndex && m_hasIndex) ? (*it).first == m_index : element.Matches ((*it).first))
         {
-          std::ostringstream oss;
-          oss << (*it).first;
-          m_workStack.push_back (oss.str ());
-          DoResolve (pathLeft, (*it).second);
-          m_workStack.pop_back ();
+          DoArrayResolveOne (next + 1, (*it).first, (*it).second);
         }
     }
 }
 
+void
+Resolver::DoArrayResolveOne (std::size_t next, uint32_t index, Ptr<Object> object)
+{
+  NS_LOG_FUNCTION (this << next << index << object);
+  std::ostringstream oss;
+  oss << index;
+  m_workStack.push_back (oss.str ());
+  DoResolve (next, object);
+  m_workStack.pop_back ();
+}
+
 /** Config system implementation class. */
 class ConfigImpl : public Singleton<ConfigImpl>
 {
@@ -588,6 +696,17 @@ public:
   void Disconnect (std::string path, const CallbackBase &cb);
   /** \copydoc Config::LookupMatches() */
   Config::MatchContainer LookupMatches (std::string path);
+  /**
+   * Find the objects which match a compiled Config path.
+   *
+   * \param [in] elements The elements of the Config path.
+   * \param [in] index The index to substitute for the placeholder,
+   *        or 0 to match all the indices.
+   * \param [in] path The Config path, as given by the user.
+   * \returns The matching objects.
+   */
+  Config::MatchContainer LookupMatches (const std::vector<Config::CompiledPath::Element> &elements,
+                                        const uint32_t *index, std::string path);
 
   /** \copydoc Config::RegisterRootNamespaceObject() */
   void RegisterRootNamespaceObject (Ptr<Object> obj);
@@ -681,11 +800,20 @@ Config::MatchContainer
 ConfigImpl::LookupMatches (std::string path)
 {
   NS_LOG_FUNCTION (this << path);
+  return LookupMatches (Config::CompiledPath::Compile (path), 0, path);
+}
+
+Config::MatchContainer
+ConfigImpl::LookupMatches (const std::vector<Config::CompiledPath::Element> &elements,
+                           const uint32_t *index, std::string path)
+{
+  NS_LOG_FUNCTION (this << &elements << index << path);
   class LookupMatchesResolver : public Resolver 
   {
   public:
-    LookupMatchesResolver (std::string path)
-      : Resolver (path)
+    LookupMatchesResolver (const std::vector<Config::CompiledPath::Element> &elements,
+                           const uint32_t *index)
+      : Resolver (elements, index)
     {}
     virtual void DoOne (Ptr<Object> object, std::string path) {
       m_objects.push_back (object);
@@ -693,7 +821,7 @@ ConfigImpl::LookupMatches (std::string path)
     }
     std::vector<Ptr<Object> > m_objects;
     std::vector<std::string> m_contexts;
-  } resolver = LookupMatchesResolver (path);
+  } resolver = LookupMatchesResolver (elements, index);
   for (Roots::const_iterator i = m_roots.begin (); i != m_roots.end (); i++)
     {
       resolver.Resolve (*i);
@@ -873,6 +1001,83 @@ Ptr<Object> GetRootNamespaceObject (uint32_t i)
   return ConfigImpl::Get ()->GetRootNamespaceObject (i);
 }
 
+CompiledPath::CompiledPath ()
+{
+  NS_LOG_FUNCTION (this);
+}
+CompiledPath::CompiledPath (std::string path)
+  : m_path (path)
+{
+  NS_LOG_FUNCTION (this << path);
+  std::string::size_type slash = path.find_last_of ("/");
+  NS_ASSERT (slash != std::string::npos);
+  m_root = path.substr (0, slash);
+  m_leaf = path.substr (slash+1, path.size ()-(slash+1));
+  m_elements = Compile (m_root);
+}
+std::string
+CompiledPath::GetPath (void) const
+{
+  NS_LOG_FUNCTION (this);
+  return m_path;
+}
+MatchContainer
+CompiledPath::LookupMatches (void) const
+{
+  NS_LOG_FUNCTION (this);
+  if (m_path.empty ())
+    {
+      return MatchContainer ();
+    }
+  return ConfigImpl::Get ()->LookupMatches (m_elements, 0, m_root);
+}
+MatchContainer
+CompiledPath::LookupMatches (uint32_t index) const
+{
+  NS_LOG_FUNCTION (this << index);
+  if (m_path.empty ())
+    {
+      return MatchContainer ();
+    }
+  return ConfigImpl::Get ()->LookupMatches (m_elements, &index, m_root);
+}
+void
+CompiledPath::Set (const AttributeValue &value) const
+{
+  NS_LOG_FUNCTION (this << &value);
+  LookupMatches ().Set (m_leaf, value);
+}
+void
+CompiledPath::Set (uint32_t index, const AttributeValue &value) const
+{
+  NS_LOG_FUNCTION (this << index << &value);
+  LookupMatches (index).Set (m_leaf, value);
+}
+void
+CompiledPath::Connect (const CallbackBase &cb) const
+{
+  NS_LOG_FUNCTION (this << &cb);
+  LookupMatches ().Connect (m_leaf, cb);
+}
+void
+CompiledPath::Connect (uint32_t index, const CallbackBase &cb) const
+{
+  NS_LOG_FUNCTION (this << index << &cb);
+  LookupMatches (index).Connect (m_leaf, cb);
+}
+void
+CompiledPath::ConnectWithoutContext (const CallbackBase &cb) const
+{
+  NS_LOG_FUNCTION (this << &cb);
+  LookupMatches ().ConnectWithoutContext (m_leaf, cb);
+}
+void
+CompiledPath::ConnectWithoutContext (uint32_t index, const CallbackBase &cb) const
+{
+  NS_LOG_FUNCTION (this << index << &cb);
+  LookupMatches (index).ConnectWithoutContext (m_leaf, cb);
+}
+
 } // namespace Config
 
 } // namespace ns3
@@ -21,7 +21,9 @@
 #define CONFIG_H
 
 #include "ptr.h"
+#include "type-id.h"
 #include <string>
+#include <utility>
 #include <vector>
 
 /**
@@ -258,6 +260,148 @@ private:
  */
 MatchContainer LookupMatches (std::string path);
 
+/**
+ * \ingroup config
+ * \brief A Config path parsed once, to be resolved many times.
+ *
+ * Config::Set and Config::Connect parse their path on every call. A
+ * CompiledPath parses it once: the names, the TypeIds of the \c $
+ * elements and the index ranges of the container elements are stored,
+ * so that each resolution only walks the objects of the path.
+ *
+ * A path element which is exactly \c % is a placeholder for an index,
+ * which is substituted by the methods taking an index:
+ * \code
+ *   Config::CompiledPath path ("/NodeList/%/DeviceList/0/Phy/PhyTxBegin");
+ *   for (uint32_t i = 0; i < n; i++)
+ *     {
+ *       path.Connect (i, MakeCallback (&Stats::TxBegin, stats[i]));
+ *     }
+ * \endcode
+ * Without an index, the placeholder matches all the indices, like \c *.
+ *
+ * The elements of the containers indexed by their position, such as the
+ * ObjectVector attributes, are looked up directly, so that the cost of a
+ * resolution is linear in the number of matched objects rather than in
+ * the size of the containers walked. A range such as
+ * \c /NodeList/[0-8191]/ is thus resolved in a single walk.
+ */
+class CompiledPath
+{
+public:
+  /** Create an empty path, which matches nothing. */
+  CompiledPath ();
+  /**
+   * Parse a path.
+   *
+   * \param [in] path The full path, as given to Config::Set or
+   *        Config::Connect: the last element is the name of the
+   *        attribute or of the trace source.
+   */
+  CompiledPath (std::string path);
+
+  /**
+   * \returns The path this object was created with.
+   */
+  std::string GetPath (void) const;
+
+  /**
+   * \returns The objects which match the path without its last element.
+   */
+  MatchContainer LookupMatches (void) const;
+  /**
+   * \param [in] index The index to substitute for the placeholder.
+   * \returns The objects which match the path without its last element.
+   */
+  MatchContainer LookupMatches (uint32_t index) const;
+
+  /**
+   * \param [in] value The value to set in all the matching attributes.
+   * \sa ns3::Config::Set
+   */
+  void Set (const AttributeValue &value) const;
+  /**
+   * \param [in] index The index to substitute for the placeholder.
+   * \param [in] value The value to set in all the matching attributes.
+   * \sa ns3::Config::Set
+   */
+  void Set (uint32_t index, const AttributeValue &value) const;
+  /**
+   * \param [in] cb The sink to connect to the matching trace sources.
+   * \sa ns3::Config::Connect
+   */
+  void Connect (const CallbackBase &cb) const;
+  /**
+   * \param [in] index The index to substitute for the placeholder.
+   * \param [in] cb The sink to connect to the matching trace sources.
+   * \sa ns3::Config::Connect
+   */
+  void Connect (uint32_t index, const CallbackBase &cb) const;
+  /**
+   * \param [in] cb The sink to connect to the matching trace sources.
+   * \sa ns3::Config::ConnectWithoutContext
+   */
+  void ConnectWithoutContext (const CallbackBase &cb) const;
+  /**
+   * \param [in] index The index to substitute for the placeholder.
+   * \param [in] cb The sink to connect to the matching trace sources.
+   * \sa ns3::Config::ConnectWithoutContext
+   */
+  void ConnectWithoutContext (uint32_t index, const CallbackBase &cb) const;
+
+  /** A parsed element of a path, between two slashes. */
+  struct Element
+  {
+    /**
+     * Parse an element.
+     *
+     * \param [in] name The element.
+     */
+    Element (std::string name);
+    /**
+     * Check if an index of a container matches this element.
+     *
+     * \param [in] i The index.
+     * \returns \c true if the index matches.
+     */
+    bool Matches (uint32_t i) const;
+
+    /** The element, as written in the path. */
+    std::string name;
+    /** The element is the index placeholder \c %. */
+    bool isIndex;
+    /** The element is a \c $ call to GetObject. */
+    bool isGetObject;
+    /** The TypeId could be looked up when the path was parsed. */
+    bool hasTid;
+    /** The TypeId of a \c $ element. */
+    TypeId tid;
+    /** The element matches all the indices of a container. */
+    bool matchAll;
+    /** The index ranges matched, sorted and disjoint, bounds included. */
+    std::vector<std::pair<uint32_t, uint32_t> > ranges;
+  };
+
+  /**
+   * Split a path into its elements. The path needs not start nor
+   * end with a slash.
+   *
+   * \param [in] path The path.
+   * \returns The elements of the path.
+   */
+  static std::vector<Element> Compile (std::string path);
+
+private:
+  /** The full path. */
+  std::string m_path;
+  /** The last element of the path: an attribute or a trace source. */
+  std::string m_leaf;
+  /** The path without its last element. */
+  std::string m_root;
+  /** The elements of the path without its last element. */
+  std::vector<Element> m_elements;
+};
+
 /**
  * \ingroup config
  * \param [in] obj A new root object
@@ -25,10 +25,12 @@
 
 #include "ptr.h"
 #include "pointer.h"
+#include "string.h"
 #include "assert.h"
 #include "log.h"
 
 #include <cmath>
+#include <cstring>
 
 
 /**
@@ -53,10 +55,19 @@ DefaultSimulatorImpl::GetTypeId (void)
     .SetParent<SimulatorImpl> ()
     .SetGroupName ("Core")
     .AddConstructor<DefaultSimulatorImpl> ()
+    .AddAttribute ("EventTraceFile",
+                   "The file to record the operations on the event queue to, "
+                   "none if empty.",
+                   StringValue (""),
+                   MakeStringAccessor (&DefaultSimulatorImpl::SetEventTraceFile),
+                   MakeStringChecker ())
   ;
   return tid;
 }
 
+const char DefaultSimulatorImpl::EVENT_TRACE_MAGIC[8] = { 'N', 'S', '3', 'E', 'V', 'T', 'R', '1' };
+const uint32_t DefaultSimulatorImpl::EVENT_TRACE_RECORD_SIZE;
+
 DefaultSimulatorImpl::DefaultSimulatorImpl ()
 {
   NS_LOG_FUNCTION (this);
@@ -71,8 +82,8 @@ DefaultSimulatorImpl::DefaultSimulatorImpl ()
   m_currentTs = 0;
   m_currentContext = 0xffffffff;
   m_unscheduledEvents = 0;
-  m_eventsWithContextEmpty = true;
   m_main = SystemThread::Self();
+  m_recording = false;
 }
 
 DefaultSimulatorImpl::~DefaultSimulatorImpl ()
@@ -92,6 +103,11 @@ DefaultSimulatorImpl::DoDispose (void)
       next.impl->Unref ();
     }
   m_events = 0;
+  if (m_recording)
+    {
+      m_eventTrace.close ();
+      m_recording = false;
+    }
   SimulatorImpl::DoDispose ();
 }
 void
@@ -127,6 +143,40 @@ DefaultSimulatorImpl::SetScheduler (ObjectFactory schedulerFactory)
   m_events = scheduler;
 }
 
+void
+DefaultSimulatorImpl::SetEventTraceFile (std::string filename)
+{
+  NS_LOG_FUNCTION (this << filename);
+  if (m_recording)
+    {
+      m_eventTrace.close ();
+      m_recording = false;
+    }
+  if (filename.empty ())
+    {
+      return;
+    }
+  m_eventTrace.open (filename.c_str (), std::ios::out | std::ios::binary | std::ios::trunc);
+  if (!m_eventTrace.is_open ())
+    {
+      NS_FATAL_ERROR ("Could not open event trace file " << filename);
+    }
+  m_eventTrace.write (EVENT_TRACE_MAGIC, sizeof (EVENT_TRACE_MAGIC));
+  m_recording = true;
+}
+
+void
+DefaultSimulatorImpl::RecordEvent (enum EventTraceOp op, const Scheduler::Event &ev)
+{
+  char record[EVENT_TRACE_RECORD_SIZE];
+  record[0] = op;
+  memcpy (record + 1, &m_currentTs, 8);
+  memcpy (record + 9, &ev.key.m_ts, 8);
+  memcpy (record + 17, &ev.key.m_context, 4);
+  memcpy (record + 21, &ev.key.m_uid, 4);
+  m_eventTrace.write (record, EVENT_TRACE_RECORD_SIZE);
+}
+
 // System ID for non-distributed simulation is always zero
 uint32_t 
 DefaultSimulatorImpl::GetSystemId (void) const
@@ -138,6 +188,10 @@ void
 DefaultSimulatorImpl::ProcessOneEvent (void)
 {
   Scheduler::Event next = m_events->RemoveNext ();
+  if (m_recording)
+    {
+      RecordEvent (EVENT_TRACE_REMOVE_NEXT, next);
+    }
 
   NS_ASSERT (next.key.m_ts >= m_currentTs);
   m_unscheduledEvents--;
@@ -161,22 +215,18 @@ DefaultSimulatorImpl::IsFinished (void) const
 void
 DefaultSimulatorImpl::ProcessEventsWithContext (void)
 {
-  if (m_eventsWithContextEmpty)
+  if (m_eventsWithContext.IsEmpty ())
     {
       return;
     }
 
-  // swap queues
-  EventsWithContext eventsWithContext;
-  {
-    CriticalSection cs (m_eventsWithContextMutex);
-    m_eventsWithContext.swap(eventsWithContext);
-    m_eventsWithContextEmpty = true;
-  }
-  while (!eventsWithContext.empty ())
+  // drain the whole batch at once
+  m_eventsWithContextBatch.clear ();
+  m_eventsWithContext.PopAll (m_eventsWithContextBatch);
+  for (EventsWithContext::const_iterator i = m_eventsWithContextBatch.begin ();
+       i != m_eventsWithContextBatch.end (); i++)
     {
-       EventWithContext event = eventsWithContext.front ();
-       eventsWithContext.pop_front ();
+       const EventWithContext &event = *i;
        Scheduler::Event ev;
        ev.impl = event.event;
        ev.key.m_ts = m_currentTs + event.timestamp;
@@ -185,6 +235,10 @@ DefaultSimulatorImpl::ProcessEventsWithContext (void)
        m_uid++;
        m_unscheduledEvents++;
        m_events->Insert (ev);
+       if (m_recording)
+         {
+           RecordEvent (EVENT_TRACE_INSERT, ev);
+         }
     }
 }
 
@@ -242,6 +296,10 @@ DefaultSimulatorImpl::Schedule (Time const &delay, EventImpl *event)
   m_uid++;
   m_unscheduledEvents++;
   m_events->Insert (ev);
+  if (m_recording)
+    {
+      RecordEvent (EVENT_TRACE_INSERT, ev);
+    }
   return EventId (event, ev.key.m_ts, ev.key.m_context, ev.key.m_uid);
 }
 
@@ -261,6 +319,10 @@ DefaultSimulatorImpl::ScheduleWithContext (uint32_t context, Time const &delay,
       m_uid++;
       m_unscheduledEvents++;
       m_events->Insert (ev);
+      if (m_recording)
+        {
+          RecordEvent (EVENT_TRACE_INSERT, ev);
+        }
     }
   else
     {
@@ -269,11 +331,7 @@ DefaultSimulatorImpl::ScheduleWithContext (uint32_t context, Time const &delay,
       // Current time added in ProcessEventsWithContext()
       ev.timestamp = delay.GetTimeStep ();
       ev.event = event;
-      {
-        CriticalSection cs (m_eventsWithContextMutex);
-        m_eventsWithContext.push_back(ev);
-        m_eventsWithContextEmpty = false;
-      }
+      m_eventsWithContext.Push (ev);
     }
 }
 
@@ -290,6 +348,10 @@ DefaultSimulatorImpl::ScheduleNow (EventImpl *event)
   m_uid++;
   m_unscheduledEvents++;
   m_events->Insert (ev);
+  if (m_recording)
+    {
+      RecordEvent (EVENT_TRACE_INSERT, ev);
+    }
   return EventId (event, ev.key.m_ts, ev.key.m_context, ev.key.m_uid);
 }
 
@@ -350,6 +412,10 @@ DefaultSimulatorImpl::Remove (const EventId &id)
   event.key.m_context = id.GetContext ();
   event.key.m_uid = id.GetUid ();
   m_events->Remove (event);
+  if (m_recording)
+    {
+      RecordEvent (EVENT_TRACE_REMOVE, event);
+    }
   event.impl->Cancel ();
   // whenever we remove an event from the event list, we have to unref it.
   event.impl->Unref ();
@@ -363,6 +429,15 @@ DefaultSimulatorImpl::Cancel (const EventId &id)
   if (!IsExpired (id))
     {
       id.PeekEventImpl ()->Cancel ();
+      if (m_recording && id.GetUid () != 2)
+        {
+          Scheduler::Event event;
+          event.impl = id.PeekEventImpl ();
+          event.key.m_ts = id.GetTs ();
+          event.key.m_context = id.GetContext ();
+          event.key.m_uid = id.GetUid ();
+          RecordEvent (EVENT_TRACE_CANCEL, event);
+        }
     }
 }
 
@@ -25,11 +25,14 @@
 #include "scheduler.h"
 #include "event-impl.h"
 #include "system-thread.h"
-#include "ns3/system-mutex.h"
+#include "mpsc-queue.h"
 
 #include "ptr.h"
 
 #include <list>
+#include <vector>
+#include <fstream>
+#include <string>
 
 /**
  * \file
@@ -43,6 +46,19 @@ namespace ns3 {
  * \ingroup simulator
  *
  * The default single process simulator implementation.
+ *
+ * When the EventTraceFile attribute is set, every operation on the event
+ * queue is recorded to that file, so that the schedulers can be compared
+ * on the events of a real simulation (see utils/bench-scheduler.cc).
+ * The file starts with the EVENT_TRACE_MAGIC string and holds one
+ * record of EVENT_TRACE_RECORD_SIZE bytes per operation, in host byte
+ * order:
+ *
+ *   - uint8_t: the EventTraceOp,
+ *   - uint64_t: the current time, in time steps,
+ *   - uint64_t: the timestamp of the event,
+ *   - uint32_t: the context of the event,
+ *   - uint32_t: the uid of the event.
  */
 class DefaultSimulatorImpl : public SimulatorImpl
 {
@@ -53,6 +69,19 @@ public:
    */
   static TypeId GetTypeId (void);
 
+  /** The operations recorded in an event trace. */
+  enum EventTraceOp
+  {
+    EVENT_TRACE_INSERT = 0,       /**< An event was scheduled. */
+    EVENT_TRACE_REMOVE_NEXT = 1,  /**< The next event was run. */
+    EVENT_TRACE_REMOVE = 2,       /**< An event was removed from the queue. */
+    EVENT_TRACE_CANCEL = 3        /**< An event was cancelled, but left in the queue. */
+  };
+  /** The string an event trace starts with. */
+  static const char EVENT_TRACE_MAGIC[8];
+  /** The size of a record in an event trace. */
+  static const uint32_t EVENT_TRACE_RECORD_SIZE = 25;
+
   /** Constructor. */
   DefaultSimulatorImpl ();
   /** Destructor. */
@@ -85,6 +114,19 @@ private:
   void ProcessOneEvent (void);
   /** Move events from a different context into the main event queue. */
   void ProcessEventsWithContext (void);
+  /**
+   * Start recording the operations on the event queue.
+   *
+   * \param [in] filename The file to record to, none if empty.
+   */
+  void SetEventTraceFile (std::string filename);
+  /**
+   * Record an operation on the event queue.
+   *
+   * \param [in] op The operation.
+   * \param [in] ev The event.
+   */
+  void RecordEvent (enum EventTraceOp op, const Scheduler::Event &ev);
  
   /** Wrap an event with its execution context. */
   struct EventWithContext {
@@ -95,17 +137,15 @@ private:
     /** The event implementation. */
     EventImpl *event;
   };
-  /** Container type for the events from a different context. */
-  typedef std::list<struct EventWithContext> EventsWithContext;
-  /** The container of events from a different context. */
-  EventsWithContext m_eventsWithContext;
+  /** Container type for a batch of events from a different context. */
+  typedef std::vector<struct EventWithContext> EventsWithContext;
+  /** The lock-free queue of events from a different context. */
+  MpscQueue<struct EventWithContext> m_eventsWithContext;
   /**
-   * Flag \c true if all events with context have been moved to the
-   * primary event queue.
+   * The batch of events moved from m_eventsWithContext to the primary
+   * event queue, kept to reuse its storage.
    */
-  bool m_eventsWithContextEmpty;
-  /** Mutex to control access to the list of events with context. */
-  SystemMutex m_eventsWithContextMutex;
+  EventsWithContext m_eventsWithContextBatch;
 
   /** Container type for the events to run at Simulator::Destroy() */
   typedef std::list<EventId> DestroyEvents;
@@ -132,6 +172,11 @@ private:
 
   /** Main execution thread. */
   SystemThread::ThreadId m_main;
+
+  /** The event trace, if recording. */
+  std::ofstream m_eventTrace;
+  /** Flag \c true if the operations on the event queue are recorded. */
+  bool m_recording;
 };
 
 } // namespace ns3
@@ -19,7 +19,9 @@
  */
 
 #include "event-impl.h"
+#include "system-mutex.h"
 #include "log.h"
+#include <new>
 
 /**
  * \file
@@ -31,6 +33,149 @@ namespace ns3 {
 
 NS_LOG_COMPONENT_DEFINE ("EventImpl");
 
+namespace {
+
+/** Sizes are rounded up to a multiple of this. */
+const std::size_t EVENT_POOL_GRANULARITY = 16;
+/** Number of size classes; larger events use the general allocator. */
+const std::size_t EVENT_POOL_CLASSES = 16;
+/** Maximum number of blocks kept in the free list of a size class. */
+const uint32_t EVENT_POOL_MAX_CACHED = 65536;
+
+/** A block in a free list. */
+struct FreeBlock
+{
+  FreeBlock *next;  /**< Next block in the free list. */
+};
+
+/**
+ * The free lists of a thread.
+ *
+ * This is trivially destructible so that events released while the
+ * thread's destructors run, after EventPoolReaper has emptied the lists,
+ * can still check m_dead.
+ */
+struct EventPool
+{
+  FreeBlock *head[EVENT_POOL_CLASSES];     /**< Free lists. */
+  uint32_t length[EVENT_POOL_CLASSES];     /**< Length of the free lists. */
+  EventImpl::PoolStats stats;              /**< Statistics. */
+  bool dead;                               /**< Has the thread released its lists. */
+};
+
+thread_local EventPool g_eventPool;
+
+/** Statistics of the threads which have exited. */
+EventImpl::PoolStats g_retiredStats;
+
+/**
+ * \returns The mutex protecting g_retiredStats.
+ */
+SystemMutex &
+GetRetiredStatsMutex (void)
+{
+  static SystemMutex mutex;
+  return mutex;
+}
+
+/** Releases the free lists of a thread when it exits. */
+struct EventPoolReaper
+{
+  /** Make sure the destructor is registered by the first allocation. */
+  void Touch (void)
+  {
+  }
+  ~EventPoolReaper ()
+  {
+    EventPool &pool = g_eventPool;
+    for (std::size_t i = 0; i < EVENT_POOL_CLASSES; i++)
+      {
+        while (pool.head[i] != 0)
+          {
+            FreeBlock *block = pool.head[i];
+            pool.head[i] = block->next;
+            ::operator delete (block);
+          }
+        pool.length[i] = 0;
+      }
+    pool.stats.cached = 0;
+    pool.dead = true;
+    CriticalSection cs (GetRetiredStatsMutex ());
+    g_retiredStats.allocated += pool.stats.allocated;
+    g_retiredStats.recycled += pool.stats.recycled;
+    g_retiredStats.released += pool.stats.released;
+  }
+};
+
+thread_local EventPoolReaper g_eventPoolReaper;
+
+} // anonymous namespace
+
+void *
+EventImpl::operator new (std::size_t size)
+{
+  EventPool &pool = g_eventPool;
+  std::size_t sizeClass = (size - 1) / EVENT_POOL_GRANULARITY;
+  if (sizeClass >= EVENT_POOL_CLASSES)
+    {
+      return ::operator new (size);
+    }
+  //The block may be released by another thread into its free list, so it
+  //must hold any event of its size class even if this thread's lists are gone
+  if (pool.dead)
+    {
+      return ::operator new ((sizeClass + 1) * EVENT_POOL_GRANULARITY);
+    }
+  pool.stats.allocated++;
+  FreeBlock *block = pool.head[sizeClass];
+  if (block != 0)
+    {
+      pool.head[sizeClass] = block->next;
+      pool.length[sizeClass]--;
+      pool.stats.recycled++;
+      pool.stats.cached--;
+      return block;
+    }
+  g_eventPoolReaper.Touch ();
+  return ::operator new ((sizeClass + 1) * EVENT_POOL_GRANULARITY);
+}
+
+void
+EventImpl::operator delete (void *p, std::size_t size)
+{
+  EventPool &pool = g_eventPool;
+  std::size_t sizeClass = (size - 1) / EVENT_POOL_GRANULARITY;
+  if (sizeClass >= EVENT_POOL_CLASSES)
+    {
+      ::operator delete (p);
+      return;
+    }
+  //Events created by another thread, with ScheduleWithContext, are
+  //released by the simulation thread: their blocks join its free lists.
+  pool.stats.released++;
+  if (pool.dead || pool.length[sizeClass] >= EVENT_POOL_MAX_CACHED)
+    {
+      ::operator delete (p);
+      return;
+    }
+  FreeBlock *block = static_cast<FreeBlock *> (p);
+  block->next = pool.head[sizeClass];
+  pool.head[sizeClass] = block;
+  pool.length[sizeClass]++;
+  pool.stats.cached++;
+}
+
+EventImpl::PoolStats
+EventImpl::GetPoolStats (void)
+{
+  PoolStats stats = g_eventPool.stats;
+  CriticalSection cs (GetRetiredStatsMutex ());
+  stats.allocated += g_retiredStats.allocated;
+  stats.recycled += g_retiredStats.recycled;
+  stats.released += g_retiredStats.released;
+  return stats;
+}
+
 EventImpl::~EventImpl ()
 {
   NS_LOG_FUNCTION (this);
@@ -21,6 +21,7 @@
 #define EVENT_IMPL_H
 
 #include <stdint.h>
+#include <cstddef>
 #include "simple-ref-count.h"
 
 /**
@@ -66,6 +67,37 @@ public:
    */
   bool IsCancelled (void);
 
+  /**
+   * Allocate the storage of an event from the free list of its size class.
+   *
+   * \param [in] size The size of the event.
+   * \returns The storage.
+   */
+  static void * operator new (std::size_t size);
+  /**
+   * Return the storage of an event to the free list of its size class.
+   *
+   * \param [in] p The storage.
+   * \param [in] size The size of the event.
+   */
+  static void operator delete (void *p, std::size_t size);
+
+  /** Statistics of the event allocator. */
+  struct PoolStats
+  {
+    uint64_t allocated;  /**< Number of events allocated. */
+    uint64_t recycled;   /**< Number of those taken from a free list. */
+    uint64_t released;   /**< Number of events released. */
+    uint64_t cached;     /**< Number of blocks held in free lists. */
+  };
+  /**
+   * Get the statistics of the allocator of the calling thread, including
+   * those of the threads which have exited.
+   *
+   * \returns The statistics.
+   */
+  static PoolStats GetPoolStats (void);
+
 protected:
   /**
    * Implementation for Invoke().
@@ -187,32 +187,6 @@ int64x64_t::Udiv (const uint128_t a, const uint128_t b)
   return result;
 }
 
-void 
-int64x64_t::MulByInvert (const int64x64_t & o)
-{
-  bool negResult = _v < 0;
-  uint128_t a = negResult ? -_v : _v;
-  uint128_t result = UmulByInvert (a, o._v);
-
-  _v = negResult ? -result : result;
-}
-
-uint128_t
-int64x64_t::UmulByInvert (const uint128_t a, const uint128_t b)
-{
-  uint128_t result, ah, bh, al, bl;
-  uint128_t hi, mid;
-  ah = a >> 64;
-  bh = b >> 64;
-  al = a & HP_MASK_LO;
-  bl = b & HP_MASK_LO;
-  hi = ah * bh;
-  mid = ah * bl + al * bh;
-  mid >>= 64;
-  result = hi + mid;
-  return result;
-}
-
 int64x64_t 
 int64x64_t::Invert (const uint64_t v)
 {
@@ -0,0 +1,288 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "ladder-scheduler.h"
+#include "event-impl.h"
+#include <algorithm>
+#include "assert.h"
+#include "log.h"
+
+/**
+ * \file
+ * \ingroup scheduler
+ * Implementation of ns3::LadderScheduler class.
+ */
+
+namespace ns3 {
+
+NS_LOG_COMPONENT_DEFINE ("LadderScheduler");
+
+NS_OBJECT_ENSURE_REGISTERED (LadderScheduler);
+
+namespace {
+
+/** Buckets of at most this many events are sorted into the bottom list. */
+const uint32_t LADDER_THRESHOLD = 50;
+/** Maximum number of rungs; the buckets of the last one are always sorted. */
+const uint32_t LADDER_MAX_RUNGS = 8;
+
+} // anonymous namespace
+
+TypeId
+LadderScheduler::GetTypeId (void)
+{
+  static TypeId tid = TypeId ("ns3::LadderScheduler")
+    .SetParent<Scheduler> ()
+    .SetGroupName ("Core")
+    .AddConstructor<LadderScheduler> ()
+  ;
+  return tid;
+}
+
+LadderScheduler::LadderScheduler ()
+  : m_topMin (0),
+    m_topMax (0),
+    m_topStart (0),
+    m_rungs (LADDER_MAX_RUNGS),
+    m_nRungs (0),
+    m_bottomHead (0),
+    m_size (0)
+{
+  NS_LOG_FUNCTION (this);
+}
+
+LadderScheduler::~LadderScheduler ()
+{
+  NS_LOG_FUNCTION (this);
+}
+
+uint32_t
+LadderScheduler::FindRung (uint64_t ts) const
+{
+  for (uint32_t i = 0; i < m_nRungs; i++)
+    {
+      const Rung &rung = m_rungs[i];
+      if (ts >= rung.start + rung.current * rung.width)
+        {
+          return i;
+        }
+    }
+  return m_nRungs;
+}
+
+LadderScheduler::Rung &
+LadderScheduler::PushRung (uint64_t start, uint64_t end, uint32_t nEvents)
+{
+  NS_LOG_FUNCTION (this << start << end << nEvents);
+  NS_ASSERT (m_nRungs < LADDER_MAX_RUNGS);
+  NS_ASSERT (nEvents > 0 && start <= end);
+  Rung &rung = m_rungs[m_nRungs++];
+  rung.start = start;
+  rung.width = (end - start) / nEvents + 1;
+  rung.nBuckets = static_cast<uint32_t> ((end - start) / rung.width) + 1;
+  rung.current = 0;
+  rung.count = 0;
+  if (rung.buckets.size () < rung.nBuckets)
+    {
+      rung.buckets.resize (rung.nBuckets);
+    }
+  return rung;
+}
+
+void
+LadderScheduler::InsertBottom (const Scheduler::Event &ev)
+{
+  Bucket::iterator i = std::upper_bound (m_bottom.begin () + m_bottomHead, m_bottom.end (), ev);
+  if (i == m_bottom.begin () + m_bottomHead && m_bottomHead > 0)
+    {
+      m_bottom[--m_bottomHead] = ev;
+    }
+  else
+    {
+      m_bottom.insert (i, ev);
+    }
+}
+
+void
+LadderScheduler::Insert (const Scheduler::Event &ev)
+{
+  NS_LOG_FUNCTION (this << ev.impl << ev.key.m_ts << ev.key.m_uid);
+  m_size++;
+  uint64_t ts = ev.key.m_ts;
+  if (ts >= m_topStart)
+    {
+      if (m_top.empty ())
+        {
+          m_topMin = ts;
+          m_topMax = ts;
+        }
+      else
+        {
+          m_topMin = std::min (m_topMin, ts);
+          m_topMax = std::max (m_topMax, ts);
+        }
+      m_top.push_back (ev);
+      return;
+    }
+  uint32_t r = FindRung (ts);
+  if (r < m_nRungs)
+    {
+      Rung &rung = m_rungs[r];
+      uint64_t index = (ts - rung.start) / rung.width;
+      NS_ASSERT (index >= rung.current && index < rung.nBuckets);
+      rung.buckets[index].push_back (ev);
+      rung.count++;
+      return;
+    }
+  InsertBottom (ev);
+}
+
+void
+LadderScheduler::FillBottom (void)
+{
+  NS_LOG_FUNCTION (this);
+  NS_ASSERT (m_size > 0);
+  while (m_bottomHead == m_bottom.size ())
+    {
+      m_bottom.clear ();
+      m_bottomHead = 0;
+      if (m_nRungs == 0)
+        {
+          NS_ASSERT (!m_top.empty ());
+          Rung &rung = PushRung (m_topMin, m_topMax, m_top.size ());
+          for (Bucket::const_iterator i = m_top.begin (); i != m_top.end (); ++i)
+            {
+              rung.buckets[(i->key.m_ts - rung.start) / rung.width].push_back (*i);
+            }
+          rung.count = m_top.size ();
+          m_topStart = rung.start + rung.nBuckets * rung.width;
+          m_top.clear ();
+          continue;
+        }
+      Rung &rung = m_rungs[m_nRungs - 1];
+      if (rung.count == 0)
+        {
+          m_nRungs--;
+          continue;
+        }
+      while (rung.buckets[rung.current].empty ())
+        {
+          rung.current++;
+        }
+      Bucket &bucket = rung.buckets[rung.current];
+      uint64_t bucketEnd = rung.start + (rung.current + 1) * rung.width;
+      rung.current++;
+      rung.count -= bucket.size ();
+      uint64_t min = bucket.front ().key.m_ts;
+      uint64_t max = min;
+      for (Bucket::const_iterator i = bucket.begin (); i != bucket.end (); ++i)
+        {
+          min = std::min (min, i->key.m_ts);
+          max = std::max (max, i->key.m_ts);
+        }
+      if (bucket.size () <= LADDER_THRESHOLD || min == max || m_nRungs == LADDER_MAX_RUNGS)
+        {
+          //The bottom list is empty: take the bucket's storage and give
+          //the bottom list's to the bucket
+          m_bottom.swap (bucket);
+          std::sort (m_bottom.begin (), m_bottom.end ());
+          continue;
+        }
+      //Spread the bucket over a finer rung. Events inserted later before
+      //min go to the bottom list, so the rung starts at min, but it has
+      //to reach the end of the bucket.
+      Rung &child = PushRung (min, bucketEnd - 1, bucket.size ());
+      for (Bucket::const_iterator i = bucket.begin (); i != bucket.end (); ++i)
+        {
+          child.buckets[(i->key.m_ts - child.start) / child.width].push_back (*i);
+        }
+      child.count = bucket.size ();
+      bucket.clear ();
+    }
+}
+
+bool
+LadderScheduler::IsEmpty (void) const
+{
+  return m_size == 0;
+}
+
+Scheduler::Event
+LadderScheduler::PeekNext (void) const
+{
+  NS_LOG_FUNCTION (this);
+  NS_ASSERT (!IsEmpty ());
+  //Moving events down the ladder does not change the order of the queue
+  const_cast<LadderScheduler *> (this)->FillBottom ();
+  return m_bottom[m_bottomHead];
+}
+
+Scheduler::Event
+LadderScheduler::RemoveNext (void)
+{
+  NS_LOG_FUNCTION (this);
+  NS_ASSERT (!IsEmpty ());
+  FillBottom ();
+  m_size--;
+  return m_bottom[m_bottomHead++];
+}
+
+void
+LadderScheduler::Remove (const Scheduler::Event &ev)
+{
+  NS_LOG_FUNCTION (this << ev.impl << ev.key.m_ts << ev.key.m_uid);
+  NS_ASSERT (!IsEmpty ());
+  m_size--;
+  uint64_t ts = ev.key.m_ts;
+  if (ts >= m_topStart)
+    {
+      for (Bucket::iterator i = m_top.begin (); i != m_top.end (); ++i)
+        {
+          if (i->key.m_uid == ev.key.m_uid)
+            {
+              NS_ASSERT (ev.impl == i->impl);
+              *i = m_top.back ();
+              m_top.pop_back ();
+              return;
+            }
+        }
+      NS_ASSERT (false);
+    }
+  uint32_t r = FindRung (ts);
+  if (r < m_nRungs)
+    {
+      Rung &rung = m_rungs[r];
+      Bucket &bucket = rung.buckets[(ts - rung.start) / rung.width];
+      for (Bucket::iterator i = bucket.begin (); i != bucket.end (); ++i)
+        {
+          if (i->key.m_uid == ev.key.m_uid)
+            {
+              NS_ASSERT (ev.impl == i->impl);
+              *i = bucket.back ();
+              bucket.pop_back ();
+              rung.count--;
+              return;
+            }
+        }
+      NS_ASSERT (false);
+    }
+  Bucket::iterator i = std::lower_bound (m_bottom.begin () + m_bottomHead, m_bottom.end (), ev);
+  NS_ASSERT (i != m_bottom.end () && i->key.m_uid == ev.key.m_uid);
+  NS_ASSERT (ev.impl == i->impl);
+  m_bottom.erase (i);
+}
+
+} // namespace ns3
@@ -0,0 +1,145 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#ifndef LADDER_SCHEDULER_H
+#define LADDER_SCHEDULER_H
+
+#include "scheduler.h"
+#include <stdint.h>
+#include <vector>
+
+/**
+ * \file
+ * \ingroup scheduler
+ * Declaration of ns3::LadderScheduler class.
+ */
+
+namespace ns3 {
+
+class EventImpl;
+
+/**
+ * \ingroup scheduler
+ * \brief a ladder queue event scheduler
+ *
+ * This event scheduler implements the ladder queue of
+ * "Ladder Queue: An O(1) Priority Queue Structure for Large-Scale
+ * Discrete Event Simulation" by Tang, Goh and Thng (2005).
+ *
+ * Events far in the future are appended, unsorted, to the top list.
+ * When the events due next are needed, the top list is spread over the
+ * buckets of a rung; the first non-empty bucket is either sorted into
+ * the bottom list, from which events are removed in order, or, when it
+ * holds too many events, spread over the finer buckets of a new rung.
+ * Each event is thus moved a bounded number of times and only small
+ * buckets are ever sorted.
+ *
+ * A bucket whose events all have the same timestamp cannot be spread
+ * and is moved to the bottom list at once. Since events of the same
+ * timestamp are scheduled in uid order, such bursts (all the stations
+ * waking up for the same beacon, say) are appended to the bottom list
+ * without any search.
+ *
+ * The rungs and their buckets are kept once allocated and reused by
+ * later rungs, so a running simulation does not allocate per event.
+ */
+class LadderScheduler : public Scheduler
+{
+public:
+  /**
+   *  Register this type.
+   *  \return The object TypeId.
+   */
+  static TypeId GetTypeId (void);
+
+  /** Constructor. */
+  LadderScheduler ();
+  /** Destructor. */
+  virtual ~LadderScheduler ();
+
+  // Inherited
+  virtual void Insert (const Scheduler::Event &ev);
+  virtual bool IsEmpty (void) const;
+  virtual Scheduler::Event PeekNext (void) const;
+  virtual Scheduler::Event RemoveNext (void);
+  virtual void Remove (const Scheduler::Event &ev);
+
+private:
+  /** A list of events, sorted in the bottom list only. */
+  typedef std::vector<Scheduler::Event> Bucket;
+
+  /** Buckets of equal width covering a contiguous range of timestamps. */
+  struct Rung
+  {
+    uint64_t start;               /**< Timestamp of the first bucket. */
+    uint64_t width;               /**< Width of a bucket. */
+    uint32_t nBuckets;            /**< Number of buckets in use. */
+    uint32_t current;             /**< First bucket not yet moved down. */
+    uint32_t count;               /**< Number of events in the rung. */
+    std::vector<Bucket> buckets;  /**< The buckets; may hold more than nBuckets. */
+  };
+
+  /**
+   * Move events down the ladder until the bottom list is not empty.
+   * The queue must not be empty.
+   */
+  void FillBottom (void);
+  /**
+   * Set up the next rung to cover a range of timestamps.
+   *
+   * \param [in] start The first timestamp of the range.
+   * \param [in] end The last timestamp of the range.
+   * \param [in] nEvents The number of events to spread over the rung.
+   * \returns The new rung.
+   */
+  Rung & PushRung (uint64_t start, uint64_t end, uint32_t nEvents);
+  /**
+   * Find the rung an event of a given timestamp belongs to.
+   *
+   * \param [in] ts The timestamp.
+   * \returns The index of the rung, m_nRungs for the bottom list.
+   */
+  uint32_t FindRung (uint64_t ts) const;
+  /**
+   * Insert an event in the sorted bottom list.
+   *
+   * \param [in] ev The event.
+   */
+  void InsertBottom (const Scheduler::Event &ev);
+
+  /** Unsorted events at or after m_topStart. */
+  Bucket m_top;
+  /** Smallest timestamp in m_top. */
+  uint64_t m_topMin;
+  /** Largest timestamp in m_top. */
+  uint64_t m_topMax;
+  /** Events at or after this timestamp go to m_top. */
+  uint64_t m_topStart;
+  /** The rungs; the first m_nRungs are in use. */
+  std::vector<Rung> m_rungs;
+  /** Number of rungs in use. */
+  uint32_t m_nRungs;
+  /** Sorted events, the next one at m_bottomHead. */
+  Bucket m_bottom;
+  /** Index of the next event in m_bottom. */
+  uint32_t m_bottomHead;
+  /** Number of events in the queue. */
+  uint32_t m_size;
+};
+
+} // namespace ns3
+
+#endif /* LADDER_SCHEDULER_H */
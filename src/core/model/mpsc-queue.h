@@ -0,0 +1,161 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#ifndef MPSC_QUEUE_H
+#define MPSC_QUEUE_H
+
+#include <algorithm>
+#include <atomic>
+#include <vector>
+
+/**
+ * \file
+ * \ingroup system
+ * ns3::MpscQueue declaration and template implementation.
+ */
+
+namespace ns3 {
+
+/**
+ * \ingroup system
+ * \brief A lock-free queue with many producer threads and one consumer.
+ *
+ * The producers push each item on a linked stack with a compare and swap,
+ * without any lock. The consumer takes the whole stack with a single
+ * exchange and hands the batch over in the order of the pushes, so the
+ * items of each producer keep their order. As the consumer never removes
+ * a single node, the queue is not exposed to the ABA problem.
+ *
+ * \tparam T \explicit The type of the items, which must be copyable.
+ */
+template <typename T>
+class MpscQueue
+{
+public:
+  MpscQueue ();
+  /** Destructor: the items which were not popped are dropped. */
+  ~MpscQueue ();
+
+  /**
+   * Push an item, from any thread.
+   *
+   * \param [in] item The item.
+   */
+  void Push (const T &item);
+  /**
+   * Check if there is no item to pop, from any thread.
+   *
+   * \returns \c true if the queue was empty at the time of the check.
+   */
+  bool IsEmpty (void) const;
+  /**
+   * Pop all the items, from the consumer thread only.
+   *
+   * \param [in,out] items The items are appended to this container, in
+   *        the order they were pushed in.
+   * \returns The number of items popped.
+   */
+  std::size_t PopAll (std::vector<T> &items);
+
+private:
+  /** Copy constructor, not implemented. */
+  MpscQueue (const MpscQueue &);
+  /**
+   * Assignment operator, not implemented.
+   * \returns This queue.
+   */
+  MpscQueue &operator = (const MpscQueue &);
+
+  /** A node of the linked stack. */
+  struct Node
+  {
+    T item;      /**< The item. */
+    Node *next;  /**< The node pushed before this one. */
+  };
+  /** The node pushed last, 0 if the queue is empty. */
+  std::atomic<Node *> m_head;
+};
+
+} // namespace ns3
+
+
+/********************************************************************
+ *  Implementation of the templates declared above.
+ ********************************************************************/
+
+namespace ns3 {
+
+template <typename T>
+MpscQueue<T>::MpscQueue ()
+  : m_head (0)
+{
+}
+
+template <typename T>
+MpscQueue<T>::~MpscQueue ()
+{
+  Node *node = m_head.exchange (0);
+  while (node != 0)
+    {
+      Node *next = node->next;
+      delete node;
+      node = next;
+    }
+}
+
+template <typename T>
+void
+MpscQueue<T>::Push (const T &item)
+{
+  Node *node = new Node;
+  node->item = item;
+  node->next = m_head.load (std::memory_order_relaxed);
+  // On failure, node->next is set to the new head
+  while (!m_head.compare_exchange_weak (node->next, node,
+                                        std::memory_order_release,
+                                        std::memory_order_relaxed))
+    {
+    }
+}
+
+template <typename T>
+bool
+MpscQueue<T>::IsEmpty (void) const
+{
+  return m_head.load (std::memory_order_relaxed) == 0;
+}
+
+template <typename T>
+std::size_t
+MpscQueue<T>::PopAll (std::vector<T> &items)
+{
+  Node *node = m_head.exchange (0, std::memory_order_acquire);
+  std::size_t first = items.size ();
+  while (node != 0)
+    {
+      items.push_back (node->item);
+      Node *next = node->next;
+      delete node;
+      node = next;
+    }
+  // The stack is linked from the last push
+  std::reverse (items.begin () + first, items.end ());
+  return items.size () - first;
+}
+
+} // namespace ns3
+
+#endif /* MPSC_QUEUE_H */
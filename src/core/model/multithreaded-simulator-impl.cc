@@ -0,0 +1,654 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "simulator.h"
+#include "multithreaded-simulator-impl.h"
+#include "fatal-error.h"
+#include "uinteger.h"
+#include "assert.h"
+#include "log.h"
+
+#include <algorithm>
+#include <thread>
+#include <unistd.h>
+
+/**
+ * \file
+ * \ingroup simulator
+ * Implementation of class ns3::MultithreadedSimulatorImpl.
+ */
+
+namespace ns3 {
+
+// Note:  Logging in this file is largely avoided due to the
+// number of calls that are made to these functions and the possibility
+// of causing recursions leading to stack overflow
+NS_LOG_COMPONENT_DEFINE ("MultithreadedSimulatorImpl");
+
+NS_OBJECT_ENSURE_REGISTERED (MultithreadedSimulatorImpl);
+
+namespace {
+
+/** Index of the partition run by the calling thread, -1 if none. */
+thread_local int32_t g_partition = -1;
+
+/** Flag \c true while the events run on more than one thread. */
+std::atomic<bool> g_parallel (false);
+
+/** Number of checks of a flag before waiting on the window mutex. */
+const uint32_t SPIN_COUNT = 4000;
+
+} // unnamed namespace
+
+TypeId
+MultithreadedSimulatorImpl::GetTypeId (void)
+{
+  static TypeId tid = TypeId ("ns3::MultithreadedSimulatorImpl")
+    .SetParent<SimulatorImpl> ()
+    .SetGroupName ("Core")
+    .AddConstructor<MultithreadedSimulatorImpl> ()
+    .AddAttribute ("Threads",
+                   "The number of threads running the events, "
+                   "0 for one per processor.",
+                   UintegerValue (0),
+                   MakeUintegerAccessor (&MultithreadedSimulatorImpl::m_threads),
+                   MakeUintegerChecker<uint32_t> ())
+    .AddAttribute ("Lookahead",
+                   "The minimum delay of the events scheduled for "
+                   "the nodes of another thread.",
+                   TimeValue (Time (0)),
+                   MakeTimeAccessor (&MultithreadedSimulatorImpl::m_lookahead),
+                   MakeTimeChecker (Time (0)))
+  ;
+  return tid;
+}
+
+MultithreadedSimulatorImpl::MultithreadedSimulatorImpl ()
+  : m_threads (0),
+    m_currentTs (0),
+    m_windowEnd (0),
+    m_stopped (false),
+    m_running (false),
+    m_window (0),
+    m_quit (false),
+    m_busy (0),
+    m_nextWorker (0)
+{
+  NS_LOG_FUNCTION (this);
+  m_main = SystemThread::Self ();
+}
+
+MultithreadedSimulatorImpl::~MultithreadedSimulatorImpl ()
+{
+  NS_LOG_FUNCTION (this);
+}
+
+bool
+MultithreadedSimulatorImpl::IsParallel (void)
+{
+  return g_parallel.load (std::memory_order_relaxed);
+}
+
+int32_t
+MultithreadedSimulatorImpl::GetPartitionIndex (void)
+{
+  return g_partition;
+}
+
+void
+MultithreadedSimulatorImpl::DoDispose (void)
+{
+  NS_LOG_FUNCTION (this);
+  MergeHeldEvents ();
+  for (std::vector<Partition>::iterator i = m_partitions.begin (); i != m_partitions.end (); i++)
+    {
+      while (!i->events->IsEmpty ())
+        {
+          Scheduler::Event next = i->events->RemoveNext ();
+          next.impl->Unref ();
+        }
+    }
+  m_partitions.clear ();
+  SimulatorImpl::DoDispose ();
+}
+
+void
+MultithreadedSimulatorImpl::Destroy ()
+{
+  NS_LOG_FUNCTION (this);
+  while (!m_destroyEvents.empty ())
+    {
+      Ptr<EventImpl> ev = m_destroyEvents.front ().PeekEventImpl ();
+      m_destroyEvents.pop_front ();
+      NS_LOG_LOGIC ("handle destroy " << ev);
+      if (!ev->IsCancelled ())
+        {
+          ev->Invoke ();
+        }
+    }
+}
+
+void
+MultithreadedSimulatorImpl::SetScheduler (ObjectFactory schedulerFactory)
+{
+  NS_LOG_FUNCTION (this << schedulerFactory);
+  if (m_partitions.empty ())
+    {
+      uint32_t threads = m_threads;
+      if (threads == 0)
+        {
+          long processors = sysconf (_SC_NPROCESSORS_ONLN);
+          threads = processors > 0 ? processors : 1;
+        }
+      NS_LOG_INFO ("running the events on " << threads << " threads");
+      m_partitions.resize (threads);
+      for (std::vector<Partition>::iterator i = m_partitions.begin (); i != m_partitions.end (); i++)
+        {
+          // uids are allocated from 4, as in DefaultSimulatorImpl
+          i->currentTs = 0;
+          i->currentUid = 0;
+          i->currentContext = 0xffffffff;
+          i->uid = 4;
+          i->held.resize (threads);
+        }
+    }
+  for (std::vector<Partition>::iterator i = m_partitions.begin (); i != m_partitions.end (); i++)
+    {
+      Ptr<Scheduler> scheduler = schedulerFactory.Create<Scheduler> ();
+      if (i->events != 0)
+        {
+          while (!i->events->IsEmpty ())
+            {
+              scheduler->Insert (i->events->RemoveNext ());
+            }
+        }
+      i->events = scheduler;
+    }
+}
+
+// System ID for non-distributed simulation is always zero
+uint32_t
+MultithreadedSimulatorImpl::GetSystemId (void) const
+{
+  return 0;
+}
+
+uint32_t
+MultithreadedSimulatorImpl::GetPartition (uint32_t context) const
+{
+  // The events without a node run with the first partition
+  if (context == 0xffffffff)
+    {
+      return 0;
+    }
+  return context % m_partitions.size ();
+}
+
+MultithreadedSimulatorImpl::Partition &
+MultithreadedSimulatorImpl::GetCurrentPartition (void) const
+{
+  uint32_t index = g_partition >= 0 ? g_partition : 0;
+  return const_cast<Partition &> (m_partitions[index]);
+}
+
+Scheduler::Event
+MultithreadedSimulatorImpl::Insert (Partition &partition, uint64_t ts, uint32_t context, EventImpl *event)
+{
+  Scheduler::Event ev;
+  ev.impl = event;
+  ev.key.m_ts = ts;
+  ev.key.m_context = context;
+  ev.key.m_uid = partition.uid;
+  partition.uid++;
+  partition.events->Insert (ev);
+  return ev;
+}
+
+void
+MultithreadedSimulatorImpl::MergeHeldEvents (void)
+{
+  // Merged by source then destination partition, so that the uids, which
+  // order the events of the same timestamp, do not depend on the threads.
+  for (std::vector<Partition>::iterator src = m_partitions.begin (); src != m_partitions.end (); src++)
+    {
+      for (uint32_t dst = 0; dst < src->held.size (); dst++)
+        {
+          HeldEvents &held = src->held[dst];
+          for (HeldEvents::const_iterator i = held.begin (); i != held.end (); i++)
+            {
+              Insert (m_partitions[dst], i->timestamp, i->context, i->event);
+            }
+          held.clear ();
+        }
+    }
+
+  if (m_foreignEvents.IsEmpty ())
+    {
+      return;
+    }
+  HeldEvents foreign;
+  m_foreignEvents.PopAll (foreign);
+  uint64_t now = m_currentTs;
+  for (std::vector<Partition>::const_iterator i = m_partitions.begin (); i != m_partitions.end (); i++)
+    {
+      now = std::max (now, i->currentTs);
+    }
+  for (HeldEvents::const_iterator i = foreign.begin (); i != foreign.end (); i++)
+    {
+      Insert (m_partitions[GetPartition (i->context)], now + i->timestamp, i->context, i->event);
+    }
+}
+
+void
+MultithreadedSimulatorImpl::RunWindow (uint32_t index)
+{
+  g_partition = index;
+  Partition &partition = m_partitions[index];
+  // A stop only ends the run between two windows, so every partition runs
+  // the whole window whatever the timing of the threads
+  while (!partition.events->IsEmpty ()
+         && partition.events->PeekNext ().key.m_ts < m_windowEnd)
+    {
+      Scheduler::Event next = partition.events->RemoveNext ();
+      NS_ASSERT (next.key.m_ts >= partition.currentTs);
+      partition.currentTs = next.key.m_ts;
+      partition.currentContext = next.key.m_context;
+      partition.currentUid = next.key.m_uid;
+      next.impl->Invoke ();
+      next.impl->Unref ();
+    }
+  g_partition = -1;
+}
+
+void
+MultithreadedSimulatorImpl::Worker (void)
+{
+  uint32_t index = m_nextWorker.fetch_add (1);
+  uint64_t window = 0;
+  while (true)
+    {
+      // The windows are short, so spin a bit before sleeping.
+      for (uint32_t spin = 0; spin < SPIN_COUNT && m_window.load () == window; spin++)
+        {
+          std::this_thread::yield ();
+        }
+      {
+        std::unique_lock<std::mutex> lock (m_windowMutex);
+        while (!m_quit && m_window.load () == window)
+          {
+            m_windowStart.wait (lock);
+          }
+        if (m_quit)
+          {
+            return;
+          }
+      }
+      window++;
+      RunWindow (index);
+      m_busy.fetch_sub (1, std::memory_order_release);
+    }
+}
+
+bool
+MultithreadedSimulatorImpl::IsFinished (void) const
+{
+  if (m_stopped)
+    {
+      return true;
+    }
+  for (std::vector<Partition>::const_iterator i = m_partitions.begin (); i != m_partitions.end (); i++)
+    {
+      if (!i->events->IsEmpty ())
+        {
+          return false;
+        }
+    }
+  return true;
+}
+
+void
+MultithreadedSimulatorImpl::Run (void)
+{
+  NS_LOG_FUNCTION (this);
+  // Set the current threadId as the main threadId
+  m_main = SystemThread::Self ();
+  m_stopped = false;
+
+  uint32_t threads = m_partitions.size ();
+  uint64_t lookahead = std::max<int64_t> (m_lookahead.GetTimeStep (), 1);
+  if (threads > 1)
+    {
+      // The workers wait for the first window of the run
+      m_window = 0;
+      m_quit = false;
+      m_nextWorker = 1;
+      for (uint32_t i = 1; i < threads; i++)
+        {
+          Ptr<SystemThread> worker = Create<SystemThread> (MakeCallback (&MultithreadedSimulatorImpl::Worker, this));
+          worker->Start ();
+          m_workers.push_back (worker);
+        }
+      g_parallel = true;
+    }
+  m_running = true;
+
+  while (true)
+    {
+      MergeHeldEvents ();
+      uint64_t stop = UINT64_MAX;
+      {
+        std::lock_guard<std::mutex> lock (m_stopMutex);
+        if (!m_stops.empty ())
+          {
+            stop = *m_stops.begin ();
+          }
+      }
+      bool empty = true;
+      uint64_t next = 0;
+      for (std::vector<Partition>::const_iterator i = m_partitions.begin (); i != m_partitions.end (); i++)
+        {
+          if (!i->events->IsEmpty ())
+            {
+              uint64_t ts = i->events->PeekNext ().key.m_ts;
+              next = empty ? ts : std::min (next, ts);
+              empty = false;
+            }
+        }
+      if (stop != UINT64_MAX && (empty || next >= stop))
+        {
+          // Like the stop event of DefaultSimulatorImpl, the clock moves to
+          // the time of the stop
+          {
+            std::lock_guard<std::mutex> lock (m_stopMutex);
+            m_stops.erase (m_stops.begin ());
+          }
+          m_currentTs = stop;
+          m_stopped = true;
+          break;
+        }
+      if (empty)
+        {
+          break;
+        }
+      m_currentTs = next;
+      m_windowEnd = std::min (next + lookahead, stop);
+
+      if (threads == 1)
+        {
+          RunWindow (0);
+          continue;
+        }
+      m_busy.store (threads, std::memory_order_relaxed);
+      {
+        std::lock_guard<std::mutex> lock (m_windowMutex);
+        m_window++;
+      }
+      m_windowStart.notify_all ();
+      RunWindow (0);
+      m_busy.fetch_sub (1, std::memory_order_release);
+      while (m_busy.load (std::memory_order_acquire) != 0)
+        {
+          std::this_thread::yield ();
+        }
+    }
+
+  m_running = false;
+  if (!m_workers.empty ())
+    {
+      {
+        std::lock_guard<std::mutex> lock (m_windowMutex);
+        m_quit = true;
+      }
+      m_windowStart.notify_all ();
+      for (std::vector<Ptr<SystemThread> >::iterator i = m_workers.begin (); i != m_workers.end (); i++)
+        {
+          (*i)->Join ();
+        }
+      m_workers.clear ();
+      g_parallel = false;
+    }
+  // Now () is the time of the last event run
+  for (std::vector<Partition>::const_iterator i = m_partitions.begin (); i != m_partitions.end (); i++)
+    {
+      m_currentTs = std::max (m_currentTs, i->currentTs);
+    }
+}
+
+void
+MultithreadedSimulatorImpl::AddStop (uint64_t ts)
+{
+  std::lock_guard<std::mutex> lock (m_stopMutex);
+  m_stops.insert (ts);
+}
+
+void
+MultithreadedSimulatorImpl::Stop (void)
+{
+  NS_LOG_FUNCTION (this);
+  // Like DefaultSimulatorImpl, ignored outside of a run. The other
+  // partitions may already be past the current event, so the run ends
+  // with the current window.
+  if (m_running)
+    {
+      AddStop (m_windowEnd);
+    }
+}
+
+void
+MultithreadedSimulatorImpl::Stop (Time const &delay)
+{
+  NS_LOG_FUNCTION (this << delay.GetTimeStep ());
+  NS_ASSERT_MSG (g_partition >= 0 || SystemThread::Equals (m_main), "Simulator::Stop Thread-unsafe invocation!");
+  uint64_t ts = (Now () + delay).GetTimeStep ();
+  if (m_running)
+    {
+      // The other partitions may already be past a time of the current window
+      ts = std::max (ts, m_windowEnd);
+    }
+  AddStop (ts);
+}
+
+EventId
+MultithreadedSimulatorImpl::Schedule (Time const &delay, EventImpl *event)
+{
+  NS_ASSERT_MSG (g_partition >= 0 || SystemThread::Equals (m_main), "Simulator::Schedule Thread-unsafe invocation!");
+
+  Time tAbsolute = delay + Now ();
+  NS_ASSERT (tAbsolute.IsPositive ());
+  Partition &partition = GetCurrentPartition ();
+  Scheduler::Event ev = Insert (partition, tAbsolute.GetTimeStep (), GetContext (), event);
+  return EventId (event, ev.key.m_ts, ev.key.m_context, ev.key.m_uid);
+}
+
+void
+MultithreadedSimulatorImpl::ScheduleWithContext (uint32_t context, Time const &delay, EventImpl *event)
+{
+  NS_LOG_FUNCTION (this << context << delay.GetTimeStep () << event);
+
+  uint32_t target = GetPartition (context);
+  if (g_partition >= 0)
+    {
+      Partition &partition = m_partitions[g_partition];
+      uint64_t ts = partition.currentTs + delay.GetTimeStep ();
+      if (target == (uint32_t)g_partition)
+        {
+          Insert (partition, ts, context, event);
+          return;
+        }
+      if (ts < m_windowEnd)
+        {
+          NS_FATAL_ERROR ("Event for context " << context << " scheduled " << delay.GetTimeStep ()
+                          << " after context " << partition.currentContext
+                          << ", below the lookahead of " << m_lookahead.GetTimeStep ());
+        }
+      HeldEvent held;
+      held.timestamp = ts;
+      held.context = context;
+      held.event = event;
+      partition.held[target].push_back (held);
+    }
+  else if (SystemThread::Equals (m_main))
+    {
+      Insert (m_partitions[target], m_currentTs + delay.GetTimeStep (), context, event);
+    }
+  else
+    {
+      HeldEvent ev;
+      ev.context = context;
+      // Current time added in MergeHeldEvents()
+      ev.timestamp = delay.GetTimeStep ();
+      ev.event = event;
+      m_foreignEvents.Push (ev);
+    }
+}
+
+EventId
+MultithreadedSimulatorImpl::ScheduleNow (EventImpl *event)
+{
+  return Schedule (Time (0), event);
+}
+
+EventId
+MultithreadedSimulatorImpl::ScheduleDestroy (EventImpl *event)
+{
+  NS_ASSERT_MSG (SystemThread::Equals (m_main) && !m_running, "Simulator::ScheduleDestroy Thread-unsafe invocation!");
+
+  EventId id (Ptr<EventImpl> (event, false), m_currentTs, 0xffffffff, 2);
+  m_destroyEvents.push_back (id);
+  return id;
+}
+
+Time
+MultithreadedSimulatorImpl::Now (void) const
+{
+  // Do not add function logging here, to avoid stack overflow
+  if (g_partition >= 0)
+    {
+      return TimeStep (m_partitions[g_partition].currentTs);
+    }
+  return TimeStep (m_currentTs);
+}
+
+Time
+MultithreadedSimulatorImpl::GetDelayLeft (const EventId &id) const
+{
+  if (IsExpired (id))
+    {
+      return TimeStep (0);
+    }
+  else
+    {
+      return TimeStep (id.GetTs ()) - Now ();
+    }
+}
+
+void
+MultithreadedSimulatorImpl::Remove (const EventId &id)
+{
+  if (id.GetUid () == 2)
+    {
+      // destroy events.
+      for (DestroyEvents::iterator i = m_destroyEvents.begin (); i != m_destroyEvents.end (); i++)
+        {
+          if (*i == id)
+            {
+              m_destroyEvents.erase (i);
+              break;
+            }
+        }
+      return;
+    }
+  if (IsExpired (id))
+    {
+      return;
+    }
+  uint32_t index = GetPartition (id.GetContext ());
+  NS_ASSERT_MSG (g_partition < 0 ? !m_running : (uint32_t)g_partition == index,
+                 "Simulator::Remove of an event of another thread");
+  Scheduler::Event event;
+  event.impl = id.PeekEventImpl ();
+  event.key.m_ts = id.GetTs ();
+  event.key.m_context = id.GetContext ();
+  event.key.m_uid = id.GetUid ();
+  m_partitions[index].events->Remove (event);
+  event.impl->Cancel ();
+  // whenever we remove an event from the event list, we have to unref it.
+  event.impl->Unref ();
+}
+
+void
+MultithreadedSimulatorImpl::Cancel (const EventId &id)
+{
+  if (!IsExpired (id))
+    {
+      id.PeekEventImpl ()->Cancel ();
+    }
+}
+
+bool
+MultithreadedSimulatorImpl::IsExpired (const EventId &id) const
+{
+  if (id.GetUid () == 2)
+    {
+      if (id.PeekEventImpl () == 0 ||
+          id.PeekEventImpl ()->IsCancelled ())
+        {
+          return true;
+        }
+      // destroy events.
+      for (DestroyEvents::const_iterator i = m_destroyEvents.begin (); i != m_destroyEvents.end (); i++)
+        {
+          if (*i == id)
+            {
+              return false;
+            }
+        }
+      return true;
+    }
+  if (id.PeekEventImpl () == 0 || id.PeekEventImpl ()->IsCancelled ())
+    {
+      return true;
+    }
+  uint32_t index = GetPartition (id.GetContext ());
+  if (g_partition >= 0 && (uint32_t)g_partition != index)
+    {
+      // The other partition runs the current window concurrently: only the
+      // events before the window are known to have run
+      return id.GetTs () < m_currentTs;
+    }
+  // The events of a context are ordered by the clock of its partition
+  const Partition &partition = m_partitions[index];
+  return id.GetTs () < partition.currentTs ||
+         (id.GetTs () == partition.currentTs && id.GetUid () <= partition.currentUid);
+}
+
+Time
+MultithreadedSimulatorImpl::GetMaximumSimulationTime (void) const
+{
+  return TimeStep (0x7fffffffffffffffLL);
+}
+
+uint32_t
+MultithreadedSimulatorImpl::GetContext (void) const
+{
+  if (g_partition >= 0)
+    {
+      return m_partitions[g_partition].currentContext;
+    }
+  return 0xffffffff;
+}
+
+} // namespace ns3
@@ -0,0 +1,232 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#ifndef MULTITHREADED_SIMULATOR_IMPL_H
+#define MULTITHREADED_SIMULATOR_IMPL_H
+
+#include "simulator-impl.h"
+#include "scheduler.h"
+#include "event-impl.h"
+#include "system-thread.h"
+#include "mpsc-queue.h"
+#include "nstime.h"
+#include "ptr.h"
+
+#include <atomic>
+#include <condition_variable>
+#include <list>
+#include <mutex>
+#include <set>
+#include <vector>
+
+/**
+ * \file
+ * \ingroup simulator
+ * Declaration of class ns3::MultithreadedSimulatorImpl.
+ */
+
+namespace ns3 {
+
+/**
+ * \ingroup simulator
+ *
+ * A conservative parallel simulator implementation for a single process.
+ *
+ * The execution contexts (the node ids) are spread over partitions, one
+ * per thread, each with its own event queue. The simulation advances in
+ * windows: a window starts at the timestamp of the earliest pending event
+ * and is Lookahead long (or holds only that timestamp if the lookahead
+ * is zero), and every partition runs its events of the window in its own
+ * thread.
+ *
+ * An event scheduled for a context of another partition is held until
+ * the end of the window, so it must not fall inside the window: its delay
+ * must be at least the lookahead, and strictly positive. Models which
+ * schedule events across nodes, like a wireless channel, derive the
+ * lookahead from their minimum delay. Since the held events are merged
+ * in a fixed order, the results do not depend on the scheduling of the
+ * threads, only on their number.
+ *
+ * The models running in different partitions must not share state which
+ * is modified during the simulation, and an event can only be cancelled
+ * or removed from the partition which runs it. Seen from another partition,
+ * an event has only expired if it is before the current window.
+ *
+ * A run only stops between two windows, so that every partition runs the
+ * same events. Stop (delay) ends the run at an absolute time: the windows
+ * are cut at that time, every partition runs all its events before it and
+ * none after it, and the clock is then at that time. Stop () ends the run
+ * at the end of the current window, as does Stop (delay) for a time inside
+ * the current window.
+ */
+class MultithreadedSimulatorImpl : public SimulatorImpl
+{
+public:
+  /**
+   *  Register this type.
+   *  \return The object TypeId.
+   */
+  static TypeId GetTypeId (void);
+
+  /** Constructor. */
+  MultithreadedSimulatorImpl ();
+  /** Destructor. */
+  ~MultithreadedSimulatorImpl ();
+
+  /**
+   * \returns true if a MultithreadedSimulatorImpl is running events on
+   * more than one thread.
+   */
+  static bool IsParallel (void);
+  /**
+   * \returns the index of the partition whose events run on the calling
+   * thread, or -1 outside of the events of a MultithreadedSimulatorImpl
+   * run. State drawn by the events, like the packet uids, can be kept per
+   * partition so that it does not depend on the timing of the threads.
+   */
+  static int32_t GetPartitionIndex (void);
+
+  // Inherited
+  virtual void Destroy ();
+  virtual bool IsFinished (void) const;
+  virtual void Stop (void);
+  virtual void Stop (Time const &delay);
+  virtual EventId Schedule (Time const &delay, EventImpl *event);
+  virtual void ScheduleWithContext (uint32_t context, Time const &delay, EventImpl *event);
+  virtual EventId ScheduleNow (EventImpl *event);
+  virtual EventId ScheduleDestroy (EventImpl *event);
+  virtual void Remove (const EventId &id);
+  virtual void Cancel (const EventId &id);
+  virtual bool IsExpired (const EventId &id) const;
+  virtual void Run (void);
+  virtual Time Now (void) const;
+  virtual Time GetDelayLeft (const EventId &id) const;
+  virtual Time GetMaximumSimulationTime (void) const;
+  virtual void SetScheduler (ObjectFactory schedulerFactory);
+  virtual uint32_t GetSystemId (void) const;
+  virtual uint32_t GetContext (void) const;
+
+private:
+  virtual void DoDispose (void);
+
+  /** An event held until the end of the window. */
+  struct HeldEvent
+  {
+    uint64_t timestamp;  /**< Absolute timestamp, or delay for foreign threads. */
+    uint32_t context;    /**< The event context. */
+    EventImpl *event;    /**< The event implementation. */
+  };
+  /** Container type for the held events. */
+  typedef std::vector<HeldEvent> HeldEvents;
+
+  /** The events of a set of contexts, run by one thread. */
+  struct Partition
+  {
+    Ptr<Scheduler> events;          /**< The event queue. */
+    uint64_t currentTs;             /**< Timestamp of the current event. */
+    uint32_t currentUid;            /**< Unique id of the current event. */
+    uint32_t currentContext;        /**< Execution context of the current event. */
+    uint32_t uid;                   /**< Next event unique id. */
+    std::vector<HeldEvents> held;   /**< Events for the other partitions, by partition. */
+  };
+
+  /**
+   * \param [in] context A context.
+   * \returns The index of the partition of the context.
+   */
+  uint32_t GetPartition (uint32_t context) const;
+  /**
+   * \returns The partition running on the calling thread, or the one the
+   * main thread schedules to when it is not running events.
+   */
+  Partition & GetCurrentPartition (void) const;
+  /**
+   * Insert an event in a partition.
+   *
+   * \param [in] partition The partition.
+   * \param [in] ts The timestamp of the event.
+   * \param [in] context The context of the event.
+   * \param [in] event The event.
+   * \returns The event as inserted.
+   */
+  Scheduler::Event Insert (Partition &partition, uint64_t ts, uint32_t context, EventImpl *event);
+  /** Move the held events to their partitions. */
+  void MergeHeldEvents (void);
+  /**
+   * Run the events of a partition which fall in the current window.
+   *
+   * \param [in] index The index of the partition.
+   */
+  void RunWindow (uint32_t index);
+  /** Main loop of a worker thread. */
+  void Worker (void);
+  /**
+   * Record a time at which the run stops.
+   *
+   * \param [in] ts The timestamp of the stop.
+   */
+  void AddStop (uint64_t ts);
+
+  /** The partitions. */
+  std::vector<Partition> m_partitions;
+  /** Number of threads, 0 for one per processor. */
+  uint32_t m_threads;
+  /** Minimum delay of the events scheduled across partitions. */
+  Time m_lookahead;
+
+  /** Timestamp of the start of the current window. */
+  uint64_t m_currentTs;
+  /** End of the current window, excluded. */
+  uint64_t m_windowEnd;
+  /** The times at which the runs stop, protected by m_stopMutex. */
+  std::set<uint64_t> m_stops;
+  /** Protects m_stops. */
+  std::mutex m_stopMutex;
+  /** Flag \c true if the last run reached a stop. */
+  bool m_stopped;
+  /** Flag \c true while the worker threads are running. */
+  bool m_running;
+
+  /** Events from foreign threads, with their delay. */
+  MpscQueue<HeldEvent> m_foreignEvents;
+
+  /** Container type for the events to run at Simulator::Destroy() */
+  typedef std::list<EventId> DestroyEvents;
+  /** The container of events to run at Destroy. */
+  DestroyEvents m_destroyEvents;
+
+  /** The worker threads. */
+  std::vector<Ptr<SystemThread> > m_workers;
+  /** Protects m_window. */
+  std::mutex m_windowMutex;
+  /** Signals a new window to the workers. */
+  std::condition_variable m_windowStart;
+  /** Number of the current window of the run. */
+  std::atomic<uint64_t> m_window;
+  /** Flag \c true to stop the workers, protected by m_windowMutex. */
+  bool m_quit;
+  /** Number of partitions still running the current window. */
+  std::atomic<uint32_t> m_busy;
+  /** Index of the partition of the next worker to start. */
+  std::atomic<uint32_t> m_nextWorker;
+
+  /** Main execution thread. */
+  SystemThread::ThreadId m_main;
+};
+
+} // namespace ns3
+
+#endif /* MULTITHREADED_SIMULATOR_IMPL_H */
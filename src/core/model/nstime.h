@@ -428,6 +428,24 @@ public:
    */
   inline static Time FromInteger (uint64_t value, enum Unit unit)
   {
+    // At the default resolution, the factors are constants, which
+    // saves the lookup of the conversion info
+    if (PeekResolution ()->unit == NS)
+      {
+        switch (unit)
+          {
+          case S:
+            return Time (value * 1000000000);
+          case MS:
+            return Time (value * 1000000);
+          case US:
+            return Time (value * 1000);
+          case NS:
+            return Time (value);
+          default:
+            break;
+          }
+      }
     struct Information *info = PeekInformation (unit);
     if (info->fromMul)
       {
@@ -476,6 +494,24 @@ public:
    */
   inline int64_t ToInteger (enum Unit unit) const
   {
+    // At the default resolution, the divisors are constants, which the
+    // compiler turns into a multiplication
+    if (PeekResolution ()->unit == NS)
+      {
+        switch (unit)
+          {
+          case S:
+            return m_data / 1000000000;
+          case MS:
+            return m_data / 1000000;
+          case US:
+            return m_data / 1000;
+          case NS:
+            return m_data;
+          default:
+            break;
+          }
+      }
     struct Information *info = PeekInformation (unit);
     int64_t v = m_data;
     if (info->toMul)
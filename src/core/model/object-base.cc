@@ -22,6 +22,7 @@
 #include "trace-source-accessor.h"
 #include "attribute-construction-list.h"
 #include "string.h"
+#include "traced-callback.h"
 #include "ns3/core-config.h"
 #ifdef HAVE_STDLIB_H
 #include <cstdlib>
@@ -305,6 +306,10 @@ ObjectBase::TraceConnectWithoutContext (std::string name, const CallbackBase &cb
     {
       return false;
     }
+  if (internal::IsTraceNameListed (name.c_str (), NS3_DISABLED_TRACES))
+    {
+      NS_LOG_WARN ("Trace source " << name << " is compiled out and may never fire");
+    }
   bool ok = accessor->ConnectWithoutContext (this, cb);
   return ok;
 }
@@ -318,6 +323,10 @@ ObjectBase::TraceConnect (std::string name, std::string context, const CallbackB
     {
       return false;
     }
+  if (internal::IsTraceNameListed (name.c_str (), NS3_DISABLED_TRACES))
+    {
+      NS_LOG_WARN ("Trace source " << name << " is compiled out and may never fire");
+    }
   bool ok = accessor->Connect (this, context, cb);
   return ok;
 }
@@ -220,6 +220,31 @@ public:
   virtual bool Get (const ObjectBase * object, AttributeValue &value) const;
   virtual bool HasGetter (void) const;
   virtual bool HasSetter (void) const;
+  /**
+   * Get the number of instances in the container, without copying
+   * the container into an ObjectPtrContainerValue.
+   *
+   * \param [in] object The container object.
+   * \param [out] n The number of instances in the container.
+   * \returns true if the value could be obtained successfully.
+   */
+  bool GetN (const ObjectBase *object, uint32_t *n) const;
+  /**
+   * Get an instance from the container, identified by its position.
+   *
+   * \param [in] object The container object.
+   * \param [in] i The position of the instance, in [0,n[.
+   * \param [out] index The index of the instance in the container.
+   * \returns The instance.
+   */
+  Ptr<Object> GetAt (const ObjectBase *object, uint32_t i, uint32_t *index) const;
+  /**
+   * Check if the index of each instance is its position, so that
+   * an index can be looked up with GetAt without a scan.
+   *
+   * \returns true if GetAt always returns the index \p i.
+   */
+  virtual bool IsIndexedByPosition (void) const;
 private:
   /**
    * Get the number of instances in the container.
@@ -261,6 +286,9 @@ MakeObjectPtrContainerAccessor (Ptr<U> (T::*get)(INDEX) const,
       *index = i;
       return (obj->*m_get)(i);
     }
+    virtual bool IsIndexedByPosition (void) const {
+      return true;
+    }
     Ptr<U> (T::*m_get)(INDEX) const;
     INDEX (T::*m_getN)(void) const;
   } *spec = new MemberGetters ();
@@ -103,6 +103,7 @@ Object::Object ()
   NS_LOG_FUNCTION (this);
   m_aggregates->n = 1;
   m_aggregates->buffer[0] = this;
+  ClearCache (m_aggregates);
 }
 Object::~Object () 
 {
@@ -126,6 +127,11 @@ Object::~Object ()
     {
       std::free (m_aggregates);
     }
+  else
+    {
+      // the cache may point to this object
+      ClearCache (m_aggregates);
+    }
   m_aggregates = 0;
 }
 Object::Object (const Object &o)
@@ -137,6 +143,7 @@ Object::Object (const Object &o)
 {
   m_aggregates->n = 1;
   m_aggregates->buffer[0] = this;
+  ClearCache (m_aggregates);
 }
 void
 Object::Construct (const AttributeConstructionList &attributes)
@@ -151,6 +158,15 @@ Object::DoGetObject (TypeId tid) const
   NS_LOG_FUNCTION (this << tid);
   NS_ASSERT (CheckLoose ());
 
+  Object *cached;
+  if (LookupCache (tid.GetUid (), &cached))
+    {
+      return const_cast<Object *> (cached);
+    }
+
+  uint32_t slot = tid.GetUid () % GET_OBJECT_CACHE_SIZE;
+  m_aggregates->cacheUid[slot] = tid.GetUid ();
+  m_aggregates->cacheObject[slot] = 0;
   uint32_t n = m_aggregates->n;
   TypeId objectTid = Object::GetTypeId ();
   for (uint32_t i = 0; i < n; i++)
@@ -173,7 +189,8 @@ Object::DoGetObject (TypeId tid) const
           current->m_getObjectCount++;
           // then, update the sort
           UpdateSortedArray (m_aggregates, i);
-          // finally, return the match
+          // finally, return the match, and remember it
+          m_aggregates->cacheObject[slot] = current;
           return const_cast<Object *> (current);
         }
     }
@@ -230,6 +247,13 @@ restart:
     }
 }
 void
+Object::ClearCache (struct Aggregates *aggregates)
+{
+  NS_LOG_FUNCTION (aggregates);
+  // uid 0 is never given to a TypeId
+  std::memset (aggregates->cacheUid, 0, sizeof (aggregates->cacheUid));
+}
+void
 Object::UpdateSortedArray (struct Aggregates *aggregates, uint32_t j) const
 {
   NS_LOG_FUNCTION (this << aggregates << j);
@@ -264,6 +288,7 @@ Object::AggregateObject (Ptr<Object> o)
   struct Aggregates *aggregates = 
     (struct Aggregates *)std::malloc (sizeof(struct Aggregates)+(total-1)*sizeof(Object*));
   aggregates->n = total;
+  ClearCache (aggregates);
 
   // copy our buffer to the new buffer
   std::memcpy (&aggregates->buffer[0], 
@@ -333,6 +358,7 @@ Object::SetTypeId (TypeId tid)
   NS_LOG_FUNCTION (this << tid);
   NS_ASSERT (Check ());
   m_tid = tid;
+  ClearCache (m_aggregates);
 }
 
 void
@@ -316,6 +316,8 @@ private:
   friend class AggregateIterator;
   friend struct ObjectDeleter;
 
+  /** The number of entries of the GetObject() cache of the aggregates. */
+  static const uint32_t GET_OBJECT_CACHE_SIZE = 8;
   /**
    * The list of Objects aggregated to this one.
    *
@@ -327,14 +329,30 @@ private:
    * chunk of memory than the struct to allow space for a larger
    * variable sized buffer whose size is indicated by the element
    * \c n
+   *
+   * The buffer is preceded by a direct-mapped cache of the results of
+   * DoGetObject(), indexed by the uid of the requested TypeId. As
+   * AggregateObject() allocates a new structure, the cache starts empty
+   * every time the set of aggregates changes.
    */
   struct Aggregates {
     /** The number of entries in \c buffer. */
     uint32_t n;
+    /** The TypeId uids of the cache entries, 0 for an empty entry. */
+    uint16_t cacheUid[GET_OBJECT_CACHE_SIZE];
+    /** The Objects found for \c cacheUid, 0 if there is none. */
+    Object *cacheObject[GET_OBJECT_CACHE_SIZE];
     /** The array of Objects. */
     Object *buffer[1];
   };
 
+  /**
+   * Empty the GetObject() cache of a list of aggregates.
+   *
+   * \param [in] aggregates The list of aggregates.
+   */
+  static void ClearCache (struct Aggregates *aggregates);
+
   /**
    * Find an Object of TypeId tid in the aggregates of this Object.
    *
@@ -342,6 +360,14 @@ private:
    * \return The matching Object, if it is found
    */
   Ptr<Object> DoGetObject (TypeId tid) const;
+  /**
+   * Look up the GetObject() cache of the aggregates.
+   *
+   * \param [in] uid The uid of the TypeId we're looking for.
+   * \param [out] object The matching Object, 0 if there is none.
+   * \return \c true if the result of the lookup was in the cache.
+   */
+  inline bool LookupCache (uint16_t uid, Object **object) const;
   /**
    * Verify that this Object is still live, by checking it's reference count.
    * \return \c true if the reference count is non zero.
@@ -450,18 +476,30 @@ ObjectDeleter::Delete (Object *object)
   object->DoDelete ();
 }
 
+bool
+Object::LookupCache (uint16_t uid, Object **object) const
+{
+  uint32_t slot = uid % GET_OBJECT_CACHE_SIZE;
+  if (m_aggregates->cacheUid[slot] == uid)
+    {
+      *object = m_aggregates->cacheObject[slot];
+      return true;
+    }
+  return false;
+}
+
 template <typename T>
 Ptr<T> 
 Object::GetObject () const
 {
-  // This is an optimization: if the cast works (which is likely),
-  // things will be pretty fast.
-  T *result = dynamic_cast<T *> (m_aggregates->buffer[0]);
-  if (result != 0)
+  // This is an optimization: a hit in the cache of the aggregates
+  // costs a few loads.
+  Object *cached;
+  if (LookupCache (T::GetTypeId ().GetUid (), &cached))
     {
-      return Ptr<T> (result);
+      return Ptr<T> (static_cast<T *> (cached));
     }
-  // if the cast does not work, we try to do a full type check.
+  // if the type is not in the cache, we do a full type check.
   Ptr<Object> found = DoGetObject (T::GetTypeId ());
   if (found != 0)
     {
@@ -180,6 +180,12 @@ Simulator::Destroy (void)
   (*pimpl)->Destroy ();
   (*pimpl)->Unref ();
   *pimpl = 0;
+
+  EventImpl::PoolStats stats = EventImpl::GetPoolStats ();
+  NS_LOG_INFO ("events allocated: " << stats.allocated <<
+               ", recycled: " << stats.recycled <<
+               ", released: " << stats.released <<
+               ", cached blocks: " << stats.cached);
 }
 
 void
@@ -0,0 +1,151 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "sweep-runner.h"
+#include "fatal-error.h"
+#include "log.h"
+
+#include <cstdio>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+#include <map>
+#include <sys/types.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+/**
+ * \file
+ * \ingroup system
+ * ns3::SweepRunner implementation.
+ */
+
+namespace ns3 {
+
+NS_LOG_COMPONENT_DEFINE ("SweepRunner");
+
+SweepRunner::SweepRunner ()
+  : m_workers (0)
+{
+  NS_LOG_FUNCTION (this);
+}
+
+void
+SweepRunner::SetWorkers (uint32_t workers)
+{
+  NS_LOG_FUNCTION (this << workers);
+  m_workers = workers;
+}
+
+uint32_t
+SweepRunner::GetWorkers (void) const
+{
+  if (m_workers != 0)
+    {
+      return m_workers;
+    }
+  long processors = sysconf (_SC_NPROCESSORS_ONLN);
+  return processors > 0 ? processors : 1;
+}
+
+std::string
+SweepRunner::GetPartName (std::string output, uint32_t index)
+{
+  std::ostringstream oss;
+  oss << output << ".part" << index;
+  return oss.str ();
+}
+
+uint32_t
+SweepRunner::Run (uint32_t replications, Replication replication, std::string output)
+{
+  NS_LOG_FUNCTION (this << replications << output);
+  uint32_t workers = GetWorkers ();
+  uint32_t failed = 0;
+  std::map<pid_t, uint32_t> running;
+  uint32_t next = 0;
+  while (next < replications || !running.empty ())
+    {
+      if (next < replications && running.size () < workers)
+        {
+          //What the parent buffered would be written again by the worker
+          std::cout.flush ();
+          std::cerr.flush ();
+          fflush (0);
+          pid_t pid = fork ();
+          if (pid < 0)
+            {
+              NS_FATAL_ERROR ("Could not fork the worker of replication " << next);
+            }
+          if (pid == 0)
+            {
+              std::ofstream part (GetPartName (output, next).c_str (), std::ios::out | std::ios::trunc);
+              replication (next, part);
+              part.close ();
+              std::cout.flush ();
+              std::cerr.flush ();
+              fflush (0);
+              //Skip the destructors of the copy of the parent's state
+              _exit (part.fail () ? 1 : 0);
+            }
+          NS_LOG_INFO ("replication " << next << " runs in process " << pid);
+          running[pid] = next;
+          next++;
+          continue;
+        }
+      int status;
+      pid_t pid = waitpid (-1, &status, 0);
+      if (pid < 0)
+        {
+          NS_FATAL_ERROR ("Could not wait for the workers");
+        }
+      std::map<pid_t, uint32_t>::iterator i = running.find (pid);
+      if (i == running.end ())
+        {
+          continue;
+        }
+      if (!WIFEXITED (status) || WEXITSTATUS (status) != 0)
+        {
+          NS_LOG_WARN ("replication " << i->second << " failed");
+          failed++;
+        }
+      else
+        {
+          NS_LOG_INFO ("replication " << i->second << " done");
+        }
+      running.erase (i);
+    }
+
+  std::ofstream out (output.c_str (), std::ios::out | std::ios::trunc);
+  if (!out.is_open ())
+    {
+      NS_FATAL_ERROR ("Could not open " << output);
+    }
+  for (uint32_t index = 0; index < replications; index++)
+    {
+      std::string name = GetPartName (output, index);
+      std::ifstream part (name.c_str ());
+      if (part.is_open () && part.peek () != std::ifstream::traits_type::eof ())
+        {
+          out << part.rdbuf ();
+        }
+      part.close ();
+      std::remove (name.c_str ());
+    }
+  return failed;
+}
+
+} // namespace ns3
@@ -0,0 +1,95 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#ifndef SWEEP_RUNNER_H
+#define SWEEP_RUNNER_H
+
+#include <stdint.h>
+#include <ostream>
+#include <string>
+#include "callback.h"
+
+/**
+ * \file
+ * \ingroup system
+ * ns3::SweepRunner declaration.
+ */
+
+namespace ns3 {
+
+/**
+ * \ingroup system
+ * \brief Run the replications of a parameter sweep in worker processes.
+ *
+ * The calling process is forked once per replication, after the modules
+ * are loaded and the command line is parsed, and at most a given number
+ * of workers run at the same time. The workers share the memory of the
+ * calling process copy on write, so the globals of a simulation script
+ * can be used as is: each worker changes its own copy.
+ *
+ * The replication callback gets the index of the replication and a
+ * stream for its results. It is responsible for setting up the
+ * replication (seed, run number, parameters), building the topology and
+ * running the simulation. When all the replications are done, their
+ * results are written to the output file in the order of their index.
+ *
+ * The simulator must not have been used before Run () is called, and the
+ * random variables must be created by the replications, since a stream
+ * is seeded when it is created.
+ */
+class SweepRunner
+{
+public:
+  /** The replication callback: its index and the stream for its results. */
+  typedef Callback<void, uint32_t, std::ostream &> Replication;
+
+  SweepRunner ();
+
+  /**
+   * Set the number of workers running at the same time.
+   *
+   * \param [in] workers The number of workers, 0 for one per processor.
+   */
+  void SetWorkers (uint32_t workers);
+  /**
+   * \returns The number of workers running at the same time.
+   */
+  uint32_t GetWorkers (void) const;
+
+  /**
+   * Run the replications and collect their results.
+   *
+   * \param [in] replications The number of replications.
+   * \param [in] replication The replication callback.
+   * \param [in] output The file to write the results to.
+   * \returns The number of replications which failed.
+   */
+  uint32_t Run (uint32_t replications, Replication replication, std::string output);
+
+private:
+  /**
+   * \param [in] output The output file.
+   * \param [in] index The index of a replication.
+   * \returns The file for the results of the replication.
+   */
+  static std::string GetPartName (std::string output, uint32_t index);
+
+  uint32_t m_workers;  /**< Number of workers running at the same time. */
+};
+
+} // namespace ns3
+
+#endif /* SWEEP_RUNNER_H */
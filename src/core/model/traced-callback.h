@@ -22,7 +22,9 @@
 #define TRACED_CALLBACK_H
 
 #include <list>
+#include <type_traits>
 #include "callback.h"
+#include "ns3/core-config.h"
 
 /**
  * \file
@@ -30,8 +32,94 @@
  * ns3::TracedCallback declaration and template implementation.
  */
 
+#ifndef NS3_DISABLED_TRACES
+/**
+ * \ingroup tracing
+ * The names of the trace sources compiled out, separated by commas, as
+ * given to <tt>./waf configure --disable-traces=...</tt>.
+ */
+#define NS3_DISABLED_TRACES ""
+#endif
+
+/**
+ * \ingroup tracing
+ * Check at compile time if a trace source is compiled in.
+ *
+ * \param [in] name The name of the trace source, a string literal.
+ * \returns \c false if \p name is listed in NS3_DISABLED_TRACES.
+ */
+#define NS_TRACE_ENABLED(name)                                          \
+  (!std::integral_constant<bool, ns3::internal::IsTraceNameListed (name, NS3_DISABLED_TRACES)>::value)
+
+/**
+ * \ingroup tracing
+ * Check if a TracedCallback needs to be invoked: its trace source is
+ * compiled in and a Callback is connected to it. Guard the invocation
+ * and the construction of its arguments with it:
+ * \code
+ *   if (NS_TRACE_IS_CONNECTED ("PhyTxBegin", m_phyTxBeginTrace))
+ *     {
+ *       m_phyTxBeginTrace (packet->Copy ());
+ *     }
+ * \endcode
+ * The trace sources listed in NS3_DISABLED_TRACES are compiled out of
+ * the guarded call sites.
+ *
+ * \param [in] name The name of the trace source, a string literal.
+ * \param [in] trace The TracedCallback.
+ */
+#define NS_TRACE_IS_CONNECTED(name, trace)                              \
+  (NS_TRACE_ENABLED (name) && (trace).IsConnected ())
+
 namespace ns3 {
 
+namespace internal {
+
+/**
+ * \ingroup tracing
+ * Check if a comma separated list of names starts with a name.
+ *
+ * \param [in] name The name.
+ * \param [in] list The list.
+ * \returns \c true if the first name of \p list is \p name.
+ */
+constexpr bool
+IsTraceNameFirst (const char *name, const char *list)
+{
+  return *name == 0 ? (*list == ',' || *list == 0)
+    : (*name == *list && IsTraceNameFirst (name + 1, list + 1));
+}
+
+/**
+ * \ingroup tracing
+ * Skip the first name of a comma separated list of names.
+ *
+ * \param [in] list The list.
+ * \returns The list without its first name.
+ */
+constexpr const char *
+SkipTraceName (const char *list)
+{
+  return *list == 0 ? list : (*list == ',' ? list + 1 : SkipTraceName (list + 1));
+}
+
+/**
+ * \ingroup tracing
+ * Check if a name is in a comma separated list of names.
+ *
+ * \param [in] name The name.
+ * \param [in] list The list.
+ * \returns \c true if \p name is in \p list.
+ */
+constexpr bool
+IsTraceNameListed (const char *name, const char *list)
+{
+  return *list != 0
+    && (IsTraceNameFirst (name, list) || IsTraceNameListed (name, SkipTraceName (list)));
+}
+
+} // namespace internal
+
 /**
  * \ingroup tracing
  * \brief Forward calls to a chain of Callback
@@ -93,6 +181,14 @@ public:
    * \param [in] path Context path which was used to connect the Callback.
    */
   void Disconnect (const CallbackBase & callback, std::string path);
+  /**
+   * Check if a Callback is connected. When building the arguments of
+   * the trace is costly, as a Packet::Copy is, check this first, or use
+   * NS_TRACE_IS_CONNECTED so that the trace can also be compiled out.
+   *
+   * \returns \c true if the chain of Callbacks is not empty.
+   */
+  bool IsConnected (void) const;
   /**
    * \name Functors taking various numbers of arguments.
    *
@@ -314,6 +410,15 @@ TracedCallback<T1,T2,T3,T4,T5,T6,T7,T8>::Disconnect (const CallbackBase & callba
   Callback<void,T1,T2,T3,T4,T5,T6,T7,T8> realCb = cb.Bind (path);
   DisconnectWithoutContext (realCb);
 }
+template<typename T1, typename T2,
+         typename T3, typename T4,
+         typename T5, typename T6,
+         typename T7, typename T8>
+bool
+TracedCallback<T1,T2,T3,T4,T5,T6,T7,T8>::IsConnected (void) const
+{
+  return !m_callbackList.empty ();
+}
 template<typename T1, typename T2, 
          typename T3, typename T4,
          typename T5, typename T6,
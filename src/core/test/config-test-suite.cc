@@ -669,6 +669,113 @@ ObjectVectorTraceConfigTestCase::DoRun (void)
   NS_TEST_ASSERT_MSG_EQ (m_path, "/NodeA/NodeB/NodesB/1/Source", "Trace 1 did not provide expected context");
 }
 
+// ===========================================================================
+// Test for compiled paths, resolved with and without an index.
+// ===========================================================================
+class CompiledPathConfigTestCase : public TestCase
+{
+public:
+  CompiledPathConfigTestCase ();
+  virtual ~CompiledPathConfigTestCase () {}
+
+  void TraceWithPath (std::string path, int16_t old, int16_t newValue) { m_paths.push_back (path); }
+
+private:
+  virtual void DoRun (void);
+
+  std::vector<std::string> m_paths;
+};
+
+CompiledPathConfigTestCase::CompiledPathConfigTestCase ()
+  : TestCase ("Check compiled paths with an index placeholder and index ranges")
+{
+}
+
+void
+CompiledPathConfigTestCase::DoRun (void)
+{
+  IntegerValue iv;
+
+  //
+  // Create a root namespace object with four objects in a vector one
+  // level down.
+  //
+  Ptr<ConfigTestObject> root = CreateObject<ConfigTestObject> ();
+  Config::RegisterRootNamespaceObject (root);
+  Ptr<ConfigTestObject> a = CreateObject<ConfigTestObject> ();
+  root->SetNodeA (a);
+  std::vector<Ptr<ConfigTestObject> > objs;
+  for (uint32_t i = 0; i < 4; i++)
+    {
+      objs.push_back (CreateObject<ConfigTestObject> ());
+      a->AddNodeB (objs.back ());
+    }
+
+  //
+  // Without an index, the placeholder matches the whole vector.
+  //
+  Config::CompiledPath path ("/NodeA/NodesB/%/A");
+  NS_TEST_ASSERT_MSG_EQ (path.GetPath (), "/NodeA/NodesB/%/A", "Unexpected path");
+  Config::MatchContainer matches = path.LookupMatches ();
+  NS_TEST_ASSERT_MSG_EQ (matches.GetN (), 4, "Placeholder without an index does not match all");
+  NS_TEST_ASSERT_MSG_EQ (matches.GetMatchedPath (3), "/NodeA/NodesB/3/", "Unexpected matched path");
+
+  //
+  // With an index, only the object at that index matches.
+  //
+  matches = path.LookupMatches (2);
+  NS_TEST_ASSERT_MSG_EQ (matches.GetN (), 1, "Placeholder with an index does not match one object");
+  NS_TEST_ASSERT_MSG_EQ (matches.Get (0), objs[2], "Unexpected object matched");
+  NS_TEST_ASSERT_MSG_EQ (matches.GetMatchedPath (0), "/NodeA/NodesB/2/", "Unexpected matched path");
+  NS_TEST_ASSERT_MSG_EQ (path.LookupMatches (4).GetN (), 0, "Index past the end matched");
+
+  path.Set (1, IntegerValue (-5));
+  for (uint32_t i = 0; i < 4; i++)
+    {
+      objs[i]->GetAttribute ("A", iv);
+      NS_TEST_ASSERT_MSG_EQ (iv.Get (), (i == 1 ? -5 : 10), "Set with an index changed the wrong objects");
+    }
+  path.Set (IntegerValue (-6));
+  for (uint32_t i = 0; i < 4; i++)
+    {
+      objs[i]->GetAttribute ("A", iv);
+      NS_TEST_ASSERT_MSG_EQ (iv.Get (), -6, "Set without an index did not change all the objects");
+    }
+
+  //
+  // Ranges are visited in order, once per index, and clamped to the vector.
+  //
+  Config::CompiledPath range ("/NodeA/NodesB/[2-8191]|0|[1-2]/Source");
+  range.Connect (MakeCallback (&CompiledPathConfigTestCase::TraceWithPath, this));
+  NS_TEST_ASSERT_MSG_EQ (range.LookupMatches ().GetN (), 4, "Range does not match every object once");
+  for (uint32_t i = 0; i < 4; i++)
+    {
+      objs[i]->SetAttribute ("Source", IntegerValue (i));
+    }
+  NS_TEST_ASSERT_MSG_EQ (m_paths.size (), 4, "Traces did not fire as expected");
+  NS_TEST_ASSERT_MSG_EQ (m_paths[3], "/NodeA/NodesB/3/Source", "Trace 3 did not provide expected context");
+
+  //
+  // Connect with an index substitutes it in the context.
+  //
+  m_paths.clear ();
+  Config::CompiledPath source ("/NodeA/NodesB/%/Source");
+  source.Connect (3, MakeCallback (&CompiledPathConfigTestCase::TraceWithPath, this));
+  objs[2]->SetAttribute ("Source", IntegerValue (-1));
+  objs[3]->SetAttribute ("Source", IntegerValue (-1));
+  NS_TEST_ASSERT_MSG_EQ (m_paths.size (), 3, "Traces did not fire as expected");
+  NS_TEST_ASSERT_MSG_EQ (m_paths[2], "/NodeA/NodesB/3/Source", "Trace 3 did not provide expected context");
+
+  //
+  // The string API resolves through the same matcher.
+  //
+  NS_TEST_ASSERT_MSG_EQ (Config::LookupMatches ("/NodeA/NodesB/1|3").GetN (), 2, "Alternatives not matched");
+  NS_TEST_ASSERT_MSG_EQ (Config::LookupMatches ("/NodeA/NodesB/[3-1]").GetN (), 0, "Empty range matched");
+  NS_TEST_ASSERT_MSG_EQ (Config::CompiledPath ().LookupMatches ().GetN (), 0, "Empty path matched");
+
+  Config::UnregisterRootNamespaceObject (root);
+}
+
 // ===========================================================================
 // Test for the ability to search attributes of parent classes
 // when Resolver searches for attributes in a derived class object.
@@ -737,6 +844,7 @@ ConfigTestSuite::ConfigTestSuite ()
   AddTestCase (new UnderRootNamespaceConfigTestCase, TestCase::QUICK);
   AddTestCase (new ObjectVectorConfigTestCase, TestCase::QUICK);
   AddTestCase (new SearchAttributesOfParentObjectsTestCase, TestCase::QUICK);
+  AddTestCase (new CompiledPathConfigTestCase, TestCase::QUICK);
 }
 
 static ConfigTestSuite configTestSuite;
@@ -0,0 +1,229 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+#include "ns3/test.h"
+#include "ns3/simulator.h"
+#include "ns3/mpsc-queue.h"
+#include "ns3/system-thread.h"
+#include "ns3/config.h"
+#include "ns3/string.h"
+
+#include <utility>
+#include <vector>
+
+using namespace ns3;
+
+/** An item of the queue: the producer and its sequence number. */
+typedef std::pair<uint32_t, uint32_t> Item;
+
+/**
+ * Producer threads push numbered items while the test drains the
+ * queue: no item may be lost, and the items of each producer must come
+ * out in order.
+ */
+class MpscQueueTestCase : public TestCase
+{
+public:
+  MpscQueueTestCase (uint32_t producers, uint32_t items);
+
+private:
+  virtual void DoRun (void);
+  /** The arguments of a producer thread. */
+  struct Producer
+  {
+    MpscQueueTestCase *test;  //!< The test case
+    MpscQueue<Item> *queue;   //!< The queue to push to
+    uint32_t index;           //!< The index of the producer
+  };
+  static void Produce (const Producer *producer);
+
+  uint32_t m_producers;
+  uint32_t m_items;
+};
+
+MpscQueueTestCase::MpscQueueTestCase (uint32_t producers, uint32_t items)
+  : TestCase ("Check the MpscQueue with " + std::to_string (producers) + " producers"),
+    m_producers (producers),
+    m_items (items)
+{
+}
+
+void
+MpscQueueTestCase::Produce (const Producer *producer)
+{
+  for (uint32_t seq = 0; seq < producer->test->m_items; seq++)
+    {
+      producer->queue->Push (Item (producer->index, seq));
+    }
+}
+
+void
+MpscQueueTestCase::DoRun (void)
+{
+  MpscQueue<Item> queue;
+  NS_TEST_EXPECT_MSG_EQ (queue.IsEmpty (), true, "a new queue is not empty");
+
+  std::vector<Producer> producers (m_producers);
+  std::vector<Ptr<SystemThread> > threads;
+  for (uint32_t i = 0; i < m_producers; i++)
+    {
+      producers[i].test = this;
+      producers[i].queue = &queue;
+      producers[i].index = i;
+      threads.push_back (Create<SystemThread> (MakeBoundCallback (&MpscQueueTestCase::Produce,
+                                                                  static_cast<const Producer *> (&producers[i]))));
+    }
+  for (uint32_t i = 0; i < m_producers; i++)
+    {
+      threads[i]->Start ();
+    }
+
+  std::vector<uint32_t> next (m_producers, 0);
+  std::vector<Item> batch;
+  uint64_t total = static_cast<uint64_t> (m_producers) * m_items;
+  uint64_t popped = 0;
+  uint32_t batches = 0;
+  bool ordered = true;
+  while (popped < total)
+    {
+      batch.clear ();
+      if (queue.PopAll (batch) == 0)
+        {
+          continue;
+        }
+      batches++;
+      for (std::vector<Item>::const_iterator i = batch.begin (); i != batch.end (); i++)
+        {
+          ordered = ordered && i->first < m_producers && i->second == next[i->first];
+          next[i->first] = i->second + 1;
+        }
+      popped += batch.size ();
+    }
+  for (uint32_t i = 0; i < m_producers; i++)
+    {
+      threads[i]->Join ();
+    }
+  batch.clear ();
+  NS_TEST_EXPECT_MSG_EQ (queue.PopAll (batch), 0, "more items than pushed");
+  NS_TEST_EXPECT_MSG_EQ (popped, total, "items were lost");
+  NS_TEST_EXPECT_MSG_EQ (ordered, true, "the items of a producer are out of order");
+  NS_TEST_EXPECT_MSG_GT (batches, 0, "nothing was drained");
+  NS_TEST_EXPECT_MSG_EQ (queue.IsEmpty (), true, "the queue is not empty after PopAll");
+}
+
+class ScheduleWithContextStressTestCase : public TestCase
+{
+public:
+  ScheduleWithContextStressTestCase (uint32_t producers, uint32_t events);
+  void Receive (uint32_t producer, uint32_t seq);
+  void Poll (void);
+
+private:
+  virtual void DoRun (void);
+  virtual void DoTeardown (void);
+  static void Produce (std::pair<ScheduleWithContextStressTestCase *, uint32_t> args);
+
+  uint32_t m_producers;
+  uint32_t m_events;
+  uint64_t m_received;
+  bool m_ordered;
+  std::vector<uint32_t> m_next;
+};
+
+ScheduleWithContextStressTestCase::ScheduleWithContextStressTestCase (uint32_t producers, uint32_t events)
+  : TestCase ("Check ScheduleWithContext from " + std::to_string (producers) + " threads"),
+    m_producers (producers),
+    m_events (events),
+    m_received (0),
+    m_ordered (true)
+{
+}
+
+void
+ScheduleWithContextStressTestCase::Receive (uint32_t producer, uint32_t seq)
+{
+  m_ordered = m_ordered && Simulator::GetContext () == producer && seq == m_next[producer];
+  m_next[producer] = seq + 1;
+  m_received++;
+}
+
+void
+ScheduleWithContextStressTestCase::Poll (void)
+{
+  // Keep the simulation alive until the producers are done
+  if (m_received < static_cast<uint64_t> (m_producers) * m_events)
+    {
+      Simulator::Schedule (MicroSeconds (1), &ScheduleWithContextStressTestCase::Poll, this);
+    }
+}
+
+void
+ScheduleWithContextStressTestCase::Produce (std::pair<ScheduleWithContextStressTestCase *, uint32_t> args)
+{
+  ScheduleWithContextStressTestCase *test = args.first;
+  for (uint32_t seq = 0; seq < test->m_events; seq++)
+    {
+      Simulator::ScheduleWithContext (args.second, Time (0), &ScheduleWithContextStressTestCase::Receive,
+                                      test, args.second, seq);
+    }
+}
+
+void
+ScheduleWithContextStressTestCase::DoRun (void)
+{
+  Config::SetGlobal ("SimulatorImplementationType", StringValue ("ns3::DefaultSimulatorImpl"));
+  m_next.assign (m_producers, 0);
+  Simulator::Schedule (Time (0), &ScheduleWithContextStressTestCase::Poll, this);
+
+  std::vector<Ptr<SystemThread> > threads;
+  for (uint32_t i = 0; i < m_producers; i++)
+    {
+      threads.push_back (Create<SystemThread> (MakeBoundCallback (&ScheduleWithContextStressTestCase::Produce,
+                                                                  std::make_pair (this, i))));
+    }
+  for (uint32_t i = 0; i < m_producers; i++)
+    {
+      threads[i]->Start ();
+    }
+  Simulator::Run ();
+  for (uint32_t i = 0; i < m_producers; i++)
+    {
+      threads[i]->Join ();
+    }
+  Simulator::Destroy ();
+
+  NS_TEST_EXPECT_MSG_EQ (m_received, static_cast<uint64_t> (m_producers) * m_events, "events were lost");
+  NS_TEST_EXPECT_MSG_EQ (m_ordered, true, "the events of a producer are out of order");
+}
+
+void
+ScheduleWithContextStressTestCase::DoTeardown (void)
+{
+  Simulator::Destroy ();
+}
+
+class MpscQueueTestSuite : public TestSuite
+{
+public:
+  MpscQueueTestSuite ()
+    : TestSuite ("mpsc-queue")
+  {
+    AddTestCase (new MpscQueueTestCase (1, 20000), TestCase::QUICK);
+    AddTestCase (new MpscQueueTestCase (4, 50000), TestCase::QUICK);
+    AddTestCase (new ScheduleWithContextStressTestCase (4, 50000), TestCase::QUICK);
+    AddTestCase (new MpscQueueTestCase (8, 1000000), TestCase::EXTENSIVE);
+    AddTestCase (new ScheduleWithContextStressTestCase (8, 500000), TestCase::EXTENSIVE);
+  }
+} g_mpscQueueTestSuite;
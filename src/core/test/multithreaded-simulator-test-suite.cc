@@ -0,0 +1,267 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+#include "ns3/test.h"
+#include "ns3/simulator.h"
+#include "ns3/multithreaded-simulator-impl.h"
+#include "ns3/config.h"
+#include "ns3/string.h"
+#include "ns3/uinteger.h"
+
+#include <algorithm>
+#include <vector>
+
+using namespace ns3;
+
+/**
+ * Tokens hop between the nodes of a toy model, and every node logs what
+ * it receives. The partitions must produce the same logs as the default
+ * simulator.
+ */
+class MultithreadedSimulatorTestCase : public TestCase
+{
+public:
+  MultithreadedSimulatorTestCase (uint32_t threads, Time lookahead);
+  void Token (uint32_t node, uint32_t hop, uint64_t value);
+  void Local (uint32_t node, uint64_t value);
+  void CheckContext (uint32_t node);
+  std::vector<std::vector<std::pair<int64_t, uint64_t> > > RunModel (std::string simulatorType);
+
+  /** Log entry of a node: the time and the value. */
+  typedef std::pair<int64_t, uint64_t> Entry;
+  std::vector<std::vector<Entry> > m_logs;
+  std::vector<uint8_t> m_badContext;
+
+private:
+  virtual void DoRun (void);
+  virtual void DoTeardown (void);
+
+  uint32_t m_threads;
+  Time m_lookahead;
+};
+
+static const uint32_t NODES = 23;
+static const uint32_t HOPS = 40;
+
+MultithreadedSimulatorTestCase::MultithreadedSimulatorTestCase (uint32_t threads, Time lookahead)
+  : TestCase ("Check that the events of the nodes run on " + std::to_string (threads) +
+              " threads as in the default simulator, with a lookahead of " +
+              std::to_string (lookahead.GetNanoSeconds ()) + "ns"),
+    m_threads (threads),
+    m_lookahead (lookahead)
+{
+}
+
+void
+MultithreadedSimulatorTestCase::CheckContext (uint32_t node)
+{
+  if (Simulator::GetContext () != node)
+    {
+      m_badContext[node] = 1;
+    }
+}
+
+void
+MultithreadedSimulatorTestCase::Local (uint32_t node, uint64_t value)
+{
+  CheckContext (node);
+  m_logs[node].push_back (Entry (Simulator::Now ().GetNanoSeconds (), value));
+}
+
+void
+MultithreadedSimulatorTestCase::Token (uint32_t node, uint32_t hop, uint64_t value)
+{
+  CheckContext (node);
+  m_logs[node].push_back (Entry (Simulator::Now ().GetNanoSeconds (), value));
+  if (hop == HOPS)
+    {
+      return;
+    }
+  Simulator::Schedule (NanoSeconds (value % 5 + 1), &MultithreadedSimulatorTestCase::Local, this, node, value + 1);
+  uint32_t next = (node * 5 + value) % NODES;
+  Time delay = std::max (m_lookahead, NanoSeconds (1)) + NanoSeconds (value % 97);
+  Simulator::ScheduleWithContext (next, delay, &MultithreadedSimulatorTestCase::Token, this,
+                                  next, hop + 1, value * 31 + node);
+}
+
+std::vector<std::vector<MultithreadedSimulatorTestCase::Entry> >
+MultithreadedSimulatorTestCase::RunModel (std::string simulatorType)
+{
+  Config::SetGlobal ("SimulatorImplementationType", StringValue (simulatorType));
+  Config::SetDefault ("ns3::MultithreadedSimulatorImpl::Threads", UintegerValue (m_threads));
+  Config::SetDefault ("ns3::MultithreadedSimulatorImpl::Lookahead", TimeValue (m_lookahead));
+  m_logs.assign (NODES, std::vector<Entry> ());
+  m_badContext.assign (NODES, 0);
+  for (uint32_t node = 0; node < NODES; node++)
+    {
+      Simulator::ScheduleWithContext (node, NanoSeconds (node % 3), &MultithreadedSimulatorTestCase::Token, this,
+                                      node, 0, node);
+    }
+  Simulator::Run ();
+  int64_t end = Simulator::Now ().GetNanoSeconds ();
+  Simulator::Destroy ();
+
+  for (uint32_t node = 0; node < NODES; node++)
+    {
+      NS_TEST_EXPECT_MSG_EQ (m_badContext[node], 0, "events of node " << node << " run in another context");
+      // The events of the same time may run in another order
+      std::sort (m_logs[node].begin (), m_logs[node].end ());
+      if (!m_logs[node].empty ())
+        {
+          NS_TEST_EXPECT_MSG_GT_OR_EQ (end, m_logs[node].back ().first, "the clock is not at the last event");
+        }
+    }
+  return m_logs;
+}
+
+void
+MultithreadedSimulatorTestCase::DoRun (void)
+{
+  std::vector<std::vector<Entry> > expected = RunModel ("ns3::DefaultSimulatorImpl");
+  std::vector<std::vector<Entry> > logs = RunModel ("ns3::MultithreadedSimulatorImpl");
+  for (uint32_t node = 0; node < NODES; node++)
+    {
+      NS_TEST_ASSERT_MSG_EQ (logs[node].size (), expected[node].size (), "wrong number of events of node " << node);
+      NS_TEST_EXPECT_MSG_EQ ((logs[node] == expected[node]), true, "wrong events of node " << node);
+    }
+}
+
+void
+MultithreadedSimulatorTestCase::DoTeardown (void)
+{
+  Config::SetGlobal ("SimulatorImplementationType", StringValue ("ns3::DefaultSimulatorImpl"));
+  Config::SetDefault ("ns3::MultithreadedSimulatorImpl::Threads", UintegerValue (0));
+  Config::SetDefault ("ns3::MultithreadedSimulatorImpl::Lookahead", TimeValue (Time (0)));
+}
+
+/**
+ * A stop must end the run at the same time in every partition, whatever
+ * the timing of the threads, and the next run must resume there.
+ */
+class MultithreadedSimulatorStopTestCase : public TestCase
+{
+public:
+  MultithreadedSimulatorStopTestCase ();
+  void Log (uint32_t node);
+  void StopNow (void);
+
+  /** Times of the events run by each node. */
+  std::vector<std::vector<int64_t> > m_logs;
+
+private:
+  virtual void DoRun (void);
+  virtual void DoTeardown (void);
+  /**
+   * \param [in] ts A time, in ns.
+   * \returns true if every node ran exactly its events before that time.
+   */
+  bool RanUntil (int64_t ts) const;
+};
+
+static const uint32_t STOP_NODES = 4;
+
+MultithreadedSimulatorStopTestCase::MultithreadedSimulatorStopTestCase ()
+  : TestCase ("Check that Simulator::Stop ends the run at the same time in every thread")
+{
+}
+
+void
+MultithreadedSimulatorStopTestCase::Log (uint32_t node)
+{
+  m_logs[node].push_back (Simulator::Now ().GetNanoSeconds ());
+}
+
+void
+MultithreadedSimulatorStopTestCase::StopNow (void)
+{
+  Simulator::Stop ();
+}
+
+bool
+MultithreadedSimulatorStopTestCase::RanUntil (int64_t ts) const
+{
+  uint32_t expected = std::min<int64_t> ((ts - 1) / 100, 10);
+  for (uint32_t node = 0; node < STOP_NODES; node++)
+    {
+      if (m_logs[node].size () != expected || m_logs[node].back () >= ts)
+        {
+          return false;
+        }
+    }
+  return true;
+}
+
+void
+MultithreadedSimulatorStopTestCase::DoRun (void)
+{
+  Config::SetGlobal ("SimulatorImplementationType", StringValue ("ns3::MultithreadedSimulatorImpl"));
+  Config::SetDefault ("ns3::MultithreadedSimulatorImpl::Threads", UintegerValue (STOP_NODES));
+  Config::SetDefault ("ns3::MultithreadedSimulatorImpl::Lookahead", TimeValue (MicroSeconds (1)));
+
+  //Every node, on its own thread, runs an event every 100ns until 1us, then one at 5us
+  m_logs.assign (STOP_NODES, std::vector<int64_t> ());
+  for (uint32_t node = 0; node < STOP_NODES; node++)
+    {
+      for (uint32_t i = 1; i <= 10; i++)
+        {
+          Simulator::ScheduleWithContext (node, NanoSeconds (100 * i), &MultithreadedSimulatorStopTestCase::Log, this, node);
+        }
+      Simulator::ScheduleWithContext (node, MicroSeconds (5), &MultithreadedSimulatorStopTestCase::Log, this, node);
+    }
+  Simulator::ScheduleWithContext (0, NanoSeconds (500), &MultithreadedSimulatorStopTestCase::StopNow, this);
+
+  //The first window is cut at the time of the stop
+  Simulator::Stop (NanoSeconds (450));
+  Simulator::Run ();
+  bool first = RanUntil (450);
+  int64_t firstEnd = Simulator::Now ().GetNanoSeconds ();
+  bool finished = Simulator::IsFinished ();
+  //Stop () ends the run with the window of the event calling it
+  Simulator::Run ();
+  bool second = RanUntil (1500);
+  int64_t secondEnd = Simulator::Now ().GetNanoSeconds ();
+  Simulator::Run ();
+  bool third = m_logs[0].size () == 11 && m_logs[STOP_NODES - 1].size () == 11;
+  Simulator::Destroy ();
+
+  NS_TEST_EXPECT_MSG_EQ (first, true, "the nodes did not all run until the stop time");
+  NS_TEST_EXPECT_MSG_EQ (firstEnd, 450, "the clock is not at the stop time");
+  NS_TEST_EXPECT_MSG_EQ (finished, true, "the stopped run is not finished");
+  NS_TEST_EXPECT_MSG_EQ (second, true, "the nodes did not all run until the end of the window");
+  NS_TEST_EXPECT_MSG_EQ (secondEnd, 1500, "the clock is not at the end of the window");
+  NS_TEST_EXPECT_MSG_EQ (third, true, "the last run did not resume");
+}
+
+void
+MultithreadedSimulatorStopTestCase::DoTeardown (void)
+{
+  Config::SetGlobal ("SimulatorImplementationType", StringValue ("ns3::DefaultSimulatorImpl"));
+  Config::SetDefault ("ns3::MultithreadedSimulatorImpl::Threads", UintegerValue (0));
+  Config::SetDefault ("ns3::MultithreadedSimulatorImpl::Lookahead", TimeValue (Time (0)));
+}
+
+class MultithreadedSimulatorTestSuite : public TestSuite
+{
+public:
+  MultithreadedSimulatorTestSuite ()
+    : TestSuite ("multithreaded-simulator")
+  {
+    AddTestCase (new MultithreadedSimulatorTestCase (1, NanoSeconds (100)), TestCase::QUICK);
+    AddTestCase (new MultithreadedSimulatorTestCase (4, NanoSeconds (100)), TestCase::QUICK);
+    AddTestCase (new MultithreadedSimulatorTestCase (4, Time (0)), TestCase::QUICK);
+    AddTestCase (new MultithreadedSimulatorTestCase (7, MicroSeconds (1)), TestCase::QUICK);
+    AddTestCase (new MultithreadedSimulatorStopTestCase (), TestCase::QUICK);
+  }
+} g_multithreadedSimulatorTestSuite;
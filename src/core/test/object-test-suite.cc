@@ -113,6 +113,24 @@ public:
   }
 };
 
+/**
+ * A DerivedB which counts the checks of its TypeId, as done by
+ * Object::DoGetObject for each aggregate it walks.
+ */
+class CountingB : public DerivedB
+{
+public:
+  CountingB ()
+    : m_checks (0)
+  {}
+  virtual ns3::TypeId GetInstanceTypeId (void) const {
+    m_checks++;
+    return DerivedB::GetInstanceTypeId ();
+  }
+  /** The number of calls to GetInstanceTypeId. */
+  mutable uint32_t m_checks;
+};
+
 NS_OBJECT_ENSURE_REGISTERED (BaseA);
 NS_OBJECT_ENSURE_REGISTERED (DerivedA);
 NS_OBJECT_ENSURE_REGISTERED (BaseB);
@@ -359,6 +377,85 @@ AggregateObjectTestCase::DoRun (void)
   NS_TEST_ASSERT_MSG_NE (baseA, 0, "Unable to GetObject on released object");
 }
 
+// ===========================================================================
+// Test case to make sure that the GetObject cache of the aggregates follows
+// the changes of the aggregation
+// ===========================================================================
+class GetObjectCacheTestCase : public TestCase
+{
+public:
+  GetObjectCacheTestCase ();
+  virtual ~GetObjectCacheTestCase ();
+
+private:
+  virtual void DoRun (void);
+};
+
+GetObjectCacheTestCase::GetObjectCacheTestCase ()
+  : TestCase ("Check the GetObject cache of the aggregates")
+{
+}
+
+GetObjectCacheTestCase::~GetObjectCacheTestCase ()
+{
+}
+
+void
+GetObjectCacheTestCase::DoRun (void)
+{
+  Ptr<BaseA> baseA = CreateObject<BaseA> ();
+  Ptr<CountingB> derivedB = CreateObject<CountingB> ();
+
+  //
+  // The failed lookups are cached too, and must be forgotten when an
+  // object is aggregated.
+  //
+  NS_TEST_ASSERT_MSG_EQ (baseA->GetObject<BaseB> (), 0, "Unexpectedly found a BaseB through baseA");
+  NS_TEST_ASSERT_MSG_EQ (baseA->GetObject<BaseB> (), 0, "Unexpectedly found a cached BaseB through baseA");
+  baseA->AggregateObject (derivedB);
+  NS_TEST_ASSERT_MSG_EQ (baseA->GetObject<BaseB> (), derivedB, "Stale cached lookup of BaseB through baseA");
+  NS_TEST_ASSERT_MSG_EQ (baseA->GetObject<DerivedB> (), derivedB, "Cannot GetObject (through baseA) for DerivedB Object");
+
+  //
+  // The hits must return the same object as the first lookup, by type and
+  // by TypeId, through any object of the aggregation.
+  //
+  for (uint32_t i = 0; i < 3; i++)
+    {
+      NS_TEST_ASSERT_MSG_EQ (baseA->GetObject<BaseB> (), derivedB, "Wrong cached BaseB through baseA");
+      NS_TEST_ASSERT_MSG_EQ (derivedB->GetObject<BaseA> (), baseA, "Wrong cached BaseA through derivedB");
+      NS_TEST_ASSERT_MSG_EQ (derivedB->GetObject<BaseB> (BaseB::GetTypeId ()), derivedB, "Wrong cached BaseB by TypeId");
+      NS_TEST_ASSERT_MSG_EQ (derivedB->GetObject<DerivedA> (), 0, "Unexpectedly found a cached DerivedA through derivedB");
+    }
+
+  //
+  // A hit must return the cached pointer without walking the aggregates,
+  // which would check the TypeId of derivedB.
+  //
+  derivedB->m_checks = 0;
+  for (uint32_t i = 0; i < 3; i++)
+    {
+      NS_TEST_ASSERT_MSG_EQ (baseA->GetObject<BaseB> (), derivedB, "Wrong cached BaseB through baseA");
+      NS_TEST_ASSERT_MSG_EQ (derivedB->GetObject<BaseB> (BaseB::GetTypeId ()), derivedB, "Wrong cached BaseB by TypeId");
+    }
+  NS_TEST_ASSERT_MSG_EQ (derivedB->m_checks, 0, "A cached lookup of BaseB walked the aggregates");
+
+  //
+  // A new aggregation must replace the failed lookup of DerivedA.
+  //
+  Ptr<DerivedA> derivedA = CreateObject<DerivedA> ();
+  derivedB->AggregateObject (derivedA);
+  NS_TEST_ASSERT_MSG_EQ (baseA->GetObject<DerivedA> (), derivedA, "Stale cached lookup of DerivedA through baseA");
+  NS_TEST_ASSERT_MSG_EQ (derivedA->GetObject<DerivedB> (), derivedB, "Cannot GetObject (through derivedA) for DerivedB Object");
+
+  //
+  // The new aggregation emptied the cache, so the next lookup walks.
+  //
+  derivedB->m_checks = 0;
+  NS_TEST_ASSERT_MSG_EQ (baseA->GetObject<BaseB> (), derivedB, "Cannot GetObject (through baseA) for BaseB Object");
+  NS_TEST_ASSERT_MSG_NE (derivedB->m_checks, 0, "A lookup after a new aggregation did not walk the aggregates");
+}
+
 // ===========================================================================
 // Test case to make sure that an Object factory can create Objects
 // ===========================================================================
@@ -445,6 +542,7 @@ ObjectTestSuite::ObjectTestSuite ()
 {
   AddTestCase (new CreateObjectTestCase, TestCase::QUICK);
   AddTestCase (new AggregateObjectTestCase, TestCase::QUICK);
+  AddTestCase (new GetObjectCacheTestCase, TestCase::QUICK);
   AddTestCase (new ObjectFactoryTestCase, TestCase::QUICK);
 }
 
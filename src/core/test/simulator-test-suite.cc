@@ -23,6 +23,11 @@
 #include "ns3/heap-scheduler.h"
 #include "ns3/map-scheduler.h"
 #include "ns3/calendar-scheduler.h"
+#include "ns3/ladder-scheduler.h"
+#include "ns3/random-variable-stream.h"
+#include "ns3/system-thread.h"
+#include <cstring>
+#include <vector>
 
 using namespace ns3;
 
@@ -459,6 +464,184 @@ SimulatorTemplateTestCase::DoRun (void)
   Simulator::Destroy ();
 }
 
+class SchedulerCompareTestCase : public TestCase
+{
+public:
+  SchedulerCompareTestCase (ObjectFactory schedulerFactory);
+  virtual void DoRun (void);
+private:
+  ObjectFactory m_schedulerFactory;
+};
+
+SchedulerCompareTestCase::SchedulerCompareTestCase (ObjectFactory schedulerFactory)
+  : TestCase ("Check that " + schedulerFactory.GetTypeId ().GetName () + " orders events as the MapScheduler does"),
+    m_schedulerFactory (schedulerFactory)
+{
+}
+
+void
+SchedulerCompareTestCase::DoRun (void)
+{
+  Ptr<Scheduler> tested = m_schedulerFactory.Create<Scheduler> ();
+  Ptr<Scheduler> reference = CreateObject<MapScheduler> ();
+  Ptr<UniformRandomVariable> rand = CreateObject<UniformRandomVariable> ();
+  rand->SetStream (1);
+  std::vector<Scheduler::Event> pending;
+  uint64_t now = 0;
+  uint32_t uid = 0;
+
+  //Mostly bursts of identical timestamps, as beacon periodic simulations
+  //schedule them, with some spread events and some cancellations
+  for (uint32_t step = 0; step < 200000; step++)
+    {
+      double op = rand->GetValue ();
+      if (op < 0.6 || reference->IsEmpty ())
+        {
+          Scheduler::Event ev;
+          ev.impl = 0;
+          double kind = rand->GetValue ();
+          if (kind < 0.3)
+            {
+              ev.key.m_ts = now;
+            }
+          else if (kind < 0.6)
+            {
+              ev.key.m_ts = (now / 102400000 + 1) * 102400000;
+            }
+          else if (kind < 0.8)
+            {
+              ev.key.m_ts = now + 160000;
+            }
+          else
+            {
+              ev.key.m_ts = now + rand->GetInteger (0, 200000000);
+            }
+          ev.key.m_uid = uid++;
+          ev.key.m_context = 0;
+          tested->Insert (ev);
+          reference->Insert (ev);
+          pending.push_back (ev);
+        }
+      else if (op < 0.95)
+        {
+          NS_TEST_ASSERT_MSG_EQ (tested->PeekNext ().key.m_uid, reference->PeekNext ().key.m_uid,
+                                 "next event differs at step " << step);
+          Scheduler::Event ev = tested->RemoveNext ();
+          NS_TEST_ASSERT_MSG_EQ (ev.key.m_uid, reference->RemoveNext ().key.m_uid,
+                                 "removed event differs at step " << step);
+          now = ev.key.m_ts;
+          for (std::vector<Scheduler::Event>::iterator i = pending.begin (); i != pending.end (); ++i)
+            {
+              if (i->key.m_uid == ev.key.m_uid)
+                {
+                  *i = pending.back ();
+                  pending.pop_back ();
+                  break;
+                }
+            }
+        }
+      else
+        {
+          uint32_t i = rand->GetInteger (0, pending.size () - 1);
+          tested->Remove (pending[i]);
+          reference->Remove (pending[i]);
+          pending[i] = pending.back ();
+          pending.pop_back ();
+        }
+    }
+  while (!reference->IsEmpty ())
+    {
+      NS_TEST_ASSERT_MSG_EQ (tested->IsEmpty (), false, "events were lost");
+      NS_TEST_ASSERT_MSG_EQ (tested->RemoveNext ().key.m_uid, reference->RemoveNext ().key.m_uid,
+                             "removed event differs while draining");
+    }
+  NS_TEST_ASSERT_MSG_EQ (tested->IsEmpty (), true, "events were added");
+}
+
+/**
+ * An event whose size is sizeof (EventImpl) + N, rounded up to its alignment.
+ */
+template <std::size_t N>
+class PaddedEvent : public EventImpl
+{
+public:
+  PaddedEvent ()
+  {
+    std::memset (m_data, 0xff, N);
+  }
+private:
+  virtual void Notify (void)
+  {
+  }
+  char m_data[N];
+};
+
+/** An event released by a thread whose free lists are gone. */
+EventImpl *g_lateEvent = 0;
+
+/**
+ * Allocates g_lateEvent when its thread exits, after the thread's free
+ * lists have been released.
+ */
+struct LateEventMaker
+{
+  /** Make sure the destructor is registered before the free lists'. */
+  void Touch (void)
+  {
+  }
+  ~LateEventMaker ()
+  {
+    g_lateEvent = new PaddedEvent<8> ();
+  }
+};
+
+thread_local LateEventMaker g_lateEventMaker;
+
+class EventPoolTestCase : public TestCase
+{
+public:
+  EventPoolTestCase ();
+  virtual void DoRun (void);
+private:
+  static void ExitingThread (void);
+};
+
+EventPoolTestCase::EventPoolTestCase ()
+  : TestCase ("Check that blocks allocated after a thread released its free lists can be recycled")
+{
+}
+
+void
+EventPoolTestCase::ExitingThread (void)
+{
+  g_lateEventMaker.Touch ();
+  (new PaddedEvent<8> ())->Unref ();
+}
+
+void
+EventPoolTestCase::DoRun (void)
+{
+  //The large event fills its 16 byte size class, the small one does not
+  typedef PaddedEvent<8> SmallEvent;
+  typedef PaddedEvent<8 + (sizeof (SmallEvent) + 15) / 16 * 16 - sizeof (SmallEvent)> LargeEvent;
+  NS_TEST_ASSERT_MSG_EQ ((sizeof (SmallEvent) - 1) / 16, (sizeof (LargeEvent) - 1) / 16,
+                         "the events should be in the same size class");
+  NS_TEST_ASSERT_MSG_LT (sizeof (SmallEvent), sizeof (LargeEvent), "the small event should be smaller");
+
+  Ptr<SystemThread> thread = Create<SystemThread> (MakeCallback (&EventPoolTestCase::ExitingThread));
+  thread->Start ();
+  thread->Join ();
+  NS_TEST_ASSERT_MSG_NE (g_lateEvent, 0, "no event allocated at thread exit");
+
+  //The block joins the free list of this thread, and must be large enough
+  //for any event of its size class
+  void *block = g_lateEvent;
+  g_lateEvent->Unref ();
+  EventImpl *large = new LargeEvent ();
+  NS_TEST_EXPECT_MSG_EQ (static_cast<void *> (large), block, "the block was not recycled");
+  large->Unref ();
+}
+
 class SimulatorTestSuite : public TestSuite
 {
 public:
@@ -475,5 +658,9 @@ public:
     AddTestCase (new SimulatorEventsTestCase (factory), TestCase::QUICK);
     factory.SetTypeId (CalendarScheduler::GetTypeId ());
     AddTestCase (new SimulatorEventsTestCase (factory), TestCase::QUICK);
+    factory.SetTypeId (LadderScheduler::GetTypeId ());
+    AddTestCase (new SimulatorEventsTestCase (factory), TestCase::QUICK);
+    AddTestCase (new SchedulerCompareTestCase (factory), TestCase::QUICK);
+    AddTestCase (new EventPoolTestCase (), TestCase::QUICK);
   }
 } g_simulatorTestSuite;
@@ -0,0 +1,99 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+#include "ns3/sweep-runner.h"
+#include "ns3/simulator.h"
+#include "ns3/test.h"
+
+#include <fstream>
+#include <unistd.h>
+
+using namespace ns3;
+
+class SweepRunnerTestCase : public TestCase
+{
+public:
+  SweepRunnerTestCase ();
+  virtual void DoRun (void);
+  void Replication (uint32_t index, std::ostream &os);
+  void Record (uint32_t index);
+  uint32_t m_recorded;
+};
+
+SweepRunnerTestCase::SweepRunnerTestCase ()
+  : TestCase ("Check that the replications run in workers and their results are collected in order")
+{
+}
+
+void
+SweepRunnerTestCase::Record (uint32_t index)
+{
+  m_recorded = index;
+}
+
+void
+SweepRunnerTestCase::Replication (uint32_t index, std::ostream &os)
+{
+  if (index == 2)
+    {
+      _exit (3);
+    }
+  m_recorded = 0;
+  Simulator::Schedule (MicroSeconds (10 * (8 - index)), &SweepRunnerTestCase::Record, this, index);
+  Simulator::Run ();
+  os << index << " " << m_recorded << " " << Simulator::Now ().GetMicroSeconds () << std::endl;
+  Simulator::Destroy ();
+}
+
+void
+SweepRunnerTestCase::DoRun (void)
+{
+  m_recorded = 100;
+  std::string output = CreateTempDirFilename ("sweep.txt");
+  SweepRunner runner;
+  runner.SetWorkers (3);
+  uint32_t failed = runner.Run (8, MakeCallback (&SweepRunnerTestCase::Replication, this), output);
+  NS_TEST_ASSERT_MSG_EQ (failed, 1, "one replication exits with an error");
+  NS_TEST_ASSERT_MSG_EQ (m_recorded, 100, "the replications run in other processes");
+
+  std::ifstream in (output.c_str ());
+  for (uint32_t index = 0; index < 8; index++)
+    {
+      if (index == 2)
+        {
+          continue;
+        }
+      uint32_t i, recorded;
+      int64_t now;
+      in >> i >> recorded >> now;
+      NS_TEST_ASSERT_MSG_EQ (in.good (), true, "missing result of replication " << index);
+      NS_TEST_ASSERT_MSG_EQ (i, index, "results out of order");
+      NS_TEST_ASSERT_MSG_EQ (recorded, index, "wrong result of replication " << index);
+      NS_TEST_ASSERT_MSG_EQ (now, 10 * (8 - index), "wrong end of replication " << index);
+    }
+  uint32_t extra;
+  in >> extra;
+  NS_TEST_ASSERT_MSG_EQ (in.fail (), true, "unexpected results");
+}
+
+static class SweepRunnerTestSuite : public TestSuite
+{
+public:
+  SweepRunnerTestSuite ()
+    : TestSuite ("sweep-runner", UNIT)
+  {
+    AddTestCase (new SweepRunnerTestCase (), TestCase::QUICK);
+  }
+} g_sweepRunnerTestSuite;
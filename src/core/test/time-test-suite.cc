@@ -102,6 +102,55 @@ TimeSimpleTestCase::DoTeardown (void)
 {
 }
 
+/**
+ * The conversions at the default resolution take an integer fast path:
+ * check them against the int64x64_t conversions, around the rounding
+ * boundaries and for negative times.
+ */
+class TimeFastPathTestCase : public TestCase
+{
+public:
+  TimeFastPathTestCase ();
+private:
+  virtual void DoRun (void);
+};
+
+TimeFastPathTestCase::TimeFastPathTestCase ()
+  : TestCase ("Check the integer conversions at the default resolution")
+{
+}
+
+void
+TimeFastPathTestCase::DoRun (void)
+{
+  const int64_t values[] = { 0, 1, 999, 1000, 1001, 999999, 1000000, 1000001,
+                             999999999, 1000000000, 1000000001, 123456789012345LL,
+                             -1, -999, -1000, -1001, -1000000001, -123456789012345LL };
+  for (uint32_t i = 0; i < sizeof (values) / sizeof (values[0]); i++)
+    {
+      Time t = NanoSeconds (values[i]);
+      NS_TEST_ASSERT_MSG_EQ (t.GetNanoSeconds (), values[i], "ns of " << values[i]);
+      NS_TEST_ASSERT_MSG_EQ (t.GetMicroSeconds (), values[i] / 1000, "us of " << values[i]);
+      NS_TEST_ASSERT_MSG_EQ (t.GetMilliSeconds (), values[i] / 1000000, "ms of " << values[i]);
+      NS_TEST_ASSERT_MSG_EQ (t.ToInteger (Time::S), values[i] / 1000000000, "s of " << values[i]);
+      NS_TEST_ASSERT_MSG_EQ (t.GetPicoSeconds (), values[i] * 1000, "ps of " << values[i]);
+      // GetHigh () rounds toward minus infinity, ToInteger () toward zero
+      int64x64_t us = t.To (Time::US);
+      NS_TEST_ASSERT_MSG_EQ ((values[i] >= 0 ? us.GetHigh () : -(-us).GetHigh ()),
+                             t.GetMicroSeconds (), "To (US) of " << values[i]);
+
+      int64_t small = values[i] / 1000000;
+      NS_TEST_ASSERT_MSG_EQ (MicroSeconds (small), Time::From (int64x64_t (small), Time::US),
+                             "MicroSeconds (" << small << ")");
+      NS_TEST_ASSERT_MSG_EQ (MilliSeconds (small), Time::From (int64x64_t (small), Time::MS),
+                             "MilliSeconds (" << small << ")");
+      NS_TEST_ASSERT_MSG_EQ (Time::FromInteger (small, Time::S), Seconds (small),
+                             "FromInteger (" << small << ", S)");
+      NS_TEST_ASSERT_MSG_EQ (NanoSeconds (values[i]) * 3, NanoSeconds (values[i] * 3),
+                             "3 * " << values[i]);
+    }
+}
+
 class TimeWithSignTestCase : public TestCase
 {
 public:
@@ -238,6 +287,7 @@ public:
   {
     AddTestCase (new TimeWithSignTestCase (), TestCase::QUICK);
     AddTestCase (new TimeInputOutputTestCase (), TestCase::QUICK);
+    AddTestCase (new TimeFastPathTestCase (), TestCase::QUICK);
     // This should be last, since it changes the resolution
     AddTestCase (new TimeSimpleTestCase (), TestCase::QUICK);
   }
@@ -62,6 +62,7 @@ BasicTracedCallbackTestCase::DoRun (void)
   // these methods do is to set corresponding member variables m_one and m_two.
   //
   TracedCallback<uint8_t, double> trace;
+  NS_TEST_ASSERT_MSG_EQ (trace.IsConnected (), false, "New trace is connected");
 
   //
   // Connect both callbacks to their respective test methods.  If we hit the 
@@ -70,6 +71,7 @@ BasicTracedCallbackTestCase::DoRun (void)
   //
   trace.ConnectWithoutContext (MakeCallback (&BasicTracedCallbackTestCase::CbOne, this));
   trace.ConnectWithoutContext (MakeCallback (&BasicTracedCallbackTestCase::CbTwo, this));
+  NS_TEST_ASSERT_MSG_EQ (trace.IsConnected (), true, "Trace with callbacks is not connected");
   m_one = false;
   m_two = false;
   trace (1, 2);
@@ -90,6 +92,7 @@ BasicTracedCallbackTestCase::DoRun (void)
   // If we now disconnect callback two then neither callback should be called.
   //
   trace.DisconnectWithoutContext (MakeCallback (&BasicTracedCallbackTestCase::CbTwo, this));
+  NS_TEST_ASSERT_MSG_EQ (trace.IsConnected (), false, "Trace without callbacks is connected");
   m_one = false;
   m_two = false;
   trace (1, 2);
@@ -108,6 +111,53 @@ BasicTracedCallbackTestCase::DoRun (void)
   NS_TEST_ASSERT_MSG_EQ (m_two, true, "Callback CbTwo not called");
 }
 
+class DisabledTracesTestCase : public TestCase
+{
+public:
+  DisabledTracesTestCase ();
+  virtual ~DisabledTracesTestCase () {}
+
+private:
+  virtual void DoRun (void);
+
+  void Cb (uint8_t a, double b) {}
+};
+
+DisabledTracesTestCase::DisabledTracesTestCase ()
+  : TestCase ("Check the matching of the names of the trace sources compiled out")
+{
+}
+
+void
+DisabledTracesTestCase::DoRun (void)
+{
+  // The lists are matched at compile time
+  static_assert (internal::IsTraceNameListed ("PhyTxBegin", "PhyTxBegin"), "single name");
+  static_assert (!internal::IsTraceNameListed ("PhyTxBegin", ""), "empty list");
+
+  NS_TEST_ASSERT_MSG_EQ (internal::IsTraceNameListed ("PhyRxEnd", "PhyTxBegin,PhyRxEnd"), true,
+                         "Last name not found");
+  NS_TEST_ASSERT_MSG_EQ (internal::IsTraceNameListed ("PhyTxBegin", "PhyTxBegin,PhyRxEnd"), true,
+                         "First name not found");
+  NS_TEST_ASSERT_MSG_EQ (internal::IsTraceNameListed ("PhyTx", "PhyTxBegin,PhyRxEnd"), false,
+                         "Prefix of a name found");
+  NS_TEST_ASSERT_MSG_EQ (internal::IsTraceNameListed ("PhyTxBeginX", "PhyTxBegin"), false,
+                         "Name extending a listed name found");
+  NS_TEST_ASSERT_MSG_EQ (internal::IsTraceNameListed ("", "PhyTxBegin"), false,
+                         "Empty name found");
+
+  //
+  // A trace source not compiled out is only fired when connected.
+  //
+  TracedCallback<uint8_t, double> trace;
+  NS_TEST_ASSERT_MSG_EQ (NS_TRACE_IS_CONNECTED ("ns3::DisabledTracesTestCase", trace), false,
+                         "Unconnected trace needs to be fired");
+  trace.ConnectWithoutContext (MakeCallback (&DisabledTracesTestCase::Cb, this));
+  NS_TEST_ASSERT_MSG_EQ (NS_TRACE_IS_CONNECTED ("ns3::DisabledTracesTestCase", trace),
+                         NS_TRACE_ENABLED ("ns3::DisabledTracesTestCase"),
+                         "Connected trace is not fired");
+}
+
 class TracedCallbackTestSuite : public TestSuite
 {
 public:
@@ -118,6 +168,7 @@ TracedCallbackTestSuite::TracedCallbackTestSuite ()
   : TestSuite ("traced-callback", UNIT)
 {
   AddTestCase (new BasicTracedCallbackTestCase, TestCase::QUICK);
+  AddTestCase (new DisabledTracesTestCase, TestCase::QUICK);
 }
 
 static TracedCallbackTestSuite tracedCallbackTestSuite;
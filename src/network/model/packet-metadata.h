@@ -21,6 +21,7 @@
 #define PACKET_METADATA_H
 
 #include <stdint.h>
+#include <atomic>
 #include <vector>
 #include <limits>
 #include "ns3/callback.h"
@@ -656,7 +657,10 @@ public:
    */
   static void Deallocate (struct PacketMetadata::Data *data);
 
-  static DataFreeList m_freeList; //!< the metadata data storage
+  // The free list and its heuristics are per thread, so that the packets
+  // of the MultithreadedSimulatorImpl partitions need no locking.
+  static thread_local DataFreeList m_freeList; //!< the metadata data storage
+  static thread_local bool m_freeListDestroyed; //!< m_freeList was destroyed with its thread
   static bool m_enable; //!< Enable the packet metadata
   static bool m_enableChecking; //!< Enable the packet metadata checking
 
@@ -667,8 +671,8 @@ public:
    */
   static bool m_metadataSkipped;
 
-  static uint32_t m_maxSize; //!< maximum metadata size
-  static uint16_t m_chunkUid; //!< Chunk Uid
+  static thread_local uint32_t m_maxSize; //!< maximum metadata size
+  static std::atomic<uint16_t> m_chunkUid; //!< Chunk Uid
 
   struct Data *m_data; //!< Metadata storage
   /*
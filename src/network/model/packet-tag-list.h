@@ -229,6 +229,10 @@ public:
    * \returns True if \pname{tag} is found, false otherwise.
    */
   bool Peek (Tag &tag) const;
+  /**
+   * \returns A copy of this list which shares no tags with it.
+   */
+  PacketTagList CreateFullCopy (void) const;
   /**
    * Remove all tags from this list (up to the first merge).
    */
@@ -21,6 +21,13 @@
 #include "ns3/assert.h"
 #include "ns3/log.h"
 #include "ns3/simulator.h"
+#include "ns3/core-config.h"
+#ifdef HAVE_PTHREAD_H
+#include "ns3/multithreaded-simulator-impl.h"
+#include <map>
+#include <mutex>
+#endif
+#include <algorithm>
 #include <string>
 #include <cstdarg>
 
@@ -28,7 +35,57 @@ namespace ns3 {
 
 NS_LOG_COMPONENT_DEFINE ("Packet");
 
-uint32_t Packet::m_globalUid = 0;
+#ifdef HAVE_PTHREAD_H
+namespace {
+
+/**
+ * The uid counter of each partition of a MultithreadedSimulatorImpl run,
+ * the first one also counting the packets created outside of a run. The
+ * elements of a map do not move, so a thread keeps a pointer to the
+ * counter of its partition.
+ */
+std::map<int32_t, uint32_t> g_uids;
+/** Protects g_uids. */
+std::mutex g_uidsMutex;
+/** Partition of the counter of the calling thread. */
+thread_local int32_t g_uidPartition = -1;
+/** Counter of the calling thread. */
+thread_local uint32_t *g_uidCounter = 0;
+
+} // unnamed namespace
+
+uint64_t
+Packet::AllocateUid (void)
+{
+  // Counted per partition, so that the uids only depend on the number of
+  // threads, like the order of the events
+  int32_t partition = std::max (MultithreadedSimulatorImpl::GetPartitionIndex (), 0);
+  if (partition != g_uidPartition)
+    {
+      std::lock_guard<std::mutex> lock (g_uidsMutex);
+      g_uidCounter = &g_uids[partition];
+      g_uidPartition = partition;
+    }
+  // The partition is above the system id, so the first partition keeps
+  // the uids of a sequential run
+  return static_cast<uint64_t> (partition) << 48
+         | static_cast<uint64_t> (Simulator::GetSystemId ()) << 32
+         | (*g_uidCounter)++;
+}
+#else
+namespace {
+
+/** Global counter of packets Uid */
+uint32_t g_globalUid = 0;
+
+} // unnamed namespace
+
+uint64_t
+Packet::AllocateUid (void)
+{
+  return static_cast<uint64_t> (Simulator::GetSystemId ()) << 32 | g_globalUid++;
+}
+#endif
 
 TypeId 
 ByteTagIterator::Item::GetTypeId (void) const
@@ -127,6 +184,31 @@ Packet::Copy (void) const
   return Ptr<Packet> (new Packet (*this), false);
 }
 
+Ptr<Packet>
+Packet::DeepCopy (void) const
+{
+  NS_LOG_FUNCTION (this);
+  Buffer buffer;
+  buffer.AddAtStart (m_buffer.GetSize ());
+  buffer.Begin ().Write (m_buffer.Begin (), m_buffer.End ());
+
+  ByteTagList byteTagList;
+  byteTagList.Add (m_byteTagList);
+
+  std::vector<uint8_t> serialized (m_metadata.GetSerializedSize ());
+  m_metadata.Serialize (&serialized[0], serialized.size ());
+  PacketMetadata metadata (0, 0);
+  // the size includes the 4 bytes of the length, as written by Serialize
+  metadata.Deserialize (&serialized[0], serialized.size () + 4);
+
+  Ptr<Packet> copy = Ptr<Packet> (new Packet (buffer, byteTagList, m_packetTagList.CreateFullCopy (), metadata), false);
+  if (m_nixVector)
+    {
+      copy->m_nixVector = m_nixVector->Copy ();
+    }
+  return copy;
+}
+
 Packet::Packet ()
   : m_buffer (),
     m_byteTagList (),
@@ -137,10 +219,9 @@ Packet::Packet ()
      * zero.  The lower 32 bits are for the 
      * global UID
      */
-    m_metadata (static_cast<uint64_t> (Simulator::GetSystemId ()) << 32 | m_globalUid, 0),
+    m_metadata (AllocateUid (), 0),
     m_nixVector (0)
 {
-  m_globalUid++;
 }
 
 Packet::Packet (const Packet &o)
@@ -179,10 +260,9 @@ Packet::Packet (uint32_t size)
      * zero.  The lower 32 bits are for the 
      * global UID
      */
-    m_metadata (static_cast<uint64_t> (Simulator::GetSystemId ()) << 32 | m_globalUid, size),
+    m_metadata (AllocateUid (), size),
     m_nixVector (0)
 {
-  m_globalUid++;
 }
 Packet::Packet (uint8_t const *buffer, uint32_t size, bool magic)
   : m_buffer (0, false),
@@ -205,10 +285,9 @@ Packet::Packet (uint8_t const*buffer, uint32_t size)
      * zero.  The lower 32 bits are for the 
      * global UID
      */
-    m_metadata (static_cast<uint64_t> (Simulator::GetSystemId ()) << 32 | m_globalUid, size),
+    m_metadata (AllocateUid (), size),
     m_nixVector (0)
 {
-  m_globalUid++;
   m_buffer.AddAtStart (size);
   Buffer::Iterator i = m_buffer.Begin ();
   i.Write (buffer, size);
@@ -424,6 +424,19 @@ public:
    */
   Ptr<Packet> Copy (void) const;
 
+  /**
+   * \brief performs a full copy of the packet.
+   *
+   * \returns a copy of the packet which shares no data with the
+   * original, not even the packet tags, metadata and byte tags.
+   *
+   * A COW copy can only be used by the thread of the original packet.
+   * This copy can be handed over to another thread, as is done with the
+   * packets received by the nodes of another MultithreadedSimulatorImpl
+   * partition.
+   */
+  Ptr<Packet> DeepCopy (void) const;
+
   /**
    * \brief Returns the packet's Uid.
    *
@@ -721,7 +734,13 @@ private:
   /* Please see comments above about nix-vector */
   Ptr<NixVector> m_nixVector; //!< the packet's Nix vector
 
-  static uint32_t m_globalUid; //!< Global counter of packets Uid
+  /**
+   * \returns the uid of a new packet: the system id in the upper 32 bits,
+   * above which the partition of a MultithreadedSimulatorImpl run is
+   * added, and a counter of the packets of that partition in the lower 32
+   * bits.
+   */
+  static uint64_t AllocateUid (void);
 };
 
 /**
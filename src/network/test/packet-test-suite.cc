@@ -582,6 +582,27 @@ PacketTest::DoRun (void)
     tmp->AddPaddingAtEnd (50);
     CHECK (tmp, 1, E (25, 0, 50));
   }
+
+  /* Test DeepCopy. */
+  {
+    Ptr<Packet> tmp = Create<Packet> (100);
+    tmp->AddHeader (ATestHeader<10> ());
+    tmp->AddByteTag (ATestTag<25> ());
+    tmp->AddPacketTag (ATestTag<3> (7));
+    Ptr<Packet> deep = tmp->DeepCopy ();
+    CHECK (deep, 1, E (25, 0, 110));
+    NS_TEST_EXPECT_MSG_EQ (deep->GetUid (), tmp->GetUid (), "DeepCopy keeps the uid");
+    ATestTag<3> tag;
+    NS_TEST_EXPECT_MSG_EQ (deep->RemovePacketTag (tag), true, "DeepCopy keeps the packet tags");
+    NS_TEST_EXPECT_MSG_EQ (tag.GetData (), 7, "wrong packet tag value");
+    NS_TEST_EXPECT_MSG_EQ (tmp->PeekPacketTag (tag), true, "the packet tags of the original are not shared");
+    ATestHeader<10> header;
+    deep->RemoveHeader (header);
+    NS_TEST_EXPECT_MSG_EQ (header.m_error, false, "wrong header in the copy");
+    NS_TEST_EXPECT_MSG_EQ (deep->GetSize (), 100, "wrong size of the copy");
+    NS_TEST_EXPECT_MSG_EQ (tmp->GetSize (), 110, "the buffer of the original is not shared");
+    CHECK (tmp, 1, E (25, 0, 110));
+  }
 }
 //--------------------------------------
 class PacketTagListTest : public TestCase
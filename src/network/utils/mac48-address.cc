@@ -254,6 +254,20 @@ Mac48Address Mac48Address::GetMulticast (Ipv6Address addr)
   return etherAddr;
 }
 
+size_t Mac48AddressHash::operator() (Mac48Address const &x) const
+{
+  uint8_t ad[6];
+  x.CopyTo (ad);
+  uint64_t value = 0;
+  for (uint8_t i = 0; i < 6; i++)
+    {
+      value = (value << 8) | ad[i];
+    }
+  // Fibonacci hashing spreads the allocated addresses, which only differ in
+  // their last bytes, over the whole range
+  return static_cast<size_t> ((value * 0x9e3779b97f4a7c15ULL) >> 16);
+}
+
 std::ostream& operator<< (std::ostream& os, const Mac48Address & address)
 {
   uint8_t ad[6];
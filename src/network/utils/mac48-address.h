@@ -205,6 +205,22 @@ private:
 
 ATTRIBUTE_HELPER_HEADER (Mac48Address);
 
+/**
+ * \ingroup address
+ *
+ * \brief Class providing an hash for Mac48Address, for use with
+ *        hash-based containers.
+ */
+class Mac48AddressHash {
+public:
+  /**
+   * Returns the hash of the address
+   * \param x the address
+   * \return the hash
+   */
+  size_t operator() (Mac48Address const &x) const;
+};
+
 inline bool operator == (const Mac48Address &a, const Mac48Address &b)
 {
   return memcmp (a.m_address, b.m_address, 6) == 0;
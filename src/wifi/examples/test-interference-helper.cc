@@ -48,6 +48,13 @@
 // The output of the program displays InterfenceHelper and YansWifiPhy trace
 // logs associated to the chosen scenario.
 //
+// With --storm=N, the program instead benchmarks the InterferenceHelper
+// under the collision storms seen at the start of RAW slots: N IEEE 802.11ah
+// stations in range of each other all transmit within the first --jitter
+// microseconds of each of --slots slots, so that every PHY, including the
+// listening AP, tracks N overlapping signals. It prints the number of
+// receptions that succeeded and failed, and the wall-clock time of the run.
+//
 
 #include "ns3/core-module.h"
 #include "ns3/wifi-net-device.h"
@@ -66,6 +73,9 @@
 #include "ns3/nstime.h"
 #include "ns3/command-line.h"
 #include "ns3/wifi-tx-vector.h"
+#include "ns3/random-variable-stream.h"
+#include "ns3/system-wall-clock-ms.h"
+#include <vector>
 
 using namespace ns3;
 
@@ -183,6 +193,142 @@ InterferenceExperiment::Run (struct InterferenceExperiment::Input input)
   Simulator::Destroy ();
 }
 
+class CollisionStormExperiment
+{
+public:
+  struct Input
+  {
+    Input ();
+    uint32_t nStations;
+    uint32_t nSlots;
+    Time slotDuration;
+    Time jitter;
+    uint32_t packetSize;
+    double radius;
+  };
+  struct Output
+  {
+    uint64_t rxOk;
+    uint64_t rxError;
+    int64_t elapsedMs;
+  };
+
+  CollisionStormExperiment ();
+  struct CollisionStormExperiment::Output Run (struct CollisionStormExperiment::Input input);
+
+private:
+  void StartSlot (void);
+  void Send (Ptr<YansWifiPhy> phy) const;
+  void ReceiveOk (Ptr<Packet> p, double snr, WifiTxVector txVector, enum WifiPreamble preamble);
+  void ReceiveError (Ptr<const Packet> p, double snr);
+  std::vector<Ptr<YansWifiPhy> > m_phys;
+  Ptr<YansWifiPhy> m_ap;
+  Ptr<UniformRandomVariable> m_jitter;
+  struct Input m_input;
+  struct Output m_output;
+};
+
+CollisionStormExperiment::CollisionStormExperiment ()
+{
+}
+
+CollisionStormExperiment::Input::Input ()
+  : nStations (200),
+    nSlots (100),
+    slotDuration (MicroSeconds (500 + 200 * 120)),
+    jitter (MicroSeconds (500)),
+    packetSize (100),
+    radius (50)
+{
+}
+
+void
+CollisionStormExperiment::StartSlot (void)
+{
+  for (std::vector<Ptr<YansWifiPhy> >::const_iterator i = m_phys.begin (); i != m_phys.end (); i++)
+    {
+      Time delay = NanoSeconds (m_jitter->GetInteger (0, m_input.jitter.GetNanoSeconds ()));
+      Simulator::Schedule (delay, &CollisionStormExperiment::Send, this, *i);
+    }
+}
+
+void
+CollisionStormExperiment::Send (Ptr<YansWifiPhy> phy) const
+{
+  Ptr<Packet> p = Create<Packet> (m_input.packetSize);
+  WifiTxVector txVector;
+  txVector.SetTxPowerLevel (0);
+  txVector.SetMode (WifiPhy::GetOfdmRate300KbpsBW1MHz ());
+  phy->SendPacket (p, txVector, WIFI_PREAMBLE_S1G_1M, 0);
+}
+
+void
+CollisionStormExperiment::ReceiveOk (Ptr<Packet> p, double snr, WifiTxVector txVector, enum WifiPreamble preamble)
+{
+  m_output.rxOk++;
+}
+
+void
+CollisionStormExperiment::ReceiveError (Ptr<const Packet> p, double snr)
+{
+  m_output.rxError++;
+}
+
+struct CollisionStormExperiment::Output
+CollisionStormExperiment::Run (struct CollisionStormExperiment::Input input)
+{
+  m_input = input;
+  m_output.rxOk = 0;
+  m_output.rxError = 0;
+
+  Ptr<YansWifiChannel> channel = CreateObject<YansWifiChannel> ();
+  channel->SetPropagationDelayModel (CreateObject<ConstantSpeedPropagationDelayModel> ());
+  channel->SetPropagationLossModel (CreateObject<LogDistancePropagationLossModel> ());
+  Ptr<ErrorRateModel> error = CreateObject<YansErrorRateModel> ();
+  m_jitter = CreateObject<UniformRandomVariable> ();
+  m_jitter->SetStream (1);
+
+  //A listening AP in the center, the stations on a circle around it, all in range of each other
+  for (uint32_t i = 0; i <= m_input.nStations; i++)
+    {
+      Ptr<MobilityModel> position = CreateObject<ConstantPositionMobilityModel> ();
+      if (i > 0)
+        {
+          double angle = 2 * M_PI * i / m_input.nStations;
+          position->SetPosition (Vector (m_input.radius * std::cos (angle), m_input.radius * std::sin (angle), 0.0));
+        }
+      Ptr<YansWifiPhy> phy = CreateObject<YansWifiPhy> ();
+      phy->SetErrorRateModel (error);
+      phy->SetChannel (channel);
+      phy->SetMobility (position);
+      phy->ConfigureStandard (WIFI_PHY_STANDARD_80211ah);
+      phy->SetReceiveOkCallback (MakeCallback (&CollisionStormExperiment::ReceiveOk, this));
+      phy->SetReceiveErrorCallback (MakeCallback (&CollisionStormExperiment::ReceiveError, this));
+      if (i > 0)
+        {
+          m_phys.push_back (phy);
+        }
+      else
+        {
+          m_ap = phy;
+        }
+    }
+
+  for (uint32_t i = 0; i < m_input.nSlots; i++)
+    {
+      Simulator::Schedule (m_input.slotDuration * i, &CollisionStormExperiment::StartSlot, this);
+    }
+
+  SystemWallClockMs clock;
+  clock.Start ();
+  Simulator::Run ();
+  m_output.elapsedMs = clock.End ();
+  Simulator::Destroy ();
+  m_phys.clear ();
+  m_ap = 0;
+  return m_output;
+}
+
 
 int main (int argc, char *argv[])
 {
@@ -190,6 +336,9 @@ int main (int argc, char *argv[])
   std::string str_standard = "WIFI_PHY_STANDARD_80211a";
   std::string str_preamble = "WIFI_PREAMBLE_LONG";
   double delay = 0; //microseconds
+  CollisionStormExperiment::Input stormInput;
+  uint32_t storm = 0;
+  double jitter = stormInput.jitter.GetMicroSeconds ();
 
   CommandLine cmd;
   cmd.AddValue ("delay", "Delay in microseconds between frame transmission from sender A and frame transmission from sender B", delay);
@@ -203,8 +352,23 @@ int main (int argc, char *argv[])
   cmd.AddValue ("txModeB", "Wifi mode used for payload transmission of sender B", input.txModeB);
   cmd.AddValue ("standard", "IEEE 802.11 flavor", str_standard);
   cmd.AddValue ("preamble", "Type of preamble", str_preamble);
+  cmd.AddValue ("storm", "Number of stations of the collision storm benchmark (0 to disable it)", storm);
+  cmd.AddValue ("slots", "Number of RAW slots of the collision storm benchmark", stormInput.nSlots);
+  cmd.AddValue ("jitter", "Window in microseconds within which the stations transmit at the start of each slot", jitter);
   cmd.Parse (argc, argv);
 
+  if (storm > 0)
+    {
+      stormInput.nStations = storm;
+      stormInput.jitter = MicroSeconds (jitter);
+      CollisionStormExperiment storm;
+      struct CollisionStormExperiment::Output output = storm.Run (stormInput);
+      std::cout << "stations\tslots\trxOk\trxError\tms" << std::endl;
+      std::cout << stormInput.nStations << "\t" << stormInput.nSlots << "\t" << output.rxOk << "\t"
+                << output.rxError << "\t" << output.elapsedMs << std::endl;
+      return 0;
+    }
+
   LogComponentEnable ("YansWifiPhy", LOG_LEVEL_ALL);
   LogComponentEnable ("InterferenceHelper", LOG_LEVEL_ALL);
 
@@ -0,0 +1,222 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+/*
+ * Measures the cost of the fan-out of a transmission on a YansWifiChannel
+ * shared by one AP and many stations: the number of heap allocations and
+ * the wall-clock time needed to deliver beacon-sized frames from the AP to
+ * every station.
+ *
+ * ./waf --run "yans-wifi-channel-bench --nStations=1000,4000,8000"
+ */
+
+#include "ns3/yans-wifi-channel.h"
+#include "ns3/yans-wifi-phy.h"
+#include "ns3/propagation-loss-model.h"
+#include "ns3/propagation-delay-model.h"
+#include "ns3/yans-error-rate-model.h"
+#include "ns3/constant-position-mobility-model.h"
+#include "ns3/packet.h"
+#include "ns3/simulator.h"
+#include "ns3/boolean.h"
+#include "ns3/command-line.h"
+#include "ns3/system-wall-clock-ms.h"
+#include "ns3/wifi-tx-vector.h"
+#include <cstdlib>
+#include <iostream>
+#include <new>
+#include <sstream>
+#include <vector>
+
+using namespace ns3;
+
+static uint64_t g_allocations = 0;
+
+void *
+operator new (std::size_t size)
+{
+  g_allocations++;
+  void *p = std::malloc (size == 0 ? 1 : size);
+  if (p == 0)
+    {
+      throw std::bad_alloc ();
+    }
+  return p;
+}
+
+void
+operator delete (void *p) noexcept
+{
+  std::free (p);
+}
+
+void *
+operator new[] (std::size_t size)
+{
+  return operator new (size);
+}
+
+void
+operator delete[] (void *p) noexcept
+{
+  operator delete (p);
+}
+
+class FanoutExperiment
+{
+public:
+  struct Input
+  {
+    Input ();
+    uint32_t nStations;
+    uint32_t nPackets;
+    uint32_t packetSize;
+    double radius;
+    bool cull;
+    bool cache;
+  };
+  struct Output
+  {
+    uint64_t allocations;
+    uint64_t received;
+    int64_t elapsedMs;
+  };
+  FanoutExperiment ();
+
+  struct FanoutExperiment::Output Run (struct FanoutExperiment::Input input);
+
+private:
+  void Send (void);
+  void Receive (Ptr<Packet> p, double snr, WifiTxVector txVector, enum WifiPreamble preamble);
+  Ptr<WifiPhy> m_tx;
+  struct Input m_input;
+  struct Output m_output;
+};
+
+FanoutExperiment::FanoutExperiment ()
+{
+}
+
+FanoutExperiment::Input::Input ()
+  : nStations (1000),
+    nPackets (20),
+    packetSize (100),
+    radius (100.0),
+    cull (false),
+    cache (false)
+{
+}
+
+void
+FanoutExperiment::Send (void)
+{
+  Ptr<Packet> p = Create<Packet> (m_input.packetSize);
+  WifiTxVector txVector;
+  txVector.SetTxPowerLevel (0);
+  txVector.SetMode (WifiPhy::GetOfdmRate300KbpsBW1MHz ());
+  m_tx->SendPacket (p, txVector, WIFI_PREAMBLE_S1G_1M, 0);
+}
+
+void
+FanoutExperiment::Receive (Ptr<Packet> p, double snr, WifiTxVector txVector, enum WifiPreamble preamble)
+{
+  m_output.received++;
+}
+
+struct FanoutExperiment::Output
+FanoutExperiment::Run (struct FanoutExperiment::Input input)
+{
+  m_input = input;
+  m_output.received = 0;
+
+  Ptr<YansWifiChannel> channel = CreateObject<YansWifiChannel> ();
+  channel->SetAttribute ("ReceiverCulling", BooleanValue (m_input.cull));
+  channel->SetAttribute ("CachePropagation", BooleanValue (m_input.cache));
+  channel->SetPropagationDelayModel (CreateObject<ConstantSpeedPropagationDelayModel> ());
+  channel->SetPropagationLossModel (CreateObject<LogDistancePropagationLossModel> ());
+  Ptr<ErrorRateModel> error = CreateObject<YansErrorRateModel> ();
+
+  //The AP in the center, the stations on a square grid around it
+  uint32_t side = 1;
+  while (side * side < m_input.nStations)
+    {
+      side++;
+    }
+  std::vector<Ptr<YansWifiPhy> > phys;
+  for (uint32_t i = 0; i <= m_input.nStations; i++)
+    {
+      Ptr<ConstantPositionMobilityModel> position = CreateObject<ConstantPositionMobilityModel> ();
+      if (i > 0)
+        {
+          double step = 2 * m_input.radius / side;
+          position->SetPosition (Vector (((i - 1) % side) * step - m_input.radius,
+                                         ((i - 1) / side) * step - m_input.radius, 0.0));
+        }
+      Ptr<YansWifiPhy> phy = CreateObject<YansWifiPhy> ();
+      phy->SetErrorRateModel (error);
+      phy->SetChannel (channel);
+      phy->SetMobility (position);
+      phy->ConfigureStandard (WIFI_PHY_STANDARD_80211ah);
+      phy->SetReceiveOkCallback (MakeCallback (&FanoutExperiment::Receive, this));
+      phys.push_back (phy);
+    }
+  m_tx = phys[0];
+
+  for (uint32_t i = 0; i < m_input.nPackets; ++i)
+    {
+      Simulator::Schedule (Seconds (i + 1), &FanoutExperiment::Send, this);
+    }
+
+  SystemWallClockMs clock;
+  uint64_t allocations = g_allocations;
+  clock.Start ();
+  Simulator::Run ();
+  m_output.elapsedMs = clock.End ();
+  m_output.allocations = g_allocations - allocations;
+  Simulator::Destroy ();
+  return m_output;
+}
+
+int
+main (int argc, char *argv[])
+{
+  struct FanoutExperiment::Input input;
+  std::string nStations = "1000,4000,8000";
+
+  CommandLine cmd;
+  cmd.AddValue ("nStations", "Comma-separated list of numbers of stations", nStations);
+  cmd.AddValue ("nPackets", "Number of frames sent by the AP", input.nPackets);
+  cmd.AddValue ("PacketSize", "Size of the frames sent by the AP", input.packetSize);
+  cmd.AddValue ("Radius", "Half the side of the square holding the stations (m)", input.radius);
+  cmd.AddValue ("Cull", "Enable receiver culling on the channel", input.cull);
+  cmd.AddValue ("Cache", "Enable the propagation cache on the channel", input.cache);
+  cmd.Parse (argc, argv);
+
+  std::cout << "stations\tframes\tallocations\tallocs/frame/sta\treceived\tms" << std::endl;
+  std::istringstream is (nStations);
+  std::string token;
+  while (std::getline (is, token, ','))
+    {
+      input.nStations = std::atoi (token.c_str ());
+      FanoutExperiment experiment;
+      struct FanoutExperiment::Output output = experiment.Run (input);
+      std::cout << input.nStations << "\t" << input.nPackets << "\t"
+                << output.allocations << "\t"
+                << (double)output.allocations / input.nPackets / input.nStations << "\t"
+                << output.received << "\t" << output.elapsedMs << std::endl;
+    }
+  return 0;
+}
@@ -0,0 +1,223 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+/*
+ * Measures the wall-clock time of a run of ad hoc nodes sharing a
+ * YansWifiChannel on the MultithreadedSimulatorImpl, with the lookahead
+ * returned by YansWifiChannel::GetLookahead with and without the shortest
+ * PLCP preamble and header (the LookaheadPreamble attribute). Every node
+ * broadcasts frames periodically, so the run is made of many short
+ * windows when the lookahead is only the propagation delay.
+ *
+ * ./waf --run "yans-wifi-channel-parallel-bench --nNodes=100 --Threads=4"
+ */
+
+#include "ns3/yans-wifi-channel.h"
+#include "ns3/yans-wifi-phy.h"
+#include "ns3/wifi-net-device.h"
+#include "ns3/wifi-mac.h"
+#include "ns3/wifi-remote-station-manager.h"
+#include "ns3/propagation-loss-model.h"
+#include "ns3/propagation-delay-model.h"
+#include "ns3/yans-error-rate-model.h"
+#include "ns3/constant-position-mobility-model.h"
+#include "ns3/node.h"
+#include "ns3/packet.h"
+#include "ns3/simulator.h"
+#include "ns3/simulator-impl.h"
+#include "ns3/config.h"
+#include "ns3/boolean.h"
+#include "ns3/string.h"
+#include "ns3/uinteger.h"
+#include "ns3/nstime.h"
+#include "ns3/object-factory.h"
+#include "ns3/command-line.h"
+#include "ns3/system-wall-clock-ms.h"
+#include <cmath>
+#include <iostream>
+#include <vector>
+
+using namespace ns3;
+
+class ParallelExperiment
+{
+public:
+  struct Input
+  {
+    Input ();
+    uint32_t nNodes;
+    uint32_t threads;
+    uint32_t packetSize;
+    double side;
+    Time interval;
+    Time duration;
+    bool preamble;
+  };
+  struct Output
+  {
+    Time lookahead;
+    uint64_t received;
+    int64_t elapsedMs;
+  };
+  ParallelExperiment ();
+
+  struct ParallelExperiment::Output Run (struct ParallelExperiment::Input input);
+
+private:
+  void CreateOne (Vector pos, Ptr<YansWifiChannel> channel, uint32_t index);
+  void Send (Ptr<WifiNetDevice> dev);
+  bool Receive (Ptr<NetDevice> dev, Ptr<const Packet> p, uint16_t protocol, const Address &from);
+  struct Input m_input;
+  std::vector<uint64_t> m_received;
+};
+
+ParallelExperiment::ParallelExperiment ()
+{
+}
+
+ParallelExperiment::Input::Input ()
+  : nNodes (100),
+    threads (4),
+    packetSize (100),
+    side (50.0),
+    interval (MilliSeconds (10)),
+    duration (Seconds (2)),
+    preamble (true)
+{
+}
+
+void
+ParallelExperiment::Send (Ptr<WifiNetDevice> dev)
+{
+  dev->Send (Create<Packet> (m_input.packetSize), dev->GetBroadcast (), 1);
+  Simulator::Schedule (m_input.interval, &ParallelExperiment::Send, this, dev);
+}
+
+bool
+ParallelExperiment::Receive (Ptr<NetDevice> dev, Ptr<const Packet> p, uint16_t protocol, const Address &from)
+{
+  //Each node only runs on the thread of its partition
+  m_received[dev->GetNode ()->GetId ()]++;
+  return true;
+}
+
+void
+ParallelExperiment::CreateOne (Vector pos, Ptr<YansWifiChannel> channel, uint32_t index)
+{
+  Ptr<Node> node = CreateObject<Node> ();
+  Ptr<WifiNetDevice> dev = CreateObject<WifiNetDevice> ();
+  ObjectFactory factory;
+  factory.SetTypeId ("ns3::AdhocWifiMac");
+  Ptr<WifiMac> mac = factory.Create<WifiMac> ();
+  mac->ConfigureStandard (WIFI_PHY_STANDARD_80211a);
+  Ptr<ConstantPositionMobilityModel> mobility = CreateObject<ConstantPositionMobilityModel> ();
+  Ptr<YansWifiPhy> phy = CreateObject<YansWifiPhy> ();
+  phy->SetErrorRateModel (CreateObject<YansErrorRateModel> ());
+  phy->SetChannel (channel);
+  phy->SetDevice (dev);
+  phy->ConfigureStandard (WIFI_PHY_STANDARD_80211a);
+  factory.SetTypeId ("ns3::ConstantRateWifiManager");
+  Ptr<WifiRemoteStationManager> manager = factory.Create<WifiRemoteStationManager> ();
+
+  mobility->SetPosition (pos);
+  node->AggregateObject (mobility);
+  mac->SetAddress (Mac48Address::Allocate ());
+  dev->SetMac (mac);
+  dev->SetPhy (phy);
+  dev->SetRemoteStationManager (manager);
+  node->AddDevice (dev);
+  dev->SetReceiveCallback (MakeCallback (&ParallelExperiment::Receive, this));
+
+  //Spread the first frames over an interval, from the context of the node
+  Time start = Seconds (1) + m_input.interval * index / m_input.nNodes;
+  Simulator::ScheduleWithContext (node->GetId (), start, &ParallelExperiment::Send, this, dev);
+}
+
+struct ParallelExperiment::Output
+ParallelExperiment::Run (struct ParallelExperiment::Input input)
+{
+  m_input = input;
+  Config::SetGlobal ("SimulatorImplementationType", StringValue ("ns3::MultithreadedSimulatorImpl"));
+  Config::SetDefault ("ns3::MultithreadedSimulatorImpl::Threads", UintegerValue (m_input.threads));
+
+  Ptr<YansWifiChannel> channel = CreateObject<YansWifiChannel> ();
+  channel->SetAttribute ("CachePropagation", BooleanValue (true));
+  channel->SetAttribute ("LookaheadPreamble", BooleanValue (m_input.preamble));
+  channel->SetPropagationDelayModel (CreateObject<ConstantSpeedPropagationDelayModel> ());
+  channel->SetPropagationLossModel (CreateObject<LogDistancePropagationLossModel> ());
+
+  //The nodes on a square grid
+  uint32_t side = 1;
+  while (side * side < m_input.nNodes)
+    {
+      side++;
+    }
+  double step = m_input.side / side;
+  for (uint32_t i = 0; i < m_input.nNodes; i++)
+    {
+      CreateOne (Vector ((i % side) * step, (i / side) * step, 1.5), channel, i);
+    }
+  m_received.assign (m_input.nNodes, 0);
+
+  struct Output output;
+  output.lookahead = channel->GetLookahead ();
+  Simulator::GetImplementation ()->SetAttribute ("Lookahead", TimeValue (output.lookahead));
+  Simulator::Stop (Seconds (1) + m_input.duration);
+
+  SystemWallClockMs clock;
+  clock.Start ();
+  Simulator::Run ();
+  output.elapsedMs = clock.End ();
+  Simulator::Destroy ();
+
+  output.received = 0;
+  for (uint32_t i = 0; i < m_input.nNodes; i++)
+    {
+      output.received += m_received[i];
+    }
+  return output;
+}
+
+int
+main (int argc, char *argv[])
+{
+  struct ParallelExperiment::Input input;
+  double interval = 10;
+  double duration = 2;
+
+  CommandLine cmd;
+  cmd.AddValue ("nNodes", "Number of nodes", input.nNodes);
+  cmd.AddValue ("Threads", "Number of threads of the MultithreadedSimulatorImpl", input.threads);
+  cmd.AddValue ("PacketSize", "Size of the frames broadcast by the nodes", input.packetSize);
+  cmd.AddValue ("Side", "Side of the square holding the nodes (m)", input.side);
+  cmd.AddValue ("Interval", "Interval between the frames of a node (ms)", interval);
+  cmd.AddValue ("Duration", "Duration of the traffic (s)", duration);
+  cmd.Parse (argc, argv);
+  input.interval = MicroSeconds (std::floor (interval * 1000));
+  input.duration = Seconds (duration);
+
+  std::cout << "preamble\tlookahead\treceived\tms" << std::endl;
+  for (uint32_t preamble = 0; preamble < 2; preamble++)
+    {
+      input.preamble = preamble;
+      ParallelExperiment experiment;
+      struct ParallelExperiment::Output output = experiment.Run (input);
+      std::cout << (input.preamble ? "yes" : "no") << "\t\t"
+                << output.lookahead.GetNanoSeconds () << "ns\t\t"
+                << output.received << "\t\t" << output.elapsedMs << std::endl;
+    }
+  return 0;
+}
@@ -39,6 +39,7 @@
 #include "msdu-aggregator.h"
 #include "ns3/uinteger.h"
 #include "wifi-mac-queue.h"
+#include <algorithm>
 #include <map>
 
 namespace ns3
@@ -111,7 +112,20 @@ MakeTraceSourceAccessor(&ApWifiMac::m_rawSlotStarted),
 						.AddAttribute("PageSlicingActivated", "Whether or not page slicing is activated.", BooleanValue(true),
 													MakeBooleanAccessor(&ApWifiMac::SetPageSlicingActivated, &ApWifiMac::GetPageSlicingActivated),
 													MakeBooleanChecker())
-						.AddAttribute("TIMSet", "configuration of TIM", TIMValue(), MakeTIMAccessor(&ApWifiMac::m_TIM), MakeTIMChecker());
+						.AddAttribute("TIMSet", "configuration of TIM", TIMValue(), MakeTIMAccessor(&ApWifiMac::m_TIM), MakeTIMChecker())
+						.AddAttribute("TwtScheduling",
+													"Whether the TWT setup requests are placed between the beacon, the RAW and the service periods of the other "
+													"agreements, and answered with an alternative when they collide.",
+													BooleanValue(false), MakeBooleanAccessor(&ApWifiMac::SetTwtScheduling, &ApWifiMac::GetTwtScheduling),
+													MakeBooleanChecker())
+						.AddAttribute("TwtGuardInterval", "Minimum time between two TWT service periods, or a service period and the RAW.",
+													TimeValue(MicroSeconds(1000)), MakeTimeAccessor(&ApWifiMac::m_twtGuardInterval), MakeTimeChecker())
+						.AddAttribute("TwtFrameSize", "Size of the frame a STA is expected to exchange in a TWT service period.", UintegerValue(100),
+													MakeUintegerAccessor(&ApWifiMac::m_twtFrameSize), MakeUintegerChecker<uint32_t>())
+						.AddAttribute("TwtSetupDelay",
+													"Minimum time between an alternative proposed to a STA and its first service period, which covers the "
+													"request of the alternative and the confirmation.",
+													TimeValue(MilliSeconds(500)), MakeTimeAccessor(&ApWifiMac::m_twtSetupDelay), MakeTimeChecker());
 		/*
 				 .AddAttribute ("DTIMPeriod", "TIM number in one of DTIM",
 																 UintegerValue (4),
@@ -137,15 +151,24 @@ MakeTraceSourceAccessor(&ApWifiMac::m_rawSlotStarted),
 		SetTypeOfStation(AP);
 
 		m_enableBeaconGeneration = false;
+		m_twtScheduling = false;
 		AuthenThreshold = 0;
 		currentRawGroup = 0;
 		// m_SlotFormat = 0;
-		m_AidToMacAddr.clear();
-		m_accessList.clear();
+		m_aidToMacAddr.clear();
+		m_aidAssigned.clear();
+		m_macAddrToAid.clear();
 		m_supportPageSlicingList.clear();
 		m_sleepList.clear();
 		m_DTIMCount = 0;
 		// m_DTIMOffset = 0;
+
+		m_downlink.SetWakeCallback(MakeCallback(&ApWifiMac::StartAccess, this));
+		m_downlink.SetHasFramesCallback(MakeCallback(&ApWifiMac::HasPacketsToAid, this));
+		for (auto it = m_edca.begin(); it != m_edca.end(); ++it) {
+			it->second->GetEdcaQueue()->SetEnqueueCallback(MakeCallback(&ApWifiMac::NotifyQueued, this));
+			it->second->SetAidLookupCallback(MakeCallback(&ApWifiMac::GetAidFromAddress, this));
+		}
 	}
 
 	ApWifiMac::~ApWifiMac()
@@ -159,6 +182,10 @@ MakeTraceSourceAccessor(&ApWifiMac::m_rawSlotStarted),
 		m_beaconDca = 0;
 		m_enableBeaconGeneration = false;
 		m_beaconEvent.Cancel();
+		m_rawSchedules.clear();
+		m_downlink.Clear();
+		m_twtScheduler.Clear();
+		m_twtProposals.clear();
 		RegularWifiMac::DoDispose();
 	}
 
@@ -392,21 +419,15 @@ MakeTraceSourceAccessor(&ApWifiMac::m_rawSlotStarted),
 		hdr.SetDsFrom();
 		hdr.SetDsNotTo();
 
-		int aid = 0;
-		if (!to.IsBroadcast()) {
-			/*for (auto it=m_AidToMacAddr.begin(); it != m_AidToMacAddr.end(); ++it){
-			if (m_AidToMacAddr.find(aid)->second == to)
-					break;
-			else if (it == m_AidToMacAddr.end())
-					aid = -1;
-	}
-	if (aid == -1)
-			NS_LOG_INFO (Simulator::Now().GetMicroSeconds() << " ms: AP cannot forward down data because There is no RAW for
-	this MAC address.");
-	*/
-			do {
-				aid++;
-			} while (m_AidToMacAddr.find(aid)->second != to); // TODO optimize search
+		uint16_t aid = 0;
+		if (!to.IsGroup()) {
+			aid = GetAidFromAddress(to);
+			if (aid == 0) {
+				// Without an AID, the frame can be neither announced in the TIM nor sent in a RAW slot
+				NS_LOG_WARN("No AID assigned to " << to << ", dropping the frame");
+				NotifyTxDrop(packet);
+				return;
+			}
 
 			NS_LOG_INFO(Simulator::Now().GetMicroSeconds() << " ms: AP to forward data for [aid=" << aid << "]");
 
@@ -450,7 +471,8 @@ MakeTraceSourceAccessor(&ApWifiMac::m_rawSlotStarted),
 	void (ApWifiMac::*fp) (Ptr<const Packet>, Mac48Address, Mac48Address) = &ApWifiMac::ForwardDown;
 	Simulator::Schedule(wait, fp, this, packet, from, to);*/
 
-			Simulator::Schedule(wait, &EdcaTxopN::StartAccessIfNeeded, m_edca[QosUtilsMapTidToAc(tid)]);
+			// the frames of the same slot share a single channel access attempt
+			m_downlink.Schedule(QosUtilsMapTidToAc(tid), wait);
 		}
 
 		if (m_qosSupported) {
@@ -486,42 +508,75 @@ MakeTraceSourceAccessor(&ApWifiMac::m_rawSlotStarted),
 		}
 
 		// std::cout << "aid=" << (int)aid << ", toTim=" << (int)toTim << std::endl;
-		uint16_t raw_len = (*m_rpsset.rpsset.at(toTim)).GetInformationFieldSize();
-
-		uint16_t rawAssignment_len = 6;
-		if (raw_len % rawAssignment_len != 0) {
-			NS_ASSERT("RAW configuration incorrect!");
-		}
-		uint8_t RAW_number = raw_len / rawAssignment_len;
-
-		uint16_t slotDurationCount = 0;
-		uint16_t slotNum = 0;
-		uint64_t currentRAW_start = 0;
-		Time lastRawDurationus = MicroSeconds(0);
-		int x = 0;
-		for (uint8_t raw_index = 0; raw_index < RAW_number; raw_index++) {
-			RPS::RawAssignment ass = m_rpsset.rpsset.at(toTim)->GetRawAssigmentObj(raw_index);
-			currentRAW_start += (500 + slotDurationCount * 120) * slotNum;
-			slotDurationCount = ass.GetSlotDurationCount();
-			slotNum = ass.GetSlotNum();
-			Time slotDuration = MicroSeconds(500 + slotDurationCount * 120);
-			lastRawDurationus += slotDuration * slotNum;
-			if (ass.GetRawGroupAIDStart() <= aid && aid <= ass.GetRawGroupAIDEnd()) {
-				uint16_t statRawSlot = (aid & 0x03ff) % slotNum;
-				Time start = MicroSeconds((500 + slotDurationCount * 120) * statRawSlot + currentRAW_start);
-				NS_LOG_DEBUG("[aid=" << aid << "] is located in RAW " << (int)raw_index + 1 << " in slot " << statRawSlot + 1
-														 << ". RAW slot start time relative to the beacon = " << start.GetMicroSeconds() << " us.");
-				x = 1;
-				return start;
-			}
+		Ptr<const RawSchedule> schedule = GetRawSchedule(m_rpsset.rpsset.at(toTim));
+		uint32_t group;
+		uint16_t slot;
+		if (schedule->FindSlot(aid, group, slot)) {
+			Time start = schedule->GetSlotStart(group, slot);
+			NS_LOG_DEBUG("[aid=" << aid << "] is located in RAW " << group + 1 << " in slot " << slot + 1
+													 << ". RAW slot start time relative to the beacon = " << start.GetMicroSeconds() << " us.");
+			return start;
 		}
 		// AIDs that are not assigned to any RAW group can sleep through all the RAW groups
 		// For station that does not belong to anz RAW group, return the time after all RAW groups
-		/*currentRAW_start += (500 + slotDurationCount * 120) * slotNum;
-NS_LOG_DEBUG ("[aid=" << aid << "] is located outside all RAWs. It can start contending " << currentRAW_start << " us
-after the beacon.");*/
-		NS_ASSERT(x);
-		return MicroSeconds(currentRAW_start);
+		NS_ASSERT_MSG(false, "[aid=" << aid << "] is located outside all RAWs");
+		return schedule->GetDuration();
+	}
+
+	void ApWifiMac::SetAid(uint16_t aid, Mac48Address address)
+	{
+		NS_LOG_FUNCTION(this << aid << address);
+		if (aid == 0) {
+			// AID 0 is reserved, it is what GetAidFromAddress returns for an unknown STA
+			NS_LOG_WARN("AID 0 cannot be assigned to " << address);
+			return;
+		}
+		RemoveAid(address);
+		if (aid >= m_aidToMacAddr.size()) {
+			m_aidToMacAddr.resize(aid + 1);
+			m_aidAssigned.resize(aid + 1, false);
+		}
+		if (m_aidAssigned[aid]) {
+			// the AID was derived from the address of another STA
+			m_macAddrToAid.erase(m_aidToMacAddr[aid]);
+		}
+		m_aidToMacAddr[aid] = address;
+		m_aidAssigned[aid] = true;
+		m_macAddrToAid[address] = aid;
+	}
+
+	void ApWifiMac::RemoveAid(Mac48Address address)
+	{
+		auto it = m_macAddrToAid.find(address);
+		if (it != m_macAddrToAid.end()) {
+			m_aidAssigned[it->second] = false;
+			m_macAddrToAid.erase(it);
+		}
+	}
+
+	uint16_t ApWifiMac::GetAidFromAddress(Mac48Address address) const
+	{
+		auto it = m_macAddrToAid.find(address);
+		if (it == m_macAddrToAid.end()) {
+			return 0;
+		}
+		return it->second;
+	}
+
+	bool ApWifiMac::IsAidAssigned(uint16_t aid) const
+	{
+		return aid < m_aidAssigned.size() && m_aidAssigned[aid];
+	}
+
+	Mac48Address ApWifiMac::GetAddressFromAid(uint16_t aid) const
+	{
+		NS_ASSERT(IsAidAssigned(aid));
+		return m_aidToMacAddr[aid];
+	}
+
+	bool ApWifiMac::IsAidAssociated(uint16_t aid) const
+	{
+		return IsAidAssigned(aid) && m_stationManager->IsAssociated(m_aidToMacAddr[aid]);
 	}
 
 	void ApWifiMac::Enqueue(Ptr<const Packet> packet, Mac48Address to, Mac48Address from)
@@ -656,7 +711,7 @@ after the beacon.");*/
 		uint8_t aid_h = mac[4] & 0x1f;
 		uint16_t aid = (aid_h << 8) | (aid_l << 0); // assign mac address as AID
 		assoc.SetAID(aid);													//
-		m_AidToMacAddr[aid] = to;
+		SetAid(aid, to);
 
 		StatusCode code;
 		if (success) {
@@ -730,29 +785,23 @@ after the beacon.");*/
 
 	uint8_t ApWifiMac::HasPacketsToBlock(uint16_t blockInd, uint16_t PageInd)
 	{
-		uint16_t sta_aid, subblock, block;
-		uint8_t blockBitmap;
-
-		blockBitmap = 0;
-		block = (PageInd << 11) | (blockInd << 6); // TODO check
-
-		for (uint16_t i = 0; i <= 7; i++) // 8 subblock in each block.
-		{
-			subblock = block | (i << 3);
-			for (uint16_t j = 0; j <= 7; j++) // 8 stations in each subblock
-			{
-				sta_aid = subblock | j;
-				if (m_stationManager->IsAssociated(m_AidToMacAddr.find(sta_aid)->second) &&
-						HasPacketsInQueueTo(m_AidToMacAddr.find(sta_aid)->second)) {
-					blockBitmap = blockBitmap | (1 << i);
-					NS_LOG_DEBUG("[aid=" << sta_aid << "] "
-															 << "paged");
-					// if there is at least one station associated with AP that has FALSE for PageSlicingImplemented within this
-					// page then m_PageSliceNum = 31
-					if (!m_supportPageSlicingList.at(m_AidToMacAddr[sta_aid]))
-						m_PageSliceNum = 31;
-					break;
-				}
+		uint16_t block = (PageInd << 11) | (blockInd << 6); // TODO check
+		uint8_t blockBitmap = 0;
+
+		// 8 subblocks of 8 stations in each block
+		std::vector<uint16_t> aids;
+		m_downlink.GetBuffered(block, block | 0x3f, aids);
+		for (auto it = aids.begin(); it != aids.end(); ++it) {
+			uint16_t sta_aid = *it;
+			uint8_t subblock = (sta_aid >> 3) & 0x07;
+			if (!(blockBitmap & (1 << subblock)) && IsAidAssociated(sta_aid)) {
+				blockBitmap = blockBitmap | (1 << subblock);
+				NS_LOG_DEBUG("[aid=" << sta_aid << "] "
+														 << "paged");
+				// if there is at least one station associated with AP that has FALSE for PageSlicingImplemented within this
+				// page then m_PageSliceNum = 31
+				if (!m_supportPageSlicingList.at(GetAddressFromAid(sta_aid)))
+					m_PageSliceNum = 31;
 			}
 		}
 
@@ -761,18 +810,16 @@ after the beacon.");*/
 
 	uint8_t ApWifiMac::HasPacketsToSubBlock(uint16_t subblockInd, uint16_t blockInd, uint16_t PageInd)
 	{
-		uint16_t sta_aid, subblock;
-		uint8_t subblockBitmap;
-		subblockBitmap = 0;
-
-		subblock = (PageInd << 11) | (blockInd << 6) | (subblockInd << 3);
-		for (uint16_t j = 0; j <= 7; j++) // 8 stations in each subblock
-		{
-			sta_aid = subblock | j;
-			if (m_stationManager->IsAssociated(m_AidToMacAddr.find(sta_aid)->second) &&
-					HasPacketsInQueueTo(m_AidToMacAddr.find(sta_aid)->second)) {
-				subblockBitmap = subblockBitmap | (1 << j);
-				m_sleepList[m_AidToMacAddr.find(sta_aid)->second] = false;
+		uint16_t subblock = (PageInd << 11) | (blockInd << 6) | (subblockInd << 3);
+		uint8_t subblockBitmap = 0;
+
+		// 8 stations in each subblock
+		std::vector<uint16_t> aids;
+		m_downlink.GetBuffered(subblock, subblock | 0x07, aids);
+		for (auto it = aids.begin(); it != aids.end(); ++it) {
+			if (IsAidAssociated(*it)) {
+				subblockBitmap = subblockBitmap | (1 << (*it & 0x07));
+				m_sleepList[GetAddressFromAid(*it)] = false;
 			}
 		}
 		return subblockBitmap;
@@ -797,25 +844,170 @@ after the beacon.");*/
 		}
 	}
 
-	uint16_t ApWifiMac::RpsIndex = 0;
-	void ApWifiMac::SetaccessList(std::map<Mac48Address, bool> list)
+	bool ApWifiMac::HasPacketsToAid(uint16_t aid)
 	{
-		Mac48Address stasAddr;
+		return IsAidAssigned(aid) && HasPacketsInQueueTo(m_aidToMacAddr[aid]);
+	}
 
-		if (list.size() == 0) {
+	void ApWifiMac::SetTwtScheduling(bool enable)
+	{
+		if (enable == m_twtScheduling) {
 			return;
 		}
+		m_twtScheduling = enable;
+		if (enable) {
+			// Keep the functions in place before, to restore them when the scheduling is disabled
+			m_savedTwtAcceptance = GetTWTAcceptanceFunction();
+			m_savedTwtAlternative = GetTWTAlternativeConfigurationFunction();
+			SetTWTAcceptanceFunction([this](const TWTHeader &request) { return AcceptTwt(request); });
+			SetTWTAlternativeConfigurationFunction([this](const TWTHeader &request) { return ProposeTwt(request); });
+		} else {
+			SetTWTAcceptanceFunction(m_savedTwtAcceptance);
+			SetTWTAlternativeConfigurationFunction(m_savedTwtAlternative);
+			m_savedTwtAcceptance = nullptr;
+			m_savedTwtAlternative = nullptr;
+		}
+	}
 
-		for (uint32_t k = 1; k <= m_totalStaNum; k++) {
-			stasAddr = m_AidToMacAddr.find(k)->second;
-			// NS_LOG_UNCOND ( "aid "  << k << ", send " << list.find(stasAddr)->second << ", at " << Simulator::Now () << ",
-			// size " << list.size ());
+	bool ApWifiMac::GetTwtScheduling(void) const
+	{
+		return m_twtScheduling;
+	}
+
+	void ApWifiMac::UpdateTwtReservations(void)
+	{
+		m_twtScheduler.Clear();
+		m_twtScheduler.SetBeaconInterval(m_beaconInterval);
+		m_twtScheduler.SetGuardInterval(m_twtGuardInterval);
+		// The beacon and the longest RAW of the RPS cycle, which starts at the end of the beacon
+		Time raw = Seconds(0);
+		for (const RPS *rps : m_rpsset.rpsset) {
+			raw = std::max(raw, GetRawSchedule(rps)->GetDuration());
+		}
+		m_twtScheduler.Reserve(Seconds(0), m_beaconInterval, m_beaconTxTime + raw);
+		for (const TWTHeader *agreement : GetTwtAgreements()) {
+			m_twtScheduler.Reserve(agreement->GetTargetWakeTime() - m_lastBeaconTime, TwtScheduler::GetWakeInterval(*agreement),
+														 agreement->GetNominalMinimumWakeDuration());
+		}
+		// A proposal holds its service periods until its first one
+		Time now = Simulator::Now();
+		m_twtProposals.erase(std::remove_if(m_twtProposals.begin(), m_twtProposals.end(),
+																				[now](const TWTHeader &proposal) { return proposal.GetTargetWakeTime() <= now; }),
+												 m_twtProposals.end());
+		for (const TWTHeader &proposal : m_twtProposals) {
+			m_twtScheduler.Reserve(proposal.GetTargetWakeTime() - m_lastBeaconTime, TwtScheduler::GetWakeInterval(proposal),
+														 proposal.GetNominalMinimumWakeDuration());
 		}
+	}
+
+	Time ApWifiMac::GetTwtAirtime(void) const
+	{
+		// The STA is not known to the policy, so the frame is sent at the non-unicast rate, the most robust one
+		WifiMacHeader hdr;
+		hdr.SetType(WIFI_MAC_QOSDATA);
+		uint32_t size = m_twtFrameSize + hdr.GetSize() + 4;
+		Ptr<const Packet> packet = Create<Packet>(m_twtFrameSize);
+		WifiTxVector txVector = m_stationManager->GetDataTxVector(Mac48Address::GetBroadcast(), &hdr, packet, size);
+		// The ACK is sent at the control answer rate of the data mode. Our own address stands for the STA,
+		// which GetAckTxVector needs to be unicast.
+		WifiTxVector ackTxVector = m_stationManager->GetAckTxVector(m_low->GetAddress(), txVector.GetMode());
+		WifiPreamble preamble = WIFI_PREAMBLE_LONG;
+		WifiPreamble ackPreamble = WIFI_PREAMBLE_LONG;
+		if (txVector.GetMode().GetModulationClass() == WIFI_MOD_CLASS_S1G) {
+			preamble = m_phy->GetS1g1Mfield() ? WIFI_PREAMBLE_S1G_1M : (m_phy->GetS1gShortfield() ? WIFI_PREAMBLE_S1G_SHORT : WIFI_PREAMBLE_S1G_LONG);
+		}
+		if (ackTxVector.GetMode().GetModulationClass() == WIFI_MOD_CLASS_S1G) {
+			ackPreamble = WIFI_PREAMBLE_S1G_SHORT;
+		}
+		WifiMacHeader ack;
+		ack.SetType(WIFI_MAC_CTL_ACK);
+		Time data = m_phy->CalculateTxDuration(size, txVector, preamble, m_phy->GetFrequency(), 0, 0);
+		Time acknowledgment = m_phy->CalculateTxDuration(ack.GetSize() + 4, ackTxVector, ackPreamble, m_phy->GetFrequency(), 0, 0);
+		// DIFS, frame, SIFS, ACK
+		return GetSifs() + GetSlot() * 2 + data + GetSifs() + acknowledgment;
+	}
+
+	bool ApWifiMac::AcceptTwt(const TWTHeader &request)
+	{
+		Time interval = TwtScheduler::GetWakeInterval(request);
+		for (auto it = m_twtProposals.begin(); it != m_twtProposals.end(); ++it) {
+			// The request of an alternative we proposed takes the service periods kept for it
+			if (it->GetTargetWakeTime() == request.GetTargetWakeTime() && TwtScheduler::GetWakeInterval(*it) == interval &&
+					it->GetNominalMinimumWakeDuration() == request.GetNominalMinimumWakeDuration() &&
+					it->GetFlowIdentifier() == request.GetFlowIdentifier()) {
+				m_twtProposals.erase(it);
+				return request.GetTargetWakeTime() > Simulator::Now();
+			}
+		}
+		UpdateTwtReservations();
+		Time duration = request.GetNominalMinimumWakeDuration();
+		return request.GetTargetWakeTime() > Simulator::Now() && interval == m_twtScheduler.GetHarmonicInterval(interval) &&
+					 duration >= GetTwtAirtime() && m_twtScheduler.Fits(request.GetTargetWakeTime() - m_lastBeaconTime, interval, duration);
+	}
+
+	TWTHeader ApWifiMac::ProposeTwt(const TWTHeader &request)
+	{
+		UpdateTwtReservations();
+		TWTHeader alternative = request;
+		alternative.SetRequest(false);
+		Time interval = m_twtScheduler.GetHarmonicInterval(TwtScheduler::GetWakeInterval(request));
+		// At least the exchange of a frame, in the 256 us units of the element
+		int64_t duration = std::max(request.GetNominalMinimumWakeDuration(), GetTwtAirtime()).GetMicroSeconds();
+		duration = (duration + 255) / 256 * 256;
+		Time phase;
+		if (duration > 255 * 256 || !TwtScheduler::SetWakeInterval(alternative, interval) ||
+				!m_twtScheduler.FindPhase(interval, MicroSeconds(duration), phase)) {
+			NS_LOG_DEBUG("No TWT service period of " << duration << " us every " << interval << " fits");
+			alternative.SetSetupCommand(TWT_SETUPCOMMAND_REJECT);
+			return alternative;
+		}
+		// The first service period at the phase which leaves the time to set the agreement up
+		int64_t twt = (m_lastBeaconTime + phase).GetMicroSeconds();
+		int64_t earliest = (Simulator::Now() + m_twtSetupDelay).GetMicroSeconds();
+		int64_t p = interval.GetMicroSeconds();
+		if (twt < earliest) {
+			twt += (earliest - twt + p - 1) / p * p;
+		}
+		alternative.SetSetupCommand(TWT_SETUPCOMMAND_ALTERNATE);
+		alternative.SetTargetWakeTime(MicroSeconds(twt));
+		alternative.SetNominalMinimumWakeDuration(MicroSeconds(duration));
+		m_twtProposals.push_back(alternative);
+		return alternative;
+	}
 
+	void ApWifiMac::NotifyQueued(Ptr<const Packet> packet, const WifiMacHeader &hdr)
+	{
+		uint16_t aid = GetAidFromAddress(hdr.GetAddr1());
+		if (aid != 0) {
+			m_downlink.Buffer(aid);
+		}
+	}
+
+	void ApWifiMac::StartAccess(enum AcIndex ac)
+	{
+		m_edca.find(ac)->second->StartAccessIfNeeded();
+	}
+
+	uint16_t ApWifiMac::RpsIndex = 0;
+	void ApWifiMac::SetaccessList(Ptr<const RawSlotAccessList> list)
+	{
 		m_edca.find(AC_VO)->second->SetaccessList(list);
 		m_edca.find(AC_VI)->second->SetaccessList(list);
 		m_edca.find(AC_BE)->second->SetaccessList(list);
 		m_edca.find(AC_BK)->second->SetaccessList(list);
+		// The frames held back during the previous slot may be sent now
+		for (auto it = m_edca.begin(); it != m_edca.end(); ++it) {
+			it->second->StartAccessIfNeeded();
+		}
+	}
+
+	Ptr<const RawSchedule> ApWifiMac::GetRawSchedule(const RPS *rps) const
+	{
+		Ptr<const RawSchedule> &schedule = m_rawSchedules[rps];
+		if (schedule == 0 || !schedule->Matches(*rps)) {
+			schedule = Create<RawSchedule>(*rps);
+		}
+		return schedule;
 	}
 
 	void ApWifiMac::SendOneBeacon(void)
@@ -848,14 +1040,11 @@ after the beacon.");*/
 			}
 			beacon.SetRPS(*m_rps);
 
-			Mac48Address stasleepAddr;
-			for (auto i = m_AidToMacAddr.begin(); i != m_AidToMacAddr.end(); ++i) {
+			for (auto i = m_macAddrToAid.begin(); i != m_macAddrToAid.end(); ++i) {
 				// assume all station sleep, then change some to awake state based on downlink data
 				// This implementation is temporary, should be removed if ps-poll is supported
-
-				stasleepAddr = i->second;
-				if (m_stationManager->IsAssociated(stasleepAddr)) {
-					m_sleepList[stasleepAddr] = true;
+				if (m_stationManager->IsAssociated(i->first)) {
+					m_sleepList[i->first] = true;
 				}
 			}
 
@@ -906,8 +1095,11 @@ after the beacon.");*/
 			m_PageIndex = m_pageslice.GetPageindex();
 			// m_TIM.SetPageIndex (m_PageIndex);
 			uint64_t numPagedStas(0);
-			for (auto it = m_supportPageSlicingList.begin(); it != m_supportPageSlicingList.end(); ++it) {
-				if (m_stationManager->IsAssociated(it->first) && HasPacketsInQueueTo(it->first)) {
+			std::vector<uint16_t> bufferedAids;
+			m_downlink.GetBuffered(0, 0xffff, bufferedAids);
+			for (auto it = bufferedAids.begin(); it != bufferedAids.end(); ++it) {
+				Mac48Address addr = m_aidToMacAddr[*it];
+				if (m_supportPageSlicingList.find(addr) != m_supportPageSlicingList.end() && m_stationManager->IsAssociated(addr)) {
 					numPagedStas++;
 				}
 			}
@@ -1038,79 +1230,35 @@ else if (m_pageslice.GetPageSliceCount () == 0 && numPagedStas == 0)
 			params.DisableAck();
 			params.DisableNextData();
 			Time txTime = m_low->CalculateOverallTxTime(packet, &hdr, params);
+			m_beaconTxTime = txTime;
 			NS_LOG_DEBUG("Transmission of beacon will take " << txTime << ", delaying RAW start for that amount");
 			Time bufferTimeToAllowBeaconToBeReceived = txTime;
 			// bufferTimeToAllowBeaconToBeReceived = MicroSeconds (5600);
 			auto nRaw = m_rps->GetNumberOfRawGroups();
 			currentRawGroup = (currentRawGroup + 1) % nRaw;
 
-			uint16_t startaid;
-			uint16_t endaid;
-			Mac48Address stasAddr;
-			// uint16_t offset;
-			// uint16_t statsPerSlot;
-			uint16_t statRawSlot;
-
-			// NS_LOG_UNCOND ("ap send beacon at " << Simulator::Now ());
-
-			m_accessList.clear();
-			for (uint16_t i = 1; i <= m_totalStaNum; i++) {
-				// assume all station sleeps, then change some to awake state based on downlink data
-				// This implementation is temporary, should be removed if ps-poll is supported
-				if (m_AidToMacAddr.size() == 0) {
-					break;
-				}
-				stasAddr = m_AidToMacAddr.find(i)->second;
-
-				if (m_stationManager->IsAssociated(stasAddr)) {
-					m_accessList[stasAddr] = false;
-				}
-			}
-			// NS_LOG_UNCOND ("m_accessList.size " << m_accessList.size ());
-
 			// schedule the slot start
-			Time timeToSlotStart = Time();
+			Ptr<const RawSchedule> schedule = GetRawSchedule(m_rps);
 			for (uint32_t g = 0; g < nRaw; g++) {
-				if (m_AidToMacAddr.size() == 0) {
+				if (m_macAddrToAid.empty()) {
 					break;
 				}
 
-				startaid = m_rps->GetRawAssigmentObj(g).GetRawGroupAIDStart();
-				endaid = m_rps->GetRawAssigmentObj(g).GetRawGroupAIDEnd();
-
-				// offset =0; // for test
-				// m_slotNum=m_rps->GetRawAssigmentObj(g).GetSlotNum();
-				// statsPerSlot = (endaid - startaid + 1)/m_rps->GetRawAssigmentObj(g).GetSlotNum();
-
-				for (uint32_t i = 0; i < m_rps->GetRawAssigmentObj(g).GetSlotNum(); i++) {
-					for (uint32_t k = startaid; k <= endaid; k++) {
-
-						statRawSlot = (k & 0x03ff) % m_rps->GetRawAssigmentObj(g).GetSlotNum(); // slot that the station k will be
-						// station is in sot i
-						if (statRawSlot == i) {
-							stasAddr = m_AidToMacAddr.find(k)->second;
-							if (m_stationManager->IsAssociated(stasAddr)) {
-								m_accessList[stasAddr] = true;
-							}
-						}
-					}
-					Simulator::Schedule(bufferTimeToAllowBeaconToBeReceived + timeToSlotStart, &ApWifiMac::SetaccessList, this, m_accessList);
+				const RawSchedule::Group &group = schedule->GetRawGroup(g);
+				for (uint16_t i = 0; i < group.slotNum; i++) {
+					Time timeToSlotStart = group.start + group.slotDuration * i;
+					Simulator::Schedule(bufferTimeToAllowBeaconToBeReceived + timeToSlotStart, &ApWifiMac::SetaccessList, this,
+															group.slots[i]);
 
 					Simulator::Schedule(bufferTimeToAllowBeaconToBeReceived + timeToSlotStart, &ApWifiMac::OnRAWSlotStart, this, RpsIndex, g + 1,
 															i + 1);
-					timeToSlotStart += MicroSeconds(500 + m_rps->GetRawAssigmentObj(g).GetSlotDurationCount() * 120);
-
-					for (uint16_t i = 1; i <= m_totalStaNum; i++) {
-						stasAddr = m_AidToMacAddr.find(i)->second;
-
-						if (m_stationManager->IsAssociated(stasAddr)) {
-							m_accessList[stasAddr] = false;
-						}
-					}
 				}
 			}
-			// NS_LOG_UNCOND(GetAddress () << ", " << startaid << "\t" << endaid << ", at " << Simulator::Now () << ",
-			// bufferTimeToAllowBeaconToBeReceived " << bufferTimeToAllowBeaconToBeReceived);
+			if (!m_macAddrToAid.empty()) {
+				// Lift the restriction of the last slot once the RAW groups end
+				Simulator::Schedule(bufferTimeToAllowBeaconToBeReceived + schedule->GetDuration(), &ApWifiMac::SetaccessList, this,
+														Ptr<const RawSlotAccessList>());
+			}
 		} else {
 			m_receivedAid.clear(); // release storage
 			hdr.SetBeacon();
@@ -1312,6 +1460,7 @@ else if (m_pageslice.GetPageSliceCount () == 0 && numPagedStas == 0)
 		uint8_t aid_h = mac[4] & 0x1f;
 		uint16_t aid = (aid_h << 8) | (aid_l << 0);
 		NS_LOG_UNCOND("Disassociation request from aid " << aid);
+		RemoveAid(from);
 
 		for (std::vector<uint16_t>::iterator it = m_sensorList.begin(); it != m_sensorList.end(); it++) {
 			if (*it == aid) {
@@ -1345,23 +1494,25 @@ else if (m_pageslice.GetPageSliceCount () == 0 && numPagedStas == 0)
 			if (tag != TwtPacketTag::ERROR()) {
 				static std::set<uint64_t> mytags;
 				mytags.insert(tag.id);
-				const char *sep = "";
-				const auto sepActual = ", ";
-				std::stringstream ss;
-				ss << "[";
-				for (auto it = mytags.begin(); it != mytags.end(); ++it) {
-					ss << sep << *it;
-					sep = sepActual;
+				if (g_log.IsEnabled(LOG_DEBUG)) {
+					const char *sep = "";
+					const auto sepActual = ", ";
+					std::stringstream ss;
+					ss << "[";
+					for (auto it = mytags.begin(); it != mytags.end(); ++it) {
+						ss << sep << *it;
+						sep = sepActual;
+					}
+					ss << "]";
+					NS_LOG_DEBUG("RECV = " << ss.str());
 				}
-				ss << "]";
-				NS_LOG_UNCOND("RECV = " << ss.str());
 				return;
 			}
 			HandleDataPacket(packet, hdr);
 		} else if (hdr->IsMgt()) {
 			HandleManagementPacket(packet, hdr);
 		} else {
-			NS_LOG_UNCOND("Other frame received by AP, passing to RegularWifiMac.");
+			NS_LOG_LOGIC("Other frame received by AP, passing to RegularWifiMac.");
 			// Invoke the receive handler of our parent class to deal with any
 			// other frames. Specifically, this will handle Block Ack-related
 			// Management Action frames and TWT frames.
@@ -34,12 +34,15 @@
 #include "regular-wifi-mac.h"
 #include "rps.h"
 #include "s1g-capabilities.h"
+#include "s1g-downlink-scheduler.h"
 #include "s1g-raw-control.h"
 #include "supported-rates.h"
 #include "tim.h"
+#include "twt-scheduler.h"
 
 #include <functional>
 #include <map>
+#include <unordered_map>
 #include <utility>
 
 namespace ns3
@@ -136,7 +139,12 @@ namespace ns3
 		 * \return the number of stream indices assigned by this model
 		 */
 		int64_t AssignStreams(int64_t stream);
-		void SetaccessList(std::map<Mac48Address, bool> list);
+		/**
+		 * Restrict the downlink frames of the EDCA queues to the stations of a RAW slot.
+		 *
+		 * \param list the stations of the RAW slot which starts, or 0 once the RAW groups end
+		 */
+		void SetaccessList(Ptr<const RawSlotAccessList> list);
 
 		uint8_t GetDTIMPeriod(void) const;
 		void SetDTIMPeriod(uint8_t period);
@@ -148,6 +156,47 @@ namespace ns3
 	protected:
 		uint8_t GetLastBeaconSequence() const override;
 
+		/**
+		 * Record the AID assigned to a STA in the AID indexes.
+		 *
+		 * \param aid the AID assigned to the STA
+		 * \param address the address of the STA
+		 */
+		void SetAid(uint16_t aid, Mac48Address address);
+		/**
+		 * Remove a STA from the AID indexes.
+		 *
+		 * \param address the address of the STA
+		 */
+		void RemoveAid(Mac48Address address);
+		/**
+		 * \param address the address of a STA
+		 * \return the AID assigned to the STA, or 0 if none was assigned
+		 */
+		uint16_t GetAidFromAddress(Mac48Address address) const;
+		/**
+		 * \param aid the AID of a STA
+		 * \return true if the AID is assigned to a STA
+		 */
+		bool IsAidAssigned(uint16_t aid) const;
+		/**
+		 * \param aid an AID assigned to a STA
+		 * \return the address of the STA
+		 */
+		Mac48Address GetAddressFromAid(uint16_t aid) const;
+		/**
+		 * \param aid the AID of a STA
+		 * \return true if the AID is assigned to a STA which is associated
+		 */
+		bool IsAidAssociated(uint16_t aid) const;
+
+		/**
+		 * \param rps an RPS of m_rpsset
+		 *
+		 * \return the schedule compiled from the RPS, rebuilt only when the content of the RPS changes
+		 */
+		Ptr<const RawSchedule> GetRawSchedule(const RPS *rps) const;
+
 	private:
 		virtual void Receive(Ptr<Packet> packet, const WifiMacHeader *hdr);
 
@@ -265,6 +314,51 @@ namespace ns3
 		void HandleDisassociation(Ptr<Packet> packet, const WifiMacHeader *hdr);
 
 		Time GetSlotStartTimeFromAid(uint16_t aid) const;
+		/**
+		 * Record the station a frame was queued for in an EDCA queue, for the TIM.
+		 *
+		 * \param packet the frame
+		 * \param hdr the header of the frame
+		 */
+		void NotifyQueued(Ptr<const Packet> packet, const WifiMacHeader &hdr);
+		/**
+		 * Start the channel access of an access category, at the start of a RAW slot.
+		 *
+		 * \param ac the access category
+		 */
+		void StartAccess(enum AcIndex ac);
+		/**
+		 * \param aid the AID of a STA
+		 * \return true if the AID is assigned and frames are queued for the STA
+		 */
+		bool HasPacketsToAid(uint16_t aid);
+		/**
+		 * \param enable whether the TWT setup requests are checked against the service periods already
+		 *        placed, and answered with an alternative when they do not fit. Disabling it restores the
+		 *        acceptance and alternative functions set before it was enabled.
+		 */
+		void SetTwtScheduling(bool enable);
+		bool GetTwtScheduling(void) const;
+		/**
+		 * Rebuild the reservations of the TWT scheduler from the beacon and the RAW, the TWT agreements
+		 * and the alternatives proposed to the STAs which did not request them yet.
+		 */
+		void UpdateTwtReservations(void);
+		/**
+		 * \return the airtime of the exchange of a frame in a service period, at the non-unicast rate, and of
+		 *         its ACK, at the control answer rate
+		 */
+		Time GetTwtAirtime(void) const;
+		/**
+		 * \param request a TWT setup request
+		 * \return true if the service periods of the request fit the schedule
+		 */
+		bool AcceptTwt(const TWTHeader &request);
+		/**
+		 * \param request a TWT setup request which does not fit the schedule
+		 * \return the alternative parameters, or a rejection if no service period fits
+		 */
+		TWTHeader ProposeTwt(const TWTHeader &request);
 		void SetPageSlicingActivated(bool activate);
 		bool GetPageSlicingActivated(void) const;
 
@@ -314,8 +408,22 @@ namespace ns3
 		std::vector<uint16_t> m_sensorList; // stations allowed to transmit in last beacon
 		std::vector<uint16_t> m_OffloadList;
 		std::vector<uint16_t> m_receivedAid;
-		std::map<uint16_t, Mac48Address> m_AidToMacAddr;
-		std::map<Mac48Address, bool> m_accessList;
+		std::vector<Mac48Address> m_aidToMacAddr;	//!< Address of the STA of each AID, indexed by AID
+		std::vector<bool> m_aidAssigned;					//!< Whether each AID is assigned, indexed by AID
+		std::unordered_map<Mac48Address, uint16_t, Mac48AddressHash> m_macAddrToAid; //!< AID of each STA
+		mutable std::map<const RPS *, Ptr<const RawSchedule>> m_rawSchedules; //!< Compiled schedule of each RPS of m_rpsset
+
+		S1gDownlinkScheduler m_downlink; //!< Buffered downlink frames, by RAW slot and by AID
+
+		TwtScheduler m_twtScheduler;			 //!< Placement of the TWT service periods
+		bool m_twtScheduling;							 //!< Whether the TWT setup requests are scheduled
+		TWTParamaterAcceptanceFunctionType m_savedTwtAcceptance;					//!< Acceptance function replaced by the scheduling
+		TWTAlternativeConfigurationFunctionType m_savedTwtAlternative; //!< Alternative function replaced by the scheduling
+		Time m_twtGuardInterval;					 //!< Minimum time between two service periods
+		uint32_t m_twtFrameSize;					 //!< Size of the frame exchanged in a service period
+		Time m_twtSetupDelay;							 //!< Minimum time from a proposal to its first service period
+		std::vector<TWTHeader> m_twtProposals; //!< Alternatives proposed to the STAs and not requested yet
+		Time m_beaconTxTime;							 //!< Duration of the last beacon
 
 		std::map<Mac48Address, bool> m_sleepList;
 		std::map<Mac48Address, bool> m_supportPageSlicingList;
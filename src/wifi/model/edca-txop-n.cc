@@ -320,6 +320,7 @@ EdcaTxopN::DoDispose (void)
   m_blockAckListener = 0;
   m_txMiddle = 0;
   m_aggregator = 0;
+  m_accessList = 0;
 }
 
 bool
@@ -375,6 +376,13 @@ EdcaTxopN::SetsleepCallback (sleepCallback callback)
   m_sleepCallback = callback;
 }
 
+void
+EdcaTxopN::SetAidLookupCallback (AidLookup callback)
+{
+  NS_LOG_FUNCTION (this << &callback);
+  m_aidLookup = callback;
+}
+
 void
 EdcaTxopN::SetWifiRemoteStationManager (Ptr<WifiRemoteStationManager> remoteManager)
 {
@@ -497,9 +505,9 @@ EdcaTxopN::RemoveRetransmitPacket (uint8_t tid, Mac48Address recipient, uint16_t
 }
 
 void
-EdcaTxopN::SetaccessList (std::map<Mac48Address, bool> list)
+EdcaTxopN::SetaccessList (Ptr<const RawSlotAccessList> list)
 {
-    m_accessList = list;
+  m_accessList = list;
 }
 
 void
@@ -561,6 +569,15 @@ EdcaTxopN::NotifyAccessGranted (void)
                 }
 
              //}
+          if (m_accessList != 0 && !m_currentHdr.GetAddr1 ().IsGroup () && !m_aidLookup.IsNull ())
+            {
+              uint16_t aid = m_aidLookup (m_currentHdr.GetAddr1 ());
+              if (aid != 0 && !m_accessList->IsAllowed (aid))
+                {
+                  NS_LOG_DEBUG ("AID " << aid << " is not allowed in the current RAW slot");
+                  return;
+                }
+            }
           // TODO implement restrictions regarding non-Cross slot boundary
           m_currentPacket = m_queue->DequeueFirstAvailable (&m_currentHdr, m_currentPacketTimestamp, m_qosBlockedDestinations);
           NS_ASSERT (m_currentPacket != 0);
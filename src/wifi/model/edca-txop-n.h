@@ -32,6 +32,7 @@
 #include "dcf.h"
 #include "ctrl-headers.h"
 #include "block-ack-manager.h"
+#include "rps.h"
 #include <map>
 #include <list>
 #include "ns3/traced-callback.h"
@@ -95,6 +96,10 @@ public:
   typedef Callback <void, const WifiMacHeader&> TxFailed;  
   
   typedef Callback <void, bool> sleepCallback;
+  /**
+   * typedef for a callback returning the AID of a station, or 0 if it has none.
+   */
+  typedef Callback <uint16_t, Mac48Address> AidLookup;
   
   typedef void (* CollisionCallback)(uint32_t nrOfSlotsToBackOff);
 
@@ -144,6 +149,12 @@ public:
    * packet transmission was completed to check if the queue is empty.
    */
   void SetsleepCallback (sleepCallback callback);
+  /**
+   * \param callback the callback to invoke to get the AID of the
+   * receiver of a frame, which the access list of a RAW slot is checked
+   * against.
+   */
+  void SetAidLookupCallback (AidLookup callback);
   
   /**
    * Set WifiRemoteStationsManager this EdcaTxopN is associated to.
@@ -494,7 +505,14 @@ public:
   void RawStart (Time duration, bool crossSlotBoundaryAllowed);
   void OutsideRawStart (void);
   
-  void SetaccessList (std::map<Mac48Address, bool> list);
+  /**
+   * During a RAW slot, frames are only sent to the stations of the access
+   * list of the slot.
+   *
+   * \param list the stations allowed to access the channel in the current
+   * RAW slot, or 0 outside of the RAW slots
+   */
+  void SetaccessList (Ptr<const RawSlotAccessList> list);
   void SetsleepList (std::map<Mac48Address, bool> list);
 
 
@@ -568,6 +586,7 @@ private:
   TxOk m_txOkCallback;
   TxFailed m_txFailedCallback;   
   sleepCallback m_sleepCallback;
+  AidLookup m_aidLookup;
   Ptr<MacLow> m_low;
   MacTxMiddle *m_txMiddle;
   TransmissionListener *m_transmissionListener;
@@ -596,7 +615,7 @@ private:
   struct Bar m_currentBar;
   bool m_ampduExist;
   
-  std::map<Mac48Address, bool> m_accessList;
+  Ptr<const RawSlotAccessList> m_accessList; //!< stations allowed in the current RAW slot
   
   TracedCallback<uint32_t> m_collisionTrace;
   TracedCallback<Time,Time> m_transmissionWillCrossRAWBoundary;
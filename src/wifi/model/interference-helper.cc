@@ -24,7 +24,6 @@
 #include "error-rate-model.h"
 #include "ns3/simulator.h"
 #include "ns3/log.h"
-#include <algorithm>
 
 namespace ns3 {
 
@@ -36,11 +35,11 @@ NS_LOG_COMPONENT_DEFINE ("InterferenceHelper");
 
 InterferenceHelper::Event::Event (uint32_t size, WifiTxVector txVector,
                                   enum WifiPreamble preamble,
-                                  Time duration, double rxPower)
+                                  Time startTime, Time duration, double rxPower)
   : m_size (size),
     m_txVector (txVector),
     m_preamble (preamble),
-    m_startTime (Simulator::Now ()),
+    m_startTime (startTime),
     m_endTime (m_startTime + duration),
     m_rxPowerW (rxPower)
 {
@@ -129,6 +128,66 @@ InterferenceHelper::NiChange::operator < (const InterferenceHelper::NiChange& o)
 }
 
 
+InterferenceHelper::NiChangeIterator::NiChangeIterator (const NiChanges &niChanges, double firstPower,
+                                                        Ptr<const InterferenceHelper::Event> event)
+  : m_niChanges (niChanges),
+    m_event (event),
+    m_stored (niChanges.begin ()),
+    m_current (event->GetStartTime (), firstPower),
+    m_position (FIRST)
+{
+  //The first stored change is the one summed up in firstPower
+  if (m_stored != m_niChanges.end ())
+    {
+      m_stored++;
+    }
+}
+
+bool
+InterferenceHelper::NiChangeIterator::IsEnd (void) const
+{
+  return m_position == END;
+}
+
+const InterferenceHelper::NiChange &
+InterferenceHelper::NiChangeIterator::operator * (void) const
+{
+  NS_ASSERT (m_position != END);
+  return m_position == STORED ? *m_stored : m_current;
+}
+
+void
+InterferenceHelper::NiChangeIterator::Next (void)
+{
+  switch (m_position)
+    {
+    case FIRST:
+      m_position = STORED;
+      break;
+    case STORED:
+      m_stored++;
+      break;
+    case LAST:
+      m_position = END;
+      return;
+    case END:
+      NS_FATAL_ERROR ("Walked past the end of the NI changes");
+      return;
+    }
+  if (m_stored == m_niChanges.end () || IsEventEnd ())
+    {
+      m_current = NiChange (m_event->GetEndTime (), 0);
+      m_position = LAST;
+    }
+}
+
+bool
+InterferenceHelper::NiChangeIterator::IsEventEnd (void) const
+{
+  return (m_event->GetEndTime () == m_stored->GetTime ()) && m_event->GetRxPowerW () == -m_stored->GetDelta ();
+}
+
+
 /****************************************************************
  *       The actual InterferenceHelper
  ****************************************************************/
@@ -136,7 +195,10 @@ InterferenceHelper::NiChange::operator < (const InterferenceHelper::NiChange& o)
 InterferenceHelper::InterferenceHelper ()
   : m_errorRateModel (0),
     m_firstPower (0.0),
-    m_rxing (false)
+    m_rxing (false),
+    m_energyCursorW (0.0),
+    m_energyThresholdW (0.0),
+    m_energyCursorValid (false)
 {
 }
 
@@ -149,13 +211,14 @@ InterferenceHelper::~InterferenceHelper ()
 Ptr<InterferenceHelper::Event>
 InterferenceHelper::Add (uint32_t size, WifiTxVector txVector,
                          enum WifiPreamble preamble,
-                         Time duration, double rxPowerW)
+                         Time startTime, Time duration, double rxPowerW)
 {
   Ptr<InterferenceHelper::Event> event;
 
   event = Create<InterferenceHelper::Event> (size,
                                              txVector,
                                              preamble,
+                                             startTime,
                                              duration,
                                              rxPowerW);
   AppendEvent (event);
@@ -191,22 +254,48 @@ Time
 InterferenceHelper::GetEnergyDuration (double energyW)
 {
   Time now = Simulator::Now ();
-  double noiseInterferenceW = 0.0;
+  double noiseInterferenceW = m_firstPower;
   Time end = now;
-  noiseInterferenceW = m_firstPower;
-  for (NiChanges::const_iterator i = m_niChanges.begin (); i != m_niChanges.end (); i++)
+  NiChanges::const_iterator i = m_niChanges.begin ();
+  //Whether the changes from m_energyCheckedFrom to the current one all left
+  //the power above the threshold
+  bool checked = false;
+  if (m_energyCursorValid && energyW == m_energyThresholdW)
+    {
+      //The changes added since the last call, if any, were all inserted after
+      //m_energyCheckedFrom, so none of the changes before the cursor can stop
+      //the walk now.
+      i = m_energyCursor;
+      noiseInterferenceW = m_energyCursorW;
+      checked = true;
+    }
+  for (; i != m_niChanges.end (); i++)
     {
+      m_energyCursor = i;
+      m_energyCursorW = noiseInterferenceW;
+      m_energyCursorValid = true;
       noiseInterferenceW += i->GetDelta ();
       end = i->GetTime ();
       if (end < now)
         {
+          checked = false;
           continue;
         }
+      if (!checked)
+        {
+          m_energyCheckedFrom = end;
+          checked = true;
+        }
       if (noiseInterferenceW < energyW)
         {
           break;
         }
     }
+  if (!checked)
+    {
+      m_energyCheckedFrom = Time::Max ();
+    }
+  m_energyThresholdW = energyW;
   return end > now ? end - now : MicroSeconds (0);
 }
 
@@ -221,15 +310,16 @@ InterferenceHelper::AppendEvent (Ptr<InterferenceHelper::Event> event)
         {
           m_firstPower += i->GetDelta ();
         }
+      if (m_energyCursorValid && m_energyCursor->GetTime () <= now)
+        {
+          m_energyCursorValid = false;
+        }
       m_niChanges.erase (m_niChanges.begin (), nowIterator);
-      m_niChanges.insert (m_niChanges.begin (), NiChange (event->GetStartTime (), event->GetRxPowerW ()));
-    }
-  else
-    {
-      AddNiChangeEvent (NiChange (event->GetStartTime (), event->GetRxPowerW ()));
     }
+  //A signal handed over late starts before now, before the changes left:
+  //the power from its start until now is taken to be m_firstPower
+  AddNiChangeEvent (NiChange (event->GetStartTime (), event->GetRxPowerW ()));
   AddNiChangeEvent (NiChange (event->GetEndTime (), -event->GetRxPowerW ()));
-
 }
 
 
@@ -249,21 +339,10 @@ InterferenceHelper::CalculateSnr (double signal, double noiseInterference, WifiM
 }
 
 double
-InterferenceHelper::CalculateNoiseInterferenceW (Ptr<InterferenceHelper::Event> event, NiChanges *ni) const
+InterferenceHelper::CalculateNoiseInterferenceW (Ptr<InterferenceHelper::Event> event) const
 {
-  double noiseInterference = m_firstPower;
   NS_ASSERT (m_rxing);
-  for (NiChanges::const_iterator i = m_niChanges.begin () + 1; i != m_niChanges.end (); i++)
-    {
-      if ((event->GetEndTime () == i->GetTime ()) && event->GetRxPowerW () == -i->GetDelta ())
-        {
-          break;
-        }
-      ni->push_back (*i);
-    }
-  ni->insert (ni->begin (), NiChange (event->GetStartTime (), noiseInterference));
-  ni->push_back (NiChange (event->GetEndTime (), 0));
-  return noiseInterference;
+  return m_firstPower;
 }
 
 double
@@ -280,11 +359,11 @@ InterferenceHelper::CalculateChunkSuccessRate (double snir, Time duration, WifiM
 }
 
 double
-InterferenceHelper::CalculatePlcpPayloadPer (Ptr<const InterferenceHelper::Event> event, NiChanges *ni) const
+InterferenceHelper::CalculatePlcpPayloadPer (Ptr<const InterferenceHelper::Event> event) const
 {
   NS_LOG_FUNCTION (this);
   double psr = 1.0; /* Packet Success Rate */
-  NiChanges::iterator j = ni->begin ();
+  NiChangeIterator j (m_niChanges, m_firstPower, event);
   Time previous = (*j).GetTime ();
   WifiMode payloadMode = event->GetPayloadMode ();
   WifiPreamble preamble = event->GetPreambleType ();
@@ -315,8 +394,8 @@ InterferenceHelper::CalculatePlcpPayloadPer (Ptr<const InterferenceHelper::Event
    }
   double noiseInterferenceW = (*j).GetDelta ();
   double powerW = event->GetRxPowerW ();
-  j++;
-  while (ni->end () != j)
+  j.Next ();
+  while (!j.IsEnd ())
     {
       Time current = (*j).GetTime ();
       NS_LOG_DEBUG ("previous= " << previous << ", current=" << current);
@@ -345,7 +424,7 @@ InterferenceHelper::CalculatePlcpPayloadPer (Ptr<const InterferenceHelper::Event
 
       noiseInterferenceW += (*j).GetDelta ();
       previous = (*j).GetTime ();
-      j++;
+      j.Next ();
     }
 
   double per = 1 - psr;
@@ -353,11 +432,11 @@ InterferenceHelper::CalculatePlcpPayloadPer (Ptr<const InterferenceHelper::Event
 }
 
 double
-InterferenceHelper::CalculatePlcpHeaderPer (Ptr<const InterferenceHelper::Event> event, NiChanges *ni) const
+InterferenceHelper::CalculatePlcpHeaderPer (Ptr<const InterferenceHelper::Event> event) const
 {
   NS_LOG_FUNCTION (this);
   double psr = 1.0; /* Packet Success Rate */
-  NiChanges::iterator j = ni->begin ();
+  NiChangeIterator j (m_niChanges, m_firstPower, event);
   Time previous = (*j).GetTime ();
   WifiMode payloadMode = event->GetPayloadMode ();
   WifiPreamble preamble = event->GetPreambleType ();
@@ -395,8 +474,8 @@ else
  }
   double noiseInterferenceW = (*j).GetDelta ();
   double powerW = event->GetRxPowerW ();
-  j++;
-  while (ni->end () != j)
+  j.Next ();
+  while (!j.IsEnd ())
     {
       Time current = (*j).GetTime ();
       NS_LOG_DEBUG ("previous= " << previous << ", current=" << current);
@@ -679,7 +758,7 @@ else
 
       noiseInterferenceW += (*j).GetDelta ();
       previous = (*j).GetTime ();
-      j++;
+      j.Next ();
     }
 
   double per = 1 - psr;
@@ -689,8 +768,7 @@ else
 struct InterferenceHelper::SnrPer
 InterferenceHelper::CalculatePlcpPayloadSnrPer (Ptr<InterferenceHelper::Event> event)
 {
-  NiChanges ni;
-  double noiseInterferenceW = CalculateNoiseInterferenceW (event, &ni);
+  double noiseInterferenceW = CalculateNoiseInterferenceW (event);
   double snr = CalculateSnr (event->GetRxPowerW (),
                              noiseInterferenceW,
                              event->GetPayloadMode ());
@@ -698,7 +776,7 @@ InterferenceHelper::CalculatePlcpPayloadSnrPer (Ptr<InterferenceHelper::Event> e
   /* calculate the SNIR at the start of the packet and accumulate
    * all SNIR changes in the snir vector.
    */
-  double per = CalculatePlcpPayloadPer (event, &ni);
+  double per = CalculatePlcpPayloadPer (event);
 
   struct SnrPer snrPer;
   snrPer.snr = snr;
@@ -709,8 +787,7 @@ InterferenceHelper::CalculatePlcpPayloadSnrPer (Ptr<InterferenceHelper::Event> e
 struct InterferenceHelper::SnrPer
 InterferenceHelper::CalculatePlcpHeaderSnrPer (Ptr<InterferenceHelper::Event> event)
 {
-  NiChanges ni;
-  double noiseInterferenceW = CalculateNoiseInterferenceW (event, &ni);
+  double noiseInterferenceW = CalculateNoiseInterferenceW (event);
   double snr = CalculateSnr (event->GetRxPowerW (),
                              noiseInterferenceW,
                              WifiPhy::GetPlcpHeaderMode (event->GetPayloadMode (), event->GetPreambleType ()));
@@ -718,7 +795,7 @@ InterferenceHelper::CalculatePlcpHeaderSnrPer (Ptr<InterferenceHelper::Event> ev
   /* calculate the SNIR at the start of the plcp header and accumulate
    * all SNIR changes in the snir vector.
    */
-  double per = CalculatePlcpHeaderPer (event, &ni);
+  double per = CalculatePlcpHeaderPer (event);
 
   struct SnrPer snrPer;
   snrPer.snr = snr;
@@ -732,18 +809,31 @@ InterferenceHelper::EraseEvents (void)
   m_niChanges.clear ();
   m_rxing = false;
   m_firstPower = 0.0;
+  m_energyCursorValid = false;
 }
 
 InterferenceHelper::NiChanges::iterator
 InterferenceHelper::GetPosition (Time moment)
 {
-  return std::upper_bound (m_niChanges.begin (), m_niChanges.end (), NiChange (moment, 0));
+  return m_niChanges.upper_bound (NiChange (moment, 0));
 }
 
 void
 InterferenceHelper::AddNiChangeEvent (NiChange change)
 {
-  m_niChanges.insert (GetPosition (change.GetTime ()), change);
+  //Inserted after the changes at the same time, so after the energy cursor
+  //unless it is earlier
+  if (m_energyCursorValid && change.GetTime () < m_energyCursor->GetTime ())
+    {
+      if (change.GetTime () < m_energyCheckedFrom)
+        {
+          //The power before the change may be below the threshold, so that
+          //the change may stop the walk before the cursor
+          m_energyCursorValid = false;
+        }
+      m_energyCursorW += change.GetDelta ();
+    }
+  m_niChanges.insert (change);
 }
 
 void
@@ -24,6 +24,7 @@
 #include <stdint.h>
 #include <vector>
 #include <list>
+#include <set>
 #include "wifi-mode.h"
 #include "wifi-preamble.h"
 #include "wifi-phy-standard.h"
@@ -31,6 +32,8 @@
 #include "ns3/simple-ref-count.h"
 #include "ns3/wifi-tx-vector.h"
 
+class InterferenceHelperNiChangesTest;
+
 namespace ns3 {
 
 class ErrorRateModel;
@@ -42,6 +45,8 @@ class ErrorRateModel;
 class InterferenceHelper
 {
 public:
+  // Allow test cases to access private members
+  friend class ::InterferenceHelperNiChangesTest;
   /**
    * Signal event for a packet.
    */
@@ -54,13 +59,14 @@ public:
      * \param size packet size
      * \param txvector TXVECTOR of the packet
      * \param preamble preamble type
+     * \param startTime arrival time of the first bit of the signal
      * \param duration duration of the signal
      * \param rxPower the receive power (w)
      * \param txvector TXVECTOR of the packet
      */
     Event (uint32_t size, WifiTxVector txvector,
            enum WifiPreamble preamble,
-           Time duration, double rxPower);
+           Time startTime, Time duration, double rxPower);
     ~Event ();
 
     /**
@@ -175,6 +181,8 @@ private:
    * \param size packet size
    * \param txvector TXVECTOR of the packet
    * \param preamble Wi-Fi preamble for the packet
+   * \param startTime arrival time of the first bit of the signal, now or
+   *        earlier if the packet was handed over late
    * \param duration the duration of the signal
    * \param rxPower receive power (W)
    *
@@ -182,7 +190,7 @@ private:
    */
   Ptr<InterferenceHelper::Event> Add (uint32_t size, WifiTxVector txvector,
                                       enum WifiPreamble preamble,
-                                      Time duration, double rxPower);
+                                      Time startTime, Time duration, double rxPower);
 
   /**
    * Calculate the SNIR at the start of the plcp payload and accumulate
@@ -257,14 +265,64 @@ private:
     double m_delta;
   };
   /**
-   * typedef for a vector of NiChanges
+   * typedef for a sorted tree of NiChanges. Changes at the same time keep
+   * their order of insertion, so insertion costs O(log n) and the oldest
+   * changes expire cheaply however many signals overlap.
    */
-  typedef std::vector <NiChange> NiChanges;
+  typedef std::multiset <NiChange> NiChanges;
   /**
    * typedef for a list of Events
    */
   typedef std::list<Ptr<Event> > Events;
 
+  /**
+   * Walks, without copying them, the NI changes seen by an event: the
+   * noise and interference at the start of the event, the stored changes
+   * after the first one up to the end of the event, then the end of the
+   * event.
+   */
+  class NiChangeIterator
+  {
+public:
+    /**
+     * \param niChanges the NI changes stored by the helper
+     * \param firstPower the noise and interference at the start of the event
+     * \param event the event being received
+     */
+    NiChangeIterator (const NiChanges &niChanges, double firstPower, Ptr<const Event> event);
+    /**
+     * \return true once all the NI changes seen by the event have been walked
+     */
+    bool IsEnd (void) const;
+    /**
+     * \return the current NI change
+     */
+    const NiChange & operator * (void) const;
+    /**
+     * Move to the next NI change.
+     */
+    void Next (void);
+
+
+private:
+    /**
+     * \return true if the current stored NI change is the end of the event
+     */
+    bool IsEventEnd (void) const;
+
+    const NiChanges &m_niChanges;       //!< NI changes stored by the helper
+    Ptr<const Event> m_event;           //!< event being received
+    NiChanges::const_iterator m_stored; //!< current stored NI change
+    NiChange m_current;                 //!< current NI change, when it is not a stored one
+    enum
+    {
+      FIRST,  //!< at the NI at the start of the event
+      STORED, //!< at a stored NI change
+      LAST,   //!< at the end of the event
+      END     //!< past the end of the event
+    } m_position;                       //!< where the walk is
+  };
+
   /**
    * Append the given Event.
    *
@@ -275,11 +333,10 @@ private:
    * Calculate noise and interference power in W.
    *
    * \param event
-   * \param ni
    *
    * \return noise and interference power
    */
-  double CalculateNoiseInterferenceW (Ptr<Event> event, NiChanges *ni) const;
+  double CalculateNoiseInterferenceW (Ptr<Event> event) const;
   /**
    * Calculate SNR (linear ratio) from the given signal power and noise+interference power.
    * (Mode is not currently used)
@@ -307,21 +364,19 @@ private:
    * multiple chunks (e.g. due to interference from other transmissions).
    *
    * \param event
-   * \param ni
    *
    * \return the error rate of the packet
    */
-  double CalculatePlcpPayloadPer (Ptr<const Event> event, NiChanges *ni) const;
+  double CalculatePlcpPayloadPer (Ptr<const Event> event) const;
   /**
    * Calculate the error rate of the plcp header. The plcp header can be divided into
    * multiple chunks (e.g. due to interference from other transmissions).
    *
    * \param event
-   * \param ni
    *
    * \return the error rate of the packet
    */
-  double CalculatePlcpHeaderPer (Ptr<const Event> event, NiChanges *ni) const;
+  double CalculatePlcpHeaderPer (Ptr<const Event> event) const;
 
   double m_noiseFigure; /**< noise figure (linear) */
   Ptr<ErrorRateModel> m_errorRateModel;
@@ -329,6 +384,11 @@ private:
   NiChanges m_niChanges;
   double m_firstPower;
   bool m_rxing;
+  NiChanges::const_iterator m_energyCursor; //!< NI change where GetEnergyDuration last stopped
+  double m_energyCursorW;                   //!< noise and interference power (W) before m_energyCursor
+  double m_energyThresholdW;                //!< energy (W) requested by the last GetEnergyDuration
+  bool m_energyCursorValid;                 //!< whether m_energyCursor can be resumed from
+  Time m_energyCheckedFrom;                 //!< time of the first NI change checked by GetEnergyDuration: from it to m_energyCursor, every change left the power above the threshold
   /// Returns an iterator to the first nichange, which is later than moment
   NiChanges::iterator GetPosition (Time moment);
   /**
@@ -87,6 +87,9 @@ namespace ns3
 		m_twtEndOfWakePeriodCallback = nullptr;
 
 		m_computeNextTwtValue = computeNextTwtValue;
+
+		m_twtAgreements.SetBoundaryCallbacks(MakeCallback(&RegularWifiMac::HandleStartOfWakePeriod, this),
+																				 MakeCallback(&RegularWifiMac::HandleEndOfWakePeriod, this));
 	}
 
 	void RegularWifiMac::OnQueuePacketDropped(std::string context, Ptr<const Packet> packet, DropReason reason)
@@ -144,6 +147,8 @@ namespace ns3
 		for (EdcaQueues::iterator i = m_edca.begin(); i != m_edca.end(); ++i) {
 			i->second = 0;
 		}
+
+		m_twtAgreements.Clear();
 	}
 
 	void RegularWifiMac::SetWifiRemoteStationManager(Ptr<WifiRemoteStationManager> stationManager)
@@ -573,14 +578,11 @@ namespace ns3
 
 	std::vector<TWTAgreementData *> RegularWifiMac::GetTwtAgreements(const Mac48Address &addr)
 	{
+		std::vector<TwtTimeline::Handle> handles;
+		m_twtAgreements.GetAgreements(addr, handles);
 		std::vector<TWTAgreementData *> ret;
-		for (uint8_t i = 0u; i < 8; ++i) {
-			// Iterate over all possible flow identifiers
-			auto key = TWTAgreementKey{addr, i};
-			auto *result = GetTwtAgreementIfExists(key);
-			if (result != nullptr) {
-				ret.push_back(result);
-			}
+		for (auto handle : handles) {
+			ret.push_back(&m_twtAgreements.GetData(handle));
 		}
 		return ret;
 	}
@@ -743,6 +745,9 @@ namespace ns3
 														"Fired when a transmission is held off because it won't fit inside the RAW slot",
 														MakeTraceSourceAccessor(&RegularWifiMac::m_transmissionWillCrossRAWBoundary),
 														"ns3::RegularWifiMac::TransmissionWillCrossRAWBoundaryCallback")
+						.AddTraceSource("TwtEvent", "Fired when a TWT agreement is set up or torn down, a service period starts or ends, "
+																				"or a frame is buffered until the next service period",
+														MakeTraceSourceAccessor(&RegularWifiMac::m_twtEventTrace), "ns3::TwtEvent::TracedCallback")
 
 				;
 		return tid;
@@ -796,9 +801,9 @@ namespace ns3
 	}
 	TWTAgreementData *RegularWifiMac::GetTwtAgreementIfExists(const TWTAgreementKey &key)
 	{
-		auto location = m_twtAgreements.find(key);
-		if (location != m_twtAgreements.end()) {
-			return &(location->second);
+		auto handle = m_twtAgreements.Find(key);
+		if (handle != TwtTimeline::INVALID_HANDLE) {
+			return &m_twtAgreements.GetData(handle);
 		}
 		// No such agreement
 		return nullptr;
@@ -877,7 +882,7 @@ namespace ns3
 	}
 	void RegularWifiMac::HandleTwtAnnouncementFrame(Ptr<Packet> packet, const WifiMacHeader *hdr)
 	{
-		NS_LOG_UNCOND("Handling TWT Announcement frame.");
+		NS_LOG_DEBUG("Handling TWT Announcement frame.");
 		auto agreements = GetTwtAgreements(hdr->GetAddr2());
 		for (auto agreement : agreements) {
 			if (agreement->IsActive()) {
@@ -885,7 +890,7 @@ namespace ns3
 				this->HandleStartOfWakePeriod(key, *agreement);
 			}
 		}
-		NS_LOG_UNCOND("Activated ALL twt agreements trigger frame could apply to.");
+		NS_LOG_DEBUG("Activated ALL twt agreements trigger frame could apply to.");
 		return;
 	}
 	void RegularWifiMac::HandleTwtFrame(Ptr<Packet> packet, const WifiMacHeader *hdr)
@@ -895,7 +900,7 @@ namespace ns3
 		static std::set<uint64_t> previous{};
 		auto tag = TwtPacketTag::FromPacket(packet);
 		if (previous.find(tag.id) != previous.end()) {
-			NS_LOG_UNCOND("Encountered duplicate TWT frame (id=" << tag.id << "), dropping...");
+			NS_LOG_DEBUG("Encountered duplicate TWT frame (id=" << tag.id << "), dropping...");
 			NotifyRxDrop(packet);
 			return;
 		}
@@ -911,18 +916,18 @@ namespace ns3
 		// TWT Acknowledgement handling
 		SendTwtAcknowledgmentIfNecessary(packet, hdr, twtHeader);
 
-		NS_LOG_UNCOND("Received non-duplicate TWT frame, id = " << tag.id);
+		NS_LOG_DEBUG("Received non-duplicate TWT frame, id = " << tag.id);
 		if (twtHeader.IsTwtConfirmationFrame()) {
-			NS_LOG_UNCOND("TWT frame is confirmation.");
+			NS_LOG_DEBUG("TWT frame is confirmation.");
 			HandleTwtConfirmationFrame(packet, hdr, &twtHeader);
 		} else if (twtHeader.IsTwtTeardownFrame()) {
-			NS_LOG_UNCOND("TWT frame is Teardown.");
+			NS_LOG_DEBUG("TWT frame is Teardown.");
 			HandleTwtTeardownFrame(packet, hdr, &twtHeader);
 		} else if (twtHeader.IsTwtInformationFrame()) {
-			NS_LOG_UNCOND("TWT frame is Information.");
+			NS_LOG_DEBUG("TWT frame is Information.");
 			HandleTwtInformationFrame(packet, hdr, &twtHeader);
 		} else if (twtHeader.IsTwtSetupFrame()) {
-			NS_LOG_UNCOND("TWT frame is Setup.");
+			NS_LOG_DEBUG("TWT frame is Setup.");
 			HandleTwtSetupFrame(packet, hdr, &twtHeader);
 		} else {
 			NS_ASSERT_MSG(false, "Support for this twt frame type is not yet implemented.");
@@ -937,9 +942,11 @@ namespace ns3
 		// I believe ns3 time shouldn't progress while we're looping over this but better safe than sorry.
 		// Would cause rather hard to find non-compliant behaviour if the assumption were wrong
 		Time now = Simulator::Now();
-		for (const auto &agreement : m_twtAgreements) {
+		std::vector<TwtTimeline::Handle> handles;
+		m_twtAgreements.GetAgreements(handles);
+		for (auto handle : handles) {
 			// Get the target wake time stored in the agreement
-			auto timeUntilAgreement = agreement.second.header.GetTargetWakeTime() - now;
+			auto timeUntilAgreement = m_twtAgreements.GetData(handle).header.GetTargetWakeTime() - now;
 			if (timeUntilAgreement < closest)
 				closest = timeUntilAgreement;
 		}
@@ -949,15 +956,11 @@ namespace ns3
 	{
 		Time closest = Time::Max();
 		Time now = Simulator::Now();
-		std::list<std::reference_wrapper<const TWTAgreementData>> agreements;
-		for (const auto &agreement : m_twtAgreements) {
-			if (agreement.first.macAddress == APMacAddress) {
-				agreements.emplace_back(std::ref(agreement.second));
-			}
-		}
-		for (const auto &agreementData : agreements) {
+		std::vector<TwtTimeline::Handle> handles;
+		m_twtAgreements.GetAgreements(APMacAddress, handles);
+		for (auto handle : handles) {
 			// Get the target wake time stored in the agreement
-			auto timeUntilAgreement = agreementData.get().header.GetTargetWakeTime() - now;
+			auto timeUntilAgreement = m_twtAgreements.GetData(handle).header.GetTargetWakeTime() - now;
 			if (timeUntilAgreement < closest)
 				closest = timeUntilAgreement;
 		}
@@ -971,8 +974,8 @@ namespace ns3
 	void RegularWifiMac::SendTwtSetupFrame(const Mac48Address &destination)
 	{
 		NS_ASSERT_MSG(this->GetConfiguredStandard() == WifiPhyStandard::WIFI_PHY_STANDARD_80211ah, "TWT only implemented for 802.11ah");
-		NS_LOG_UNCOND("Time @ twt setup frame entry: " << Simulator::Now().GetMilliSeconds());
-		NS_LOG_UNCOND("SendTwtSetupFrame START.");
+		NS_LOG_DEBUG("Time @ twt setup frame entry: " << Simulator::Now().GetMilliSeconds());
+		NS_LOG_DEBUG("SendTwtSetupFrame START.");
 
 		Ptr<Packet> packet = Create<Packet>();
 		// Packet structure: Inner-most header to outermost.
@@ -1038,15 +1041,15 @@ namespace ns3
 
 		this->QueueWithTwt(packet, macHeader);
 
-		NS_LOG_UNCOND("Scheduling packet send to TWT resp station now!");
+		NS_LOG_DEBUG("Scheduling packet send to TWT resp station now!");
 		Simulator::Schedule(Time::FromInteger(1u, Time::Unit::S), &RegularWifiMac::SendTwtTestTraffic, this, destination);
 
-		NS_LOG_UNCOND("SendTwtSetupFrame STOP.");
+		NS_LOG_DEBUG("SendTwtSetupFrame STOP.");
 	}
 	void RegularWifiMac::SendTwtTestTraffic(Mac48Address to)
 	{
 		static std::set<uint64_t> mytags;
-		NS_LOG_UNCOND("Send twt test traffic fired!");
+		NS_LOG_DEBUG("Send twt test traffic fired!");
 
 		auto packet = Create<Packet>(150);
 		WifiMacHeader hdr;
@@ -1059,16 +1062,18 @@ namespace ns3
 		TwtPacketTag mytag = TwtPacketTag::Create();
 		packet->AddPacketTag(mytag);
 		mytags.insert(mytag.id);
-		const char *sep = "";
-		const auto sepActual = ", ";
-		std::stringstream ss;
-		ss << "[";
-		for (auto it = mytags.begin(); it != mytags.end(); ++it) {
-			ss << sep << *it;
-			sep = sepActual;
+		if (g_log.IsEnabled(LOG_DEBUG)) {
+			const char *sep = "";
+			const auto sepActual = ", ";
+			std::stringstream ss;
+			ss << "[";
+			for (auto it = mytags.begin(); it != mytags.end(); ++it) {
+				ss << sep << *it;
+				sep = sepActual;
+			}
+			ss << "]";
+			NS_LOG_DEBUG("SENT = " << ss.str());
 		}
-		ss << "]";
-		NS_LOG_UNCOND("SENT = " << ss.str());
 		this->QueueWithTwt(packet, hdr);
 
 		Simulator::Schedule(Seconds(2), &RegularWifiMac::SendTwtTestTraffic, this, to);
@@ -1076,30 +1081,19 @@ namespace ns3
 
 	void RegularWifiMac::QueueWithTwt(Ptr<Packet> packet, const WifiMacHeader &header)
 	{
-		NS_LOG_UNCOND("Sending packet with twt functionality");
 		// Check for TWT agreements with the destination
 		auto dest = header.GetAddr1();
-		auto agreements = GetTwtAgreements(dest);
-		if (agreements.empty()) {
+		if (!m_twtAgreements.HasAgreements(dest)) {
 			// If none found, send without TWT
-			NS_LOG_UNCOND("No TWT agreements active for this mac address - sending immediately.");
 			m_dca->Queue(packet, header);
 			return;
 		}
-		bool anyActive = false;
 		// Check if we have any active TWT service periods.
-		for (auto agreement : agreements) {
-			if (agreement->IsActive()) {
-				anyActive = true;
-				break;
-			}
-		}
-		if (anyActive) {
-			NS_LOG_UNCOND("TWT agreement found, currently in active SP. Sending immediately.");
+		if (m_twtAgreements.IsInServicePeriod(dest)) {
 			// We're allowed to send packets currently
 			m_dca->Queue(packet, header);
 		} else {
-			NS_LOG_UNCOND("TWT agreement found, not in any active SP. Queueing the packet.");
+			NS_LOG_LOGIC("Buffering the frame to " << dest << " until the next TWT service period");
 			// Else queue them until we get another TWT wake-up
 			auto loc = m_twtPacketQueue.find(dest);
 			if (loc == m_twtPacketQueue.end()) {
@@ -1108,16 +1102,16 @@ namespace ns3
 			}
 			loc->second.push({packet, header});
 			// The queue will be emptied when a TWT agreement's wake-up time happens or when it is torn down
+			NotifyTwtEvent(TWT_EVENT_QUEUED, TWTAgreementKey{dest, TwtEvent::TWT_EVENT_ANY_FLOW}, Seconds(0), Seconds(0), 0);
 		}
 	}
 
 	void RegularWifiMac::SendTwtTeardownFrame(const Mac48Address &destination, uint8_t flowId)
 	{
 		NS_ASSERT_MSG(this->GetConfiguredStandard() == WifiPhyStandard::WIFI_PHY_STANDARD_80211ah, "TWT only implemented for 802.11ah");
-		NS_LOG_UNCOND("Time @ twt teardown frame entry: " << ns3::Simulator::Now().GetMilliSeconds());
+		NS_LOG_FUNCTION(this << destination << static_cast<uint32_t>(flowId));
 		TWTAgreementKey key{destination, flowId};
-		auto location = m_twtAgreements.find(key);
-		if (location == m_twtAgreements.end()) {
+		if (m_twtAgreements.Find(key) == TwtTimeline::INVALID_HANDLE) {
 			NS_ASSERT_MSG(false, "Expected teardown frame to be for a TWT agreement we know of locally.");
 		}
 		Ptr<Packet> packet = Create<Packet>();
@@ -1134,9 +1128,7 @@ namespace ns3
 		macHeader.SetAddr4(GetAddress());
 		macHeader.SetType(WIFI_MAC_EXTENSION_TWT_FRAME);
 		packet->AddPacketTag(TwtPacketTag::Create());
-		NS_LOG_UNCOND("PRESEND PACKET SIZE: " << packet->GetSize());
 		this->QueueWithTwt(packet, macHeader);
-		NS_LOG_UNCOND("Successfully queued the TWT teardown frame.");
 		// TODO: For now we just assume send will succeed, but we need to verify that to be standard compliant
 		// Standard states either station can terminate a agreement by successfully transmitting OR receiving a
 		// TWT teardown frame. This means we do not need to wait for an accept message or similar, we simply
@@ -1146,39 +1138,57 @@ namespace ns3
 		// And in case of the TWT teardown message being transmitted, then calling this teardown function.
 		HandleLocalTwtTeardown(destination, flowId);
 	}
-	void RegularWifiMac::SendQueuedPackets(const Mac48Address &to)
+	uint32_t RegularWifiMac::SendQueuedPackets(const Mac48Address &to)
 	{
 		auto loc = m_twtPacketQueue.find(to);
 		if (loc == m_twtPacketQueue.end()) {
-			NS_LOG_UNCOND("Entered queued packet sent, but no packets queued.");
 			// This means we have no queued packets for this mac address, so this function is a no-op
-			return;
+			return 0;
 		}
 		auto &packets = loc->second;
-		NS_LOG_UNCOND("Sending queued packets to " << to << ", total = " << packets.size());
+		uint32_t flushed = packets.size();
+		NS_LOG_LOGIC("Sending " << flushed << " buffered frames to " << to);
 		while (!packets.empty()) {
 			auto packetData{packets.front()};
 			m_dca->Queue(packetData.packet, packetData.header);
 			packets.pop();
 		}
-		NS_LOG_UNCOND("Exit queued packet send.");
 		// Remove the entry from the queue, because we've just handled it.
 		m_twtPacketQueue.erase(loc);
+		return flushed;
+	}
+
+	void RegularWifiMac::NotifyTwtEvent(TwtEventType type, const TWTAgreementKey &key, Time spStart, Time spEnd, uint32_t flushed)
+	{
+		if (!NS_TRACE_IS_CONNECTED("TwtEvent", m_twtEventTrace)) {
+			return;
+		}
+		auto loc = m_twtPacketQueue.find(key.macAddress);
+		TwtEvent event;
+		event.time = Simulator::Now().GetNanoSeconds();
+		event.spStart = spStart.GetNanoSeconds();
+		event.spEnd = spEnd.GetNanoSeconds();
+		event.queued = loc == m_twtPacketQueue.end() ? 0 : loc->second.size();
+		event.flushed = flushed;
+		event.key = key;
+		event.type = type;
+		m_twtEventTrace(event);
 	}
 
 	void RegularWifiMac::HandleLocalTwtTeardown(const Mac48Address &destination, uint8_t flowId)
 	{
-		NS_LOG_UNCOND("Removing TWT agreement with destination " << destination << " and flow id " << static_cast<unsigned>(flowId));
-		auto loc = m_twtAgreements.find({destination, flowId});
-		NS_ASSERT(loc != m_twtAgreements.end());
-		auto &agreement = loc->second;
-		Simulator::Cancel(agreement.nextEvent);
-		m_twtAgreements.erase(loc);
-		if (GetTwtAgreements(destination).empty()) {
+		NS_LOG_DEBUG("Removing TWT agreement with destination " << destination << " and flow id " << static_cast<unsigned>(flowId));
+		auto handle = m_twtAgreements.Find({destination, flowId});
+		NS_ASSERT(handle != TwtTimeline::INVALID_HANDLE);
+		// This also cancels the next start or end of wake period of the agreement
+		m_twtAgreements.Remove(handle);
+		uint32_t flushed = 0;
+		if (!m_twtAgreements.HasAgreements(destination)) {
 			// Empty the packet queue if we deleted the last TWT session between us and destination
 			// Since we're no longer time constrained for our sending
-			this->SendQueuedPackets(destination);
+			flushed = this->SendQueuedPackets(destination);
 		}
+		NotifyTwtEvent(TWT_EVENT_TEARDOWN, TWTAgreementKey{destination, flowId}, Seconds(0), Seconds(0), flushed);
 		// Call the twtchangedcallback if it's set
 		if (m_twtChangedCallback) {
 			m_twtChangedCallback();
@@ -1190,8 +1200,7 @@ namespace ns3
 		NS_ASSERT_MSG(hdr->IsTwtFrame(), "Can't handle TWT confirmation from a non-twt frame");
 		NS_ASSERT_MSG(twtHeader->IsTwtConfirmationFrame(), "Can't handle TWT confirmation from non-confirmation frame.");
 		TWTAgreementKey key{hdr->GetAddr2(), twtHeader->GetFlowIdentifier()};
-		auto agreementLocation = m_twtAgreements.find(key);
-		if (agreementLocation != m_twtAgreements.end()) {
+		if (m_twtAgreements.Find(key) != TwtTimeline::INVALID_HANDLE) {
 			NS_ASSERT_MSG(false, "Attempted to insert second agreement with same flow id.");
 		}
 		CreateLocalTwtAgreement(*twtHeader, hdr->GetAddr2());
@@ -1203,13 +1212,12 @@ namespace ns3
 		auto flowId = twtHeader->GetFlowIdentifier();
 		TWTAgreementKey key{remote, flowId};
 		if (previous == key) {
-			NS_LOG_UNCOND("Encountered presumed duplicate twt teardown packet, ignoring...");
+			NS_LOG_DEBUG("Encountered presumed duplicate twt teardown packet, ignoring...");
 			previous = key;
 			return;
 		}
 		previous = key;
-		auto location = m_twtAgreements.find(key);
-		if (location == m_twtAgreements.end()) {
+		if (m_twtAgreements.Find(key) == TwtTimeline::INVALID_HANDLE) {
 			NS_ASSERT_MSG(false, "Expected teardown only of agreement we know of locally.");
 		}
 		// This removes the local agreement + handles callback if needed
@@ -1217,11 +1225,24 @@ namespace ns3
 	}
 	void RegularWifiMac::HandleTwtSetupFrame(Ptr<Packet> packet, const WifiMacHeader *hdr, TWTHeader *twtHeader)
 	{
+		if (!twtHeader->IsRequest()) {
+			// The responding station answered our request with other parameters
+			if (twtHeader->GetSetupCommand() == TWT_SETUPCOMMAND_ALTERNATE) {
+				// Request the alternative, which the responding station is expected to accept
+				TWTHeader request = *twtHeader;
+				request.SetRequest(true);
+				request.SetSetupCommand(TWT_SETUPCOMMAND_REQUEST);
+				SendTwtFrame(request, hdr->GetAddr2());
+			} else {
+				NS_LOG_DEBUG("TWT setup rejected by " << hdr->GetAddr2() << ", command " << +twtHeader->GetSetupCommand());
+			}
+			return;
+		}
 		NS_ASSERT(m_twtParameterAcceptanceFunction != nullptr);
 		bool acceptable = m_twtParameterAcceptanceFunction(*twtHeader);
 		if (acceptable) {
 			SendTwtConfirmationFrame(packet, hdr, twtHeader);
-			NS_LOG_UNCOND("Sending TWT confirmation frame, creating local agreement.");
+			NS_LOG_DEBUG("Sending TWT confirmation frame, creating local agreement.");
 			CreateLocalTwtAgreement(*twtHeader, hdr->GetAddr2());
 		} else {
 			SendTwtAlternativeFrame(packet, hdr, twtHeader);
@@ -1239,8 +1260,8 @@ namespace ns3
 			data.myRole = TWT_REQUESTING_STA;
 		}
 		// Creating the scheduled wake-up before emplacing for simplicity's sake
-		auto entry = m_twtAgreements.emplace(key, data);
-		if (!entry.second) {
+		auto handle = m_twtAgreements.Add(key, data);
+		if (handle == TwtTimeline::INVALID_HANDLE) {
 			NS_FATAL_ERROR("Emplacing local TWT agreement failed.");
 		}
 		// Callback if configured. This lets derived classes handle changes in TWT agreements.
@@ -1248,14 +1269,14 @@ namespace ns3
 		if (m_twtChangedCallback) {
 			m_twtChangedCallback();
 		}
-		NS_LOG_UNCOND("Created local TWT agreement. Map size: " << m_twtAgreements.size());
+		NS_LOG_DEBUG("Created local TWT agreement. Map size: " << m_twtAgreements.GetN());
+		NotifyTwtEvent(TWT_EVENT_SETUP, key, header.GetTargetWakeTime(), header.GetTargetWakeTime() + header.GetNominalMinimumWakeDuration(), 0);
 		auto wakeupDelay = header.GetTargetWakeTime() - Simulator::Now();
 		if (!(data.myRole == TWT_RESPONDING_STA && header.IsAnnouncedFlowType())) {
 			// In case of either a) an unnanounced TWT agreement
 			//                or b) us being the requesting station in an announced twt agreement
 			// We schedule a time-based wake up.
-			data.nextEvent =
-					Simulator::Schedule(wakeupDelay, &RegularWifiMac::HandleStartOfWakePeriod, this, entry.first->first, entry.first->second);
+			m_twtAgreements.ScheduleStart(handle, wakeupDelay);
 			// In the remaining case, (announced TWT agreement where we are the responding station),
 			// We will wake up when we receive a PS-Poll frame from the requesting station.
 		}
@@ -1267,11 +1288,15 @@ namespace ns3
 	std::list<const TWTHeader *> RegularWifiMac::GetTwtAgreements(const Mac48Address *addressPtr) const
 	{
 		std::list<const TWTHeader *> ret;
-		for (const auto &agreement : m_twtAgreements) {
-			// If nullptr, match all, else only those it compares equal to
-			if (addressPtr == nullptr || agreement.first.macAddress == *addressPtr) {
-				ret.push_back(&agreement.second.header);
-			}
+		std::vector<TwtTimeline::Handle> handles;
+		// If nullptr, match all, else only those it compares equal to
+		if (addressPtr == nullptr) {
+			m_twtAgreements.GetAgreements(handles);
+		} else {
+			m_twtAgreements.GetAgreements(*addressPtr, handles);
+		}
+		for (auto handle : handles) {
+			ret.push_back(&m_twtAgreements.GetData(handle).header);
 		}
 		return ret;
 	}
@@ -1280,7 +1305,7 @@ namespace ns3
 	{
 		// We've locally created the TWT agreement. Now, we must send a confirm message to the requesting STA.
 		TWTHeader twtconfirm = TWTHeader::CreateConfirmationHeader(*sourceTwtHeader);
-		NS_LOG_UNCOND(GetAddress() << " sending TWT confirm to " << sourceHeader->GetAddr2());
+		NS_LOG_DEBUG(GetAddress() << " sending TWT confirm to " << sourceHeader->GetAddr2());
 		SendTwtFrame(twtconfirm, sourceHeader->GetAddr2());
 	}
 
@@ -1319,7 +1344,11 @@ namespace ns3
 		data.header.SetTargetWakeTime(Time::FromInteger(localTime, Time::Unit::US));
 
 		if (data.waitingForNextTwt) {
-			this->HandleEndOfWakePeriod(key, data);
+			// The end of the last service period left the next start unscheduled
+			data.waitingForNextTwt = false;
+			Time delay = data.header.GetTargetWakeTime() - Simulator::Now();
+			NS_LOG_LOGIC("Scheduled start of wake period " << delay << " from now.");
+			m_twtAgreements.ScheduleStart(m_twtAgreements.Find(key), delay);
 		}
 
 		if (m_twtChangedCallback) {
@@ -1400,7 +1429,7 @@ namespace ns3
 	}
 	bool RegularWifiMac::HandleExplicitTwtTimeUpdateIfNeeded(TWTAgreementKey &key, TWTAgreementData &data)
 	{
-		if (!data.periodicTwtOverridden && data.myRole == TWT_REQUESTING_STA) {
+		if (data.myRole == TWT_REQUESTING_STA && data.header.GetTargetWakeTime() <= Simulator::Now()) {
 			// If we're the requesting STA and no next time has been established
 			// We need to explicitly poll the responding STA to do so here.
 			HandleTwtTimeUpdateMessage(key, data);
@@ -1411,20 +1440,33 @@ namespace ns3
 	}
 	void RegularWifiMac::HandleEndOfWakePeriod(TWTAgreementKey &agreementKey, TWTAgreementData &agreementData)
 	{
-		NS_LOG_UNCOND("Handling end of wake period! (" << static_cast<uint32_t>(agreementData.myRole) << ")");
-		NS_LOG_UNCOND(Simulator::Now());
+		NS_LOG_FUNCTION(this << agreementKey.macAddress << static_cast<uint32_t>(agreementKey.flowIdentifier)
+											<< static_cast<uint32_t>(agreementData.myRole));
+		NotifyTwtEvent(TWT_EVENT_SP_END, agreementKey, Simulator::Now() - agreementData.adjustedMinWake, Simulator::Now(), 0);
 		bool anyChanges = false;
+		bool due = agreementData.header.GetTargetWakeTime() <= Simulator::Now();
 		if (agreementData.header.IsImplicit()) {
-			if (!agreementData.periodicTwtOverridden) {
+			if (due) {
 				agreementData.header.IncrementTargetWakeTime();
 				anyChanges = true;
 			} // else nothing. This happens when new time is set using a next-twt info field.
+		} else if (agreementData.myRole == TWT_RESPONDING_STA) {
+			if (due) {
+				// Our TACK frames gave the requesting STA the same next TWT, computed from the current one
+				agreementData.header.SetTargetWakeTime(m_computeNextTwtValue(agreementKey, agreementData));
+				anyChanges = true;
+			}
 		} else {
 			anyChanges = HandleExplicitTwtTimeUpdateIfNeeded(agreementKey, agreementData);
 		}
-		Time delay = agreementData.header.GetTargetWakeTime() - Simulator::Now();
-		NS_LOG_UNCOND("Scheduled start of wake period " << delay << " from now.");
-		agreementData.nextEvent = Simulator::Schedule(delay, &RegularWifiMac::HandleStartOfWakePeriod, this, agreementKey, agreementData);
+		if (agreementData.waitingForNextTwt) {
+			// HandleNextTwtInfoField schedules the start once the next TWT is received
+			NS_LOG_LOGIC("Waiting for the next TWT to schedule the start of wake period.");
+		} else {
+			Time delay = agreementData.header.GetTargetWakeTime() - Simulator::Now();
+			NS_LOG_LOGIC("Scheduled start of wake period " << delay << " from now.");
+			m_twtAgreements.ScheduleStart(m_twtAgreements.Find(agreementKey), delay);
+		}
 		if (m_twtEndOfWakePeriodCallback) {
 			m_twtEndOfWakePeriodCallback(agreementKey, agreementData);
 		}
@@ -1435,23 +1477,23 @@ namespace ns3
 
 	void RegularWifiMac::HandleStartOfWakePeriod(TWTAgreementKey &agreementKey, TWTAgreementData &agreementData)
 	{
-		NS_LOG_UNCOND("Handling start of wake period! (" << static_cast<uint32_t>(agreementData.myRole) << ")");
-		NS_LOG_UNCOND(Simulator::Now());
+		NS_LOG_FUNCTION(this << agreementKey.macAddress << static_cast<uint32_t>(agreementKey.flowIdentifier)
+											<< static_cast<uint32_t>(agreementData.myRole));
+		// Compute the adjust minimum wake time.
+		agreementData.adjustedMinWake = GetAdjustedMinimumWakeDuration(agreementData.header, Simulator::Now());
+		// Schedule the end of the wake period. The service period is under way from now on.
+		NS_LOG_LOGIC("Scheduled end of wake period for " << agreementData.adjustedMinWake << " from now.");
+		m_twtAgreements.StartServicePeriod(m_twtAgreements.Find(agreementKey), agreementData.adjustedMinWake);
+
 		// At start of wake period, we must handle announcement of wake up in case of an announced twt
 		if (agreementData.header.IsAnnouncedFlowType() && agreementData.myRole == TWT_REQUESTING_STA) {
 			// Here we are a Requesting STA in an announced flow TWT agreement, so we must send the wake announcement
 			// This function sends an APSD trigger frame, but may be overridden to be replaced by a PS-Poll frame.
 			this->SendAnnouncedTwtWakeupMessage(agreementKey.macAddress);
 		} // In case of unannounced TWT, or responding STA, no actions have to be taken.
-
-		// Compute the adjust minimum wake time.
-		agreementData.adjustedMinWake = GetAdjustedMinimumWakeDuration(agreementData.header, Simulator::Now());
-		// Schedule the end of the wake period.
-		NS_LOG_UNCOND("Scheduled end of wake period for " << agreementData.adjustedMinWake << " from now.");
-		agreementData.nextEvent =
-				Simulator::Schedule(agreementData.adjustedMinWake, &RegularWifiMac::HandleEndOfWakePeriod, this, agreementKey, agreementData);
 		// Send any packets we may have had buffered for the destination address
-		this->SendQueuedPackets(agreementKey.macAddress);
+		uint32_t flushed = this->SendQueuedPackets(agreementKey.macAddress);
+		NotifyTwtEvent(TWT_EVENT_SP_START, agreementKey, Simulator::Now(), Simulator::Now() + agreementData.adjustedMinWake, flushed);
 		// Do callback fn if necessary
 		if (m_twtStartOfWakePeriodCallback) {
 			m_twtStartOfWakePeriodCallback(agreementKey, agreementData);
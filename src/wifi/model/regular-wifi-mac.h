@@ -32,6 +32,8 @@
 #include "ssid.h"
 #include "twt-agreement.h"
 #include "twt-headers.h"
+#include "twt-timeline.h"
+#include "twt-trace.h"
 #include "wifi-remote-station-manager.h"
 #include <functional>
 #include <map>
@@ -526,6 +528,7 @@ namespace ns3
 		TracedCallback<Ptr<const Packet>, DropReason> m_packetdropped;
 		TracedCallback<uint32_t> m_collisionTrace;
 		TracedCallback<Time, Time> m_transmissionWillCrossRAWBoundary;
+		TracedCallback<const TwtEvent &> m_twtEventTrace;
 
 		/**
 		 * Functions for internal readability.
@@ -549,7 +552,21 @@ namespace ns3
 		virtual void SendAnnouncedTwtWakeupMessage(Mac48Address to);
 		void SendTwtTestTraffic(Mac48Address to);
 		void QueueWithTwt(Ptr<Packet> packet, const WifiMacHeader &header);
-		void SendQueuedPackets(const Mac48Address &to);
+		/**
+		 * \param to the peer
+		 * \return the number of frames buffered for the peer and handed to the channel access
+		 */
+		uint32_t SendQueuedPackets(const Mac48Address &to);
+		/**
+		 * Fire the TwtEvent trace source, if connected.
+		 *
+		 * \param type the kind of event
+		 * \param key the agreement
+		 * \param spStart the start of the service period
+		 * \param spEnd the end of the service period
+		 * \param flushed the number of frames handed to the channel access
+		 */
+		void NotifyTwtEvent(TwtEventType type, const TWTAgreementKey &key, Time spStart, Time spEnd, uint32_t flushed);
 		void HandleTwtAnnouncementFrame(Ptr<Packet> packet, const WifiMacHeader *hdr);
 		bool HandleExplicitTwtTimeUpdateIfNeeded(TWTAgreementKey &key, TWTAgreementData &data);
 		void HandleTwtTimeUpdateMessage(TWTAgreementKey &key, TWTAgreementData &data);
@@ -590,7 +607,7 @@ namespace ns3
 		/**
 		 * Members required for TWT management
 		 */
-		TWTAgreementMap m_twtAgreements;
+		TwtTimeline m_twtAgreements; //!< The TWT agreements and the boundaries of their service periods
 		TWTPacketQueue m_twtPacketQueue;
 
 		// Functions for accepting/refusing certain TWT agreements, as well as suggesting alternatives as desired.
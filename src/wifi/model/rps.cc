@@ -22,6 +22,7 @@
 #include "ns3/assert.h"
 #include "ns3/log.h" //for test
 #include <sstream>
+#include <cstring>
 
 namespace ns3 {
 
@@ -413,4 +414,123 @@ operator << (std::ostream &os, const RPS &rps)
     }
 
 
+RawSlotAccessList::RawSlotAccessList (uint16_t aidStart, uint16_t aidEnd, uint16_t slotNum, uint16_t slot)
+  : m_aidStart (aidStart),
+    m_aidEnd (aidEnd),
+    m_slotNum (slotNum),
+    m_slot (slot)
+{
+  NS_ASSERT (slotNum > 0 && slot < slotNum);
+}
+
+bool
+RawSlotAccessList::IsAllowed (uint16_t aid) const
+{
+  return aid >= m_aidStart && aid <= m_aidEnd && (aid & 0x03ff) % m_slotNum == m_slot;
+}
+
+uint16_t
+RawSlotAccessList::GetAidStart (void) const
+{
+  return m_aidStart;
+}
+
+uint16_t
+RawSlotAccessList::GetAidEnd (void) const
+{
+  return m_aidEnd;
+}
+
+uint16_t
+RawSlotAccessList::GetSlotNum (void) const
+{
+  return m_slotNum;
+}
+
+uint16_t
+RawSlotAccessList::GetSlot (void) const
+{
+  return m_slot;
+}
+
+RawSchedule::RawSchedule (const RPS &rps)
+  : m_duration (MicroSeconds (0))
+{
+  uint8_t length = rps.GetInformationFieldSize ();
+  if (length > 0)
+    {
+      const uint8_t *fields = rps.GetRawAssignment ();
+      m_rawAssignments.assign (fields, fields + length);
+    }
+  for (uint32_t g = 0; g < rps.GetNumberOfRawGroups (); g++)
+    {
+      RPS::RawAssignment ass = rps.GetRawAssigmentObj (g);
+      Group group;
+      group.rawTypeIndex = ass.GetRawTypeIndex ();
+      group.page = ass.GetRawGroupPage ();
+      group.aidStart = ass.GetRawGroupAIDStart ();
+      group.aidEnd = ass.GetRawGroupAIDEnd ();
+      group.slotNum = ass.GetSlotNum ();
+      group.slotDurationCount = ass.GetSlotDurationCount ();
+      group.crossSlotBoundary = ass.GetSlotCrossBoundary () == 0x0001;
+      group.slotDuration = MicroSeconds (500 + group.slotDurationCount * 120);
+      group.start = m_duration;
+      for (uint16_t i = 0; i < group.slotNum; i++)
+        {
+          group.slots.push_back (Create<RawSlotAccessList> (group.aidStart, group.aidEnd, group.slotNum, i));
+        }
+      m_duration += group.slotDuration * group.slotNum;
+      m_groups.push_back (group);
+    }
+}
+
+bool
+RawSchedule::Matches (const RPS &rps) const
+{
+  uint8_t length = rps.GetInformationFieldSize ();
+  return length == m_rawAssignments.size ()
+         && (length == 0 || std::memcmp (rps.GetRawAssignment (), &m_rawAssignments[0], length) == 0);
+}
+
+uint32_t
+RawSchedule::GetNumberOfRawGroups (void) const
+{
+  return m_groups.size ();
+}
+
+const RawSchedule::Group &
+RawSchedule::GetRawGroup (uint32_t index) const
+{
+  NS_ASSERT (index < m_groups.size ());
+  return m_groups[index];
+}
+
+Time
+RawSchedule::GetDuration (void) const
+{
+  return m_duration;
+}
+
+bool
+RawSchedule::FindSlot (uint16_t aid, uint32_t &group, uint16_t &slot) const
+{
+  for (uint32_t g = 0; g < m_groups.size (); g++)
+    {
+      if (m_groups[g].aidStart <= aid && aid <= m_groups[g].aidEnd)
+        {
+          group = g;
+          slot = (aid & 0x03ff) % m_groups[g].slotNum;
+          return true;
+        }
+    }
+  return false;
+}
+
+Time
+RawSchedule::GetSlotStart (uint32_t group, uint16_t slot) const
+{
+  NS_ASSERT (group < m_groups.size () && slot < m_groups[group].slotNum);
+  return m_groups[group].start + m_groups[group].slotDuration * slot;
+}
+
 } //namespace ns3
@@ -27,6 +27,9 @@
 #include "ns3/attribute-helper.h"
 #include "ns3/wifi-information-element.h"
 #include "ns3/vector.h"
+#include "ns3/simple-ref-count.h"
+#include "ns3/nstime.h"
+#include "ns3/ptr.h"
 
 
 namespace ns3 {
@@ -166,6 +169,117 @@ std::istream &operator >> (std::istream &is, RPSVector &rpsv);
 
 ATTRIBUTE_HELPER_HEADER (RPSVector);
 
+/**
+ * \ingroup wifi
+ *
+ * The stations allowed to access the channel during one slot of a RAW
+ * group: the AIDs in [aidStart, aidEnd] whose (aid & 0x03ff) % slotNum
+ * equals the slot index. The list is immutable, so a single instance is
+ * built per slot of an RPS and shared by all the EDCA queues of the AP.
+ */
+class RawSlotAccessList : public SimpleRefCount<RawSlotAccessList>
+{
+public:
+  /**
+   * \param aidStart first AID of the RAW group
+   * \param aidEnd last AID of the RAW group
+   * \param slotNum number of slots of the RAW group
+   * \param slot index of the slot, in [0, slotNum)
+   */
+  RawSlotAccessList (uint16_t aidStart, uint16_t aidEnd, uint16_t slotNum, uint16_t slot);
+
+  /**
+   * \param aid the AID of a station
+   * \return true if the station may access the channel during this slot
+   */
+  bool IsAllowed (uint16_t aid) const;
+
+  uint16_t GetAidStart (void) const;
+  uint16_t GetAidEnd (void) const;
+  uint16_t GetSlotNum (void) const;
+  uint16_t GetSlot (void) const;
+
+private:
+  uint16_t m_aidStart; //!< first AID of the RAW group
+  uint16_t m_aidEnd;   //!< last AID of the RAW group
+  uint16_t m_slotNum;  //!< number of slots of the RAW group
+  uint16_t m_slot;     //!< index of this slot
+};
+
+/**
+ * \ingroup wifi
+ *
+ * The RAW groups of an RPS decoded once: the start offset of each group
+ * relative to the end of the beacon, its slot duration, slot count, AID
+ * range, cross-slot-boundary flag and the access list of each slot. The
+ * RPS only changes when the RAW configuration changes, so the beacon path
+ * on the AP and on the STAs reuses the same schedule beacon after beacon.
+ */
+class RawSchedule : public SimpleRefCount<RawSchedule>
+{
+public:
+  /**
+   * One RAW group of the schedule.
+   */
+  struct Group
+  {
+    uint8_t rawTypeIndex;        //!< RAW type of the group
+    uint8_t page;                //!< page of the AIDs of the group
+    uint16_t aidStart;           //!< first AID of the group
+    uint16_t aidEnd;             //!< last AID of the group
+    uint16_t slotNum;            //!< number of slots
+    uint16_t slotDurationCount;  //!< slot duration count, as sent in the RPS
+    bool crossSlotBoundary;      //!< whether transmissions may cross slot boundaries
+    Time slotDuration;           //!< duration of one slot
+    Time start;                  //!< start of the group relative to the end of the beacon
+    std::vector<Ptr<const RawSlotAccessList> > slots; //!< access list of each slot
+  };
+
+  /**
+   * \param rps the RPS to compile
+   */
+  RawSchedule (const RPS &rps);
+
+  /**
+   * \param rps an RPS
+   * \return true if this schedule was compiled from an RPS with the same content
+   */
+  bool Matches (const RPS &rps) const;
+
+  uint32_t GetNumberOfRawGroups (void) const;
+  /**
+   * \param index the index of the RAW group
+   * \return the RAW group
+   */
+  const Group & GetRawGroup (uint32_t index) const;
+  /**
+   * \return the duration of all the RAW groups
+   */
+  Time GetDuration (void) const;
+
+  /**
+   * Find the slot of a station, using (aid & 0x03ff) % slotNum in the
+   * first RAW group whose AID range holds the AID.
+   *
+   * \param aid the AID of the station
+   * \param group set to the index of the RAW group of the station
+   * \param slot set to the index of the slot of the station in the group
+   * \return false if no RAW group holds the AID
+   */
+  bool FindSlot (uint16_t aid, uint32_t &group, uint16_t &slot) const;
+  /**
+   * \param group the index of the RAW group
+   * \param slot the index of the slot in the group
+   * \return the start of the slot relative to the end of the beacon
+   */
+  Time GetSlotStart (uint32_t group, uint16_t slot) const;
+
+private:
+  std::vector<uint8_t> m_rawAssignments; //!< RAW Assignment fields the schedule was compiled from
+  std::vector<Group> m_groups;           //!< RAW groups, in RPS order
+  Time m_duration;                       //!< duration of all the RAW groups
+};
+
 } //namespace ns3
 
 #endif /* RPS_H */
@@ -0,0 +1,127 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include <algorithm>
+#include "s1g-downlink-scheduler.h"
+#include "ns3/log.h"
+#include "ns3/simulator.h"
+
+namespace ns3 {
+
+NS_LOG_COMPONENT_DEFINE ("S1gDownlinkScheduler");
+
+S1gDownlinkScheduler::S1gDownlinkScheduler ()
+{
+  NS_LOG_FUNCTION (this);
+}
+
+S1gDownlinkScheduler::~S1gDownlinkScheduler ()
+{
+  NS_LOG_FUNCTION (this);
+  Clear ();
+}
+
+void
+S1gDownlinkScheduler::SetWakeCallback (WakeCallback wake)
+{
+  m_wake = wake;
+}
+
+void
+S1gDownlinkScheduler::SetHasFramesCallback (HasFramesCallback hasFrames)
+{
+  m_hasFrames = hasFrames;
+}
+
+void
+S1gDownlinkScheduler::Buffer (uint16_t aid)
+{
+  m_buffered.insert (aid);
+}
+
+void
+S1gDownlinkScheduler::Schedule (enum AcIndex ac, Time delay)
+{
+  NS_LOG_FUNCTION (this << ac << delay);
+  Time start = Simulator::Now () + delay;
+  std::map<Time, Bucket>::iterator it = m_buckets.find (start);
+  if (it == m_buckets.end ())
+    {
+      Bucket bucket;
+      bucket.event = Simulator::Schedule (delay, &S1gDownlinkScheduler::Wake, this, start);
+      bucket.frames = 0;
+      it = m_buckets.insert (std::make_pair (start, bucket)).first;
+    }
+  std::vector<enum AcIndex> &acs = it->second.acs;
+  if (std::find (acs.begin (), acs.end (), ac) == acs.end ())
+    {
+      acs.push_back (ac);
+    }
+  it->second.frames++;
+}
+
+void
+S1gDownlinkScheduler::Wake (Time start)
+{
+  std::map<Time, Bucket>::iterator it = m_buckets.find (start);
+  NS_ASSERT (it != m_buckets.end ());
+  std::vector<enum AcIndex> acs;
+  acs.swap (it->second.acs);
+  NS_LOG_DEBUG ("slot at " << start << ": " << it->second.frames << " frames");
+  m_buckets.erase (it);
+  // In the order of the first frame of each access category
+  for (std::vector<enum AcIndex>::const_iterator i = acs.begin (); i != acs.end (); i++)
+    {
+      m_wake (*i);
+    }
+}
+
+void
+S1gDownlinkScheduler::GetBuffered (uint16_t first, uint16_t last, std::vector<uint16_t> &aids)
+{
+  std::set<uint16_t>::iterator it = m_buffered.lower_bound (first);
+  while (it != m_buffered.end () && *it <= last)
+    {
+      if (m_hasFrames (*it))
+        {
+          aids.push_back (*it);
+          it++;
+        }
+      else
+        {
+          m_buffered.erase (it++);
+        }
+    }
+}
+
+uint32_t
+S1gDownlinkScheduler::GetNPendingSlots (void) const
+{
+  return m_buckets.size ();
+}
+
+void
+S1gDownlinkScheduler::Clear (void)
+{
+  for (std::map<Time, Bucket>::iterator it = m_buckets.begin (); it != m_buckets.end (); it++)
+    {
+      Simulator::Cancel (it->second.event);
+    }
+  m_buckets.clear ();
+  m_buffered.clear ();
+}
+
+} // namespace ns3
@@ -0,0 +1,126 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#ifndef S1G_DOWNLINK_SCHEDULER_H
+#define S1G_DOWNLINK_SCHEDULER_H
+
+#include <stdint.h>
+#include <map>
+#include <set>
+#include <vector>
+#include "ns3/callback.h"
+#include "ns3/event-id.h"
+#include "ns3/nstime.h"
+#include "qos-utils.h"
+
+namespace ns3 {
+
+/**
+ * \ingroup wifi
+ *
+ * The downlink frames an S1G AP holds until the RAW slot of their
+ * station. The frames wait in the EDCA queues; the scheduler buckets
+ * them by the start of their slot, and wakes each access category once
+ * per slot for the whole bucket, rather than once per frame.
+ *
+ * It also keeps the AIDs of the stations the queues may hold frames
+ * for, so that the TIM and page slice bitmaps only look at those
+ * stations instead of every AID of the page. An AID is dropped from
+ * the set when the AP finds no frame queued for it any more.
+ */
+class S1gDownlinkScheduler
+{
+public:
+  /**
+   * Wake up an access category at the start of a slot.
+   */
+  typedef Callback<void, enum AcIndex> WakeCallback;
+  /**
+   * \return true if frames are queued for the station with the given AID.
+   */
+  typedef Callback<bool, uint16_t> HasFramesCallback;
+
+  S1gDownlinkScheduler ();
+  ~S1gDownlinkScheduler ();
+
+  /**
+   * \param wake the callback to wake up an access category
+   */
+  void SetWakeCallback (WakeCallback wake);
+  /**
+   * \param hasFrames the callback to check if frames are queued for a station
+   */
+  void SetHasFramesCallback (HasFramesCallback hasFrames);
+
+  /**
+   * Record that frames may be queued for a station.
+   *
+   * \param aid the AID of the station
+   */
+  void Buffer (uint16_t aid);
+  /**
+   * Wake up an access category when a slot starts, for a frame queued
+   * for that slot. The frames of the same slot share one wake up.
+   *
+   * \param ac the access category of the frame
+   * \param delay the time until the start of the slot
+   */
+  void Schedule (enum AcIndex ac, Time delay);
+  /**
+   * Get the AIDs in a range for which frames are queued, in order.
+   * The AIDs for which the queues are empty are forgotten.
+   *
+   * \param first the first AID of the range
+   * \param last the last AID of the range
+   * \param aids the AIDs are appended to this vector
+   */
+  void GetBuffered (uint16_t first, uint16_t last, std::vector<uint16_t> &aids);
+  /**
+   * \return the number of slots with a pending wake up
+   */
+  uint32_t GetNPendingSlots (void) const;
+  /**
+   * Cancel the wake ups and forget the buffered AIDs.
+   */
+  void Clear (void);
+
+private:
+  /**
+   * The frames queued for the same slot.
+   */
+  struct Bucket
+  {
+    EventId event;                //!< the wake up at the start of the slot
+    std::vector<enum AcIndex> acs; //!< the access categories to wake up, in order
+    uint32_t frames;              //!< the number of frames queued for the slot
+  };
+
+  /**
+   * Wake up the access categories of a slot.
+   *
+   * \param start the start of the slot
+   */
+  void Wake (Time start);
+
+  std::map<Time, Bucket> m_buckets; //!< the buckets, by start of their slot
+  std::set<uint16_t> m_buffered;    //!< the AIDs frames may be queued for
+  WakeCallback m_wake;              //!< wakes up an access category
+  HasFramesCallback m_hasFrames;    //!< checks the queues of a station
+};
+
+} // namespace ns3
+
+#endif /* S1G_DOWNLINK_SCHEDULER_H */
@@ -179,6 +179,7 @@ namespace ns3
 	{
 		NS_LOG_FUNCTION(this);
 		m_pspollDca = 0;
+		m_rawSchedule = 0;
 		RegularWifiMac::DoDispose();
 	}
 
@@ -1277,61 +1278,28 @@ Last, functions called by OutsideRawStartBackoff is execuated.
 		NS_LOG_DEBUG(m_low->GetAddress() << ",beacon:," << Simulator::Now().GetSeconds());
 
 		UnsetInRAWgroup();
-		// uint8_t * rawassign;
-		// rawassign = beacon.GetRPS().GetRawAssignment();
-		uint16_t raw_len = beacon.GetRPS().GetInformationFieldSize();
-		uint16_t rawAssignment_len = 6;
-		if (raw_len % rawAssignment_len != 0) {
-			NS_ASSERT("RAW configuration incorrect!");
-		}
-		uint8_t RAW_number = raw_len / rawAssignment_len;
-
-		uint16_t m_slotDurationCount = 0;
-		uint16_t m_slotNum = 0;
-		uint64_t m_currentRAW_start = 0;
-		m_lastRawDurationus = MicroSeconds(0);
-		for (uint8_t raw_index = 0; raw_index < RAW_number; raw_index++) {
-			auto ass = beacon.GetRPS().GetRawAssigmentObj(raw_index);
-
-			if (ass.GetRawTypeIndex() == 4) // only support Generic Raw (paged STA RAW or not)
-			{
-				m_pagedStaRaw = true;
-			} else {
-				m_pagedStaRaw = false;
-			}
-			m_currentRAW_start = m_currentRAW_start + (500 + m_slotDurationCount * 120) * m_slotNum;
-			m_slotDurationCount = ass.GetSlotDurationCount();
-			m_slotNum = ass.GetSlotNum();
+		RPS rps = beacon.GetRPS();
+		if (m_rawSchedule == 0 || !m_rawSchedule->Matches(rps)) {
+			m_rawSchedule = Create<RawSchedule>(rps);
+		}
+
+		m_lastRawDurationus = m_rawSchedule->GetDuration();
+		for (uint32_t raw_index = 0; raw_index < m_rawSchedule->GetNumberOfRawGroups(); raw_index++) {
+			const RawSchedule::Group &group = m_rawSchedule->GetRawGroup(raw_index);
 
-			m_slotDuration = MicroSeconds(500 + m_slotDurationCount * 120);
-			m_lastRawDurationus = m_lastRawDurationus + m_slotDuration * m_slotNum;
-			m_crossSlotBoundaryAllowed = ass.GetSlotCrossBoundary() == 0x0001;
+			m_pagedStaRaw = group.rawTypeIndex == 4; // only support Generic Raw (paged STA RAW or not)
+			m_slotDuration = group.slotDuration;
+			m_crossSlotBoundaryAllowed = group.crossSlotBoundary;
 
-			if (ass.GetRawGroupPage() == ((GetAID() >> 11) & 0x0003)) // in the page indexed
+			if (group.page == ((GetAID() >> 11) & 0x0003)) // in the page indexed
 			{
-				// uint16_t statsPerSlot = 0;
-				uint16_t statRawSlot = 0;
-
-				Ptr<UniformRandomVariable> m_rv = CreateObject<UniformRandomVariable>();
-				uint16_t offset = m_rv->GetValue(0, 1023);
-				offset = 0; // for test
-				// statsPerSlot = (ass.GetRawGroupAIDEnd() - ass.GetRawGroupAIDStart() + 1)/m_slotNum;
-				// statRawSlot = ((GetAID() & 0x03ff)-raw_start)/statsPerSlot;
-				statRawSlot = ((GetAID() & 0x07ff) + offset) % m_slotNum;
-
-				if ((ass.GetRawGroupAIDStart() <= (GetAID() & 0x07ff)) && ((GetAID() & 0x07ff) <= ass.GetRawGroupAIDEnd())) {
-					m_statSlotStart = MicroSeconds((500 + m_slotDurationCount * 120) * statRawSlot + m_currentRAW_start);
+				uint16_t aid = GetAID() & 0x07ff;
+				if (group.aidStart <= aid && aid <= group.aidEnd) {
+					uint16_t statRawSlot = aid % group.slotNum;
+					m_statSlotStart = group.start + group.slotDuration * statRawSlot;
 					SetInRAWgroup();
 					m_currentslotDuration = m_slotDuration; // To support variable time duration among multiple RAWs
-
-					// NS_LOG_UNCOND (Simulator::Now () << ", StaWifiMac:: GetAID() = " << GetAID() <<  ", m_statSlotStart=" <<
-					// m_statSlotStart << ", m_lastRawDurationus = " << m_lastRawDurationus << ", m_currentslotDuration = " <<
-					// m_currentslotDuration);
-					// break; //break should not used if multiple RAW is supported
 				}
-				// NS_LOG_UNCOND (Simulator::Now () << ", StaWifiMac:: GetAID() = " << GetAID() << ", raw_start =" << raw_start
-				// << ", raw_end=" << raw_end << ", m_statSlotStart=" << m_statSlotStart << ", m_lastRawDurationus = " <<
-				// m_lastRawDurationus << ", m_currentslotDuration = " << m_currentslotDuration);
 			}
 		}
 		m_rawStart = true; //?
@@ -1594,6 +1562,6 @@ Last, functions called by OutsideRawStartBackoff is execuated.
 			// Then from there we're allowed to miss the standard amount of beacons again.
 			RestartBeaconWatchdog(closest + m_beaconInterval * m_maxMissedBeacons);
 		}
-		NS_LOG_UNCOND("TWT agreements changed for " << GetAddress() << ".");
+		NS_LOG_DEBUG("TWT agreements changed for " << GetAddress() << ".");
 	}
 } // namespace ns3
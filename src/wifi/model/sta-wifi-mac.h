@@ -278,6 +278,7 @@ namespace ns3
 
 		void ConfigureTwt();
 
+		Ptr<const RawSchedule> m_rawSchedule; //!< Schedule compiled from the RPS of the last beacon
 		Time m_lastRawDurationus;
 		Time m_lastRawStart;
 		Time m_rawDuration;
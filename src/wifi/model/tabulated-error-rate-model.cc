@@ -0,0 +1,130 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include <cmath>
+#include <limits>
+#include "tabulated-error-rate-model.h"
+#include "ns3/double.h"
+#include "ns3/log.h"
+
+namespace ns3 {
+
+NS_LOG_COMPONENT_DEFINE ("TabulatedErrorRateModel");
+
+NS_OBJECT_ENSURE_REGISTERED (TabulatedErrorRateModel);
+
+TypeId
+TabulatedErrorRateModel::GetTypeId (void)
+{
+  static TypeId tid = TypeId ("ns3::TabulatedErrorRateModel")
+    .SetParent<ErrorRateModel> ()
+    .SetGroupName ("Wifi")
+    .AddConstructor<TabulatedErrorRateModel> ()
+    .AddAttribute ("MinSnr",
+                   "The first SNR (dB) of the tables. "
+                   "Lower SNRs are handed to the NistErrorRateModel.",
+                   DoubleValue (-10.0),
+                   MakeDoubleAccessor (&TabulatedErrorRateModel::m_minSnrDb),
+                   MakeDoubleChecker<double> ())
+    .AddAttribute ("MaxSnr",
+                   "The last SNR (dB) of the tables. "
+                   "Higher SNRs are handed to the NistErrorRateModel.",
+                   DoubleValue (40.0),
+                   MakeDoubleAccessor (&TabulatedErrorRateModel::m_maxSnrDb),
+                   MakeDoubleChecker<double> ())
+    .AddAttribute ("Step",
+                   "The step (dB) between two SNRs of the tables.",
+                   DoubleValue (0.05),
+                   MakeDoubleAccessor (&TabulatedErrorRateModel::m_stepDb),
+                   MakeDoubleChecker<double> (1e-4))
+  ;
+  return tid;
+}
+
+TabulatedErrorRateModel::TabulatedErrorRateModel ()
+  : m_nist (CreateObject<NistErrorRateModel> ())
+{
+}
+
+const TabulatedErrorRateModel::Table &
+TabulatedErrorRateModel::GetTable (WifiMode mode) const
+{
+  std::pair<uint16_t, enum WifiCodeRate> key (mode.GetConstellationSize (), mode.GetCodeRate ());
+  std::map<std::pair<uint16_t, enum WifiCodeRate>, Table>::iterator it = m_tables.find (key);
+  if (it != m_tables.end ())
+    {
+      return it->second;
+    }
+  NS_LOG_DEBUG ("tabulating " << mode << " from " << m_minSnrDb << " dB to " << m_maxSnrDb << " dB");
+  Table &table = m_tables[key];
+  uint32_t size = static_cast<uint32_t> (std::floor ((m_maxSnrDb - m_minSnrDb) / m_stepDb)) + 1;
+  table.reserve (size);
+  for (uint32_t i = 0; i < size; i++)
+    {
+      double snr = std::pow (10.0, (m_minSnrDb + i * m_stepDb) / 10.0);
+      //The success rate of a single bit is 1 - BER
+      double bitSuccessRate = m_nist->GetChunkSuccessRate (mode, snr, 1);
+      if (bitSuccessRate >= 1.0)
+        {
+          table.push_back (-std::numeric_limits<double>::infinity ());
+        }
+      else if (bitSuccessRate <= 0.0)
+        {
+          table.push_back (std::numeric_limits<double>::infinity ());
+        }
+      else
+        {
+          table.push_back (std::log (-std::log (bitSuccessRate)));
+        }
+    }
+  return table;
+}
+
+double
+TabulatedErrorRateModel::GetChunkSuccessRate (WifiMode mode, double snr, uint32_t nbits) const
+{
+  if (nbits == 0)
+    {
+      return 1.0;
+    }
+  if (mode.GetModulationClass () != WIFI_MOD_CLASS_ERP_OFDM
+      && mode.GetModulationClass () != WIFI_MOD_CLASS_OFDM
+      && mode.GetModulationClass () != WIFI_MOD_CLASS_HT
+      && mode.GetModulationClass () != WIFI_MOD_CLASS_S1G)
+    {
+      return m_nist->GetChunkSuccessRate (mode, snr, nbits);
+    }
+  const Table &table = GetTable (mode);
+  double position = (10.0 * std::log10 (snr) - m_minSnrDb) / m_stepDb;
+  if (!(position >= 0.0) || position >= table.size () - 1)
+    {
+      return m_nist->GetChunkSuccessRate (mode, snr, nbits);
+    }
+  uint32_t i = static_cast<uint32_t> (position);
+  double t = position - i;
+  double value;
+  if (std::isinf (table[i]) || std::isinf (table[i + 1]))
+    {
+      value = t < 0.5 ? table[i] : table[i + 1];
+    }
+  else
+    {
+      value = table[i] + t * (table[i + 1] - table[i]);
+    }
+  return std::exp (-static_cast<double> (nbits) * std::exp (value));
+}
+
+} //namespace ns3
@@ -31,8 +31,6 @@ namespace ns3
 		// The TWT header for this agreement. Contains lots of data we need, simply accessing header is easier than
 		// duplicating all the contained information
 		TWTHeader header;
-		// Simulator event for wake up - allows cancelling in case of e.g. teardown
-		EventId nextEvent;
 		// Adjust for late start, e.g. in announced twt
 		Time adjustedMinWake;
 		// Can happen in case of implicit session receiving a next-twt info
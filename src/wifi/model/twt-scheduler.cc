@@ -0,0 +1,158 @@
+#include "twt-scheduler.h"
+#include "ns3/assert.h"
+#include "ns3/log.h"
+
+#include <algorithm>
+namespace ns3
+{
+	NS_LOG_COMPONENT_DEFINE("TwtScheduler");
+
+	namespace
+	{
+		/// The remainder of a by b, in [0, b)
+		int64_t Modulo(int64_t a, int64_t b)
+		{
+			int64_t r = a % b;
+			return r < 0 ? r + b : r;
+		}
+	} // namespace
+
+	TwtScheduler::TwtScheduler() : m_beaconInterval(102400), m_guard(0)
+	{
+	}
+
+	void TwtScheduler::SetBeaconInterval(Time interval)
+	{
+		NS_ASSERT(interval.GetMicroSeconds() > 0);
+		m_beaconInterval = interval.GetMicroSeconds();
+	}
+
+	Time TwtScheduler::GetBeaconInterval() const
+	{
+		return MicroSeconds(m_beaconInterval);
+	}
+
+	void TwtScheduler::SetGuardInterval(Time guard)
+	{
+		m_guard = guard.GetMicroSeconds();
+	}
+
+	Time TwtScheduler::GetGuardInterval() const
+	{
+		return MicroSeconds(m_guard);
+	}
+
+	void TwtScheduler::Reserve(Time phase, Time interval, Time duration)
+	{
+		int64_t harmonic = GetHarmonicInterval(interval).GetMicroSeconds();
+		m_reservations.push_back(Reservation{Modulo(phase.GetMicroSeconds(), harmonic), harmonic, duration.GetMicroSeconds() + m_guard});
+	}
+
+	void TwtScheduler::Clear()
+	{
+		m_reservations.clear();
+	}
+
+	uint32_t TwtScheduler::GetN() const
+	{
+		return m_reservations.size();
+	}
+
+	Time TwtScheduler::GetHarmonicInterval(Time interval) const
+	{
+		int64_t requested = interval.GetMicroSeconds();
+		int64_t harmonic = m_beaconInterval;
+		if (requested >= harmonic) {
+			while (harmonic <= requested / 2) {
+				harmonic *= 2;
+			}
+		} else {
+			// Only the exact divisions of the beacon interval are harmonic
+			while (harmonic > requested && harmonic % 2 == 0) {
+				harmonic /= 2;
+			}
+		}
+		return MicroSeconds(harmonic);
+	}
+
+	bool TwtScheduler::Fits(Time phase, Time interval, Time duration) const
+	{
+		int64_t p = interval.GetMicroSeconds();
+		int64_t d = duration.GetMicroSeconds() + m_guard;
+		int64_t start = Modulo(phase.GetMicroSeconds(), p);
+		if (d > p) {
+			return false;
+		}
+		for (const auto &r : m_reservations) {
+			int64_t g = std::min(p, r.interval);
+			// Two harmonic reservations overlap if and only if they overlap modulo the shorter interval
+			if (d >= g || r.duration >= g || Modulo(r.phase - start, g) < d || Modulo(start - r.phase, g) < r.duration) {
+				return false;
+			}
+		}
+		return true;
+	}
+
+	bool TwtScheduler::FindPhase(Time interval, Time duration, Time &phase) const
+	{
+		int64_t p = interval.GetMicroSeconds();
+		int64_t d = duration.GetMicroSeconds() + m_guard;
+		if (d > p) {
+			return false;
+		}
+		// A reservation blocks the starts in [r.phase - d + 1, r.phase + r.duration) modulo the shorter of the
+		// two intervals. These periods all divide the longest of them, so the earliest start which fits in
+		// [0, window) is the earliest one modulo p.
+		int64_t window = 1;
+		for (const auto &r : m_reservations) {
+			int64_t g = std::min(p, r.interval);
+			if (d >= g || r.duration + d - 1 >= g) {
+				NS_LOG_DEBUG("No room for " << d << " us every " << p << " us next to " << r.duration << " us every " << r.interval << " us");
+				return false;
+			}
+			window = std::max(window, g);
+		}
+		int64_t candidate = 0;
+		bool moved = true;
+		while (moved && candidate < window) {
+			moved = false;
+			for (const auto &r : m_reservations) {
+				int64_t g = std::min(p, r.interval);
+				int64_t length = r.duration + d - 1;
+				int64_t offset = Modulo(candidate - r.phase + d - 1, g);
+				if (offset < length) {
+					// Move to the end of the blocked range
+					candidate += length - offset;
+					moved = true;
+				}
+			}
+		}
+		if (candidate >= window) {
+			NS_LOG_DEBUG("No room for " << d << " us every " << p << " us among " << m_reservations.size() << " reservations");
+			return false;
+		}
+		phase = MicroSeconds(candidate);
+		return true;
+	}
+
+	Time TwtScheduler::GetWakeInterval(const TWTHeader &header)
+	{
+		return MicroSeconds(static_cast<int64_t>(header.GetWakeIntervalMantissa()) << header.GetWakeIntervalExponent());
+	}
+
+	bool TwtScheduler::SetWakeInterval(TWTHeader &header, Time interval)
+	{
+		int64_t us = interval.GetMicroSeconds();
+		uint8_t exponent = 0;
+		while (us > 0xffff && us % 2 == 0 && exponent < 31) {
+			us /= 2;
+			exponent++;
+		}
+		if (us > 0xffff || us <= 0) {
+			return false;
+		}
+		header.SetWakeIntervalMantissa(static_cast<uint16_t>(us));
+		header.SetWakeIntervalExponent(exponent);
+		return true;
+	}
+} // namespace ns3
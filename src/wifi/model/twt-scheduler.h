@@ -0,0 +1,104 @@
+#pragma once
+#ifndef INC_SRC_WIFI_MODEL_TWT_SCHEDULER_H_
+#define INC_SRC_WIFI_MODEL_TWT_SCHEDULER_H_
+#include "ns3/nstime.h"
+#include "ns3/twt-headers.h"
+
+#include <cinttypes>
+#include <vector>
+namespace ns3
+{
+	/**
+	 * \ingroup wifi
+	 *
+	 * Packing of the TWT service periods of an AP on the time axis.
+	 *
+	 * The service periods, the beacons and the RAW windows are periodic reservations, given by their phase
+	 * relative to a beacon, their interval and their duration. All the intervals are harmonic, i.e. the beacon
+	 * interval multiplied or divided by a power of two, so that two reservations overlap if and only if they
+	 * overlap modulo the shorter of their intervals. New service periods are placed first-fit, at the earliest
+	 * phase which keeps a guard interval to every reservation.
+	 */
+	class TwtScheduler
+	{
+	public:
+		TwtScheduler();
+
+		/**
+		 * \param interval the beacon interval, the base of the harmonic intervals
+		 */
+		void SetBeaconInterval(Time interval);
+		Time GetBeaconInterval() const;
+		/**
+		 * \param guard the minimum time between two reservations
+		 */
+		void SetGuardInterval(Time guard);
+		Time GetGuardInterval() const;
+
+		/**
+		 * Reserve the channel periodically. The interval is rounded down to a harmonic interval.
+		 *
+		 * \param phase the start of the reservation relative to a beacon
+		 * \param interval the interval between two reservations
+		 * \param duration the duration of the reservation
+		 */
+		void Reserve(Time phase, Time interval, Time duration);
+		/**
+		 * Remove all the reservations.
+		 */
+		void Clear();
+		/**
+		 * \return the number of reservations
+		 */
+		uint32_t GetN() const;
+
+		/**
+		 * \param interval a wake interval
+		 * \return the largest harmonic interval which is not longer than the wake interval, or the shortest
+		 *         harmonic interval if there is none
+		 */
+		Time GetHarmonicInterval(Time interval) const;
+		/**
+		 * \param phase the start of a service period relative to a beacon
+		 * \param interval a harmonic interval
+		 * \param duration the duration of the service period
+		 * \return true if the service period keeps the guard interval to every reservation
+		 */
+		bool Fits(Time phase, Time interval, Time duration) const;
+		/**
+		 * Find the earliest phase at which a service period fits.
+		 *
+		 * \param interval a harmonic interval
+		 * \param duration the duration of the service period
+		 * \param phase set to the start of the service period relative to a beacon
+		 * \return false if the service period fits nowhere
+		 */
+		bool FindPhase(Time interval, Time duration, Time &phase) const;
+
+		/**
+		 * \param header a TWT element
+		 * \return the wake interval of the element, the mantissa times two to the power of the exponent in us
+		 */
+		static Time GetWakeInterval(const TWTHeader &header);
+		/**
+		 * \param header a TWT element
+		 * \param interval the wake interval
+		 * \return false if the interval cannot be encoded exactly as a mantissa and an exponent
+		 */
+		static bool SetWakeInterval(TWTHeader &header, Time interval);
+
+	private:
+		/// A periodic reservation, in us
+		struct Reservation
+		{
+			int64_t phase;		//!< The start relative to a beacon, in [0, interval)
+			int64_t interval; //!< The harmonic interval
+			int64_t duration; //!< The duration, guard interval included
+		};
+
+		int64_t m_beaconInterval; //!< The beacon interval, in us
+		int64_t m_guard;					//!< The guard interval, in us
+		std::vector<Reservation> m_reservations;
+	};
+} // namespace ns3
+#endif
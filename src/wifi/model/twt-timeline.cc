@@ -0,0 +1,239 @@
+#include "twt-timeline.h"
+#include "ns3/assert.h"
+#include "ns3/log.h"
+#include "ns3/simulator.h"
+
+#include <algorithm>
+namespace ns3
+{
+	NS_LOG_COMPONENT_DEFINE("TwtTimeline");
+
+	const TwtTimeline::Handle TwtTimeline::INVALID_HANDLE;
+
+	TwtTimeline::TwtTimeline() : m_dispatching(false)
+	{
+	}
+
+	TwtTimeline::~TwtTimeline()
+	{
+		Clear();
+	}
+
+	void TwtTimeline::SetBoundaryCallbacks(BoundaryCallback start, BoundaryCallback end)
+	{
+		m_start = start;
+		m_end = end;
+	}
+
+	TwtTimeline::Handle TwtTimeline::Add(const TWTAgreementKey &key, const TWTAgreementData &data)
+	{
+		NS_ASSERT_MSG(key.flowIdentifier < 8, "TWT flow identifiers range from 0 to 7");
+		auto peer = m_peers.find(key.macAddress);
+		if (peer == m_peers.end()) {
+			Peer empty;
+			std::fill(empty.flows, empty.flows + 8, INVALID_HANDLE);
+			empty.nAgreements = 0;
+			empty.nServicePeriods = 0;
+			peer = m_peers.emplace(key.macAddress, empty).first;
+		} else if (peer->second.flows[key.flowIdentifier] != INVALID_HANDLE) {
+			return INVALID_HANDLE;
+		}
+		Handle handle;
+		if (m_free.empty()) {
+			handle = m_slots.size();
+			m_slots.emplace_back();
+		} else {
+			handle = m_free.back();
+			m_free.pop_back();
+		}
+		Slot &slot = m_slots[handle];
+		slot.key = key;
+		slot.data = data;
+		slot.used = true;
+		slot.inServicePeriod = false;
+		slot.scheduled = false;
+		peer->second.flows[key.flowIdentifier] = handle;
+		peer->second.nAgreements++;
+		return handle;
+	}
+
+	void TwtTimeline::Remove(Handle handle)
+	{
+		NS_ASSERT(handle < m_slots.size() && m_slots[handle].used);
+		Slot &slot = m_slots[handle];
+		Unschedule(slot);
+		SetInServicePeriod(slot, false);
+		auto peer = m_peers.find(slot.key.macAddress);
+		peer->second.flows[slot.key.flowIdentifier] = INVALID_HANDLE;
+		if (--peer->second.nAgreements == 0) {
+			m_peers.erase(peer);
+		}
+		slot.used = false;
+		slot.data = TWTAgreementData();
+		m_free.push_back(handle);
+		Arm();
+	}
+
+	TwtTimeline::Handle TwtTimeline::Find(const TWTAgreementKey &key) const
+	{
+		auto peer = m_peers.find(key.macAddress);
+		if (peer == m_peers.end() || key.flowIdentifier >= 8) {
+			return INVALID_HANDLE;
+		}
+		return peer->second.flows[key.flowIdentifier];
+	}
+
+	const TWTAgreementKey &TwtTimeline::GetKey(Handle handle) const
+	{
+		NS_ASSERT(handle < m_slots.size() && m_slots[handle].used);
+		return m_slots[handle].key;
+	}
+
+	TWTAgreementData &TwtTimeline::GetData(Handle handle)
+	{
+		NS_ASSERT(handle < m_slots.size() && m_slots[handle].used);
+		return m_slots[handle].data;
+	}
+
+	const TWTAgreementData &TwtTimeline::GetData(Handle handle) const
+	{
+		NS_ASSERT(handle < m_slots.size() && m_slots[handle].used);
+		return m_slots[handle].data;
+	}
+
+	uint32_t TwtTimeline::GetN() const
+	{
+		return m_slots.size() - m_free.size();
+	}
+
+	void TwtTimeline::GetAgreements(std::vector<Handle> &handles) const
+	{
+		for (Handle handle = 0; handle < m_slots.size(); ++handle) {
+			if (m_slots[handle].used) {
+				handles.push_back(handle);
+			}
+		}
+	}
+
+	void TwtTimeline::GetAgreements(const Mac48Address &peer, std::vector<Handle> &handles) const
+	{
+		auto location = m_peers.find(peer);
+		if (location == m_peers.end()) {
+			return;
+		}
+		for (uint8_t i = 0; i < 8; ++i) {
+			if (location->second.flows[i] != INVALID_HANDLE) {
+				handles.push_back(location->second.flows[i]);
+			}
+		}
+	}
+
+	bool TwtTimeline::HasAgreements(const Mac48Address &peer) const
+	{
+		return m_peers.find(peer) != m_peers.end();
+	}
+
+	bool TwtTimeline::IsInServicePeriod(const Mac48Address &peer) const
+	{
+		auto location = m_peers.find(peer);
+		return location != m_peers.end() && location->second.nServicePeriods > 0;
+	}
+
+	void TwtTimeline::ScheduleStart(Handle handle, Time delay)
+	{
+		NS_ASSERT(handle < m_slots.size() && m_slots[handle].used);
+		NS_ASSERT_MSG(!delay.IsNegative(), "Service period scheduled to start " << -delay << " in the past");
+		SetInServicePeriod(m_slots[handle], false);
+		Insert(handle, Simulator::Now() + delay, true);
+	}
+
+	void TwtTimeline::StartServicePeriod(Handle handle, Time duration)
+	{
+		NS_ASSERT(handle < m_slots.size() && m_slots[handle].used);
+		NS_ASSERT_MSG(!duration.IsNegative(), "Service period of negative duration " << duration);
+		SetInServicePeriod(m_slots[handle], true);
+		Insert(handle, Simulator::Now() + duration, false);
+	}
+
+	void TwtTimeline::Clear()
+	{
+		m_event.Cancel();
+		m_boundaries.clear();
+		m_peers.clear();
+		m_slots.clear();
+		m_free.clear();
+	}
+
+	void TwtTimeline::Unschedule(Slot &slot)
+	{
+		if (slot.scheduled) {
+			m_boundaries.erase(slot.boundary);
+			slot.scheduled = false;
+		}
+	}
+
+	void TwtTimeline::SetInServicePeriod(Slot &slot, bool inServicePeriod)
+	{
+		if (slot.inServicePeriod == inServicePeriod) {
+			return;
+		}
+		slot.inServicePeriod = inServicePeriod;
+		Peer &peer = m_peers.find(slot.key.macAddress)->second;
+		if (inServicePeriod) {
+			peer.nServicePeriods++;
+		} else {
+			peer.nServicePeriods--;
+		}
+	}
+
+	void TwtTimeline::Insert(Handle handle, Time at, bool start)
+	{
+		Slot &slot = m_slots[handle];
+		Unschedule(slot);
+		// Boundaries at the same time are handled in the order they were scheduled
+		slot.boundary = m_boundaries.emplace(at, Boundary{handle, start});
+		slot.scheduled = true;
+		Arm();
+	}
+
+	void TwtTimeline::Arm()
+	{
+		if (m_dispatching) {
+			// Dispatch arms the event once all the due boundaries are handled
+			return;
+		}
+		if (m_boundaries.empty()) {
+			m_event.Cancel();
+			return;
+		}
+		Time earliest = m_boundaries.begin()->first;
+		if (m_event.IsRunning() && m_eventTime == earliest) {
+			return;
+		}
+		m_event.Cancel();
+		m_eventTime = earliest;
+		m_event = Simulator::Schedule(earliest - Simulator::Now(), &TwtTimeline::Dispatch, this);
+	}
+
+	void TwtTimeline::Dispatch()
+	{
+		m_dispatching = true;
+		Time now = Simulator::Now();
+		while (!m_boundaries.empty() && m_boundaries.begin()->first <= now) {
+			Boundary boundary = m_boundaries.begin()->second;
+			m_boundaries.erase(m_boundaries.begin());
+			Slot &slot = m_slots[boundary.handle];
+			slot.scheduled = false;
+			NS_LOG_DEBUG("Service period of " << slot.key.macAddress << " flow " << static_cast<uint32_t>(slot.key.flowIdentifier)
+																				<< (boundary.start ? " starts" : " ends"));
+			if (boundary.start) {
+				m_start(slot.key, slot.data);
+			} else {
+				SetInServicePeriod(slot, false);
+				m_end(slot.key, slot.data);
+			}
+		}
+		m_dispatching = false;
+		Arm();
+	}
+} // namespace ns3
@@ -0,0 +1,170 @@
+#pragma once
+#ifndef INC_SRC_WIFI_MODEL_TWT_TIMELINE_H_
+#define INC_SRC_WIFI_MODEL_TWT_TIMELINE_H_
+#include "ns3/callback.h"
+#include "ns3/event-id.h"
+#include "ns3/mac48-address.h"
+#include "ns3/nstime.h"
+#include "ns3/twt-agreement.h"
+
+#include <cinttypes>
+#include <deque>
+#include <map>
+#include <unordered_map>
+#include <vector>
+namespace ns3
+{
+	/**
+	 * \ingroup wifi
+	 *
+	 * The TWT agreements of a MAC and the boundaries of their service periods.
+	 *
+	 * The agreements are stored densely and referenced by handle, and are indexed by peer so that
+	 * checking whether a service period with a peer is under way takes no more than a hash lookup.
+	 * The next boundary of every agreement, either the start or the end of a service period, is kept
+	 * on a single timeline, for which only the earliest boundary is scheduled in the simulator.
+	 */
+	class TwtTimeline
+	{
+	public:
+		/// The handle of an agreement, stable until the agreement is removed
+		typedef uint32_t Handle;
+		/// Called at a boundary of a service period of an agreement
+		typedef Callback<void, TWTAgreementKey &, TWTAgreementData &> BoundaryCallback;
+
+		/// The handle of no agreement
+		static const Handle INVALID_HANDLE = 0xffffffff;
+
+		TwtTimeline();
+		~TwtTimeline();
+
+		/**
+		 * \param start called when a service period is due to start
+		 * \param end called when a service period is due to end
+		 */
+		void SetBoundaryCallbacks(BoundaryCallback start, BoundaryCallback end);
+
+		/**
+		 * Store an agreement, without any service period scheduled.
+		 *
+		 * \param key the peer and flow identifier of the agreement
+		 * \param data the agreement
+		 * \return the handle of the agreement, or INVALID_HANDLE if the key is already in use
+		 */
+		Handle Add(const TWTAgreementKey &key, const TWTAgreementData &data);
+		/**
+		 * Remove an agreement and cancel its next boundary.
+		 *
+		 * \param handle the agreement
+		 */
+		void Remove(Handle handle);
+		/**
+		 * \param key the peer and flow identifier of an agreement
+		 * \return the handle of the agreement, or INVALID_HANDLE if there is none
+		 */
+		Handle Find(const TWTAgreementKey &key) const;
+		/**
+		 * \param handle an agreement
+		 * \return the key of the agreement
+		 */
+		const TWTAgreementKey &GetKey(Handle handle) const;
+		/**
+		 * \param handle an agreement
+		 * \return the agreement
+		 */
+		TWTAgreementData &GetData(Handle handle);
+		/**
+		 * \param handle an agreement
+		 * \return the agreement
+		 */
+		const TWTAgreementData &GetData(Handle handle) const;
+		/**
+		 * \return the number of agreements
+		 */
+		uint32_t GetN() const;
+		/**
+		 * \param handles the handles of all the agreements are appended to this vector
+		 */
+		void GetAgreements(std::vector<Handle> &handles) const;
+		/**
+		 * \param peer the address of a peer
+		 * \param handles the handles of the agreements with the peer are appended to this vector, by flow identifier
+		 */
+		void GetAgreements(const Mac48Address &peer, std::vector<Handle> &handles) const;
+		/**
+		 * \param peer the address of a peer
+		 * \return true if there is at least one agreement with the peer
+		 */
+		bool HasAgreements(const Mac48Address &peer) const;
+		/**
+		 * \param peer the address of a peer
+		 * \return true if a service period of an agreement with the peer is under way
+		 */
+		bool IsInServicePeriod(const Mac48Address &peer) const;
+
+		/**
+		 * End the current service period of an agreement, if any, and schedule the start of the next one.
+		 * The boundary replaces the pending boundary of the agreement.
+		 *
+		 * \param handle the agreement
+		 * \param delay the time until the start of the next service period, which must not be negative
+		 */
+		void ScheduleStart(Handle handle, Time delay);
+		/**
+		 * Start a service period of an agreement and schedule its end.
+		 * The boundary replaces the pending boundary of the agreement.
+		 *
+		 * \param handle the agreement
+		 * \param duration the duration of the service period, which must not be negative
+		 */
+		void StartServicePeriod(Handle handle, Time duration);
+		/**
+		 * Remove all the agreements.
+		 */
+		void Clear();
+
+	private:
+		/// A boundary of a service period on the timeline
+		struct Boundary
+		{
+			Handle handle; //!< The agreement
+			bool start;		 //!< Whether the service period starts or ends
+		};
+		typedef std::multimap<Time, Boundary> Boundaries;
+
+		/// An agreement and its state on the timeline
+		struct Slot
+		{
+			TWTAgreementKey key;					//!< The peer and flow identifier
+			TWTAgreementData data;				//!< The agreement
+			bool used;										//!< Whether the slot holds an agreement
+			bool inServicePeriod;					//!< Whether a service period is under way
+			bool scheduled;								//!< Whether the next boundary is on the timeline
+			Boundaries::iterator boundary; //!< The next boundary, if scheduled
+		};
+		/// The agreements with a peer
+		struct Peer
+		{
+			Handle flows[8];				 //!< The agreement of each flow identifier
+			uint8_t nAgreements;		 //!< The number of agreements
+			uint8_t nServicePeriods; //!< The number of service periods under way
+		};
+
+		void Unschedule(Slot &slot);
+		void SetInServicePeriod(Slot &slot, bool inServicePeriod);
+		void Insert(Handle handle, Time at, bool start);
+		void Arm();
+		void Dispatch();
+
+		std::deque<Slot> m_slots;																	//!< The agreements, by handle
+		std::vector<Handle> m_free;																//!< The handles of the unused slots
+		std::unordered_map<Mac48Address, Peer, Mac48AddressHash> m_peers; //!< The agreements, by peer
+		Boundaries m_boundaries;																	//!< The next boundary of each agreement
+		EventId m_event;																					//!< The event of the earliest boundary
+		Time m_eventTime;																					//!< The time of m_event
+		bool m_dispatching;																				//!< Whether the boundaries are being handled
+		BoundaryCallback m_start;																	//!< Called at the start of a service period
+		BoundaryCallback m_end;																		//!< Called at the end of a service period
+	};
+} // namespace ns3
+#endif
@@ -0,0 +1,101 @@
+#include "twt-trace.h"
+#include "ns3/assert.h"
+
+#include <cstring>
+namespace ns3
+{
+	const uint8_t TwtEvent::TWT_EVENT_ANY_FLOW;
+	const uint32_t TwtEvent::SERIALIZED_SIZE;
+
+	std::ostream &operator<<(std::ostream &os, const TwtEvent &event)
+	{
+		static const char *names[] = {"setup", "teardown", "sp-start", "sp-end", "queued"};
+		os << "+" << event.time << "ns " << (event.type <= TWT_EVENT_QUEUED ? names[event.type] : "unknown") << " " << event.key.macAddress
+			 << "/" << static_cast<unsigned>(event.key.flowIdentifier) << " sp=[" << event.spStart << "," << event.spEnd
+			 << ") queued=" << event.queued << " flushed=" << event.flushed;
+		return os;
+	}
+
+	TwtEventRing::TwtEventRing(uint32_t capacity) : m_capacity(capacity), m_next(0), m_lost(0)
+	{
+		NS_ASSERT(capacity > 0);
+		m_events.reserve(capacity);
+	}
+
+	void TwtEventRing::Record(const TwtEvent &event)
+	{
+		if (m_events.size() < m_capacity) {
+			m_events.push_back(event);
+			return;
+		}
+		m_events[m_next] = event;
+		m_next = (m_next + 1) % m_capacity;
+		m_lost++;
+	}
+
+	uint32_t TwtEventRing::GetN() const
+	{
+		return m_events.size();
+	}
+
+	uint32_t TwtEventRing::GetCapacity() const
+	{
+		return m_capacity;
+	}
+
+	uint64_t TwtEventRing::GetLost() const
+	{
+		return m_lost;
+	}
+
+	const TwtEvent &TwtEventRing::Get(uint32_t i) const
+	{
+		NS_ASSERT(i < m_events.size());
+		return m_events[(m_next + i) % m_events.size()];
+	}
+
+	void TwtEventRing::Clear()
+	{
+		m_events.clear();
+		m_next = 0;
+		m_lost = 0;
+	}
+
+	void TwtEventRing::Write(std::ostream &os) const
+	{
+		uint8_t record[TwtEvent::SERIALIZED_SIZE];
+		for (uint32_t i = 0; i < m_events.size(); i++) {
+			const TwtEvent &event = Get(i);
+			uint8_t *p = record;
+			std::memcpy(p, &event.time, 8);
+			std::memcpy(p + 8, &event.spStart, 8);
+			std::memcpy(p + 16, &event.spEnd, 8);
+			std::memcpy(p + 24, &event.queued, 4);
+			std::memcpy(p + 28, &event.flushed, 4);
+			event.key.macAddress.CopyTo(p + 32);
+			p[38] = event.key.flowIdentifier;
+			p[39] = event.type;
+			os.write(reinterpret_cast<const char *>(record), sizeof(record));
+		}
+	}
+
+	uint32_t TwtEventRing::Read(std::istream &is, std::vector<TwtEvent> &events)
+	{
+		uint8_t record[TwtEvent::SERIALIZED_SIZE];
+		uint32_t n = 0;
+		while (is.read(reinterpret_cast<char *>(record), sizeof(record))) {
+			TwtEvent event;
+			std::memcpy(&event.time, record, 8);
+			std::memcpy(&event.spStart, record + 8, 8);
+			std::memcpy(&event.spEnd, record + 16, 8);
+			std::memcpy(&event.queued, record + 24, 4);
+			std::memcpy(&event.flushed, record + 28, 4);
+			event.key.macAddress.CopyFrom(record + 32);
+			event.key.flowIdentifier = record[38];
+			event.type = static_cast<TwtEventType>(record[39]);
+			events.push_back(event);
+			n++;
+		}
+		return n;
+	}
+} // namespace ns3
@@ -0,0 +1,121 @@
+#pragma once
+#ifndef INC_SRC_WIFI_MODEL_TWT_TRACE_H_
+#define INC_SRC_WIFI_MODEL_TWT_TRACE_H_
+#include "ns3/twt-agreement.h"
+
+#include <cinttypes>
+#include <istream>
+#include <ostream>
+#include <vector>
+namespace ns3
+{
+	enum TwtEventType : uint8_t
+	{
+		TWT_EVENT_SETUP = 0,		//!< An agreement was created
+		TWT_EVENT_TEARDOWN = 1, //!< An agreement was removed
+		TWT_EVENT_SP_START = 2, //!< A service period started
+		TWT_EVENT_SP_END = 3,		//!< A service period ended
+		TWT_EVENT_QUEUED = 4		//!< A frame was buffered until the next service period with its receiver
+	};
+
+	/**
+	 * \ingroup wifi
+	 *
+	 * A TWT event of a MAC, as fired by the TwtEvent trace source of RegularWifiMac.
+	 *
+	 * The frames are buffered per peer rather than per agreement, so a TWT_EVENT_QUEUED event carries the
+	 * flow identifier TWT_EVENT_ANY_FLOW.
+	 */
+	struct TwtEvent
+	{
+		/// The flow identifier of the events which are not related to a single agreement
+		static const uint8_t TWT_EVENT_ANY_FLOW = 0xff;
+		/// The size of an event in the binary format of TwtEventRing
+		static const uint32_t SERIALIZED_SIZE = 40;
+
+		int64_t time;					//!< Time of the event, in ns
+		int64_t spStart;			//!< Start of the service period, in ns: the first one for a setup
+		int64_t spEnd;				//!< End of the service period, in ns
+		uint32_t queued;			//!< Frames buffered for the peer after the event
+		uint32_t flushed;			//!< Frames handed to the channel access by the event
+		TWTAgreementKey key;	//!< The agreement
+		TwtEventType type;		//!< The kind of event
+
+		/**
+		 * \param event the event
+		 */
+		typedef void (*TracedCallback)(const TwtEvent &event);
+	};
+	std::ostream &operator<<(std::ostream &os, const TwtEvent &event);
+
+	/**
+	 * \ingroup wifi
+	 *
+	 * A sink of the TwtEvent trace source which keeps the last events in a fixed ring buffer, so that the TWT
+	 * behaviour of a run can be captured without any I/O during the simulation:
+	 * \code
+	 *   TwtEventRing ring (65536);
+	 *   mac->TraceConnectWithoutContext ("TwtEvent", MakeCallback (&TwtEventRing::Record, &ring));
+	 *   ...
+	 *   std::ofstream os ("twt.bin", std::ios::binary);
+	 *   ring.Write (os);
+	 * \endcode
+	 * The binary format is a sequence of SERIALIZED_SIZE byte records, oldest first, with the integers in host
+	 * byte order: time, SP start, SP end, queued, flushed, MAC address, flow identifier, type.
+	 */
+	class TwtEventRing
+	{
+	public:
+		/**
+		 * \param capacity the number of events kept
+		 */
+		explicit TwtEventRing(uint32_t capacity = 4096);
+
+		/**
+		 * Keep an event, overwriting the oldest one if the ring is full.
+		 *
+		 * \param event the event
+		 */
+		void Record(const TwtEvent &event);
+		/**
+		 * \return the number of events kept
+		 */
+		uint32_t GetN() const;
+		uint32_t GetCapacity() const;
+		/**
+		 * \return the number of events overwritten since the last Clear
+		 */
+		uint64_t GetLost() const;
+		/**
+		 * \param i the index of an event, 0 for the oldest one kept
+		 * \return the event
+		 */
+		const TwtEvent &Get(uint32_t i) const;
+		/**
+		 * Drop all the events.
+		 */
+		void Clear();
+
+		/**
+		 * Write the events kept, oldest first.
+		 *
+		 * \param os a binary stream
+		 */
+		void Write(std::ostream &os) const;
+		/**
+		 * Read events written by Write.
+		 *
+		 * \param is a binary stream
+		 * \param events the events read are appended to this vector
+		 * \return the number of events read
+		 */
+		static uint32_t Read(std::istream &is, std::vector<TwtEvent> &events);
+
+	private:
+		std::vector<TwtEvent> m_events; //!< The events, m_next being the oldest once the ring is full
+		uint32_t m_capacity;
+		uint32_t m_next;								//!< The slot the next event is written to
+		uint64_t m_lost;
+	};
+} // namespace ns3
+#endif
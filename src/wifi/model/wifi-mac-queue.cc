@@ -31,6 +31,8 @@ namespace ns3
 
 	NS_OBJECT_ENSURE_REGISTERED(WifiMacQueue);
 
+	const uint8_t WifiMacQueue::NON_QOS_TID;
+
 	WifiMacQueue::Item::Item(Ptr<const Packet> packet, const WifiMacHeader &hdr, Time tstamp) : packet(packet), hdr(hdr), tstamp(tstamp)
 	{
 	}
@@ -47,11 +49,13 @@ namespace ns3
 						.AddAttribute("MaxDelay", "If a packet stays longer than this delay in the queue, it is dropped.",
 													TimeValue(MilliSeconds(500.0)), MakeTimeAccessor(&WifiMacQueue::m_maxDelay), MakeTimeChecker())
 						.AddTraceSource("PacketDropped", "Trace source indicating a packet has been dropped from the queue",
-														MakeTraceSourceAccessor(&WifiMacQueue::m_packetdropped), "ns3::WifiMacQueue::PacketDroppedCallback");
+														MakeTraceSourceAccessor(&WifiMacQueue::m_packetdropped), "ns3::WifiMacQueue::PacketDroppedCallback")
+						.AddTraceSource("Enqueue", "A packet has been queued, at the end or at the front of the queue",
+														MakeTraceSourceAccessor(&WifiMacQueue::m_enqueue), "ns3::WifiMacQueue::EnqueueCallback");
 		return tid;
 	}
 
-	WifiMacQueue::WifiMacQueue() : m_size(0)
+	WifiMacQueue::WifiMacQueue() : m_front(0), m_back(0), m_size(0)
 	{
 	}
 
@@ -80,47 +84,132 @@ namespace ns3
 		return m_maxDelay;
 	}
 
+	void WifiMacQueue::SetEnqueueCallback(Enqueued callback)
+	{
+		m_enqueueCallback = callback;
+	}
+
+	WifiMacQueue::Destination WifiMacQueue::GetDestination(const WifiMacHeader &hdr)
+	{
+		if (hdr.IsQosData()) {
+			return Destination(hdr.GetAddr1(), hdr.GetQosTid());
+		}
+		return Destination(hdr.GetAddr1(), NON_QOS_TID);
+	}
+
+	void WifiMacQueue::Insert(int64_t position, const Item &item)
+	{
+		m_queue.insert(position < 0 ? m_queue.begin() : m_queue.end(), std::make_pair(position, item));
+		Destination destination = GetDestination(item.hdr);
+		std::set<int64_t> &positions = m_destinations[destination];
+		if (positions.empty() || position < *positions.begin()) {
+			if (!positions.empty()) {
+				m_heads.erase(*positions.begin());
+			}
+			m_heads[position] = destination;
+		}
+		positions.insert(position);
+		m_expiry.push_back(std::make_pair(item.tstamp, position));
+		m_size++;
+		if (!m_enqueueCallback.IsNull()) {
+			m_enqueueCallback(item.packet, item.hdr);
+		}
+		if (NS_TRACE_IS_CONNECTED("Enqueue", m_enqueue)) {
+			m_enqueue(item.packet, item.hdr);
+		}
+	}
+
+	void WifiMacQueue::Erase(PacketQueueI it)
+	{
+		std::map<Destination, std::set<int64_t> >::iterator destination = m_destinations.find(GetDestination(it->second.hdr));
+		std::set<int64_t> &positions = destination->second;
+		if (*positions.begin() == it->first) {
+			m_heads.erase(it->first);
+			positions.erase(positions.begin());
+			if (positions.empty()) {
+				m_destinations.erase(destination);
+			} else {
+				m_heads[*positions.begin()] = destination->first;
+			}
+		} else {
+			positions.erase(it->first);
+		}
+		// The entry of m_expiry is dropped when it reaches the front
+		m_queue.erase(it);
+		m_size--;
+	}
+
+	WifiMacQueue::PacketQueueI WifiMacQueue::FindFirst(const Destination &destination)
+	{
+		std::map<Destination, std::set<int64_t> >::const_iterator it = m_destinations.find(destination);
+		if (it == m_destinations.end()) {
+			return m_queue.end();
+		}
+		return m_queue.find(*it->second.begin());
+	}
+
+	WifiMacQueue::PacketQueueI WifiMacQueue::FindFirstAvailable(const QosBlockedDestinations *blockedPackets)
+	{
+		// The first packet of a destination which is not blocked is the
+		// first available packet of that destination
+		for (std::map<int64_t, Destination>::const_iterator head = m_heads.begin(); head != m_heads.end(); head++) {
+			if (head->second.second == NON_QOS_TID || !blockedPackets->IsBlocked(head->second.first, head->second.second)) {
+				return m_queue.find(head->first);
+			}
+		}
+		return m_queue.end();
+	}
+
 	void WifiMacQueue::Enqueue(Ptr<const Packet> packet, const WifiMacHeader &hdr)
 	{
 		Cleanup();
 		if (m_size == m_maxSize) {
 			// std::cout << "DROPPING PACKET FROM WIFI MAC QUEUE " << std::endl;
-			m_packetdropped(packet->Copy(), DropReason::MacQueueSizeExceeded);
+			if (NS_TRACE_IS_CONNECTED("PacketDropped", m_packetdropped)) {
+				m_packetdropped(packet->Copy(), DropReason::MacQueueSizeExceeded);
+			}
 			return;
 		}
 		Time now = Simulator::Now();
-		m_queue.push_back(Item(packet, hdr, now));
-		m_size++;
+		Insert(m_back++, Item(packet, hdr, now));
 	}
 
 	void WifiMacQueue::Cleanup(void)
 	{
-		if (m_queue.empty()) {
-			return;
-		}
-
+		// Every packet is queued at the current time, so the packets
+		// expire in the order they were queued
 		Time now = Simulator::Now();
-		uint32_t n = 0;
-		for (PacketQueueI i = m_queue.begin(); i != m_queue.end();) {
-			if (i->tstamp + m_maxDelay > now) {
-				i++;
-			} else {
-				m_packetdropped(i->packet->Copy(), DropReason::MacQueueDelayExceeded);
-				i = m_queue.erase(i);
-				n++;
+		while (!m_expiry.empty() && m_expiry.front().first + m_maxDelay <= now) {
+			PacketQueueI it = m_queue.find(m_expiry.front().second);
+			if (it != m_queue.end()) {
+				if (NS_TRACE_IS_CONNECTED("PacketDropped", m_packetdropped)) {
+					m_packetdropped(it->second.packet->Copy(), DropReason::MacQueueDelayExceeded);
+				}
+				Erase(it);
+			}
+			m_expiry.pop_front();
+		}
+		// Drop the entries of the packets removed behind the front, which
+		// pile up when the first packet is held for long
+		if (m_expiry.size() > 2 * m_size + 64) {
+			std::deque<std::pair<Time, int64_t> > expiry;
+			for (std::deque<std::pair<Time, int64_t> >::const_iterator i = m_expiry.begin(); i != m_expiry.end(); i++) {
+				if (m_queue.count(i->second) != 0) {
+					expiry.push_back(*i);
+				}
 			}
+			m_expiry.swap(expiry);
 		}
-		m_size -= n;
 	}
+
 	Ptr<const Packet> WifiMacQueue::Dequeue(WifiMacHeader *hdr)
 	{
 		Cleanup();
 		if (!m_queue.empty()) {
-			Item i = m_queue.front();
-			m_queue.pop_front();
-			m_size--;
-			*hdr = i.hdr;
-			return i.packet;
+			Ptr<const Packet> packet = m_queue.begin()->second.packet;
+			*hdr = m_queue.begin()->second.hdr;
+			Erase(m_queue.begin());
+			return packet;
 		}
 		return 0;
 	}
@@ -129,9 +218,8 @@ namespace ns3
 	{
 		Cleanup();
 		if (!m_queue.empty()) {
-			Item i = m_queue.front();
-			*hdr = i.hdr;
-			return i.packet;
+			*hdr = m_queue.begin()->second.hdr;
+			return m_queue.begin()->second.packet;
 		}
 		return 0;
 	}
@@ -141,20 +229,21 @@ namespace ns3
 	{
 		Cleanup();
 		Ptr<const Packet> packet = 0;
-		if (!m_queue.empty()) {
-			PacketQueueI it;
+		PacketQueueI it;
+		if (type == WifiMacHeader::ADDR1) {
+			it = FindFirst(Destination(dest, tid));
+		} else {
 			for (it = m_queue.begin(); it != m_queue.end(); ++it) {
-				if (it->hdr.IsQosData()) {
-					if (GetAddressForPacket(type, it) == dest && it->hdr.GetQosTid() == tid) {
-						packet = it->packet;
-						*hdr = it->hdr;
-						m_queue.erase(it);
-						m_size--;
-						break;
-					}
+				if (it->second.hdr.IsQosData() && GetAddressForPacket(type, it) == dest && it->second.hdr.GetQosTid() == tid) {
+					break;
 				}
 			}
 		}
+		if (it != m_queue.end()) {
+			packet = it->second.packet;
+			*hdr = it->second.hdr;
+			Erase(it);
+		}
 		return packet;
 	}
 
@@ -162,31 +251,44 @@ namespace ns3
 																											Time *timestamp)
 	{
 		Cleanup();
-		if (!m_queue.empty()) {
-			PacketQueueI it;
+		PacketQueueI it;
+		if (type == WifiMacHeader::ADDR1) {
+			it = FindFirst(Destination(dest, tid));
+		} else {
 			for (it = m_queue.begin(); it != m_queue.end(); ++it) {
-				if (it->hdr.IsQosData()) {
-					if (GetAddressForPacket(type, it) == dest && it->hdr.GetQosTid() == tid) {
-						*hdr = it->hdr;
-						*timestamp = it->tstamp;
-						return it->packet;
-					}
+				if (it->second.hdr.IsQosData() && GetAddressForPacket(type, it) == dest && it->second.hdr.GetQosTid() == tid) {
+					break;
 				}
 			}
 		}
+		if (it != m_queue.end()) {
+			*hdr = it->second.hdr;
+			*timestamp = it->second.tstamp;
+			return it->second.packet;
+		}
 		return 0;
 	}
 
 	Ptr<const Packet> WifiMacQueue::PeekByAddress(WifiMacHeader::AddressType type, Mac48Address dest)
 	{
 		Cleanup();
-		if (!m_queue.empty()) {
-			PacketQueueI it;
-			for (it = m_queue.begin(); it != m_queue.end(); ++it) {
-				if (GetAddressForPacket(type, it) == dest) {
-					return it->packet;
+		if (type == WifiMacHeader::ADDR1) {
+			// The destinations of a receiver are next to each other, in order of TID
+			int64_t first = 0;
+			bool found = false;
+			std::map<Destination, std::set<int64_t> >::const_iterator it = m_destinations.lower_bound(Destination(dest, 0));
+			for (; it != m_destinations.end() && it->first.first == dest; it++) {
+				if (!found || *it->second.begin() < first) {
+					first = *it->second.begin();
+					found = true;
 				}
 			}
+			return found ? m_queue.find(first)->second.packet : 0;
+		}
+		for (PacketQueueI it = m_queue.begin(); it != m_queue.end(); ++it) {
+			if (GetAddressForPacket(type, it) == dest) {
+				return it->second.packet;
+			}
 		}
 		return 0;
 	}
@@ -204,20 +306,23 @@ namespace ns3
 
 	void WifiMacQueue::Flush(void)
 	{
-		m_queue.erase(m_queue.begin(), m_queue.end());
+		m_queue.clear();
+		m_destinations.clear();
+		m_heads.clear();
+		m_expiry.clear();
 		m_size = 0;
 	}
 
 	Mac48Address WifiMacQueue::GetAddressForPacket(enum WifiMacHeader::AddressType type, PacketQueueI it)
 	{
 		if (type == WifiMacHeader::ADDR1) {
-			return it->hdr.GetAddr1();
+			return it->second.hdr.GetAddr1();
 		}
 		if (type == WifiMacHeader::ADDR2) {
-			return it->hdr.GetAddr2();
+			return it->second.hdr.GetAddr2();
 		}
 		if (type == WifiMacHeader::ADDR3) {
-			return it->hdr.GetAddr3();
+			return it->second.hdr.GetAddr3();
 		}
 		return 0;
 	}
@@ -226,9 +331,8 @@ namespace ns3
 	{
 		PacketQueueI it = m_queue.begin();
 		for (; it != m_queue.end(); it++) {
-			if (it->packet == packet) {
-				m_queue.erase(it);
-				m_size--;
+			if (it->second.packet == packet) {
+				Erase(it);
 				return true;
 			}
 		}
@@ -239,25 +343,27 @@ namespace ns3
 	{
 		Cleanup();
 		if (m_size == m_maxSize) {
-			m_packetdropped(packet->Copy(), DropReason::MacQueueSizeExceeded);
+			if (NS_TRACE_IS_CONNECTED("PacketDropped", m_packetdropped)) {
+				m_packetdropped(packet->Copy(), DropReason::MacQueueSizeExceeded);
+			}
 			return;
 		}
 		Time now = Simulator::Now();
-		m_queue.push_front(Item(packet, hdr, now));
-		m_size++;
+		Insert(--m_front, Item(packet, hdr, now));
 	}
 
 	uint32_t WifiMacQueue::GetNPacketsByTidAndAddress(uint8_t tid, WifiMacHeader::AddressType type, Mac48Address addr)
 	{
 		Cleanup();
+		if (type == WifiMacHeader::ADDR1) {
+			std::map<Destination, std::set<int64_t> >::const_iterator it = m_destinations.find(Destination(addr, tid));
+			return it == m_destinations.end() ? 0 : it->second.size();
+		}
 		uint32_t nPackets = 0;
-		if (!m_queue.empty()) {
-			PacketQueueI it;
-			for (it = m_queue.begin(); it != m_queue.end(); it++) {
-				if (GetAddressForPacket(type, it) == addr) {
-					if (it->hdr.IsQosData() && it->hdr.GetQosTid() == tid) {
-						nPackets++;
-					}
+		for (PacketQueueI it = m_queue.begin(); it != m_queue.end(); it++) {
+			if (GetAddressForPacket(type, it) == addr) {
+				if (it->second.hdr.IsQosData() && it->second.hdr.GetQosTid() == tid) {
+					nPackets++;
 				}
 			}
 		}
@@ -268,15 +374,12 @@ namespace ns3
 	{
 		Cleanup();
 		Ptr<const Packet> packet = 0;
-		for (PacketQueueI it = m_queue.begin(); it != m_queue.end(); it++) {
-			if (!it->hdr.IsQosData() || !blockedPackets->IsBlocked(it->hdr.GetAddr1(), it->hdr.GetQosTid())) {
-				*hdr = it->hdr;
-				timestamp = it->tstamp;
-				packet = it->packet;
-				m_queue.erase(it);
-				m_size--;
-				return packet;
-			}
+		PacketQueueI it = FindFirstAvailable(blockedPackets);
+		if (it != m_queue.end()) {
+			*hdr = it->second.hdr;
+			timestamp = it->second.tstamp;
+			packet = it->second.packet;
+			Erase(it);
 		}
 		return packet;
 	}
@@ -284,12 +387,11 @@ namespace ns3
 	Ptr<const Packet> WifiMacQueue::PeekFirstAvailable(WifiMacHeader *hdr, Time &timestamp, const QosBlockedDestinations *blockedPackets)
 	{
 		Cleanup();
-		for (PacketQueueI it = m_queue.begin(); it != m_queue.end(); it++) {
-			if (!it->hdr.IsQosData() || !blockedPackets->IsBlocked(it->hdr.GetAddr1(), it->hdr.GetQosTid())) {
-				*hdr = it->hdr;
-				timestamp = it->tstamp;
-				return it->packet;
-			}
+		PacketQueueI it = FindFirstAvailable(blockedPackets);
+		if (it != m_queue.end()) {
+			*hdr = it->second.hdr;
+			timestamp = it->second.tstamp;
+			return it->second.packet;
 		}
 		return 0;
 	}
@@ -305,10 +407,10 @@ namespace ns3
 				count++;
 				continue;
 			}
-			if (!it->hdr.IsQosData() || !blockedPackets->IsBlocked(it->hdr.GetAddr1(), it->hdr.GetQosTid())) {
-				*hdr = it->hdr;
-				timestamp = it->tstamp;
-				return it->packet;
+			if (!it->second.hdr.IsQosData() || !blockedPackets->IsBlocked(it->second.hdr.GetAddr1(), it->second.hdr.GetQosTid())) {
+				*hdr = it->second.hdr;
+				timestamp = it->second.tstamp;
+				return it->second.packet;
 			}
 		}
 		return 0;
@@ -23,7 +23,9 @@
 #ifndef WIFI_MAC_QUEUE_H
 #define WIFI_MAC_QUEUE_H
 
-#include <list>
+#include <deque>
+#include <map>
+#include <set>
 #include <utility>
 #include "ns3/packet.h"
 #include "ns3/nstime.h"
@@ -49,6 +51,12 @@ class QosBlockedDestinations;
  * to verify whether or not it should be dropped. If
  * dot11EDCATableMSDULifetime has elapsed, it is dropped.
  * Otherwise, it is returned to the caller.
+ *
+ * The packets are indexed by receiver address and TID, so that the
+ * lookups by destination do not walk the whole queue, which holds the
+ * downlink traffic of every station on an AP. As every packet gets the
+ * same lifetime from the time it is queued, the packets expire in the
+ * order they were queued: only the oldest packets are checked.
  */
 class WifiMacQueue : public Object
 {
@@ -59,6 +67,13 @@ public:
 
   typedef void (* PacketDroppedCallback)
                   (Ptr<const Packet> packet, DropReason reason);
+  typedef void (* EnqueueCallback)
+                  (Ptr<const Packet> packet, const WifiMacHeader &hdr);
+  /**
+   * Callback invoked with every packet queued, at the end or at the front
+   * of the queue.
+   */
+  typedef Callback<void, Ptr<const Packet>, const WifiMacHeader &> Enqueued;
 
   /**
    * Set the maximum queue size.
@@ -84,6 +99,14 @@ public:
    * \return the maximum delay
    */
   Time GetMaxDelay (void) const;
+  /**
+   * Set the callback invoked with every packet queued. Unlike the
+   * "Enqueue" trace source, it is invoked whether or not tracing is
+   * enabled, so that the owner of the queue can track its content.
+   *
+   * \param callback the callback to invoke
+   */
+  void SetEnqueueCallback (Enqueued callback);
 
   /**
    * Enqueue the given packet and its corresponding WifiMacHeader at the <i>end</i> of the queue.
@@ -195,6 +218,7 @@ public:
                                            const QosBlockedDestinations *blockedPackets);
   /**
    * Returns first available packet for transmission. The packet isn't removed from queue.
+   * Each blocked destination is skipped at once, whatever its number of packets.
    *
    * \param hdr the header of the dequeued packet
    * \param tStamp
@@ -255,17 +279,26 @@ protected:
   };
 
   /**
-   * typedef for packet (struct Item) queue.
+   * typedef for packet (struct Item) queue, by position in the queue.
+   * PushFront takes positions below the first one, Enqueue above the last.
    */
-  typedef std::list<struct Item> PacketQueue;
+  typedef std::map<int64_t, struct Item> PacketQueue;
   /**
    * typedef for packet (struct Item) queue reverse iterator.
    */
-  typedef std::list<struct Item>::reverse_iterator PacketQueueRI;
+  typedef PacketQueue::reverse_iterator PacketQueueRI;
   /**
    * typedef for packet (struct Item) queue iterator.
    */
-  typedef std::list<struct Item>::iterator PacketQueueI;
+  typedef PacketQueue::iterator PacketQueueI;
+  /**
+   * The receiver address and TID of a QoS data packet. The other packets
+   * have the TID NON_QOS_TID.
+   */
+  typedef std::pair<Mac48Address, uint8_t> Destination;
+  /** The TID of the Destination of the packets which are not QoS data. */
+  static const uint8_t NON_QOS_TID = 0xff;
+
   /**
    * Return the appropriate address for the given packet (given by PacketQueue iterator).
    *
@@ -275,13 +308,59 @@ protected:
    * \return the address
    */
   Mac48Address GetAddressForPacket (enum WifiMacHeader::AddressType type, PacketQueueI it);
+  /**
+   * \param hdr the header of a packet
+   * \return the destination the packet is indexed by
+   */
+  static Destination GetDestination (const WifiMacHeader &hdr);
+  /**
+   * Queue a packet and index it.
+   *
+   * \param position the position of the packet in the queue
+   * \param item the packet
+   */
+  void Insert (int64_t position, const Item &item);
+  /**
+   * Remove a packet from the queue and from the index.
+   *
+   * \param it the packet
+   */
+  void Erase (PacketQueueI it);
+  /**
+   * Find the first packet of a destination.
+   *
+   * \param destination the destination
+   * \return the packet, or the end of the queue
+   */
+  PacketQueueI FindFirst (const Destination &destination);
+  /**
+   * Find the first packet which is not blocked.
+   *
+   * \param blockedPackets the blocked destinations
+   * \return the packet, or the end of the queue
+   */
+  PacketQueueI FindFirstAvailable (const QosBlockedDestinations *blockedPackets);
 
   PacketQueue m_queue; //!< Packet (struct Item) queue
+  /** The positions of the packets of each destination, in order */
+  std::map<Destination, std::set<int64_t> > m_destinations;
+  /** The destinations, by position of their first packet */
+  std::map<int64_t, Destination> m_heads;
+  /**
+   * The timestamp and position of the packets, in the order they were
+   * queued. The entries of the packets removed before they expire are
+   * left in, and skipped when they reach the front.
+   */
+  std::deque<std::pair<Time, int64_t> > m_expiry;
+  int64_t m_front;     //!< Position of the first packet pushed to the front
+  int64_t m_back;      //!< Position of the next packet enqueued at the end
   uint32_t m_size;     //!< Current queue size
   uint32_t m_maxSize;  //!< Queue capacity
   Time m_maxDelay;     //!< Time to live for packets in the queue
 
   TracedCallback<Ptr<const Packet>, DropReason> m_packetdropped;
+  TracedCallback<Ptr<const Packet>, const WifiMacHeader &> m_enqueue;
+  Enqueued m_enqueueCallback; //!< Invoked with every packet queued
 };
 
 } //namespace ns3
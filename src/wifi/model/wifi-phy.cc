@@ -56,6 +56,18 @@ WifiPhy::GetTypeId (void)
   static TypeId tid = TypeId ("ns3::WifiPhy")
     .SetParent<Object> ()
     .SetGroupName ("Wifi")
+    .AddAttribute ("TxDurationCacheHits",
+                   "The number of transmission durations which were found in the cache.",
+                   TypeId::ATTR_GET,
+                   UintegerValue (0),
+                   MakeUintegerAccessor (&WifiPhy::m_txDurationCacheHits),
+                   MakeUintegerChecker<uint64_t> ())
+    .AddAttribute ("TxDurationCacheMisses",
+                   "The number of transmission durations which were computed and added to the cache.",
+                   TypeId::ATTR_GET,
+                   UintegerValue (0),
+                   MakeUintegerAccessor (&WifiPhy::m_txDurationCacheMisses),
+                   MakeUintegerChecker<uint64_t> ())
     .AddTraceSource ("PhyTxBegin",
                      "Trace source indicating a packet "
                      "has begun transmitting over the channel medium",
@@ -116,6 +128,8 @@ WifiPhy::GetTypeId (void)
 }
 
 WifiPhy::WifiPhy ()
+  : m_txDurationCacheHits (0),
+    m_txDurationCacheMisses (0)
 {
   NS_LOG_FUNCTION (this);
   m_totalAmpduSize = 0;
@@ -816,62 +830,163 @@ else
   return duration;
 }
 
+bool
+WifiPhy::TxDurationKey::operator< (const TxDurationKey &o) const
+{
+  if (size != o.size)
+    {
+      return size < o.size;
+    }
+  if (modeUid != o.modeUid)
+    {
+      return modeUid < o.modeUid;
+    }
+  if (preamble != o.preamble)
+    {
+      return preamble < o.preamble;
+    }
+  if (nss != o.nss)
+    {
+      return nss < o.nss;
+    }
+  if (ness != o.ness)
+    {
+      return ness < o.ness;
+    }
+  if (stbc != o.stbc)
+    {
+      return stbc < o.stbc;
+    }
+  return frequency < o.frequency;
+}
+
 Time
 WifiPhy::CalculateTxDuration (uint32_t size, WifiTxVector txvector, WifiPreamble preamble, double frequency, uint8_t packetType, uint8_t incFlag)
 {
+  if (packetType != 0)
+    {
+      //The duration of an MPDU in an A-MPDU depends on the MPDUs before it,
+      //and incFlag may have to account for it
+      return CalculatePlcpPreambleAndHeaderDuration (txvector, preamble)
+             + GetPayloadDuration (size, txvector, preamble, frequency, packetType, incFlag);
+    }
+  TxDurationKey key;
+  key.size = size;
+  key.modeUid = txvector.GetMode ().GetUid ();
+  key.preamble = preamble;
+  key.nss = txvector.GetNss ();
+  key.ness = txvector.GetNess ();
+  key.stbc = txvector.IsStbc ();
+  key.frequency = frequency;
+  TxDurationCache::const_iterator it = m_txDurationCache.find (key);
+  if (it != m_txDurationCache.end ())
+    {
+      m_txDurationCacheHits++;
+      return it->second;
+    }
+  m_txDurationCacheMisses++;
   Time duration = CalculatePlcpPreambleAndHeaderDuration (txvector, preamble)
     + GetPayloadDuration (size, txvector, preamble, frequency, packetType, incFlag);
+  m_txDurationCache.insert (std::make_pair (key, duration));
   return duration;
 }
 
+bool
+WifiPhy::IsTxEndTraced (void) const
+{
+  return NS_TRACE_IS_CONNECTED ("PhyTxEnd", m_phyTxEndTrace);
+}
+
+bool
+WifiPhy::IsMonitorSniffRxTraced (void) const
+{
+  return NS_TRACE_IS_CONNECTED ("MonitorSnifferRx", m_phyMonitorSniffRxTrace);
+}
+
+bool
+WifiPhy::IsMonitorSniffTxTraced (void) const
+{
+  return NS_TRACE_IS_CONNECTED ("MonitorSnifferTx", m_phyMonitorSniffTxTrace);
+}
+
 void
 WifiPhy::NotifyTxBegin (Ptr<const Packet> packet)
 {
-  m_phyTxBeginTrace (packet);
+  if (NS_TRACE_IS_CONNECTED ("PhyTxBegin", m_phyTxBeginTrace))
+    {
+      m_phyTxBeginTrace (packet);
+    }
 }
 
 void
 WifiPhy::NotifyTxEnd (Ptr<const Packet> packet)
 {
-  m_phyTxEndTrace (packet);
+  if (NS_TRACE_IS_CONNECTED ("PhyTxEnd", m_phyTxEndTrace))
+    {
+      m_phyTxEndTrace (packet);
+    }
 }
 
 void
 WifiPhy::NotifyTxDrop (Ptr<const Packet> packet, DropReason reason)
 {
-  m_phyTxDropTrace (packet);
-  m_phyTxDropWithDropReasonTrace (packet, reason);
+  if (NS_TRACE_IS_CONNECTED ("PhyTxDrop", m_phyTxDropTrace))
+    {
+      m_phyTxDropTrace (packet);
+    }
+  if (NS_TRACE_IS_CONNECTED ("PhyTxDropWithReason", m_phyTxDropWithDropReasonTrace))
+    {
+      m_phyTxDropWithDropReasonTrace (packet, reason);
+    }
 }
 
 void
 WifiPhy::NotifyRxBegin (Ptr<const Packet> packet)
 {
-  m_phyRxBeginTrace (packet);
+  if (NS_TRACE_IS_CONNECTED ("PhyRxBegin", m_phyRxBeginTrace))
+    {
+      m_phyRxBeginTrace (packet);
+    }
 }
 
 void
 WifiPhy::NotifyRxEnd (Ptr<const Packet> packet)
 {
-  m_phyRxEndTrace (packet);
+  if (NS_TRACE_IS_CONNECTED ("PhyRxEnd", m_phyRxEndTrace))
+    {
+      m_phyRxEndTrace (packet);
+    }
 }
 
 void
 WifiPhy::NotifyRxDrop (Ptr<const Packet> packet, DropReason reason)
 {
-  m_phyRxDropTrace (packet);
-  m_phyRxDropWithDropReasonTrace(packet, reason);
+  if (NS_TRACE_IS_CONNECTED ("PhyRxDrop", m_phyRxDropTrace))
+    {
+      m_phyRxDropTrace (packet);
+    }
+  if (NS_TRACE_IS_CONNECTED ("PhyRxDropWithReason", m_phyRxDropWithDropReasonTrace))
+    {
+      m_phyRxDropWithDropReasonTrace (packet, reason);
+    }
 }
 
 void
 WifiPhy::NotifyMonitorSniffRx (Ptr<const Packet> packet, uint16_t channelFreqMhz, uint16_t channelNumber, uint32_t rate, bool isShortPreamble, WifiTxVector txvector, double signalDbm, double noiseDbm)
 {
-  m_phyMonitorSniffRxTrace (packet, channelFreqMhz, channelNumber, rate, isShortPreamble, txvector, signalDbm, noiseDbm);
+  if (NS_TRACE_IS_CONNECTED ("MonitorSnifferRx", m_phyMonitorSniffRxTrace))
+    {
+      m_phyMonitorSniffRxTrace (packet, channelFreqMhz, channelNumber, rate, isShortPreamble, txvector, signalDbm, noiseDbm);
+    }
 }
 
 void
 WifiPhy::NotifyMonitorSniffTx (Ptr<const Packet> packet, uint16_t channelFreqMhz, uint16_t channelNumber, uint32_t rate, bool isShortPreamble, WifiTxVector txvector)
 {
-  m_phyMonitorSniffTxTrace (packet, channelFreqMhz, channelNumber, rate, isShortPreamble, txvector);
+  if (NS_TRACE_IS_CONNECTED ("MonitorSnifferTx", m_phyMonitorSniffTxTrace))
+    {
+      m_phyMonitorSniffTxTrace (packet, channelFreqMhz, channelNumber, rate, isShortPreamble, txvector);
+    }
 }
 
 
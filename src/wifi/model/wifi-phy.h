@@ -22,6 +22,7 @@
 #define WIFI_PHY_H
 
 #include <stdint.h>
+#include <map>
 #include "ns3/callback.h"
 #include "ns3/packet.h"
 #include "ns3/object.h"
@@ -298,6 +299,12 @@ public:
    * \param incFlag this flag is used to indicate that the static variables need to be update or not. This function is called a couple of times for the same packet so static variables should not be increased each time.
    *
    * \return the total amount of time this PHY will stay busy for the transmission of these bytes.
+   *
+   * Durations of MPDUs which are not part of an A-MPDU are remembered per
+   * size, mode, preamble, frequency and TXVECTOR stream parameters, so that
+   * asking again for the same frame does not redo the symbol computation.
+   * MPDUs of an A-MPDU depend on the MPDUs before them and are always
+   * computed.
    */
   Time CalculateTxDuration (uint32_t size, WifiTxVector txvector, enum WifiPreamble preamble, double frequency, uint8_t packetType, uint8_t incFlag);
 
@@ -1581,6 +1588,21 @@ static WifiMode GetOfdmRate78MbpsBW16MHz ();
  * \return a WifiMode for OFDM at 86.6667Mbps with 16MHz channel spacing
  */
 static WifiMode GetOfdmRate86_666_7MbpsBW16MHz ();
+  /**
+   * \return true if a PhyTxEnd trace has to be fired at the end of the
+   *         transmissions, so that it needs to be scheduled
+   */
+  bool IsTxEndTraced (void) const;
+  /**
+   * \return true if the arguments of NotifyMonitorSniffRx need to be
+   *         computed
+   */
+  bool IsMonitorSniffRxTraced (void) const;
+  /**
+   * \return true if the arguments of NotifyMonitorSniffTx need to be
+   *         computed
+   */
+  bool IsMonitorSniffTxTraced (void) const;
   /**
    * Public method used to fire a PhyTxBegin trace.
    * Implemented for encapsulation purposes.
@@ -1883,6 +1905,27 @@ private:
    */
   TracedCallback<Ptr<const Packet>, uint16_t, uint16_t, uint32_t, bool, WifiTxVector> m_phyMonitorSniffTxTrace;
 
+  /**
+   * The parameters a non-A-MPDU transmission duration depends on.
+   */
+  struct TxDurationKey
+  {
+    uint32_t size;      //!< MPDU size (bytes)
+    uint32_t modeUid;   //!< UID of the payload mode
+    uint8_t preamble;   //!< preamble type
+    uint8_t nss;        //!< number of spatial streams
+    uint8_t ness;       //!< number of extension spatial streams
+    bool stbc;          //!< whether STBC is used
+    double frequency;   //!< channel center frequency (MHz)
+
+    bool operator< (const TxDurationKey &o) const;
+  };
+  typedef std::map<TxDurationKey, Time> TxDurationCache;
+
+  TxDurationCache m_txDurationCache;  //!< durations of the non-A-MPDU transmissions computed so far
+  uint64_t m_txDurationCacheHits;     //!< number of durations found in m_txDurationCache
+  uint64_t m_txDurationCacheMisses;   //!< number of durations computed and added to m_txDurationCache
+
   uint32_t m_totalAmpduNumSymbols; //!< Number of symbols previously transmitted for the MPDUs in an A-MPDU, used for the computation of the number of symbols needed for the last MPDU in the A-MPDU
   uint32_t m_totalAmpduSize;       //!< Total size of the previously transmitted MPDUs in an A-MPDU, used for the computation of the number of symbols needed for the last MPDU in the A-MPDU
 };
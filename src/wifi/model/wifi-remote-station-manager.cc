@@ -326,6 +326,7 @@ namespace ns3
 			delete (*i);
 		}
 		m_stations.clear();
+		m_stationIndex.clear();
 	}
 
 	void WifiRemoteStationManager::SetupPhy(Ptr<WifiPhy> phy)
@@ -1106,11 +1107,10 @@ namespace ns3
 	WifiRemoteStationState *WifiRemoteStationManager::LookupState(Mac48Address address) const
 	{
 		NS_LOG_FUNCTION(this << address);
-		for (StationStates::const_iterator i = m_states.begin(); i != m_states.end(); i++) {
-			if ((*i)->m_address == address) {
-				NS_LOG_DEBUG("WifiRemoteStationManager::LookupState returning existing state");
-				return (*i);
-			}
+		StationIndexEntry &entry = m_stationIndex[address];
+		if (entry.state != 0) {
+			NS_LOG_DEBUG("WifiRemoteStationManager::LookupState returning existing state");
+			return entry.state;
 		}
 		WifiRemoteStationState *state = new WifiRemoteStationState();
 		state->m_state = WifiRemoteStationState::BRAND_NEW;
@@ -1127,6 +1127,7 @@ namespace ns3
 		state->m_ness = 0;
 		state->m_stbc = false;
 		const_cast<WifiRemoteStationManager *>(this)->m_states.push_back(state);
+		entry.state = state;
 		NS_LOG_DEBUG("WifiRemoteStationManager::LookupState returning new state");
 		return state;
 	}
@@ -1145,12 +1146,12 @@ namespace ns3
 	WifiRemoteStation *WifiRemoteStationManager::Lookup(Mac48Address address, uint8_t tid) const
 	{
 		NS_LOG_FUNCTION(this << address << (uint16_t)tid);
-		for (Stations::const_iterator i = m_stations.begin(); i != m_stations.end(); i++) {
-			if ((*i)->m_tid == tid && (*i)->m_state->m_address == address) {
-				return (*i);
-			}
+		StationIndexEntry &entry = m_stationIndex[address];
+		Stations &stations = entry.stations;
+		if (tid < stations.size() && stations[tid] != 0) {
+			return stations[tid];
 		}
-		WifiRemoteStationState *state = LookupState(address);
+		WifiRemoteStationState *state = entry.state != 0 ? entry.state : LookupState(address);
 
 		WifiRemoteStation *station = DoCreateStation();
 		station->m_state = state;
@@ -1160,6 +1161,10 @@ namespace ns3
 		station->m_ssrc_temp = 0;
 		station->m_slrc_temp = 0;
 		const_cast<WifiRemoteStationManager *>(this)->m_stations.push_back(station);
+		if (tid >= stations.size()) {
+			stations.resize(tid + 1, 0);
+		}
+		stations[tid] = station;
 		return station;
 	}
 
@@ -1278,6 +1283,9 @@ namespace ns3
 			delete (*i);
 		}
 		m_stations.clear();
+		for (StationIndex::iterator i = m_stationIndex.begin(); i != m_stationIndex.end(); i++) {
+			i->second.stations.clear();
+		}
 		m_bssBasicRateSet.clear();
 		m_bssBasicRateSet.push_back(m_defaultTxMode);
 		m_bssBasicMcsSet.clear();
@@ -23,6 +23,7 @@
 
 #include <vector>
 #include <utility>
+#include <unordered_map>
 #include "ns3/mac48-address.h"
 #include "ns3/traced-callback.h"
 #include "ns3/packet.h"
@@ -1008,6 +1009,19 @@ private:
    * A vector of WifiRemoteStationStates
    */
   typedef std::vector <WifiRemoteStationState *> StationStates;
+  /**
+   * The state of a known station and its per-TID information, so that
+   * LookupState and Lookup need a single hash lookup on the address.
+   */
+  struct StationIndexEntry
+  {
+    WifiRemoteStationState *state; //!< Remote station state
+    Stations stations;             //!< Information for each TID, indexed by TID
+  };
+  /**
+   * An index of StationIndexEntry by station address
+   */
+  typedef std::unordered_map <Mac48Address, StationIndexEntry, Mac48AddressHash> StationIndex;
 
   /**
    * This is a pointer to the WifiPhy associated with this
@@ -1040,6 +1054,7 @@ private:
 
   StationStates m_states;  //!< States of known stations
   Stations m_stations;     //!< Information for each known stations
+  mutable StationIndex m_stationIndex; //!< m_states and m_stations indexed by address
 
   WifiMode m_defaultTxMode; //!< The default transmission mode
   uint8_t m_defaultTxMcs;   //!< The default transmission modulation-coding scheme (MCS)
@@ -26,10 +26,21 @@
 #include "ns3/log.h"
 #include "ns3/pointer.h"
 #include "ns3/object-factory.h"
+#include "ns3/boolean.h"
+#include "ns3/double.h"
+#include "ns3/abort.h"
+#include "ns3/constant-position-mobility-model.h"
 #include "yans-wifi-channel.h"
 #include "yans-wifi-phy.h"
 #include "ns3/propagation-loss-model.h"
 #include "ns3/propagation-delay-model.h"
+#include "ns3/core-config.h"
+#ifdef HAVE_PTHREAD_H
+#include "ns3/multithreaded-simulator-impl.h"
+#endif
+#include <algorithm>
+#include <cmath>
+#include <sstream>
 
 namespace ns3 {
 
@@ -37,6 +48,21 @@ NS_LOG_COMPONENT_DEFINE ("YansWifiChannel");
 
 NS_OBJECT_ENSURE_REGISTERED (YansWifiChannel);
 
+const uint32_t YansWifiChannel::INVALID_DELAY;
+
+/**
+ * \returns true if the receivers may run on another thread than the sender.
+ */
+static bool
+IsParallel (void)
+{
+#ifdef HAVE_PTHREAD_H
+  return MultithreadedSimulatorImpl::IsParallel ();
+#else
+  return false;
+#endif
+}
+
 TypeId
 YansWifiChannel::GetTypeId (void)
 {
@@ -52,6 +78,30 @@ YansWifiChannel::GetTypeId (void)
                    PointerValue (),
                    MakePointerAccessor (&YansWifiChannel::m_delay),
                    MakePointerChecker<PropagationDelayModel> ())
+    .AddAttribute ("ReceiverCulling", "If true, receivers whose received power is below RxPowerFloor are "
+                   "skipped, using a grid of receiver positions to skip whole cells at once.",
+                   BooleanValue (false),
+                   MakeBooleanAccessor (&YansWifiChannel::m_cullReceivers),
+                   MakeBooleanChecker ())
+    .AddAttribute ("RxPowerFloor", "The received power (dBm) below which a receiver is skipped when ReceiverCulling is enabled.",
+                   DoubleValue (-110.0),
+                   MakeDoubleAccessor (&YansWifiChannel::m_rxPowerFloor),
+                   MakeDoubleChecker<double> ())
+    .AddAttribute ("CullingCellSize", "The width (m) of the square cells of the receiver grid used when ReceiverCulling is enabled.",
+                   DoubleValue (50.0),
+                   MakeDoubleAccessor (&YansWifiChannel::m_cellSize),
+                   MakeDoubleChecker<double> (1e-3))
+    .AddAttribute ("CachePropagation", "If true, the propagation gain and delay of every pair of PHYs are "
+                   "cached until one of them changes course.",
+                   BooleanValue (false),
+                   MakeBooleanAccessor (&YansWifiChannel::m_cachePropagation),
+                   MakeBooleanChecker ())
+    .AddAttribute ("LookaheadPreamble", "If true, GetLookahead adds the shortest PLCP preamble and header to "
+                   "the lookahead, and frames are then handed over to their receivers once that much has arrived "
+                   "(a backoff ending before then does not defer to them).",
+                   BooleanValue (true),
+                   MakeBooleanAccessor (&YansWifiChannel::m_lookaheadPreamble),
+                   MakeBooleanChecker ())
 	.AddTraceSource("Transmission", "Fired when something is transmitted on the channel",
 				   MakeTraceSourceAccessor(&YansWifiChannel::m_channelTransmission), "ns3::YansWifiChannel::TransmissionCallback")
   ;
@@ -59,6 +109,11 @@ YansWifiChannel::GetTypeId (void)
 }
 
 YansWifiChannel::YansWifiChannel ()
+  : m_gridDirty (true),
+    m_nTracked (0),
+    m_cachePropagation (false),
+    m_lookaheadPreamble (true),
+    m_detectionDelay (Seconds (0))
 {
 }
 
@@ -66,18 +121,21 @@ YansWifiChannel::~YansWifiChannel ()
 {
   NS_LOG_FUNCTION_NOARGS ();
   m_phyList.clear ();
+  m_phyIndex.clear ();
 }
 
 void
 YansWifiChannel::SetPropagationLossModel (Ptr<PropagationLossModel> loss)
 {
   m_loss = loss;
+  m_pathCache.clear ();
 }
 
 void
 YansWifiChannel::SetPropagationDelayModel (Ptr<PropagationDelayModel> delay)
 {
   m_delay = delay;
+  m_pathCache.clear ();
 }
 
 void
@@ -86,55 +144,244 @@ YansWifiChannel::Send (Ptr<YansWifiPhy> sender, Ptr<const Packet> packet, double
 {
   Ptr<MobilityModel> senderMobility = sender->GetMobility ()->GetObject<MobilityModel> ();
   NS_ASSERT (senderMobility != 0);
-  uint32_t j = 0;
 
-  m_channelTransmission(sender->GetDevice(), packet->Copy());
+  if (NS_TRACE_IS_CONNECTED ("Transmission", m_channelTransmission))
+    {
+      m_channelTransmission(sender->GetDevice(), packet->Copy());
+    }
+
+  //A single copy is shared by all the receivers: the receiving PHYs do not
+  //modify it and only copy it when handing it over to their MAC.
+  Ptr<const Packet> shared = packet->Copy ();
+
+  //The other threads run the PHYs, so only the cache may be used
+  bool parallel = IsParallel ();
+  NS_ABORT_MSG_IF (parallel && m_phyNodes.size () != m_phyList.size (),
+                   "GetLookahead must be called once all the PHYs are added");
 
-  for (PhyList::const_iterator i = m_phyList.begin (); i != m_phyList.end (); i++, j++)
+  uint32_t senderIndex = 0;
+  if (m_cachePropagation)
     {
-      if (sender != (*i))
+      std::map<Ptr<YansWifiPhy>, uint32_t>::const_iterator it = m_phyIndex.find (sender);
+      NS_ASSERT (it != m_phyIndex.end ());
+      senderIndex = it->second;
+      if (!parallel)
         {
-          //For now don't account for inter channel interference
-          if ((*i)->GetChannelNumber () != sender->GetChannelNumber ())
-            {
-              continue;
-            }
+          TrackMobility ();
+        }
+    }
 
-          Ptr<MobilityModel> receiverMobility = (*i)->GetMobility ()->GetObject<MobilityModel> ();
-          Time delay = m_delay->GetDelay (senderMobility, receiverMobility);
-          double rxPowerDbm = m_loss->CalcRxPower (txPowerDbm, senderMobility, receiverMobility);
-          NS_LOG_DEBUG ("propagation: txPower=" << txPowerDbm << "dbm, rxPower=" << rxPowerDbm << "dbm, " <<
-                        "distance=" << senderMobility->GetDistanceFrom (receiverMobility) << "m, delay=" << delay);
-          Ptr<Packet> copy = packet->Copy ();
-          Ptr<Object> dstNetDevice = m_phyList[j]->GetDevice ();
-          uint32_t dstNode;
-          if (dstNetDevice == 0)
-            {
-              dstNode = 0xffffffff;
-            }
-          else
-            {
-              dstNode = dstNetDevice->GetObject<NetDevice> ()->GetNode ()->GetId ();
-            }
+  if (m_cullReceivers && !parallel)
+    {
+      CollectCandidates (senderMobility, txPowerDbm);
+      for (std::vector<uint32_t>::const_iterator i = m_candidates.begin (); i != m_candidates.end (); i++)
+        {
+          SendTo (*i, sender, senderIndex, senderMobility, shared, txPowerDbm, txVector, preamble, packetType, duration);
+        }
+    }
+  else
+    {
+      for (uint32_t j = 0; j < m_phyList.size (); j++)
+        {
+          SendTo (j, sender, senderIndex, senderMobility, shared, txPowerDbm, txVector, preamble, packetType, duration);
+        }
+    }
+}
 
-          double *atts = new double[3];
-          *atts = rxPowerDbm;
-          *(atts + 1) = packetType;
-          *(atts + 2) = duration.GetNanoSeconds ();
+void
+YansWifiChannel::SendTo (uint32_t j, Ptr<YansWifiPhy> sender, uint32_t senderIndex, Ptr<MobilityModel> senderMobility,
+                         Ptr<const Packet> packet, double txPowerDbm, WifiTxVector txVector,
+                         WifiPreamble preamble, uint8_t packetType, Time duration) const
+{
+  const Ptr<YansWifiPhy> &receiver = m_phyList[j];
+  if (sender == receiver)
+    {
+      return;
+    }
+  //For now don't account for inter channel interference
+  if (receiver->GetChannelNumber () != sender->GetChannelNumber ())
+    {
+      return;
+    }
 
-          Simulator::ScheduleWithContext (dstNode,
-                                          delay, &YansWifiChannel::Receive, this,
-                                          j, copy, atts, txVector, preamble);
+  Time delay;
+  double rxPowerDbm;
+  PathEntry *entry = 0;
+  if (m_cachePropagation)
+    {
+      entry = &GetPathEntry (senderIndex, j);
+    }
+  if (entry != 0 && entry->delay != INVALID_DELAY)
+    {
+      delay = TimeStep (entry->delay);
+      rxPowerDbm = txPowerDbm + entry->gainDb;
+      NS_LOG_DEBUG ("cached propagation: txPower=" << txPowerDbm << "dbm, rxPower=" << rxPowerDbm << "dbm, " <<
+                    "delay=" << delay);
+    }
+  else
+    {
+      NS_ABORT_MSG_IF (IsParallel (), "no cached propagation from phy " << senderIndex << " to phy " << j <<
+                       ", which changed course after GetLookahead");
+      Ptr<MobilityModel> receiverMobility = receiver->GetMobility ()->GetObject<MobilityModel> ();
+      delay = m_delay->GetDelay (senderMobility, receiverMobility);
+      rxPowerDbm = m_loss->CalcRxPower (txPowerDbm, senderMobility, receiverMobility);
+      NS_LOG_DEBUG ("propagation: txPower=" << txPowerDbm << "dbm, rxPower=" << rxPowerDbm << "dbm, " <<
+                    "distance=" << senderMobility->GetDistanceFrom (receiverMobility) << "m, delay=" << delay);
+      if (entry != 0 && delay.GetTimeStep () >= 0 && delay.GetTimeStep () < INVALID_DELAY)
+        {
+          entry->gainDb = rxPowerDbm - txPowerDbm;
+          entry->delay = static_cast<uint32_t> (delay.GetTimeStep ());
         }
     }
+  if (m_cullReceivers && rxPowerDbm < m_rxPowerFloor)
+    {
+      NS_LOG_DEBUG ("skipping receiver " << j << ", rxPower below floor " << m_rxPowerFloor << "dbm");
+      return;
+    }
+  RxParameters params;
+  params.rxPowerDbm = rxPowerDbm;
+  params.packetType = packetType;
+  params.duration = duration;
+  params.elapsed = m_detectionDelay;
+  delay += m_detectionDelay;
+
+  if (IsParallel ())
+    {
+      //The receiver runs on another thread, which must not share the packet
+      Simulator::ScheduleWithContext (m_phyNodes[j],
+                                      delay, &YansWifiChannel::Receive, this,
+                                      j, Ptr<const Packet> (packet->DeepCopy ()), params, txVector, preamble);
+      return;
+    }
+
+  Ptr<Object> dstNetDevice = receiver->GetDevice ();
+  uint32_t dstNode;
+  if (dstNetDevice == 0)
+    {
+      dstNode = 0xffffffff;
+    }
+  else
+    {
+      dstNode = dstNetDevice->GetObject<NetDevice> ()->GetNode ()->GetId ();
+    }
+
+  Simulator::ScheduleWithContext (dstNode,
+                                  delay, &YansWifiChannel::Receive, this,
+                                  j, packet, params, txVector, preamble);
+}
+
+void
+YansWifiChannel::TrackMobility (void) const
+{
+  for (uint32_t j = m_nTracked; j < m_phyList.size (); j++)
+    {
+      Ptr<MobilityModel> mobility = m_phyList[j]->GetMobility ()->GetObject<MobilityModel> ();
+      NS_ASSERT (mobility != 0);
+      std::ostringstream context;
+      context << j;
+      mobility->TraceConnect ("CourseChange", context.str (),
+                              MakeCallback (&YansWifiChannel::NotifyCourseChange, this));
+    }
+  m_nTracked = m_phyList.size ();
 }
 
 void
-YansWifiChannel::Receive (uint32_t i, Ptr<Packet> packet, double *atts,
+YansWifiChannel::BuildReceiverGrid (void) const
+{
+  NS_LOG_FUNCTION (this);
+  TrackMobility ();
+  m_cells.clear ();
+  for (uint32_t j = 0; j < m_phyList.size (); j++)
+    {
+      Vector position = m_phyList[j]->GetMobility ()->GetObject<MobilityModel> ()->GetPosition ();
+      CellIndex cell = std::make_pair (static_cast<int32_t> (std::floor (position.x / m_cellSize)),
+                                       static_cast<int32_t> (std::floor (position.y / m_cellSize)));
+      m_cells[cell].push_back (j);
+    }
+  if (m_probe == 0)
+    {
+      m_probe = CreateObject<ConstantPositionMobilityModel> ();
+    }
+  m_gridDirty = false;
+}
+
+YansWifiChannel::PathEntry &
+YansWifiChannel::GetPathEntry (uint32_t i, uint32_t j) const
+{
+  NS_ASSERT (i != j);
+  uint32_t n = m_phyList.size ();
+  if (m_pathCache.size () < n * (n - 1) / 2)
+    {
+      //Rows of the lower-triangular matrix are laid out one after the other,
+      //so new PHYs only append rows
+      PathEntry invalid;
+      invalid.gainDb = 0;
+      invalid.delay = INVALID_DELAY;
+      m_pathCache.resize (n * (n - 1) / 2, invalid);
+    }
+  if (i < j)
+    {
+      std::swap (i, j);
+    }
+  return m_pathCache[i * (i - 1) / 2 + j];
+}
+
+void
+YansWifiChannel::CollectCandidates (Ptr<MobilityModel> senderMobility, double txPowerDbm) const
+{
+  if (m_gridDirty)
+    {
+      BuildReceiverGrid ();
+    }
+  m_candidates.clear ();
+  Vector position = senderMobility->GetPosition ();
+  for (CellMap::const_iterator i = m_cells.begin (); i != m_cells.end (); i++)
+    {
+      //The point of the cell closest to the sender, at the height of the sender,
+      //is never further away from the sender than any receiver in the cell.
+      double xMin = i->first.first * m_cellSize;
+      double yMin = i->first.second * m_cellSize;
+      Vector closest (std::min (std::max (position.x, xMin), xMin + m_cellSize),
+                      std::min (std::max (position.y, yMin), yMin + m_cellSize),
+                      position.z);
+      m_probe->SetPosition (closest);
+      if (m_loss->CalcRxPower (txPowerDbm, senderMobility, m_probe) < m_rxPowerFloor)
+        {
+          continue;
+        }
+      m_candidates.insert (m_candidates.end (), i->second.begin (), i->second.end ());
+    }
+  //Schedule the receptions in the same order as a full scan does
+  std::sort (m_candidates.begin (), m_candidates.end ());
+}
+
+void
+YansWifiChannel::NotifyCourseChange (std::string context, Ptr<const MobilityModel> mobility) const
+{
+  m_gridDirty = true;
+  if (m_pathCache.empty ())
+    {
+      return;
+    }
+  std::istringstream is (context);
+  uint32_t i;
+  is >> i;
+  NS_LOG_DEBUG ("invalidating cached propagation of phy " << i);
+  for (uint32_t j = 0; j < m_phyList.size (); j++)
+    {
+      if (j != i)
+        {
+          GetPathEntry (i, j).delay = INVALID_DELAY;
+        }
+    }
+}
+
+void
+YansWifiChannel::Receive (uint32_t i, Ptr<const Packet> packet, RxParameters params,
                           WifiTxVector txVector, WifiPreamble preamble) const
 {
-  m_phyList[i]->StartReceivePreambleAndHeader (packet, *atts, txVector, preamble, *(atts + 1), NanoSeconds (*(atts + 2)));
-  delete[] atts;
+  m_phyList[i]->StartReceivePreambleAndHeader (packet, params.rxPowerDbm, txVector, preamble, params.packetType, params.duration,
+                                               params.elapsed);
 }
 
 uint32_t
@@ -152,7 +399,76 @@ YansWifiChannel::GetDevice (uint32_t i) const
 void
 YansWifiChannel::Add (Ptr<YansWifiPhy> phy)
 {
+  m_phyIndex[phy] = m_phyList.size ();
   m_phyList.push_back (phy);
+  m_gridDirty = true;
+}
+
+Time
+YansWifiChannel::GetLookahead (void) const
+{
+  NS_LOG_FUNCTION (this);
+  NS_ABORT_MSG_UNLESS (m_cachePropagation, "the lookahead requires CachePropagation");
+  TrackMobility ();
+  m_phyNodes.resize (m_phyList.size ());
+  for (uint32_t j = 0; j < m_phyList.size (); j++)
+    {
+      Ptr<Object> device = m_phyList[j]->GetDevice ();
+      m_phyNodes[j] = device == 0 ? 0xffffffff : device->GetObject<NetDevice> ()->GetNode ()->GetId ();
+    }
+
+  //Every frame but the MPDUs following the first one of an A-MPDU starts
+  //with a preamble, and the MPDUs are handed over as long after they arrive
+  m_detectionDelay = Seconds (0);
+  if (m_lookaheadPreamble)
+    {
+      static const WifiPreamble preambles[] = {
+        WIFI_PREAMBLE_LONG, WIFI_PREAMBLE_SHORT, WIFI_PREAMBLE_HT_MF, WIFI_PREAMBLE_HT_GF,
+        WIFI_PREAMBLE_S1G_SHORT, WIFI_PREAMBLE_S1G_LONG, WIFI_PREAMBLE_S1G_1M
+      };
+      Time shortest = Time::Max ();
+      for (uint32_t j = 0; j < m_phyList.size (); j++)
+        {
+          for (uint32_t m = 0; m < m_phyList[j]->GetNModes (); m++)
+            {
+              WifiTxVector txVector (m_phyList[j]->GetMode (m), 0, 0, false, 1, 0, false);
+              for (uint32_t k = 0; k < sizeof (preambles) / sizeof (preambles[0]); k++)
+                {
+                  shortest = std::min (shortest, m_phyList[j]->CalculatePlcpPreambleAndHeaderDuration (txVector, preambles[k]));
+                }
+            }
+        }
+      if (shortest != Time::Max ())
+        {
+          m_detectionDelay = shortest;
+        }
+    }
+
+  uint32_t lookahead = INVALID_DELAY;
+  for (uint32_t i = 1; i < m_phyList.size (); i++)
+    {
+      for (uint32_t j = 0; j < i; j++)
+        {
+          PathEntry &entry = GetPathEntry (i, j);
+          if (entry.delay == INVALID_DELAY)
+            {
+              Ptr<MobilityModel> a = m_phyList[i]->GetMobility ()->GetObject<MobilityModel> ();
+              Ptr<MobilityModel> b = m_phyList[j]->GetMobility ()->GetObject<MobilityModel> ();
+              Time delay = m_delay->GetDelay (a, b);
+              NS_ABORT_MSG_IF (delay.GetTimeStep () < 0 || delay.GetTimeStep () >= INVALID_DELAY,
+                               "propagation delay " << delay << " cannot be cached");
+              entry.gainDb = m_loss->CalcRxPower (0, a, b);
+              entry.delay = static_cast<uint32_t> (delay.GetTimeStep ());
+            }
+          NS_ABORT_MSG_IF (entry.delay == 0 && m_detectionDelay.IsZero (),
+                           "zero lookahead: phys " << j << " and " << i << " are co-located and "
+                           "LookaheadPreamble is disabled");
+          lookahead = std::min (lookahead, entry.delay);
+        }
+    }
+  NS_ABORT_MSG_IF (lookahead == INVALID_DELAY, "zero lookahead: the channel has less than two phys");
+  NS_LOG_DEBUG ("lookahead=" << lookahead << " detectionDelay=" << m_detectionDelay);
+  return TimeStep (lookahead) + m_detectionDelay;
 }
 
 int64_t
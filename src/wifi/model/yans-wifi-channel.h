@@ -22,6 +22,7 @@
 #define YANS_WIFI_CHANNEL_H
 
 #include <vector>
+#include <map>
 #include <stdint.h>
 #include "ns3/packet.h"
 #include "wifi-channel.h"
@@ -37,6 +38,8 @@ class NetDevice;
 class PropagationLossModel;
 class PropagationDelayModel;
 class YansWifiPhy;
+class MobilityModel;
+class ConstantPositionMobilityModel;
 
 /**
  * \brief A Yans wifi channel
@@ -49,6 +52,38 @@ class YansWifiPhy;
  * class and contains a ns3::PropagationLossModel and a ns3::PropagationDelayModel.
  * By default, no propagation models are set so, it is the caller's responsability
  * to set them before using the channel.
+ *
+ * When the ReceiverCulling attribute is enabled, the channel keeps the
+ * attached PHYs in a grid of square cells (CullingCellSize meters wide)
+ * keyed by their mobility position. On every transmission, a whole cell
+ * is skipped when the received power at the point of the cell closest to
+ * the sender is below RxPowerFloor, and the remaining receivers are
+ * skipped individually when their own received power is below the floor.
+ * The grid is rebuilt lazily whenever a PHY is added or one of the mobility
+ * models fires its CourseChange trace. The per-cell bound assumes that the
+ * propagation loss model is deterministic and that the received power does
+ * not increase with distance (e.g. Friis, LogDistance, ThreeLogDistance,
+ * Range); under such a model, the set of receivers that is skipped is
+ * exactly the set a full scan would find below the floor.
+ *
+ * When the CachePropagation attribute is enabled, the channel stores the
+ * propagation gain (rx power minus tx power, in dB) and the propagation
+ * delay of every pair of PHYs in a lower-triangular matrix of compact
+ * entries, so that the propagation models are only queried the first time
+ * a pair is used. The entries of a PHY are invalidated when its mobility
+ * model fires its CourseChange trace. The cache assumes deterministic
+ * models whose gain does not depend on the tx power and which are
+ * reciprocal (the same loss and delay in both directions), as is the case
+ * for the distance-based models typically used with static 802.11ah
+ * topologies. The matrix takes 4 * N * (N - 1) bytes for N PHYs.
+ *
+ * The channel can run on the MultithreadedSimulatorImpl, whose partitions
+ * hold different nodes, with the lookahead returned by GetLookahead: the
+ * smallest propagation delay plus, when LookaheadPreamble is enabled, the
+ * shortest PLCP preamble and header. While the events run on several threads, the
+ * sender only reads the propagation cache, which must hold every pair, and
+ * each receiver gets a DeepCopy of the packet; receiver culling then checks
+ * each receiver instead of the grid, with the same result.
  */
 class YansWifiChannel : public WifiChannel
 {
@@ -108,25 +143,132 @@ public:
    */
   int64_t AssignStreams (int64_t stream);
 
+  /**
+   * Compute the propagation of every pair of PHYs and return the lookahead
+   * of a parallel run of this channel on the MultithreadedSimulatorImpl.
+   * It must be called after all the PHYs are added and placed, and requires
+   * CachePropagation. It aborts if the lookahead is zero.
+   *
+   * When LookaheadPreamble is enabled, the lookahead also includes the
+   * shortest PLCP preamble and header the PHYs can send, and from then on
+   * the channel hands every frame over to its receivers once that much of
+   * it has arrived, whether the run is parallel or not. The receivers then
+   * account for the signal from its first bit, but only change state (and
+   * notify their MAC) when the frame is handed over, as if they needed
+   * that long to detect its preamble. A station whose backoff ends within
+   * that delay after another frame arrived then transmits instead of
+   * deferring, so disable LookaheadPreamble when such collisions matter.
+   *
+   * \return the smallest propagation delay between two PHYs, plus the
+   *         shortest PLCP preamble and header when LookaheadPreamble is
+   *         enabled
+   */
+  Time GetLookahead (void) const;
+
 
 private:
   /**
    * A vector of pointers to YansWifiPhy.
    */
   typedef std::vector<Ptr<YansWifiPhy> > PhyList;
+  /**
+   * Cached propagation between a pair of PHYs.
+   */
+  struct PathEntry
+  {
+    float gainDb;   //!< Received power minus transmitted power (dB)
+    uint32_t delay; //!< Propagation delay in time steps, or INVALID_DELAY
+  };
+  /**
+   * Marks a PathEntry which must be computed by the propagation models.
+   */
+  static const uint32_t INVALID_DELAY = 0xffffffff;
+  /**
+   * Reception parameters of a packet, carried by value in the reception event.
+   */
+  struct RxParameters
+  {
+    double rxPowerDbm;  //!< Received power (dBm)
+    uint8_t packetType; //!< Type of packet, used for A-MPDU
+    Time duration;      //!< Transmission duration
+    Time elapsed;       //!< Time since the first bit of the packet arrived
+  };
   /**
    * This method is scheduled by Send for each associated YansWifiPhy.
    * The method then calls the corresponding YansWifiPhy that the first
    * bit of the packet has arrived.
    *
    * \param i index of the corresponding YansWifiPhy in the PHY list
-   * \param packet the packet being sent
-   * \param atts a vector containing the received power in dBm and the packet type
+   * \param packet the packet being sent, shared by all the receivers
+   * \param params the received power, packet type, duration and elapsed time of the packet
    * \param txVector the TXVECTOR of the packet
    * \param preamble the type of preamble being used to send the packet
    */
-  void Receive (uint32_t i, Ptr<Packet> packet, double *atts,
+  void Receive (uint32_t i, Ptr<const Packet> packet, RxParameters params,
                 WifiTxVector txVector, WifiPreamble preamble) const;
+  /**
+   * Compute the propagation towards the YansWifiPhy at index j of the PHY
+   * list and schedule its reception, unless it is the sender, it is on
+   * another channel or (when receiver culling is enabled) the received
+   * power is below the floor.
+   *
+   * \param j index of the receiving YansWifiPhy in the PHY list
+   * \param sender the sending YansWifiPhy
+   * \param senderIndex index of the sending YansWifiPhy in the PHY list
+   * \param senderMobility the mobility model of the sender
+   * \param packet the packet being sent, shared by all the receivers
+   * \param txPowerDbm the tx power associated to the packet
+   * \param txVector the TXVECTOR associated to the packet
+   * \param preamble the preamble associated to the packet
+   * \param packetType the type of packet
+   * \param duration the transmission duration associated to the packet
+   */
+  void SendTo (uint32_t j, Ptr<YansWifiPhy> sender, uint32_t senderIndex, Ptr<MobilityModel> senderMobility,
+               Ptr<const Packet> packet, double txPowerDbm, WifiTxVector txVector,
+               WifiPreamble preamble, uint8_t packetType, Time duration) const;
+  /**
+   * Connect to the CourseChange trace of the mobility models of the PHYs
+   * added since the last call.
+   */
+  void TrackMobility (void) const;
+  /**
+   * Rebuild the receiver grid from the current positions of the PHYs.
+   */
+  void BuildReceiverGrid (void) const;
+  /**
+   * Get the cache entry of the given pair of PHYs, growing the cache
+   * if PHYs were added since it was last used.
+   *
+   * \param i index of the first YansWifiPhy in the PHY list
+   * \param j index of the second YansWifiPhy in the PHY list
+   *
+   * \return the cache entry shared by both directions of the pair
+   */
+  PathEntry & GetPathEntry (uint32_t i, uint32_t j) const;
+  /**
+   * Fill m_candidates with the indices (in ascending order) of the PHYs
+   * located in cells that may receive above the floor.
+   *
+   * \param senderMobility the mobility model of the sender
+   * \param txPowerDbm the tx power associated to the packet
+   */
+  void CollectCandidates (Ptr<MobilityModel> senderMobility, double txPowerDbm) const;
+  /**
+   * Trace sink for the CourseChange trace of the PHYs' mobility models.
+   *
+   * \param context the index of the YansWifiPhy in the PHY list
+   * \param mobility the mobility model which changed course
+   */
+  void NotifyCourseChange (std::string context, Ptr<const MobilityModel> mobility) const;
+
+  /**
+   * Index of a grid cell, (x, y) in units of the cell size.
+   */
+  typedef std::pair<int32_t, int32_t> CellIndex;
+  /**
+   * Indices in the PHY list of the PHYs located in each grid cell.
+   */
+  typedef std::map<CellIndex, std::vector<uint32_t> > CellMap;
 
 
   PhyList m_phyList;                   //!< List of YansWifiPhys connected to this YansWifiChannel
@@ -134,6 +276,22 @@ private:
   Ptr<PropagationDelayModel> m_delay;  //!< Propagation delay model
 
   TracedCallback<Ptr<NetDevice>, Ptr<Packet>> m_channelTransmission;
+
+  bool m_cullReceivers;                //!< Whether receivers below m_rxPowerFloor are skipped
+  double m_rxPowerFloor;               //!< Received power (dBm) below which receivers are skipped
+  double m_cellSize;                   //!< Width (m) of the square cells of the receiver grid
+  mutable bool m_gridDirty;            //!< Whether the receiver grid must be rebuilt before use
+  mutable CellMap m_cells;             //!< Receiver grid
+  mutable uint32_t m_nTracked;         //!< Number of PHYs whose CourseChange trace is connected
+  mutable std::vector<uint32_t> m_candidates; //!< Scratch list of receivers not culled by their cell
+  mutable Ptr<ConstantPositionMobilityModel> m_probe; //!< Position used to bound the rx power of a cell
+
+  bool m_cachePropagation;             //!< Whether the propagation of each pair of PHYs is cached
+  bool m_lookaheadPreamble;            //!< Whether GetLookahead adds the shortest PLCP preamble and header
+  mutable Time m_detectionDelay;       //!< Delay after which a frame is handed over to its receivers, set by GetLookahead
+  mutable std::vector<uint32_t> m_phyNodes; //!< Node id of each PHY, set by GetLookahead
+  mutable std::vector<PathEntry> m_pathCache; //!< Lower-triangular matrix of cached propagation
+  std::map<Ptr<YansWifiPhy>, uint32_t> m_phyIndex; //!< Index of each PHY in the PHY list
 };
 
 } //namespace ns3
@@ -578,27 +578,36 @@ YansWifiPhy::SetReceiveErrorCallback (RxErrorCallback callback)
 }
 
 void
-YansWifiPhy::StartReceivePreambleAndHeader (Ptr<Packet> packet,
+YansWifiPhy::StartReceivePreambleAndHeader (Ptr<const Packet> packet,
                                             double rxPowerDbm,
                                             WifiTxVector txVector,
                                             enum WifiPreamble preamble,
-                                            uint8_t packetType, Time rxDuration)
+                                            uint8_t packetType, Time rxDuration,
+                                            Time elapsed)
 {
   //This function should be later split to check separately wether plcp preamble and plcp header can be successfully received.
   //Note: plcp preamble reception is not yet modeled.
   //NS_LOG_UNCOND (packet << "\t" << rxPowerDbm << " dbm " << "\t" << txVector.GetMode () << "\t" << packet->GetSize ()); //test
-  NS_LOG_FUNCTION (this << packet << rxPowerDbm << txVector.GetMode () << preamble << (uint32_t)packetType);
+  NS_LOG_FUNCTION (this << packet << rxPowerDbm << txVector.GetMode () << preamble << (uint32_t)packetType << elapsed);
   AmpduTag ampduTag;
   rxPowerDbm += m_rxGainDb;
   double rxPowerW = DbmToW (rxPowerDbm);
-  Time endRx = Simulator::Now () + rxDuration;
+  //The signal is accounted for from its first bit, the remaining durations
+  //start now
+  Time startRx = Simulator::Now () - elapsed;
+  Time endRx = startRx + rxDuration;
   Time preambleAndHeaderDuration = CalculatePlcpPreambleAndHeaderDuration (txVector, preamble);
+  NS_ASSERT_MSG (elapsed < rxDuration && (preamble == WIFI_PREAMBLE_NONE || elapsed <= preambleAndHeaderDuration),
+                 "packet handed over " << elapsed << " after its first bit arrived");
+  rxDuration -= elapsed;
+  preambleAndHeaderDuration -= elapsed;
 
   Ptr<InterferenceHelper::Event> event;
   event = m_interference.Add (packet->GetSize (),
                               txVector,
                               preamble,
-                              rxDuration,
+                              startRx,
+                              endRx - startRx,
                               rxPowerW);
 
   switch (m_state->GetState ())
@@ -739,7 +748,7 @@ maybeCcaBusy:
 }
 
 void
-YansWifiPhy::StartReceivePacket (Ptr<Packet> packet,
+YansWifiPhy::StartReceivePacket (Ptr<const Packet> packet,
                                  WifiTxVector txVector,
                                  enum WifiPreamble preamble,
                                  uint8_t packetType,
@@ -806,17 +815,20 @@ YansWifiPhy::SendPacket (Ptr<const Packet> packet, WifiTxVector txVector, WifiPr
       m_interference.NotifyRxEnd ();
     }
   NotifyTxBegin(packet, txDuration);
-  uint32_t dataRate500KbpsUnits;
-  if (txVector.GetMode ().GetModulationClass () == WIFI_MOD_CLASS_HT || txVector.GetMode ().GetModulationClass () == WIFI_MOD_CLASS_S1G)
+  if (IsMonitorSniffTxTraced ())
     {
-      dataRate500KbpsUnits = 128 + WifiModeToMcs (txVector.GetMode ());
-    }
-  else
-    {
-      dataRate500KbpsUnits = txVector.GetMode ().GetDataRate () * txVector.GetNss () / 500000;
+      uint32_t dataRate500KbpsUnits;
+      if (txVector.GetMode ().GetModulationClass () == WIFI_MOD_CLASS_HT || txVector.GetMode ().GetModulationClass () == WIFI_MOD_CLASS_S1G)
+        {
+          dataRate500KbpsUnits = 128 + WifiModeToMcs (txVector.GetMode ());
+        }
+      else
+        {
+          dataRate500KbpsUnits = txVector.GetMode ().GetDataRate () * txVector.GetNss () / 500000;
+        }
+      bool isShortPreamble = (WIFI_PREAMBLE_SHORT == preamble);
+      NotifyMonitorSniffTx (packet, (uint16_t)GetChannelFrequencyMhz (), GetChannelNumber (), dataRate500KbpsUnits, isShortPreamble, txVector);
     }
-  bool isShortPreamble = (WIFI_PREAMBLE_SHORT == preamble);
-  NotifyMonitorSniffTx (packet, (uint16_t)GetChannelFrequencyMhz (), GetChannelNumber (), dataRate500KbpsUnits, isShortPreamble, txVector);
   m_state->SwitchToTx (txDuration, packet, GetPowerDbm (txVector.GetTxPowerLevel ()), txVector, preamble);
   m_channel->Send (this, packet, GetPowerDbm (txVector.GetTxPowerLevel ()) + m_txGainDb, txVector, preamble, packetType, txDuration);
 }
@@ -833,7 +845,11 @@ YansWifiPhy::NotifyTxBegin (Ptr<const Packet> packet, Time duration)
     WifiPhy::NotifyTxBegin(packet);
 
     //std::cout << this->m_device->GetAddress() << " " << Simulator::Now().GetMicroSeconds() << " Scheduling end tx " << time.GetMicroSeconds()  << std::endl;
-    Simulator::Schedule(duration, &OnTxEnd, this, packet);
+    //The end of the transmission is only scheduled for its trace
+    if (IsTxEndTraced ())
+      {
+        Simulator::Schedule(duration, &OnTxEnd, this, packet);
+      }
 }
 
 uint32_t
@@ -1224,7 +1240,7 @@ YansWifiPhy::GetPowerDbm (uint8_t power) const
 }
 
 void
-YansWifiPhy::EndReceive (Ptr<Packet> packet, enum WifiPreamble preamble, uint8_t packetType, Ptr<InterferenceHelper::Event> event)
+YansWifiPhy::EndReceive (Ptr<const Packet> packet, enum WifiPreamble preamble, uint8_t packetType, Ptr<InterferenceHelper::Event> event)
 {
   NS_LOG_FUNCTION (this << packet << event);
   NS_ASSERT (IsStateRx ());
@@ -1250,20 +1266,24 @@ YansWifiPhy::EndReceive (Ptr<Packet> packet, enum WifiPreamble preamble, uint8_t
       if (m_random->GetValue () > snrPer.per)
         {
           NotifyRxEnd (packet);
-          uint32_t dataRate500KbpsUnits;
-          if ((event->GetPayloadMode ().GetModulationClass () == WIFI_MOD_CLASS_HT) || (event->GetPayloadMode ().GetModulationClass () == WIFI_MOD_CLASS_S1G))
-            {
-              dataRate500KbpsUnits = 128 + WifiModeToMcs (event->GetPayloadMode ());
-            }
-          else
+          if (IsMonitorSniffRxTraced ())
             {
-              dataRate500KbpsUnits = event->GetPayloadMode ().GetDataRate () * event->GetTxVector ().GetNss () / 500000;
+              uint32_t dataRate500KbpsUnits;
+              if ((event->GetPayloadMode ().GetModulationClass () == WIFI_MOD_CLASS_HT) || (event->GetPayloadMode ().GetModulationClass () == WIFI_MOD_CLASS_S1G))
+                {
+                  dataRate500KbpsUnits = 128 + WifiModeToMcs (event->GetPayloadMode ());
+                }
+              else
+                {
+                  dataRate500KbpsUnits = event->GetPayloadMode ().GetDataRate () * event->GetTxVector ().GetNss () / 500000;
+                }
+              bool isShortPreamble = (WIFI_PREAMBLE_SHORT == event->GetPreambleType ());
+              double signalDbm = RatioToDb (event->GetRxPowerW ()) + 30;
+              double noiseDbm = RatioToDb (event->GetRxPowerW () / snrPer.snr) - GetRxNoiseFigure () + 30;
+              NotifyMonitorSniffRx (packet, (uint16_t)GetChannelFrequencyMhz (), GetChannelNumber (), dataRate500KbpsUnits, isShortPreamble, event->GetTxVector (), signalDbm, noiseDbm);
             }
-          bool isShortPreamble = (WIFI_PREAMBLE_SHORT == event->GetPreambleType ());
-          double signalDbm = RatioToDb (event->GetRxPowerW ()) + 30;
-          double noiseDbm = RatioToDb (event->GetRxPowerW () / snrPer.snr) - GetRxNoiseFigure () + 30;
-          NotifyMonitorSniffRx (packet, (uint16_t)GetChannelFrequencyMhz (), GetChannelNumber (), dataRate500KbpsUnits, isShortPreamble, event->GetTxVector (), signalDbm, noiseDbm);
-          m_state->SwitchFromRxEndOk (packet, snrPer.snr, event->GetTxVector (), event->GetPreambleType ());
+          //The MAC adds tags and removes headers, so give it its own copy
+          m_state->SwitchFromRxEndOk (packet->Copy (), snrPer.snr, event->GetTxVector (), event->GetPreambleType ());
             
           //NS_LOG_UNCOND ("YansWifiPhy::EndReceive, SwitchFromRxEndOk, "  << packet);
         }
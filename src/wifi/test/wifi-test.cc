@@ -23,15 +23,20 @@
 #include "ns3/wifi-net-device.h"
 #include "ns3/yans-wifi-channel.h"
 #include "ns3/adhoc-wifi-mac.h"
+#include "ns3/ap-wifi-mac.h"
 #include "ns3/yans-wifi-phy.h"
 #include "ns3/arf-wifi-manager.h"
+#include "ns3/constant-rate-wifi-manager.h"
 #include "ns3/propagation-delay-model.h"
 #include "ns3/propagation-loss-model.h"
 #include "ns3/error-rate-model.h"
 #include "ns3/yans-error-rate-model.h"
+#include "ns3/nist-error-rate-model.h"
+#include "ns3/tabulated-error-rate-model.h"
 #include "ns3/constant-position-mobility-model.h"
 #include "ns3/node.h"
 #include "ns3/simulator.h"
+#include "ns3/simulator-impl.h"
 #include "ns3/test.h"
 #include "ns3/object-factory.h"
 #include "ns3/dca-txop.h"
@@ -39,8 +44,24 @@
 #include "ns3/pointer.h"
 #include "ns3/rng-seed-manager.h"
 #include "ns3/edca-txop-n.h"
+#include "ns3/wifi-mac-queue.h"
+#include "ns3/qos-blocked-destinations.h"
+#include "ns3/rps.h"
+#include "ns3/interference-helper.h"
+#include "ns3/s1g-downlink-scheduler.h"
+#include "ns3/twt-timeline.h"
+#include "ns3/twt-scheduler.h"
+#include "ns3/twt-trace.h"
 #include "ns3/config.h"
 #include "ns3/boolean.h"
+#include "ns3/double.h"
+#include "ns3/uinteger.h"
+#include "ns3/string.h"
+#include "ns3/core-config.h"
+#include <algorithm>
+#include <cmath>
+#include <sstream>
+#include <vector>
 
 using namespace ns3;
 
@@ -482,6 +503,1921 @@ Bug555TestCase::DoRun (void)
 }
 
 
+//-----------------------------------------------------------------------------
+/**
+ * Make sure that the receiver culling of YansWifiChannel skips exactly the
+ * receivers whose received power is below the floor when the propagation
+ * loss model is deterministic, that every receiver gets the frame when
+ * culling is disabled, and that the propagation cache follows receivers
+ * which change position between two frames.
+ */
+class YansWifiChannelReceiversTest : public TestCase
+{
+public:
+  YansWifiChannelReceiversTest ();
+
+  virtual void DoRun (void);
+
+
+private:
+  void RunOne (bool cull, bool cache);
+  Ptr<YansWifiPhy> CreateOne (Vector pos, Ptr<YansWifiChannel> channel, uint32_t index);
+  void SendOnePacket (Ptr<WifiNetDevice> dev);
+  void NotifyPhyRxBegin (std::string context, Ptr<const Packet> p);
+  void CheckReceptions (Ptr<PropagationLossModel> propLoss, bool cull);
+
+  ObjectFactory m_manager;
+  ObjectFactory m_mac;
+  std::vector<Ptr<YansWifiPhy> > m_phys;
+  std::vector<uint32_t> m_received;
+  double m_floor;
+};
+
+YansWifiChannelReceiversTest::YansWifiChannelReceiversTest ()
+  : TestCase ("YansWifiChannelReceivers"),
+    m_floor (-80.0)
+{
+}
+
+void
+YansWifiChannelReceiversTest::SendOnePacket (Ptr<WifiNetDevice> dev)
+{
+  Ptr<Packet> p = Create<Packet> (100);
+  dev->Send (p, dev->GetBroadcast (), 1);
+}
+
+void
+YansWifiChannelReceiversTest::NotifyPhyRxBegin (std::string context, Ptr<const Packet> p)
+{
+  std::istringstream is (context);
+  uint32_t index;
+  is >> index;
+  m_received[index]++;
+}
+
+Ptr<YansWifiPhy>
+YansWifiChannelReceiversTest::CreateOne (Vector pos, Ptr<YansWifiChannel> channel, uint32_t index)
+{
+  Ptr<Node> node = CreateObject<Node> ();
+  Ptr<WifiNetDevice> dev = CreateObject<WifiNetDevice> ();
+
+  Ptr<WifiMac> mac = m_mac.Create<WifiMac> ();
+  mac->ConfigureStandard (WIFI_PHY_STANDARD_80211a);
+  Ptr<ConstantPositionMobilityModel> mobility = CreateObject<ConstantPositionMobilityModel> ();
+  Ptr<YansWifiPhy> phy = CreateObject<YansWifiPhy> ();
+  Ptr<ErrorRateModel> error = CreateObject<YansErrorRateModel> ();
+  phy->SetErrorRateModel (error);
+  phy->SetChannel (channel);
+  phy->SetDevice (dev);
+  phy->ConfigureStandard (WIFI_PHY_STANDARD_80211a);
+  //Sync on every frame delivered by the channel
+  phy->SetEdThreshold (-200.0);
+  std::ostringstream os;
+  os << index;
+  phy->TraceConnect ("PhyRxBegin", os.str (), MakeCallback (&YansWifiChannelReceiversTest::NotifyPhyRxBegin, this));
+  Ptr<WifiRemoteStationManager> manager = m_manager.Create<WifiRemoteStationManager> ();
+
+  mobility->SetPosition (pos);
+  node->AggregateObject (mobility);
+  mac->SetAddress (Mac48Address::Allocate ());
+  dev->SetMac (mac);
+  dev->SetPhy (phy);
+  dev->SetRemoteStationManager (manager);
+  node->AddDevice (dev);
+  return phy;
+}
+
+void
+YansWifiChannelReceiversTest::CheckReceptions (Ptr<PropagationLossModel> propLoss, bool cull)
+{
+  Ptr<MobilityModel> senderMobility = m_phys[0]->GetMobility ();
+  double txPowerDbm = m_phys[0]->GetTxPowerStart () + m_phys[0]->GetTxGain ();
+  uint32_t nCulled = 0;
+  for (uint32_t i = 1; i < m_phys.size (); i++)
+    {
+      double rxPowerDbm = propLoss->CalcRxPower (txPowerDbm, senderMobility, m_phys[i]->GetMobility ());
+      uint32_t expected = (!cull || rxPowerDbm >= m_floor) ? 1 : 0;
+      nCulled += 1 - expected;
+      NS_TEST_EXPECT_MSG_EQ (m_received[i], expected, "Unexpected reception at receiver " << i);
+    }
+  NS_TEST_EXPECT_MSG_EQ (m_received[0], 0, "The sender received its own frame");
+  if (cull)
+    {
+      NS_TEST_EXPECT_MSG_GT (nCulled, 0, "The test topology does not exercise culling");
+    }
+  m_received.assign (m_phys.size (), 0);
+}
+
+void
+YansWifiChannelReceiversTest::RunOne (bool cull, bool cache)
+{
+  Ptr<YansWifiChannel> channel = CreateObject<YansWifiChannel> ();
+  channel->SetAttribute ("ReceiverCulling", BooleanValue (cull));
+  channel->SetAttribute ("RxPowerFloor", DoubleValue (m_floor));
+  channel->SetAttribute ("CullingCellSize", DoubleValue (25.0));
+  channel->SetAttribute ("CachePropagation", BooleanValue (cache));
+  Ptr<PropagationLossModel> propLoss = CreateObject<LogDistancePropagationLossModel> ();
+  channel->SetPropagationDelayModel (CreateObject<ConstantSpeedPropagationDelayModel> ());
+  channel->SetPropagationLossModel (propLoss);
+
+  m_phys.clear ();
+  for (uint32_t i = 0; i < 64; i++)
+    {
+      m_phys.push_back (CreateOne (Vector ((i % 8) * 12.0 - 20.0, (i / 8) * 9.0 - 30.0, 1.5), channel, i));
+    }
+  m_received.assign (m_phys.size (), 0);
+
+  Ptr<WifiNetDevice> sender = DynamicCast<WifiNetDevice> (m_phys[0]->GetDevice ());
+  Simulator::Schedule (Seconds (1.0), &YansWifiChannelReceiversTest::SendOnePacket, this, sender);
+  Simulator::Schedule (Seconds (1.5), &YansWifiChannelReceiversTest::CheckReceptions, this, propLoss, cull);
+  //Swap a close and a distant receiver before sending again
+  Simulator::Schedule (Seconds (1.6), &MobilityModel::SetPosition, m_phys[1]->GetMobility (), Vector (70.0, 40.0, 1.5));
+  Simulator::Schedule (Seconds (1.6), &MobilityModel::SetPosition, m_phys[63]->GetMobility (), Vector (-15.0, -28.0, 1.5));
+  Simulator::Schedule (Seconds (2.0), &YansWifiChannelReceiversTest::SendOnePacket, this, sender);
+  Simulator::Schedule (Seconds (2.5), &YansWifiChannelReceiversTest::CheckReceptions, this, propLoss, cull);
+  Simulator::Stop (Seconds (3.0));
+  Simulator::Run ();
+  Simulator::Destroy ();
+  m_phys.clear ();
+}
+
+void
+YansWifiChannelReceiversTest::DoRun (void)
+{
+  m_mac.SetTypeId ("ns3::AdhocWifiMac");
+  m_manager.SetTypeId ("ns3::ConstantRateWifiManager");
+
+  RunOne (false, false);
+  RunOne (true, false);
+  RunOne (false, true);
+  RunOne (true, true);
+}
+
+
+#ifdef HAVE_PTHREAD_H
+//-----------------------------------------------------------------------------
+/**
+ * Make sure the nodes of a YansWifiChannel receive the same frames when
+ * they are spread over the threads of the MultithreadedSimulatorImpl.
+ */
+class YansWifiChannelParallelTest : public TestCase
+{
+public:
+  YansWifiChannelParallelTest ();
+
+  virtual void DoRun (void);
+
+
+private:
+  /** Reception log of a node: time (ns) and size of each frame. */
+  typedef std::vector<std::pair<int64_t, uint32_t> > RxLog;
+
+  std::vector<RxLog> RunOne (std::string simulatorType);
+  void CreateOne (Vector pos, Ptr<YansWifiChannel> channel, uint32_t index);
+  void SendOnePacket (Ptr<WifiNetDevice> dev, uint32_t size);
+  bool Receive (Ptr<NetDevice> dev, Ptr<const Packet> p, uint16_t protocol, const Address &from);
+
+  ObjectFactory m_manager;
+  ObjectFactory m_mac;
+  std::vector<RxLog> m_logs;
+};
+
+YansWifiChannelParallelTest::YansWifiChannelParallelTest ()
+  : TestCase ("YansWifiChannelParallel")
+{
+}
+
+void
+YansWifiChannelParallelTest::SendOnePacket (Ptr<WifiNetDevice> dev, uint32_t size)
+{
+  Ptr<Packet> p = Create<Packet> (size);
+  dev->Send (p, dev->GetBroadcast (), 1);
+}
+
+bool
+YansWifiChannelParallelTest::Receive (Ptr<NetDevice> dev, Ptr<const Packet> p, uint16_t protocol, const Address &from)
+{
+  m_logs[dev->GetNode ()->GetId ()].push_back (std::make_pair (Simulator::Now ().GetNanoSeconds (), p->GetSize ()));
+  return true;
+}
+
+void
+YansWifiChannelParallelTest::CreateOne (Vector pos, Ptr<YansWifiChannel> channel, uint32_t index)
+{
+  Ptr<Node> node = CreateObject<Node> ();
+  Ptr<WifiNetDevice> dev = CreateObject<WifiNetDevice> ();
+
+  Ptr<WifiMac> mac = m_mac.Create<WifiMac> ();
+  mac->ConfigureStandard (WIFI_PHY_STANDARD_80211a);
+  Ptr<ConstantPositionMobilityModel> mobility = CreateObject<ConstantPositionMobilityModel> ();
+  Ptr<YansWifiPhy> phy = CreateObject<YansWifiPhy> ();
+  Ptr<ErrorRateModel> error = CreateObject<YansErrorRateModel> ();
+  phy->SetErrorRateModel (error);
+  phy->SetChannel (channel);
+  phy->SetDevice (dev);
+  phy->ConfigureStandard (WIFI_PHY_STANDARD_80211a);
+  Ptr<WifiRemoteStationManager> manager = m_manager.Create<WifiRemoteStationManager> ();
+
+  mobility->SetPosition (pos);
+  node->AggregateObject (mobility);
+  mac->SetAddress (Mac48Address::Allocate ());
+  dev->SetMac (mac);
+  dev->SetPhy (phy);
+  dev->SetRemoteStationManager (manager);
+  node->AddDevice (dev);
+  dev->SetReceiveCallback (MakeCallback (&YansWifiChannelParallelTest::Receive, this));
+  AssignWifiRandomStreams (mac, 10 * index);
+  phy->AssignStreams (10 * index + 9);
+
+  //The frames of each node must be sent from its own context
+  for (uint32_t k = 0; k < 5; k++)
+    {
+      Simulator::ScheduleWithContext (node->GetId (), MicroSeconds (1000000 + 3100 * k + 370 * index),
+                                      &YansWifiChannelParallelTest::SendOnePacket, this, dev, 100 + index);
+    }
+}
+
+std::vector<YansWifiChannelParallelTest::RxLog>
+YansWifiChannelParallelTest::RunOne (std::string simulatorType)
+{
+  Config::SetGlobal ("SimulatorImplementationType", StringValue (simulatorType));
+  Config::SetDefault ("ns3::MultithreadedSimulatorImpl::Threads", UintegerValue (4));
+
+  Ptr<YansWifiChannel> channel = CreateObject<YansWifiChannel> ();
+  channel->SetAttribute ("CachePropagation", BooleanValue (true));
+  channel->SetPropagationDelayModel (CreateObject<ConstantSpeedPropagationDelayModel> ());
+  channel->SetPropagationLossModel (CreateObject<LogDistancePropagationLossModel> ());
+
+  uint32_t nodes = 24;
+  for (uint32_t i = 0; i < nodes; i++)
+    {
+      CreateOne (Vector (std::fmod (i * 7.3, 60.0), std::fmod (i * 11.9, 45.0), 1.5), channel, i);
+    }
+  m_logs.assign (nodes, RxLog ());
+  Time lookahead = channel->GetLookahead ();
+  NS_TEST_EXPECT_MSG_GT (lookahead, Time (0), "the nodes do not overlap");
+  Simulator::GetImplementation ()->SetAttributeFailSafe ("Lookahead", TimeValue (lookahead));
+
+  Simulator::Stop (Seconds (2.0));
+  Simulator::Run ();
+  Simulator::Destroy ();
+
+  for (uint32_t i = 0; i < nodes; i++)
+    {
+      //Frames which arrive at the same time may be handed over in another order
+      std::sort (m_logs[i].begin (), m_logs[i].end ());
+    }
+  return m_logs;
+}
+
+void
+YansWifiChannelParallelTest::DoRun (void)
+{
+  m_mac.SetTypeId ("ns3::AdhocWifiMac");
+  m_manager.SetTypeId ("ns3::ConstantRateWifiManager");
+
+  std::vector<RxLog> expected = RunOne ("ns3::DefaultSimulatorImpl");
+  std::vector<RxLog> logs = RunOne ("ns3::MultithreadedSimulatorImpl");
+  Config::SetGlobal ("SimulatorImplementationType", StringValue ("ns3::DefaultSimulatorImpl"));
+  Config::SetDefault ("ns3::MultithreadedSimulatorImpl::Threads", UintegerValue (0));
+
+  uint32_t received = 0;
+  for (uint32_t i = 0; i < expected.size (); i++)
+    {
+      received += expected[i].size ();
+      NS_TEST_EXPECT_MSG_EQ (logs[i].size (), expected[i].size (), "wrong number of frames received by node " << i);
+      NS_TEST_EXPECT_MSG_EQ ((logs[i] == expected[i]), true, "wrong frames received by node " << i);
+    }
+  NS_TEST_EXPECT_MSG_GT (received, 0, "no frame was received");
+}
+#endif /* HAVE_PTHREAD_H */
+
+
+//-----------------------------------------------------------------------------
+/**
+ * Make sure the TabulatedErrorRateModel follows the NistErrorRateModel
+ * for every S1G mode, at SNRs which are not on its grid.
+ */
+class TabulatedErrorRateModelTest : public TestCase
+{
+public:
+  TabulatedErrorRateModelTest ();
+
+  virtual void DoRun (void);
+};
+
+TabulatedErrorRateModelTest::TabulatedErrorRateModelTest ()
+  : TestCase ("Test the TabulatedErrorRateModel against the NistErrorRateModel")
+{
+}
+
+void
+TabulatedErrorRateModelTest::DoRun (void)
+{
+  Ptr<YansWifiPhy> phy = CreateObject<YansWifiPhy> ();
+  phy->ConfigureStandard (WIFI_PHY_STANDARD_80211ah);
+  Ptr<NistErrorRateModel> nist = CreateObject<NistErrorRateModel> ();
+  Ptr<TabulatedErrorRateModel> tabulated = CreateObject<TabulatedErrorRateModel> ();
+  const uint32_t nbits[] = {8, 100, 1000, 12000};
+  NS_TEST_ASSERT_MSG_GT (phy->GetNModes (), 0, "no S1G mode to test");
+
+  for (uint32_t i = 0; i < phy->GetNModes (); i++)
+    {
+      WifiMode mode = phy->GetMode (i);
+      for (double snrDb = -5.0; snrDb < 35.0; snrDb += 0.037)
+        {
+          double snr = std::pow (10.0, snrDb / 10.0);
+          for (uint32_t j = 0; j < sizeof (nbits) / sizeof (nbits[0]); j++)
+            {
+              double expected = nist->GetChunkSuccessRate (mode, snr, nbits[j]);
+              double actual = tabulated->GetChunkSuccessRate (mode, snr, nbits[j]);
+              NS_TEST_ASSERT_MSG_EQ_TOL (actual, expected, 1e-3,
+                                         mode << " at " << snrDb << " dB, " << nbits[j] << " bits");
+            }
+        }
+    }
+  NS_TEST_EXPECT_MSG_EQ (tabulated->GetChunkSuccessRate (phy->GetMode (0), 1.0, 0), 1.0,
+                         "an empty chunk is always received");
+}
+
+
+//-----------------------------------------------------------------------------
+/**
+ * Make sure WifiPhy::CalculateTxDuration remembers the durations of single
+ * MPDUs and leaves the MPDUs of an A-MPDU alone.
+ */
+class TxDurationCacheTest : public TestCase
+{
+public:
+  TxDurationCacheTest ();
+
+  virtual void DoRun (void);
+};
+
+TxDurationCacheTest::TxDurationCacheTest ()
+  : TestCase ("Test the WifiPhy transmission duration cache")
+{
+}
+
+void
+TxDurationCacheTest::DoRun (void)
+{
+  Ptr<YansWifiPhy> phy = CreateObject<YansWifiPhy> ();
+  phy->ConfigureStandard (WIFI_PHY_STANDARD_80211ah);
+  WifiTxVector txVector;
+  txVector.SetMode (phy->GetMode (0));
+  txVector.SetNss (1);
+  txVector.SetNess (0);
+  txVector.SetStbc (false);
+  UintegerValue hits;
+  UintegerValue misses;
+
+  Time expected = phy->CalculatePlcpPreambleAndHeaderDuration (txVector, WIFI_PREAMBLE_S1G_SHORT)
+    + phy->GetPayloadDuration (100, txVector, WIFI_PREAMBLE_S1G_SHORT, phy->GetFrequency (), 0, 0);
+  Time first = phy->CalculateTxDuration (100, txVector, WIFI_PREAMBLE_S1G_SHORT, phy->GetFrequency (), 0, 0);
+  Time second = phy->CalculateTxDuration (100, txVector, WIFI_PREAMBLE_S1G_SHORT, phy->GetFrequency (), 0, 0);
+  NS_TEST_EXPECT_MSG_EQ (first, expected, "computed duration differs from its components");
+  NS_TEST_EXPECT_MSG_EQ (second, expected, "cached duration differs from the computed one");
+  phy->CalculateTxDuration (200, txVector, WIFI_PREAMBLE_S1G_SHORT, phy->GetFrequency (), 0, 0);
+  phy->GetAttribute ("TxDurationCacheHits", hits);
+  phy->GetAttribute ("TxDurationCacheMisses", misses);
+  NS_TEST_EXPECT_MSG_EQ (hits.Get (), 1, "the second call should have hit the cache");
+  NS_TEST_EXPECT_MSG_EQ (misses.Get (), 2, "each new size should have missed the cache");
+
+  //An A-MPDU of two MPDUs, accounted for twice: the second time should
+  //give the same durations, and neither should go through the cache
+  for (uint32_t i = 0; i < 2; i++)
+    {
+      Time firstMpdu = phy->CalculateTxDuration (100, txVector, WIFI_PREAMBLE_S1G_SHORT, phy->GetFrequency (), 1, 1);
+      Time lastMpdu = phy->CalculateTxDuration (100, txVector, WIFI_PREAMBLE_NONE, phy->GetFrequency (), 2, 1);
+      NS_TEST_EXPECT_MSG_EQ (firstMpdu + lastMpdu - phy->CalculatePlcpPreambleAndHeaderDuration (txVector, WIFI_PREAMBLE_NONE),
+                             phy->CalculateTxDuration (200, txVector, WIFI_PREAMBLE_S1G_SHORT, phy->GetFrequency (), 0, 0),
+                             "an A-MPDU should last as long as a single MPDU of the same size");
+    }
+  phy->GetAttribute ("TxDurationCacheHits", hits);
+  phy->GetAttribute ("TxDurationCacheMisses", misses);
+  NS_TEST_EXPECT_MSG_EQ (hits.Get (), 3, "A-MPDU durations should not be looked up");
+  NS_TEST_EXPECT_MSG_EQ (misses.Get (), 2, "A-MPDU durations should not be cached");
+}
+
+
+//-----------------------------------------------------------------------------
+/**
+ * Check that the lookups of WifiMacQueue by destination give the packets
+ * of the linear scans they replaced, and that the packets expire in the
+ * order they were queued.
+ */
+class WifiMacQueueTest : public TestCase
+{
+public:
+  WifiMacQueueTest ();
+
+  virtual void DoRun (void);
+
+private:
+  /**
+   * Queue a QoS data packet.
+   * \param dest the receiver address
+   * \param tid the TID
+   * \param front whether to push the packet to the front of the queue
+   * \return the packet
+   */
+  Ptr<const Packet> Add (Mac48Address dest, uint8_t tid, bool front);
+  /** Check the packets after the first ones have expired */
+  void CheckExpiry (void);
+  /**
+   * Record a packet notified by the enqueue callback of the queue.
+   * \param packet the packet
+   * \param hdr the header of the packet
+   */
+  void NotifyEnqueued (Ptr<const Packet> packet, const WifiMacHeader &hdr);
+
+  Ptr<WifiMacQueue> m_queue;
+  std::vector<Ptr<const Packet> > m_packets;
+  std::vector<Ptr<const Packet> > m_enqueued; //!< Packets notified by the enqueue callback
+};
+
+WifiMacQueueTest::WifiMacQueueTest ()
+  : TestCase ("Test the WifiMacQueue index by destination")
+{
+}
+
+Ptr<const Packet>
+WifiMacQueueTest::Add (Mac48Address dest, uint8_t tid, bool front)
+{
+  WifiMacHeader hdr;
+  hdr.SetType (WIFI_MAC_QOSDATA);
+  hdr.SetAddr1 (dest);
+  hdr.SetQosTid (tid);
+  Ptr<const Packet> packet = Create<Packet> (100);
+  if (front)
+    {
+      m_queue->PushFront (packet, hdr);
+    }
+  else
+    {
+      m_queue->Enqueue (packet, hdr);
+    }
+  m_packets.push_back (packet);
+  return packet;
+}
+
+void
+WifiMacQueueTest::NotifyEnqueued (Ptr<const Packet> packet, const WifiMacHeader &hdr)
+{
+  m_enqueued.push_back (packet);
+}
+
+void
+WifiMacQueueTest::CheckExpiry (void)
+{
+  // Only the packets queued 100 ms after the first ones are left
+  WifiMacHeader hdr;
+  NS_TEST_EXPECT_MSG_EQ (m_queue->Peek (&hdr), m_packets[7], "the late packet pushed to the front should be first");
+  NS_TEST_EXPECT_MSG_EQ (m_queue->GetSize (), 3, "the packets of the first batch should have expired");
+  NS_TEST_EXPECT_MSG_EQ (m_queue->GetNPacketsByTidAndAddress (1, WifiMacHeader::ADDR1, Mac48Address ("00:00:00:00:00:01")), 1,
+                         "the late packet of the destination should be left");
+  NS_TEST_EXPECT_MSG_EQ (m_queue->Dequeue (&hdr), m_packets[7], "the queue should keep its order");
+  NS_TEST_EXPECT_MSG_EQ (m_queue->Dequeue (&hdr), m_packets[5], "the queue should keep its order");
+  NS_TEST_EXPECT_MSG_EQ (m_queue->Dequeue (&hdr), m_packets[6], "the queue should keep its order");
+  NS_TEST_EXPECT_MSG_EQ (m_queue->IsEmpty (), true, "the queue should be empty");
+}
+
+void
+WifiMacQueueTest::DoRun (void)
+{
+  Mac48Address a ("00:00:00:00:00:01");
+  Mac48Address b ("00:00:00:00:00:02");
+  Mac48Address c ("00:00:00:00:00:03");
+  m_queue = CreateObject<WifiMacQueue> ();
+  m_queue->SetMaxDelay (MilliSeconds (500));
+  m_queue->SetEnqueueCallback (MakeCallback (&WifiMacQueueTest::NotifyEnqueued, this));
+  WifiMacHeader hdr;
+  Time tstamp;
+
+  // In order of the queue: 3 (a, 1), 0 (a, 1), 1 (b, 1), 2 (a, 2), 4 (c, 1)
+  Add (a, 1, false);
+  Add (b, 1, false);
+  Add (a, 2, false);
+  Add (a, 1, true);
+  Add (c, 1, false);
+  NS_TEST_EXPECT_MSG_EQ (m_queue->GetSize (), 5, "all the packets should be queued");
+  // The callback sees the packets pushed to the front too, with no trace connected
+  NS_TEST_EXPECT_MSG_EQ (m_enqueued.size (), 5, "every packet queued should be notified");
+  NS_TEST_EXPECT_MSG_EQ (m_enqueued[3], m_packets[3], "the packet pushed to the front should be notified");
+  NS_TEST_EXPECT_MSG_EQ (m_queue->GetNPacketsByTidAndAddress (1, WifiMacHeader::ADDR1, a), 2, "wrong count of (a, 1)");
+  NS_TEST_EXPECT_MSG_EQ (m_queue->GetNPacketsByTidAndAddress (2, WifiMacHeader::ADDR1, c), 0, "wrong count of (c, 2)");
+  NS_TEST_EXPECT_MSG_EQ (m_queue->PeekByTidAndAddress (&hdr, 1, WifiMacHeader::ADDR1, a, &tstamp), m_packets[3],
+                         "the packet pushed to the front should be the first of its destination");
+  NS_TEST_EXPECT_MSG_EQ (m_queue->PeekByTidAndAddress (&hdr, 2, WifiMacHeader::ADDR1, b, &tstamp), 0,
+                         "there is no packet for (b, 2)");
+  NS_TEST_EXPECT_MSG_EQ (m_queue->PeekByAddress (WifiMacHeader::ADDR1, a), m_packets[3], "wrong first packet of a");
+  NS_TEST_EXPECT_MSG_EQ (m_queue->PeekByAddress (WifiMacHeader::ADDR1, b), m_packets[1], "wrong first packet of b");
+
+  // Block every destination of a and b: the first packet of c is the
+  // first available
+  QosBlockedDestinations blocked;
+  blocked.Block (a, 1);
+  blocked.Block (a, 2);
+  blocked.Block (b, 1);
+  NS_TEST_EXPECT_MSG_EQ (m_queue->PeekFirstAvailable (&hdr, tstamp, &blocked), m_packets[4], "wrong first available packet");
+  blocked.Unblock (a, 2);
+  NS_TEST_EXPECT_MSG_EQ (m_queue->DequeueFirstAvailable (&hdr, tstamp, &blocked), m_packets[2], "wrong first available packet");
+  NS_TEST_EXPECT_MSG_EQ (m_queue->DequeueByTidAndAddress (&hdr, 1, WifiMacHeader::ADDR1, a), m_packets[3],
+                         "wrong first packet of (a, 1)");
+  NS_TEST_EXPECT_MSG_EQ (m_queue->Remove (m_packets[1]), true, "the packet of b should be removed");
+  NS_TEST_EXPECT_MSG_EQ (m_queue->PeekByAddress (WifiMacHeader::ADDR1, b), 0, "b should have no packet left");
+  NS_TEST_EXPECT_MSG_EQ (m_queue->Peek (&hdr), m_packets[0], "wrong first packet");
+  NS_TEST_EXPECT_MSG_EQ (m_queue->GetSize (), 2, "wrong size after the removals");
+
+  // A second batch 100 ms later, which outlives the first
+  Simulator::Schedule (MilliSeconds (100), &WifiMacQueueTest::Add, this, b, 1, false);
+  Simulator::Schedule (MilliSeconds (100), &WifiMacQueueTest::Add, this, c, 1, false);
+  Simulator::Schedule (MilliSeconds (100), &WifiMacQueueTest::Add, this, a, 1, true);
+  Simulator::Schedule (MilliSeconds (550), &WifiMacQueueTest::CheckExpiry, this);
+  Simulator::Run ();
+  Simulator::Destroy ();
+  m_queue = 0;
+}
+
+
+//-----------------------------------------------------------------------------
+/**
+ * Check that the S1gDownlinkScheduler wakes each access category once
+ * per slot, whatever the number of frames of the slot, and that it
+ * forgets the stations whose queues are empty.
+ */
+class S1gDownlinkSchedulerTest : public TestCase
+{
+public:
+  S1gDownlinkSchedulerTest ();
+
+  virtual void DoRun (void);
+
+private:
+  /**
+   * Record a wake up.
+   * \param ac the access category woken up
+   */
+  void Wake (enum AcIndex ac);
+  /**
+   * \param aid the AID of a station
+   * \return whether frames are queued for the station
+   */
+  bool HasFrames (uint16_t aid);
+  /** Queue the frames of the two slots */
+  void QueueFrames (void);
+
+  S1gDownlinkScheduler m_scheduler;
+  std::vector<std::pair<Time, enum AcIndex> > m_wakes;
+  std::vector<uint16_t> m_queued;
+};
+
+S1gDownlinkSchedulerTest::S1gDownlinkSchedulerTest ()
+  : TestCase ("Test the S1gDownlinkScheduler wake ups and buffered AIDs")
+{
+}
+
+void
+S1gDownlinkSchedulerTest::Wake (enum AcIndex ac)
+{
+  m_wakes.push_back (std::make_pair (Simulator::Now (), ac));
+}
+
+bool
+S1gDownlinkSchedulerTest::HasFrames (uint16_t aid)
+{
+  return std::find (m_queued.begin (), m_queued.end (), aid) != m_queued.end ();
+}
+
+void
+S1gDownlinkSchedulerTest::QueueFrames (void)
+{
+  // Three frames of two access categories in the slot at 10 ms, one in
+  // the slot at 20 ms
+  m_scheduler.Schedule (AC_BE, MilliSeconds (10));
+  m_scheduler.Schedule (AC_VO, MilliSeconds (10));
+  m_scheduler.Schedule (AC_BE, MilliSeconds (10));
+  m_scheduler.Schedule (AC_BE, MilliSeconds (20));
+  NS_TEST_EXPECT_MSG_EQ (m_scheduler.GetNPendingSlots (), 2, "the frames of a slot should share a bucket");
+}
+
+void
+S1gDownlinkSchedulerTest::DoRun (void)
+{
+  m_scheduler.SetWakeCallback (MakeCallback (&S1gDownlinkSchedulerTest::Wake, this));
+  m_scheduler.SetHasFramesCallback (MakeCallback (&S1gDownlinkSchedulerTest::HasFrames, this));
+
+  Simulator::Schedule (MilliSeconds (1), &S1gDownlinkSchedulerTest::QueueFrames, this);
+  Simulator::Run ();
+  Simulator::Destroy ();
+  NS_TEST_EXPECT_MSG_EQ (m_scheduler.GetNPendingSlots (), 0, "every slot should have been woken up");
+  NS_TEST_EXPECT_MSG_EQ (m_wakes.size (), 3, "each access category should be woken up once per slot");
+  NS_TEST_EXPECT_MSG_EQ (m_wakes[0].first, MilliSeconds (11), "wrong start of the first slot");
+  NS_TEST_EXPECT_MSG_EQ (m_wakes[0].second, AC_BE, "the access categories should be woken up in order");
+  NS_TEST_EXPECT_MSG_EQ (m_wakes[1].first, MilliSeconds (11), "wrong start of the first slot");
+  NS_TEST_EXPECT_MSG_EQ (m_wakes[1].second, AC_VO, "the access categories should be woken up in order");
+  NS_TEST_EXPECT_MSG_EQ (m_wakes[2].first, MilliSeconds (21), "wrong start of the second slot");
+
+  // AIDs 1, 9, 70 and 200 are buffered, but the queues of 9 are empty
+  m_queued.push_back (1);
+  m_queued.push_back (70);
+  m_queued.push_back (200);
+  m_scheduler.Buffer (200);
+  m_scheduler.Buffer (9);
+  m_scheduler.Buffer (1);
+  m_scheduler.Buffer (70);
+  m_scheduler.Buffer (1);
+  std::vector<uint16_t> aids;
+  m_scheduler.GetBuffered (0, 127, aids);
+  NS_TEST_EXPECT_MSG_EQ (aids.size (), 2, "only the AIDs of the range with frames should be found");
+  NS_TEST_EXPECT_MSG_EQ (aids[0], 1, "the AIDs should be in order");
+  NS_TEST_EXPECT_MSG_EQ (aids[1], 70, "the AIDs should be in order");
+
+  // The AP sent the frames of 70: it is forgotten
+  m_queued.erase (std::find (m_queued.begin (), m_queued.end (), 70));
+  aids.clear ();
+  m_scheduler.GetBuffered (0, 0xffff, aids);
+  NS_TEST_EXPECT_MSG_EQ (aids.size (), 2, "the AIDs with empty queues should be left out");
+  NS_TEST_EXPECT_MSG_EQ (aids[1], 200, "wrong last AID");
+  m_queued.push_back (70);
+  aids.clear ();
+  m_scheduler.GetBuffered (64, 127, aids);
+  NS_TEST_EXPECT_MSG_EQ (aids.size (), 0, "an AID should be buffered again before it is found");
+  m_scheduler.Clear ();
+}
+
+
+//-----------------------------------------------------------------------------
+/**
+ * ApWifiMac which exposes its AID indexes to the test
+ */
+class AidIndexApWifiMac : public ApWifiMac
+{
+public:
+  using ApWifiMac::SetAid;
+  using ApWifiMac::RemoveAid;
+  using ApWifiMac::GetAidFromAddress;
+  using ApWifiMac::IsAidAssigned;
+  using ApWifiMac::GetAddressFromAid;
+  using ApWifiMac::IsAidAssociated;
+};
+
+/**
+ * Check that the AID indexes of the AP map the AIDs and the addresses
+ * of the stations both ways, and that a freed AID can be reused.
+ */
+class AidIndexTest : public TestCase
+{
+public:
+  AidIndexTest ();
+
+  virtual void DoRun (void);
+};
+
+AidIndexTest::AidIndexTest ()
+  : TestCase ("Check the AID indexes of the AP")
+{
+}
+
+void
+AidIndexTest::DoRun (void)
+{
+  Ptr<AidIndexApWifiMac> ap = CreateObject<AidIndexApWifiMac> ();
+  ap->ConfigureStandard (WIFI_PHY_STANDARD_80211ah);
+  Ptr<YansWifiPhy> phy = CreateObject<YansWifiPhy> ();
+  phy->ConfigureStandard (WIFI_PHY_STANDARD_80211ah);
+  Ptr<WifiRemoteStationManager> manager = CreateObject<ConstantRateWifiManager> ();
+  manager->SetupPhy (phy);
+  ap->SetWifiRemoteStationManager (manager);
+
+  Mac48Address a = Mac48Address ("00:00:00:00:00:01");
+  Mac48Address b = Mac48Address ("00:00:00:00:00:02");
+  Mac48Address c = Mac48Address ("00:00:00:00:00:03");
+
+  ap->SetAid (1, a);
+  ap->SetAid (70, b);
+  manager->RecordGotAssocTxOk (a);
+
+  uint16_t aidA = ap->GetAidFromAddress (a);
+  uint16_t aidB = ap->GetAidFromAddress (b);
+  uint16_t aidC = ap->GetAidFromAddress (c);
+  bool assigned1 = ap->IsAidAssigned (1);
+  bool assigned70 = ap->IsAidAssigned (70);
+  bool assigned2 = ap->IsAidAssigned (2);
+  bool assigned1000 = ap->IsAidAssigned (1000);
+  Mac48Address addr1 = ap->GetAddressFromAid (1);
+  Mac48Address addr70 = ap->GetAddressFromAid (70);
+  bool associated1 = ap->IsAidAssociated (1);
+  bool associated70 = ap->IsAidAssociated (70);
+
+  // free the AID of b and give it to c
+  ap->RemoveAid (b);
+  uint16_t removedB = ap->GetAidFromAddress (b);
+  bool freed70 = ap->IsAidAssigned (70);
+  ap->SetAid (70, c);
+  uint16_t reusedC = ap->GetAidFromAddress (c);
+  uint16_t reusedB = ap->GetAidFromAddress (b);
+  Mac48Address reused70 = ap->GetAddressFromAid (70);
+
+  // a new AID for a replaces its old one
+  ap->SetAid (5, a);
+  uint16_t movedA = ap->GetAidFromAddress (a);
+  bool moved1 = ap->IsAidAssigned (1);
+
+  Simulator::Destroy ();
+
+  NS_TEST_ASSERT_MSG_EQ (aidA, 1, "wrong AID for a");
+  NS_TEST_ASSERT_MSG_EQ (aidB, 70, "wrong AID for b");
+  NS_TEST_ASSERT_MSG_EQ (aidC, 0, "an unknown address has no AID");
+  NS_TEST_ASSERT_MSG_EQ (assigned1, true, "AID 1 is assigned");
+  NS_TEST_ASSERT_MSG_EQ (assigned70, true, "AID 70 is assigned");
+  NS_TEST_ASSERT_MSG_EQ (assigned2, false, "AID 2 is not assigned");
+  NS_TEST_ASSERT_MSG_EQ (assigned1000, false, "AID 1000 is not assigned");
+  NS_TEST_ASSERT_MSG_EQ (addr1, a, "wrong address for AID 1");
+  NS_TEST_ASSERT_MSG_EQ (addr70, b, "wrong address for AID 70");
+  NS_TEST_ASSERT_MSG_EQ (associated1, true, "the station of AID 1 is associated");
+  NS_TEST_ASSERT_MSG_EQ (associated70, false, "the station of AID 70 is not associated");
+  NS_TEST_ASSERT_MSG_EQ (removedB, 0, "a removed station has no AID");
+  NS_TEST_ASSERT_MSG_EQ (freed70, false, "AID 70 was freed");
+  NS_TEST_ASSERT_MSG_EQ (reusedC, 70, "the freed AID was not reused");
+  NS_TEST_ASSERT_MSG_EQ (reusedB, 0, "the reused AID still maps to its old station");
+  NS_TEST_ASSERT_MSG_EQ (reused70, c, "wrong address for the reused AID");
+  NS_TEST_ASSERT_MSG_EQ (movedA, 5, "wrong AID for a after a new assignment");
+  NS_TEST_ASSERT_MSG_EQ (moved1, false, "the old AID of a is still assigned");
+}
+
+//-----------------------------------------------------------------------------
+/**
+ * ApWifiMac which exposes its RAW schedule cache to the test
+ */
+class RawScheduleApWifiMac : public ApWifiMac
+{
+public:
+  using ApWifiMac::GetRawSchedule;
+};
+
+/**
+ * Check the slot lookups of a RawSchedule at the boundaries of its
+ * groups and slots, the access lists of the slots, and that a schedule
+ * is compiled again only when the content of its RPS changes.
+ */
+class RawScheduleTest : public TestCase
+{
+public:
+  RawScheduleTest ();
+
+  virtual void DoRun (void);
+
+private:
+  /**
+   * Add a RAW group to an RPS.
+   * \param rps the RPS
+   * \param aidStart the first AID of the group
+   * \param aidEnd the last AID of the group
+   * \param slotNum the number of slots of the group
+   * \param count the slot duration count of the group
+   */
+  void AddGroup (RPS &rps, uint16_t aidStart, uint16_t aidEnd, uint16_t slotNum, uint16_t count);
+  /** Check the lookups of the slots */
+  void CheckSlots (void);
+  /** Check the access lists of the slots */
+  void CheckAccessLists (void);
+  /** Check when the schedule of an RPS is compiled again */
+  void CheckCache (void);
+};
+
+RawScheduleTest::RawScheduleTest ()
+  : TestCase ("Test the RawSchedule slot lookups and its cache")
+{
+}
+
+void
+RawScheduleTest::AddGroup (RPS &rps, uint16_t aidStart, uint16_t aidEnd, uint16_t slotNum, uint16_t count)
+{
+  RPS::RawAssignment raw;
+  raw.SetRawControl (0);
+  raw.SetSlotCrossBoundary (0);
+  raw.SetSlotFormat (0);
+  raw.SetSlotDurationCount (count);
+  raw.SetSlotNum (slotNum);
+  raw.SetRawGroup ((aidEnd << 13) | (aidStart << 2));
+  rps.SetRawAssignment (raw);
+}
+
+void
+RawScheduleTest::CheckSlots (void)
+{
+  // slots of 500 us for AIDs 1 to 8, then of 500 + 5 * 120 us for AIDs 9 to 16
+  RPS rps;
+  AddGroup (rps, 1, 8, 4, 0);
+  AddGroup (rps, 9, 16, 2, 5);
+  RawSchedule schedule (rps);
+
+  NS_TEST_ASSERT_MSG_EQ (schedule.GetNumberOfRawGroups (), 2, "wrong number of RAW groups");
+  NS_TEST_ASSERT_MSG_EQ (schedule.GetDuration (), MicroSeconds (4 * 500 + 2 * 1100), "wrong RAW duration");
+
+  uint32_t group = 0;
+  uint16_t slot = 0;
+  NS_TEST_ASSERT_MSG_EQ (schedule.FindSlot (1, group, slot), true, "AID 1 is in the first group");
+  NS_TEST_EXPECT_MSG_EQ (group, 0, "wrong group for AID 1");
+  NS_TEST_EXPECT_MSG_EQ (slot, 1, "wrong slot for AID 1");
+  NS_TEST_ASSERT_MSG_EQ (schedule.FindSlot (4, group, slot), true, "AID 4 is in the first group");
+  NS_TEST_EXPECT_MSG_EQ (slot, 0, "AID 4 wraps around to the first slot");
+  NS_TEST_ASSERT_MSG_EQ (schedule.FindSlot (8, group, slot), true, "AID 8 is in the first group");
+  NS_TEST_EXPECT_MSG_EQ (group, 0, "the last AID of a group belongs to it");
+  NS_TEST_EXPECT_MSG_EQ (slot, 0, "wrong slot for AID 8");
+  NS_TEST_ASSERT_MSG_EQ (schedule.FindSlot (9, group, slot), true, "AID 9 is in the second group");
+  NS_TEST_EXPECT_MSG_EQ (group, 1, "the first AID of a group belongs to it");
+  NS_TEST_EXPECT_MSG_EQ (slot, 1, "wrong slot for AID 9");
+  NS_TEST_ASSERT_MSG_EQ (schedule.FindSlot (16, group, slot), true, "AID 16 is in the second group");
+  NS_TEST_EXPECT_MSG_EQ (group, 1, "wrong group for AID 16");
+  NS_TEST_EXPECT_MSG_EQ (slot, 0, "wrong slot for AID 16");
+  NS_TEST_EXPECT_MSG_EQ (schedule.FindSlot (0, group, slot), false, "AID 0 is in no group");
+  NS_TEST_EXPECT_MSG_EQ (schedule.FindSlot (17, group, slot), false, "AID 17 is in no group");
+
+  NS_TEST_EXPECT_MSG_EQ (schedule.GetSlotStart (0, 0), MicroSeconds (0), "wrong start of the first slot");
+  NS_TEST_EXPECT_MSG_EQ (schedule.GetSlotStart (0, 3), MicroSeconds (1500), "wrong start of the last slot of the first group");
+  NS_TEST_EXPECT_MSG_EQ (schedule.GetSlotStart (1, 0), MicroSeconds (2000), "the second group starts when the first one ends");
+  NS_TEST_EXPECT_MSG_EQ (schedule.GetSlotStart (1, 1), MicroSeconds (3100), "wrong start of the last slot");
+}
+
+void
+RawScheduleTest::CheckAccessLists (void)
+{
+  RPS rps;
+  AddGroup (rps, 1, 8, 4, 0);
+  AddGroup (rps, 9, 16, 2, 5);
+  RawSchedule schedule (rps);
+
+  const RawSchedule::Group &first = schedule.GetRawGroup (0);
+  NS_TEST_ASSERT_MSG_EQ (first.slots.size (), 4, "one access list per slot");
+  Ptr<const RawSlotAccessList> list = first.slots[1];
+  NS_TEST_EXPECT_MSG_EQ (list->GetSlot (), 1, "wrong slot of the access list");
+  NS_TEST_EXPECT_MSG_EQ (list->IsAllowed (1), true, "AID 1 may access slot 1");
+  NS_TEST_EXPECT_MSG_EQ (list->IsAllowed (5), true, "AID 5 may access slot 1");
+  NS_TEST_EXPECT_MSG_EQ (list->IsAllowed (2), false, "AID 2 belongs to slot 2");
+  NS_TEST_EXPECT_MSG_EQ (list->IsAllowed (9), false, "AID 9 is outside the group");
+  list = first.slots[0];
+  NS_TEST_EXPECT_MSG_EQ (list->IsAllowed (8), true, "the last AID of the group may access its slot");
+  NS_TEST_EXPECT_MSG_EQ (list->IsAllowed (0), false, "AID 0 is outside the group");
+
+  // every AID of a group has exactly the slot FindSlot gives it
+  for (uint16_t aid = 1; aid <= 16; aid++)
+    {
+      uint32_t group = 0;
+      uint16_t slot = 0;
+      schedule.FindSlot (aid, group, slot);
+      const RawSchedule::Group &g = schedule.GetRawGroup (group);
+      for (uint16_t i = 0; i < g.slotNum; i++)
+        {
+          NS_TEST_EXPECT_MSG_EQ (g.slots[i]->IsAllowed (aid), (i == slot), "AID " << aid << " in slot " << i);
+        }
+    }
+}
+
+void
+RawScheduleTest::CheckCache (void)
+{
+  RPS rps;
+  AddGroup (rps, 1, 8, 4, 0);
+  RPS same;
+  AddGroup (same, 1, 8, 4, 0);
+  RPS longer;
+  AddGroup (longer, 1, 8, 4, 1);
+  RPS other;
+  AddGroup (other, 1, 9, 4, 0);
+
+  RawSchedule schedule (rps);
+  NS_TEST_EXPECT_MSG_EQ (schedule.Matches (rps), true, "a schedule matches its RPS");
+  NS_TEST_EXPECT_MSG_EQ (schedule.Matches (same), true, "a schedule matches an RPS with the same content");
+  NS_TEST_EXPECT_MSG_EQ (schedule.Matches (longer), false, "the slot duration changed");
+  NS_TEST_EXPECT_MSG_EQ (schedule.Matches (other), false, "the AID range changed");
+
+  Ptr<RawScheduleApWifiMac> ap = CreateObject<RawScheduleApWifiMac> ();
+  Ptr<const RawSchedule> first = ap->GetRawSchedule (&rps);
+  Ptr<const RawSchedule> again = ap->GetRawSchedule (&rps);
+  // a new RAW group changes the content of the RPS
+  AddGroup (rps, 9, 16, 2, 5);
+  Ptr<const RawSchedule> changed = ap->GetRawSchedule (&rps);
+  Ptr<const RawSchedule> changedAgain = ap->GetRawSchedule (&rps);
+  ap->Dispose ();
+  Simulator::Destroy ();
+
+  NS_TEST_EXPECT_MSG_EQ ((first == again), true, "the schedule of an unchanged RPS is reused");
+  NS_TEST_EXPECT_MSG_EQ ((changed != first), true, "the schedule of a changed RPS is compiled again");
+  NS_TEST_EXPECT_MSG_EQ (first->GetNumberOfRawGroups (), 1, "the old schedule is left untouched");
+  NS_TEST_EXPECT_MSG_EQ (changed->GetNumberOfRawGroups (), 2, "the new schedule has the new group");
+  NS_TEST_EXPECT_MSG_EQ ((changed == changedAgain), true, "the new schedule is reused");
+}
+
+void
+RawScheduleTest::DoRun (void)
+{
+  CheckSlots ();
+  CheckAccessLists ();
+  CheckCache ();
+}
+
+//-----------------------------------------------------------------------------
+/**
+ * WifiRemoteStationManager which records the stations it is handed
+ */
+class StationIndexWifiManager : public WifiRemoteStationManager
+{
+public:
+  StationIndexWifiManager ();
+
+  /**
+   * Find a station like the linear scan the index replaced.
+   * \param address the address of the station
+   * \param tid the TID of the station
+   * \return the station, or 0 if it was never handed to the manager
+   */
+  WifiRemoteStation * Scan (Mac48Address address, uint8_t tid) const;
+
+  WifiRemoteStation *m_last; //!< station of the last DoReportDataOk
+  std::vector<WifiRemoteStation *> m_seen; //!< stations handed to DoReportDataOk
+
+private:
+  virtual bool IsLowLatency (void) const;
+  virtual WifiRemoteStation * DoCreateStation (void) const;
+  virtual WifiTxVector DoGetDataTxVector (WifiRemoteStation *station, uint32_t size);
+  virtual WifiTxVector DoGetRtsTxVector (WifiRemoteStation *station);
+  virtual void DoReportRtsFailed (WifiRemoteStation *station);
+  virtual void DoReportDataFailed (WifiRemoteStation *station);
+  virtual void DoReportRtsOk (WifiRemoteStation *station, double ctsSnr, WifiMode ctsMode, double rtsSnr);
+  virtual void DoReportDataOk (WifiRemoteStation *station, double ackSnr, WifiMode ackMode, double dataSnr);
+  virtual void DoReportFinalRtsFailed (WifiRemoteStation *station);
+  virtual void DoReportFinalDataFailed (WifiRemoteStation *station);
+  virtual void DoReportRxOk (WifiRemoteStation *station, double rxSnr, WifiMode txMode);
+};
+
+StationIndexWifiManager::StationIndexWifiManager ()
+  : m_last (0)
+{
+}
+
+WifiRemoteStation *
+StationIndexWifiManager::Scan (Mac48Address address, uint8_t tid) const
+{
+  for (std::vector<WifiRemoteStation *>::const_iterator i = m_seen.begin (); i != m_seen.end (); i++)
+    {
+      if ((*i)->m_state->m_address == address && (*i)->m_tid == tid)
+        {
+          return (*i);
+        }
+    }
+  return 0;
+}
+
+bool
+StationIndexWifiManager::IsLowLatency (void) const
+{
+  return true;
+}
+
+WifiRemoteStation *
+StationIndexWifiManager::DoCreateStation (void) const
+{
+  return new WifiRemoteStation ();
+}
+
+WifiTxVector
+StationIndexWifiManager::DoGetDataTxVector (WifiRemoteStation *station, uint32_t size)
+{
+  return WifiTxVector ();
+}
+
+WifiTxVector
+StationIndexWifiManager::DoGetRtsTxVector (WifiRemoteStation *station)
+{
+  return WifiTxVector ();
+}
+
+void
+StationIndexWifiManager::DoReportRtsFailed (WifiRemoteStation *station)
+{
+}
+
+void
+StationIndexWifiManager::DoReportDataFailed (WifiRemoteStation *station)
+{
+}
+
+void
+StationIndexWifiManager::DoReportRtsOk (WifiRemoteStation *station, double ctsSnr, WifiMode ctsMode, double rtsSnr)
+{
+}
+
+void
+StationIndexWifiManager::DoReportDataOk (WifiRemoteStation *station, double ackSnr, WifiMode ackMode, double dataSnr)
+{
+  m_last = station;
+  if (std::find (m_seen.begin (), m_seen.end (), station) == m_seen.end ())
+    {
+      m_seen.push_back (station);
+    }
+}
+
+void
+StationIndexWifiManager::DoReportFinalRtsFailed (WifiRemoteStation *station)
+{
+}
+
+void
+StationIndexWifiManager::DoReportFinalDataFailed (WifiRemoteStation *station)
+{
+}
+
+void
+StationIndexWifiManager::DoReportRxOk (WifiRemoteStation *station, double rxSnr, WifiMode txMode)
+{
+}
+
+/**
+ * Check that the index of the WifiRemoteStationManager finds the same
+ * station states and per-TID stations as a linear scan, also after a
+ * station is disassociated and associated again and after a Reset.
+ */
+class StationIndexTest : public TestCase
+{
+public:
+  StationIndexTest ();
+
+  virtual void DoRun (void);
+
+private:
+  /**
+   * Report a successful transmission to a station.
+   * \param address the address of the station
+   * \param tid the TID of the frame, or -1 for a non-QoS frame
+   * \return the station the manager handed to DoReportDataOk
+   */
+  WifiRemoteStation * Report (Mac48Address address, int tid);
+
+  Ptr<StationIndexWifiManager> m_manager; //!< the station manager
+};
+
+StationIndexTest::StationIndexTest ()
+  : TestCase ("Test the WifiRemoteStationManager index by address")
+{
+}
+
+WifiRemoteStation *
+StationIndexTest::Report (Mac48Address address, int tid)
+{
+  WifiMacHeader hdr;
+  if (tid < 0)
+    {
+      hdr.SetType (WIFI_MAC_DATA);
+    }
+  else
+    {
+      hdr.SetType (WIFI_MAC_QOSDATA);
+      hdr.SetQosTid (tid);
+    }
+  m_manager->m_last = 0;
+  m_manager->ReportDataOk (address, &hdr, 0.0, WifiMode (), 0.0);
+  return m_manager->m_last;
+}
+
+void
+StationIndexTest::DoRun (void)
+{
+  m_manager = CreateObject<StationIndexWifiManager> ();
+  Ptr<YansWifiPhy> phy = CreateObject<YansWifiPhy> ();
+  phy->ConfigureStandard (WIFI_PHY_STANDARD_80211ah);
+  m_manager->SetupPhy (phy);
+
+  std::vector<Mac48Address> addresses;
+  for (uint32_t i = 0; i < 50; i++)
+    {
+      addresses.push_back (Mac48Address::Allocate ());
+    }
+  Mac48Address a = addresses[0];
+  Mac48Address b = addresses[1];
+  Mac48Address unknown = Mac48Address::Allocate ();
+
+  m_manager->RecordGotAssocTxOk (a);
+  m_manager->RecordWaitAssocTxOk (b);
+  NS_TEST_EXPECT_MSG_EQ (m_manager->IsAssociated (a), true, "a is associated");
+  NS_TEST_EXPECT_MSG_EQ (m_manager->IsWaitAssocTxOk (b), true, "b waits for its association");
+  NS_TEST_EXPECT_MSG_EQ (m_manager->IsAssociated (b), false, "b is not associated yet");
+  NS_TEST_EXPECT_MSG_EQ (m_manager->IsAssociated (unknown), false, "an unknown station is not associated");
+  NS_TEST_EXPECT_MSG_EQ (m_manager->IsWaitAssocTxOk (unknown), false, "an unknown station is brand new");
+
+  // every station and TID finds the station a linear scan finds, once created
+  // a non-QoS frame uses the station of TID 0
+  std::vector<WifiRemoteStation *> first;
+  uint32_t created = 0;
+  for (uint32_t i = 0; i < addresses.size (); i++)
+    {
+      first.push_back (Report (addresses[i], -1));
+      Report (addresses[i], i % 8);
+      created += (i % 8 == 0) ? 1 : 2;
+    }
+  for (uint32_t i = 0; i < addresses.size (); i++)
+    {
+      WifiRemoteStation *station = Report (addresses[i], -1);
+      WifiRemoteStation *qos = Report (addresses[i], i % 8);
+      NS_TEST_EXPECT_MSG_EQ ((station == first[i]), true, "a second lookup created a new station");
+      NS_TEST_EXPECT_MSG_EQ ((station == m_manager->Scan (addresses[i], 0)), true, "the index and the scan disagree");
+      NS_TEST_EXPECT_MSG_EQ ((qos == m_manager->Scan (addresses[i], i % 8)), true, "the index and the scan disagree for TID " << i % 8);
+      NS_TEST_EXPECT_MSG_EQ (station->m_state->m_address, addresses[i], "the station has the state of another station");
+      NS_TEST_EXPECT_MSG_EQ ((qos->m_state == station->m_state), true, "the TIDs of a station share its state");
+    }
+  NS_TEST_EXPECT_MSG_EQ (m_manager->m_seen.size (), created, "wrong number of stations");
+
+  // disassociate a and associate it again
+  WifiRemoteStationState *state = first[0]->m_state;
+  m_manager->RecordDisassociated (a);
+  NS_TEST_EXPECT_MSG_EQ (m_manager->IsAssociated (a), false, "a is disassociated");
+  NS_TEST_EXPECT_MSG_EQ ((Report (a, -1) == first[0]), true, "a keeps its station when disassociated");
+  m_manager->RecordGotAssocTxOk (a);
+  NS_TEST_EXPECT_MSG_EQ (m_manager->IsAssociated (a), true, "a is associated again");
+  NS_TEST_EXPECT_MSG_EQ ((Report (a, -1)->m_state == state), true, "a keeps its state when associated again");
+  NS_TEST_EXPECT_MSG_EQ (m_manager->IsAssociated (b), false, "the association of a changed b");
+
+  // a Reset drops the per-TID stations, the states remain
+  m_manager->Reset ();
+  m_manager->m_seen.clear ();
+  WifiRemoteStation *station = Report (a, -1);
+  NS_TEST_EXPECT_MSG_EQ ((station == m_manager->Scan (a, 0)), true, "the index and the scan disagree after a Reset");
+  NS_TEST_EXPECT_MSG_EQ ((station->m_state == state), true, "a lost its state in the Reset");
+  NS_TEST_EXPECT_MSG_EQ (m_manager->m_seen.size (), 1, "a Reset station should be created again");
+  NS_TEST_EXPECT_MSG_EQ ((Report (a, -1) == station), true, "the new station of a is reused");
+  NS_TEST_EXPECT_MSG_EQ (m_manager->IsAssociated (a), true, "a is still associated after a Reset");
+  NS_TEST_EXPECT_MSG_EQ (m_manager->IsWaitAssocTxOk (b), true, "b still waits for its association after a Reset");
+
+  m_manager->Dispose ();
+  m_manager = 0;
+  Simulator::Destroy ();
+}
+
+//-----------------------------------------------------------------------------
+/**
+ * Check that the NiChangeIterator walks the same NI changes as the copy
+ * the PER computations used to make, and that GetEnergyDuration, which
+ * resumes from where its previous call stopped, agrees with a scan from
+ * the first NI change.
+ */
+class InterferenceHelperNiChangesTest : public TestCase
+{
+public:
+  InterferenceHelperNiChangesTest ();
+
+  virtual void DoRun (void);
+
+private:
+  /// A NI change
+  typedef InterferenceHelper::NiChange NiChange;
+
+  /**
+   * Add a signal starting now.
+   * \param helper the interference helper
+   * \param duration the duration of the signal
+   * \param powerW the power of the signal
+   */
+  void AddSignal (InterferenceHelper *helper, Time duration, double powerW);
+  /** Start to receive a signal of 1 ms on m_rx */
+  void StartReception (void);
+  /** Check the NI changes walked for the signal received by m_rx */
+  void CheckIterator (void);
+  /**
+   * Check GetEnergyDuration of m_cca against a scan from the first NI change.
+   * \param energyW the energy threshold
+   */
+  void CheckEnergyDuration (double energyW);
+
+  InterferenceHelper m_rx;                //!< Receives a signal
+  Ptr<InterferenceHelper::Event> m_event; //!< The signal received by m_rx
+  InterferenceHelper m_cca;               //!< Never receives, only senses the energy
+  uint32_t m_nChecks;                     //!< Number of GetEnergyDuration checks
+};
+
+InterferenceHelperNiChangesTest::InterferenceHelperNiChangesTest ()
+  : TestCase ("InterferenceHelper walks the NI changes incrementally"),
+    m_nChecks (0)
+{
+}
+
+void
+InterferenceHelperNiChangesTest::AddSignal (InterferenceHelper *helper, Time duration, double powerW)
+{
+  helper->Add (100, WifiTxVector (), WIFI_PREAMBLE_LONG, Simulator::Now (), duration, powerW);
+}
+
+void
+InterferenceHelperNiChangesTest::StartReception (void)
+{
+  m_event = m_rx.Add (100, WifiTxVector (), WIFI_PREAMBLE_LONG, Simulator::Now (), MilliSeconds (1), 1e-9);
+  m_rx.NotifyRxStart ();
+}
+
+void
+InterferenceHelperNiChangesTest::CheckIterator (void)
+{
+  // The NI changes as CalculateNoiseInterferenceW used to copy them
+  std::vector<NiChange> expected;
+  expected.push_back (NiChange (m_event->GetStartTime (), m_rx.m_firstPower));
+  InterferenceHelper::NiChanges::const_iterator i = m_rx.m_niChanges.begin ();
+  for (i++; i != m_rx.m_niChanges.end (); i++)
+    {
+      if (m_event->GetEndTime () == i->GetTime () && m_event->GetRxPowerW () == -i->GetDelta ())
+        {
+          break;
+        }
+      expected.push_back (*i);
+    }
+  expected.push_back (NiChange (m_event->GetEndTime (), 0));
+  NS_TEST_EXPECT_MSG_GT (expected.size (), 6, "the signal should overlap several others");
+
+  uint32_t n = 0;
+  for (InterferenceHelper::NiChangeIterator it (m_rx.m_niChanges, m_rx.m_firstPower, m_event); !it.IsEnd (); it.Next ())
+    {
+      if (n < expected.size ())
+        {
+          NS_TEST_EXPECT_MSG_EQ ((*it).GetTime (), expected[n].GetTime (), "wrong time of NI change " << n);
+          NS_TEST_EXPECT_MSG_EQ ((*it).GetDelta (), expected[n].GetDelta (), "wrong power of NI change " << n);
+        }
+      n++;
+    }
+  NS_TEST_EXPECT_MSG_EQ (n, expected.size (), "wrong number of NI changes walked");
+}
+
+void
+InterferenceHelperNiChangesTest::CheckEnergyDuration (double energyW)
+{
+  Time now = Simulator::Now ();
+  double noiseInterferenceW = m_cca.m_firstPower;
+  Time end = now;
+  for (InterferenceHelper::NiChanges::const_iterator i = m_cca.m_niChanges.begin (); i != m_cca.m_niChanges.end (); i++)
+    {
+      noiseInterferenceW += i->GetDelta ();
+      end = i->GetTime ();
+      if (end < now)
+        {
+          continue;
+        }
+      if (noiseInterferenceW < energyW)
+        {
+          break;
+        }
+    }
+  Time expected = end > now ? end - now : MicroSeconds (0);
+  NS_TEST_EXPECT_MSG_EQ (m_cca.GetEnergyDuration (energyW), expected, "wrong energy duration for " << energyW << " W at " << now);
+  m_nChecks++;
+}
+
+void
+InterferenceHelperNiChangesTest::DoRun (void)
+{
+  Simulator::Schedule (Seconds (0), &InterferenceHelperNiChangesTest::StartReception, this);
+  Simulator::Schedule (MicroSeconds (100), &InterferenceHelperNiChangesTest::AddSignal, this, &m_rx, MicroSeconds (300), 2e-9);
+  Simulator::Schedule (MicroSeconds (200), &InterferenceHelperNiChangesTest::AddSignal, this, &m_rx, MicroSeconds (1200), 4e-9);
+  Simulator::Schedule (MicroSeconds (400), &InterferenceHelperNiChangesTest::AddSignal, this, &m_rx, MicroSeconds (100), 1e-9);
+  Simulator::Schedule (MicroSeconds (900), &InterferenceHelperNiChangesTest::AddSignal, this, &m_rx, MicroSeconds (100), 3e-9);
+  Simulator::Schedule (MicroSeconds (950), &InterferenceHelperNiChangesTest::CheckIterator, this);
+
+  // Signals sensed while not receiving, with the energy checked after each one for two thresholds
+  struct
+  {
+    uint32_t start;
+    uint32_t duration;
+    double powerW;
+  } signals[] = {
+    { 0, 1000, 1e-9 }, { 100, 300, 2e-9 }, { 100, 50, 1e-9 }, { 300, 1200, 4e-9 },
+    { 600, 100, 1e-9 }, { 1400, 100, 2e-9 }, { 1600, 200, 2e-9 }, { 1700, 50, 4e-9 },
+  };
+  for (uint32_t s = 0; s < sizeof (signals) / sizeof (signals[0]); s++)
+    {
+      Time start = MicroSeconds (signals[s].start);
+      Simulator::Schedule (start, &InterferenceHelperNiChangesTest::AddSignal, this, &m_cca,
+                           MicroSeconds (signals[s].duration), signals[s].powerW);
+      Simulator::Schedule (start, &InterferenceHelperNiChangesTest::CheckEnergyDuration, this, 2.5e-9);
+      Simulator::Schedule (start, &InterferenceHelperNiChangesTest::CheckEnergyDuration, this, 2.5e-9);
+      Simulator::Schedule (start, &InterferenceHelperNiChangesTest::CheckEnergyDuration, this, 0.5e-9);
+      Simulator::Schedule (start + MicroSeconds (10), &InterferenceHelperNiChangesTest::CheckEnergyDuration, this, 2.5e-9);
+    }
+  Simulator::Run ();
+  Simulator::Destroy ();
+  NS_TEST_EXPECT_MSG_EQ (m_nChecks, 4 * sizeof (signals) / sizeof (signals[0]), "every check should run");
+  m_rx.EraseEvents ();
+  m_cca.EraseEvents ();
+  m_event = 0;
+}
+
+
+//-----------------------------------------------------------------------------
+/**
+ * Check that the TwtTimeline starts and ends the service periods of its
+ * agreements in order, tracks the peers in a service period, and drops
+ * the boundaries of replaced and removed agreements.
+ */
+class TwtTimelineTest : public TestCase
+{
+public:
+  TwtTimelineTest ();
+
+  virtual void DoRun (void);
+
+private:
+  /**
+   * Start a service period of 2 ms.
+   * \param key the key of the agreement
+   * \param data the agreement
+   */
+  void Start (TWTAgreementKey &key, TWTAgreementData &data);
+  /**
+   * Record the end of a service period.
+   * \param key the key of the agreement
+   * \param data the agreement
+   */
+  void End (TWTAgreementKey &key, TWTAgreementData &data);
+  /**
+   * Check the peers in a service period.
+   * \param a whether a service period with the first peer is expected
+   * \param b whether a service period with the second peer is expected
+   */
+  void CheckServicePeriods (bool a, bool b);
+  /** Remove the agreement with the second peer */
+  void RemoveB (void);
+
+  TwtTimeline m_timeline;
+  Mac48Address m_a;
+  Mac48Address m_b;
+  std::vector<std::pair<Time, TWTAgreementKey> > m_starts;
+  std::vector<std::pair<Time, TWTAgreementKey> > m_ends;
+};
+
+TwtTimelineTest::TwtTimelineTest ()
+  : TestCase ("Test the TwtTimeline service periods"),
+    m_a ("00:00:00:00:00:01"),
+    m_b ("00:00:00:00:00:02")
+{
+}
+
+void
+TwtTimelineTest::Start (TWTAgreementKey &key, TWTAgreementData &data)
+{
+  m_starts.push_back (std::make_pair (Simulator::Now (), key));
+  m_timeline.StartServicePeriod (m_timeline.Find (key), MilliSeconds (2));
+}
+
+void
+TwtTimelineTest::End (TWTAgreementKey &key, TWTAgreementData &data)
+{
+  m_ends.push_back (std::make_pair (Simulator::Now (), key));
+}
+
+void
+TwtTimelineTest::CheckServicePeriods (bool a, bool b)
+{
+  NS_TEST_EXPECT_MSG_EQ (m_timeline.IsInServicePeriod (m_a), a, "wrong service period of the first peer at " << Simulator::Now ());
+  NS_TEST_EXPECT_MSG_EQ (m_timeline.IsInServicePeriod (m_b), b, "wrong service period of the second peer at " << Simulator::Now ());
+}
+
+void
+TwtTimelineTest::RemoveB (void)
+{
+  m_timeline.Remove (m_timeline.Find (TWTAgreementKey{m_b, 0}));
+}
+
+void
+TwtTimelineTest::DoRun (void)
+{
+  m_timeline.SetBoundaryCallbacks (MakeCallback (&TwtTimelineTest::Start, this),
+                                   MakeCallback (&TwtTimelineTest::End, this));
+  TwtTimeline::Handle a0 = m_timeline.Add (TWTAgreementKey{m_a, 0}, TWTAgreementData ());
+  TwtTimeline::Handle a1 = m_timeline.Add (TWTAgreementKey{m_a, 1}, TWTAgreementData ());
+  TwtTimeline::Handle b0 = m_timeline.Add (TWTAgreementKey{m_b, 0}, TWTAgreementData ());
+  NS_TEST_EXPECT_MSG_EQ (m_timeline.Add (TWTAgreementKey{m_a, 1}, TWTAgreementData ()), TwtTimeline::INVALID_HANDLE,
+                         "a flow identifier can only be used once per peer");
+  NS_TEST_EXPECT_MSG_EQ (m_timeline.GetN (), 3, "wrong number of agreements");
+  NS_TEST_EXPECT_MSG_EQ (m_timeline.Find (TWTAgreementKey{m_b, 1}), TwtTimeline::INVALID_HANDLE, "there is no such agreement");
+  std::vector<TwtTimeline::Handle> handles;
+  m_timeline.GetAgreements (m_a, handles);
+  NS_TEST_EXPECT_MSG_EQ (handles.size (), 2, "wrong number of agreements with the first peer");
+
+  m_timeline.ScheduleStart (a0, MilliSeconds (10));
+  m_timeline.ScheduleStart (a1, MilliSeconds (5));
+  m_timeline.ScheduleStart (b0, MilliSeconds (10));
+  // Replaces the start at 5 ms
+  m_timeline.ScheduleStart (a1, MilliSeconds (20));
+  CheckServicePeriods (false, false);
+  Simulator::Schedule (MilliSeconds (6), &TwtTimelineTest::CheckServicePeriods, this, false, false);
+  Simulator::Schedule (MilliSeconds (11), &TwtTimelineTest::CheckServicePeriods, this, true, true);
+  Simulator::Schedule (MilliSeconds (13), &TwtTimelineTest::CheckServicePeriods, this, false, false);
+  Simulator::Schedule (MilliSeconds (15), &TwtTimelineTest::RemoveB, this);
+  Simulator::Schedule (MilliSeconds (21), &TwtTimelineTest::CheckServicePeriods, this, true, false);
+  Simulator::Run ();
+  Simulator::Destroy ();
+
+  NS_TEST_EXPECT_MSG_EQ (m_starts.size (), 3, "wrong number of service periods");
+  NS_TEST_EXPECT_MSG_EQ (m_starts[0].first, MilliSeconds (10), "wrong start of the first service period");
+  NS_TEST_EXPECT_MSG_EQ (m_starts[0].second.macAddress, m_a, "the boundaries should keep their order");
+  NS_TEST_EXPECT_MSG_EQ (m_starts[1].second.macAddress, m_b, "the boundaries should keep their order");
+  NS_TEST_EXPECT_MSG_EQ (m_starts[2].first, MilliSeconds (20), "the start of a1 should have been replaced");
+  NS_TEST_EXPECT_MSG_EQ (m_ends.size (), 3, "every service period should end");
+  NS_TEST_EXPECT_MSG_EQ (m_ends[2].first, MilliSeconds (22), "wrong end of the last service period");
+
+  // The handle of a removed agreement is reused
+  NS_TEST_EXPECT_MSG_EQ (m_timeline.HasAgreements (m_b), false, "the agreement with the second peer was removed");
+  NS_TEST_EXPECT_MSG_EQ (m_timeline.Add (TWTAgreementKey{m_b, 3}, TWTAgreementData ()), b0, "the free handle should be reused");
+  m_timeline.Clear ();
+}
+
+
+//-----------------------------------------------------------------------------
+/**
+ * Check that the TwtScheduler rounds the wake intervals to harmonic ones
+ * and packs the service periods after the beacon and the RAW, with the
+ * guard interval, interleaving the longer intervals.
+ */
+class TwtSchedulerTest : public TestCase
+{
+public:
+  TwtSchedulerTest ();
+
+  virtual void DoRun (void);
+};
+
+TwtSchedulerTest::TwtSchedulerTest ()
+  : TestCase ("TwtScheduler packs the service periods")
+{
+}
+
+void
+TwtSchedulerTest::DoRun (void)
+{
+  Time bi = MicroSeconds (102400);
+  TwtScheduler scheduler;
+  scheduler.SetBeaconInterval (bi);
+  scheduler.SetGuardInterval (MicroSeconds (1000));
+  NS_TEST_EXPECT_MSG_EQ (scheduler.GetHarmonicInterval (Seconds (5)), MicroSeconds (3276800), "wrong multiple of the beacon interval");
+  NS_TEST_EXPECT_MSG_EQ (scheduler.GetHarmonicInterval (MicroSeconds (30000)), MicroSeconds (25600), "wrong division of the beacon interval");
+  NS_TEST_EXPECT_MSG_EQ (scheduler.GetHarmonicInterval (bi), bi, "the beacon interval is harmonic");
+
+  // The beacon and the RAW
+  scheduler.Reserve (Seconds (0), bi, MicroSeconds (40000));
+  Time phase;
+  NS_TEST_EXPECT_MSG_EQ (scheduler.FindPhase (bi, MicroSeconds (10000), phase), true, "a service period should fit");
+  NS_TEST_EXPECT_MSG_EQ (phase, MicroSeconds (41000), "the service period should follow the RAW and the guard interval");
+  scheduler.Reserve (phase, bi * 2, MicroSeconds (10000));
+
+  NS_TEST_EXPECT_MSG_EQ (scheduler.FindPhase (bi * 2, MicroSeconds (10000), phase), true, "a service period should fit");
+  NS_TEST_EXPECT_MSG_EQ (phase, MicroSeconds (52000), "the service period should follow the first one");
+  NS_TEST_EXPECT_MSG_EQ (scheduler.Fits (MicroSeconds (45000), bi * 2, MicroSeconds (10000)), false, "the service periods overlap");
+  NS_TEST_EXPECT_MSG_EQ (scheduler.Fits (MicroSeconds (41000) + bi, bi * 2, MicroSeconds (10000)), true,
+                         "the service periods should alternate between the beacon intervals");
+  NS_TEST_EXPECT_MSG_EQ (scheduler.Fits (MicroSeconds (41000) + bi, bi, MicroSeconds (10000)), false,
+                         "a service period every beacon interval meets the other one");
+  NS_TEST_EXPECT_MSG_EQ (scheduler.FindPhase (bi, MicroSeconds (70000), phase), false, "a long service period should not fit");
+  // A long wake interval only has to clear the shorter periods of the reservations
+  NS_TEST_EXPECT_MSG_EQ (scheduler.FindPhase (bi * 32, MicroSeconds (10000), phase), true, "a service period should fit");
+  NS_TEST_EXPECT_MSG_EQ (phase, MicroSeconds (52000), "the first free phase repeats every two beacon intervals");
+  NS_TEST_EXPECT_MSG_EQ (scheduler.GetN (), 2, "wrong number of reservations");
+
+  TWTHeader header;
+  NS_TEST_EXPECT_MSG_EQ (TwtScheduler::SetWakeInterval (header, MicroSeconds (3276800)), true, "the interval should be encoded");
+  NS_TEST_EXPECT_MSG_EQ (TwtScheduler::GetWakeInterval (header), MicroSeconds (3276800), "the interval should be decoded");
+  NS_TEST_EXPECT_MSG_EQ (TwtScheduler::SetWakeInterval (header, MicroSeconds (100001)), false, "the interval has no exact encoding");
+}
+
+
+//-----------------------------------------------------------------------------
+/**
+ * MAC which exposes the TWT exchanges to the tests
+ */
+template <typename Mac>
+class TwtTestWifiMac : public Mac
+{
+public:
+  using Mac::SendTwtFrame;
+  using Mac::QueueWithTwt;
+  using Mac::GetTwtAgreements;
+};
+
+/**
+ * Make sure an AP which schedules the TWT service periods answers a
+ * request colliding with the beacon it reserves with an alternative, and
+ * that the STA requesting the alternative gets the agreement at the
+ * proposed phase.
+ */
+class TwtSetupAlternateTest : public TestCase
+{
+public:
+  TwtSetupAlternateTest ();
+
+  virtual void DoRun (void);
+
+private:
+  /**
+   * Create a node on the channel.
+   * \param pos the position of the node
+   * \param channel the channel
+   * \param mac the MAC of the node
+   */
+  void CreateOne (Vector pos, Ptr<YansWifiChannel> channel, Ptr<RegularWifiMac> mac);
+  /** Send the TWT setup request of the STA */
+  void SendRequest (void);
+  /**
+   * Record the answer of the AP to a request.
+   * \param request the request
+   * \return whether the AP accepts the request
+   */
+  bool Accept (const TWTHeader &request);
+  /**
+   * Record the alternative proposed by the AP.
+   * \param request the request
+   * \return the alternative
+   */
+  TWTHeader Propose (const TWTHeader &request);
+
+  Ptr<TwtTestWifiMac<ApWifiMac> > m_ap;
+  Ptr<TwtTestWifiMac<AdhocWifiMac> > m_sta;
+  TWTParamaterAcceptanceFunctionType m_accept;       //!< Acceptance function of the AP
+  TWTAlternativeConfigurationFunctionType m_propose; //!< Alternative function of the AP
+  std::vector<bool> m_answers;                       //!< Whether the AP accepted each request
+  std::vector<TWTHeader> m_proposals;                //!< Alternatives proposed by the AP
+};
+
+TwtSetupAlternateTest::TwtSetupAlternateTest ()
+  : TestCase ("An AP scheduling TWT proposes a service period which fits")
+{
+}
+
+void
+TwtSetupAlternateTest::CreateOne (Vector pos, Ptr<YansWifiChannel> channel, Ptr<RegularWifiMac> mac)
+{
+  Ptr<Node> node = CreateObject<Node> ();
+  Ptr<WifiNetDevice> dev = CreateObject<WifiNetDevice> ();
+  mac->ConfigureStandard (WIFI_PHY_STANDARD_80211ah);
+  Ptr<ConstantPositionMobilityModel> mobility = CreateObject<ConstantPositionMobilityModel> ();
+  Ptr<YansWifiPhy> phy = CreateObject<YansWifiPhy> ();
+  phy->SetErrorRateModel (CreateObject<YansErrorRateModel> ());
+  phy->SetChannel (channel);
+  phy->SetDevice (dev);
+  phy->SetAttribute ("ChannelWidth", UintegerValue (2));
+  phy->ConfigureStandard (WIFI_PHY_STANDARD_80211ah);
+  ObjectFactory factory;
+  factory.SetTypeId ("ns3::ConstantRateWifiManager");
+  factory.Set ("DataMode", StringValue ("OfdmRate650KbpsBW2MHz"));
+  factory.Set ("ControlMode", StringValue ("OfdmRate650KbpsBW2MHz"));
+  Ptr<WifiRemoteStationManager> manager = factory.Create<WifiRemoteStationManager> ();
+
+  mobility->SetPosition (pos);
+  node->AggregateObject (mobility);
+  mac->SetAddress (Mac48Address::Allocate ());
+  dev->SetMac (mac);
+  dev->SetPhy (phy);
+  dev->SetRemoteStationManager (manager);
+  node->AddDevice (dev);
+}
+
+void
+TwtSetupAlternateTest::SendRequest (void)
+{
+  // Every other beacon, at the time of a beacon
+  Time bi = m_ap->GetBeaconInterval ();
+  TWTHeader request;
+  request.SetAction (TWT_ACTION_FRAMETYPE_SETUP);
+  request.SetSetupCommand (TWT_SETUPCOMMAND_REQUEST);
+  request.SetRequest (true);
+  request.SetImplicit (true);
+  request.SetAnnouncedFlowType (false);
+  request.SetFlowIdentifier (0);
+  request.SetDialogToken (1);
+  request.SetTargetWakeTime (bi * 20);
+  request.SetNominalMinimumWakeDuration (MicroSeconds (10240));
+  TwtScheduler::SetWakeInterval (request, bi * 2);
+  request.SetLength ();
+  m_sta->SendTwtFrame (request, m_ap->GetAddress ());
+}
+
+bool
+TwtSetupAlternateTest::Accept (const TWTHeader &request)
+{
+  bool accepted = m_accept (request);
+  m_answers.push_back (accepted);
+  return accepted;
+}
+
+TWTHeader
+TwtSetupAlternateTest::Propose (const TWTHeader &request)
+{
+  TWTHeader alternative = m_propose (request);
+  m_proposals.push_back (alternative);
+  return alternative;
+}
+
+void
+TwtSetupAlternateTest::DoRun (void)
+{
+  Ptr<YansWifiChannel> channel = CreateObject<YansWifiChannel> ();
+  channel->SetPropagationDelayModel (CreateObject<ConstantSpeedPropagationDelayModel> ());
+  channel->SetPropagationLossModel (CreateObject<LogDistancePropagationLossModel> ());
+  m_ap = CreateObject<TwtTestWifiMac<ApWifiMac> > ();
+  m_sta = CreateObject<TwtTestWifiMac<AdhocWifiMac> > ();
+  CreateOne (Vector (0.0, 0.0, 0.0), channel, m_ap);
+  CreateOne (Vector (5.0, 0.0, 0.0), channel, m_sta);
+
+  // Record the answers of the scheduling functions of the AP
+  m_ap->SetTwtScheduling (true);
+  m_accept = m_ap->GetTWTAcceptanceFunction ();
+  m_propose = m_ap->GetTWTAlternativeConfigurationFunction ();
+  m_ap->SetTWTAcceptanceFunction ([this](const TWTHeader &request) { return Accept (request); });
+  m_ap->SetTWTAlternativeConfigurationFunction ([this](const TWTHeader &request) { return Propose (request); });
+
+  Simulator::Schedule (Seconds (1.0), &TwtSetupAlternateTest::SendRequest, this);
+  Simulator::Stop (Seconds (1.5));
+  Simulator::Run ();
+
+  std::vector<TWTHeader> sta;
+  std::vector<TWTHeader> ap;
+  int64_t bi = m_ap->GetBeaconInterval ().GetMicroSeconds ();
+  Mac48Address apAddress = m_ap->GetAddress ();
+  Mac48Address staAddress = m_sta->GetAddress ();
+  for (const TWTHeader *agreement : m_sta->GetTwtAgreements (&apAddress))
+    {
+      sta.push_back (*agreement);
+    }
+  for (const TWTHeader *agreement : m_ap->GetTwtAgreements (&staAddress))
+    {
+      ap.push_back (*agreement);
+    }
+
+  // Disabling the scheduling restores the functions it replaced
+  m_ap->SetTwtScheduling (false);
+  NS_TEST_EXPECT_MSG_EQ ((m_ap->GetTWTAlternativeConfigurationFunction () == nullptr), true, "the alternative function should be restored");
+  bool called = false;
+  m_ap->SetTWTAlternativeConfigurationFunction ([&called](const TWTHeader &request) { called = true; return request; });
+  m_ap->SetTwtScheduling (true);
+  m_ap->SetTwtScheduling (true);
+  m_ap->SetTwtScheduling (false);
+  m_ap->GetTWTAlternativeConfigurationFunction () (TWTHeader ());
+  NS_TEST_EXPECT_MSG_EQ (called, true, "the alternative function set before the scheduling should be restored");
+  m_ap = 0;
+  m_sta = 0;
+  Simulator::Destroy ();
+
+  NS_TEST_ASSERT_MSG_EQ (m_answers.size (), 2, "the STA should request twice");
+  NS_TEST_EXPECT_MSG_EQ (m_answers[0], false, "the request meets the beacon");
+  NS_TEST_EXPECT_MSG_EQ (m_answers[1], true, "the request of the alternative should be accepted");
+  NS_TEST_ASSERT_MSG_EQ (m_proposals.size (), 1, "the AP should propose one alternative");
+  const TWTHeader &proposal = m_proposals[0];
+  NS_TEST_EXPECT_MSG_EQ (static_cast<uint32_t> (proposal.GetSetupCommand ()), static_cast<uint32_t> (TWT_SETUPCOMMAND_ALTERNATE),
+                         "the AP should propose an alternative");
+  int64_t phase = proposal.GetTargetWakeTime ().GetMicroSeconds () % bi;
+  NS_TEST_EXPECT_MSG_GT (phase, 0, "the alternative should leave room for the beacon");
+
+  NS_TEST_ASSERT_MSG_EQ (sta.size (), 1, "the STA should hold the agreement");
+  NS_TEST_ASSERT_MSG_EQ (ap.size (), 1, "the AP should hold the agreement");
+  NS_TEST_EXPECT_MSG_EQ (sta[0].GetTargetWakeTime (), proposal.GetTargetWakeTime (), "the STA should wake at the proposed time");
+  NS_TEST_EXPECT_MSG_EQ (ap[0].GetTargetWakeTime (), proposal.GetTargetWakeTime (), "the AP should wake at the proposed time");
+  NS_TEST_EXPECT_MSG_EQ (TwtScheduler::GetWakeInterval (sta[0]), TwtScheduler::GetWakeInterval (proposal), "wrong wake interval");
+  NS_TEST_EXPECT_MSG_EQ (sta[0].GetNominalMinimumWakeDuration (), proposal.GetNominalMinimumWakeDuration (), "wrong wake duration");
+}
+
+
+//-----------------------------------------------------------------------------
+/**
+ * Check that the TwtEventRing keeps the last events in order and reads
+ * back the binary records it writes.
+ */
+class TwtEventRingTest : public TestCase
+{
+public:
+  TwtEventRingTest ();
+
+  virtual void DoRun (void);
+};
+
+TwtEventRingTest::TwtEventRingTest ()
+  : TestCase ("TwtEventRing keeps the last TWT events")
+{
+}
+
+void
+TwtEventRingTest::DoRun (void)
+{
+  TwtEventRing ring (3);
+  Mac48Address peer ("00:00:00:00:00:07");
+  for (uint32_t i = 0; i < 5; i++)
+    {
+      TwtEvent event;
+      event.time = 1000 * i;
+      event.spStart = 1000 * i;
+      event.spEnd = 1000 * i + 500;
+      event.queued = i;
+      event.flushed = 2 * i;
+      event.key = TWTAgreementKey{peer, static_cast<uint8_t> (i % 2)};
+      event.type = i % 2 ? TWT_EVENT_SP_END : TWT_EVENT_SP_START;
+      ring.Record (event);
+    }
+  NS_TEST_EXPECT_MSG_EQ (ring.GetN (), 3, "the ring should be full");
+  NS_TEST_EXPECT_MSG_EQ (ring.GetLost (), 2, "the two oldest events should be overwritten");
+  NS_TEST_EXPECT_MSG_EQ (ring.Get (0).time, 2000, "wrong oldest event");
+  NS_TEST_EXPECT_MSG_EQ (ring.Get (2).time, 4000, "wrong newest event");
+
+  std::stringstream ss;
+  ring.Write (ss);
+  NS_TEST_EXPECT_MSG_EQ (ss.str ().size (), 3 * TwtEvent::SERIALIZED_SIZE, "wrong size of the records");
+  std::vector<TwtEvent> events;
+  NS_TEST_EXPECT_MSG_EQ (TwtEventRing::Read (ss, events), 3, "every record should be read");
+  for (uint32_t i = 0; i < events.size (); i++)
+    {
+      const TwtEvent &event = ring.Get (i);
+      NS_TEST_EXPECT_MSG_EQ (events[i].time, event.time, "wrong time");
+      NS_TEST_EXPECT_MSG_EQ (events[i].spEnd, event.spEnd, "wrong end of service period");
+      NS_TEST_EXPECT_MSG_EQ (events[i].queued, event.queued, "wrong queued count");
+      NS_TEST_EXPECT_MSG_EQ (events[i].flushed, event.flushed, "wrong flushed count");
+      NS_TEST_EXPECT_MSG_EQ (events[i].key.macAddress, peer, "wrong peer");
+      NS_TEST_EXPECT_MSG_EQ (static_cast<uint32_t> (events[i].key.flowIdentifier), static_cast<uint32_t> (event.key.flowIdentifier), "wrong flow");
+      NS_TEST_EXPECT_MSG_EQ (static_cast<uint32_t> (events[i].type), static_cast<uint32_t> (event.type), "wrong type");
+    }
+  ring.Clear ();
+  NS_TEST_EXPECT_MSG_EQ (ring.GetN (), 0, "the ring should be empty");
+}
+
+
+//-----------------------------------------------------------------------------
+/**
+ * Make sure the TwtEvent trace source of a MAC with a TWT agreement
+ * fires the setup, the service periods, the frames buffered between them
+ * and the teardown, with the counts of buffered and flushed frames.
+ */
+class TwtEventTraceTest : public TestCase
+{
+public:
+  TwtEventTraceTest ();
+
+  virtual void DoRun (void);
+
+private:
+  /**
+   * Create an ad hoc node on the channel.
+   * \param pos the position of the node
+   * \param channel the channel
+   * \return the MAC of the node
+   */
+  Ptr<TwtTestWifiMac<AdhocWifiMac> > CreateOne (Vector pos, Ptr<YansWifiChannel> channel);
+  /** Send the TWT setup request of the requester */
+  void SendRequest (void);
+  /** Send a data frame from the requester to the responder */
+  void SendData (void);
+  /** Tear the agreement down from the requester */
+  void Teardown (void);
+
+  Ptr<TwtTestWifiMac<AdhocWifiMac> > m_requester;
+  Ptr<TwtTestWifiMac<AdhocWifiMac> > m_responder;
+};
+
+TwtEventTraceTest::TwtEventTraceTest ()
+  : TestCase ("The TwtEvent trace source follows a TWT agreement")
+{
+}
+
+Ptr<TwtTestWifiMac<AdhocWifiMac> >
+TwtEventTraceTest::CreateOne (Vector pos, Ptr<YansWifiChannel> channel)
+{
+  Ptr<Node> node = CreateObject<Node> ();
+  Ptr<WifiNetDevice> dev = CreateObject<WifiNetDevice> ();
+  Ptr<TwtTestWifiMac<AdhocWifiMac> > mac = CreateObject<TwtTestWifiMac<AdhocWifiMac> > ();
+  mac->ConfigureStandard (WIFI_PHY_STANDARD_80211ah);
+  Ptr<ConstantPositionMobilityModel> mobility = CreateObject<ConstantPositionMobilityModel> ();
+  Ptr<YansWifiPhy> phy = CreateObject<YansWifiPhy> ();
+  phy->SetErrorRateModel (CreateObject<YansErrorRateModel> ());
+  phy->SetChannel (channel);
+  phy->SetDevice (dev);
+  phy->SetAttribute ("ChannelWidth", UintegerValue (2));
+  phy->ConfigureStandard (WIFI_PHY_STANDARD_80211ah);
+  ObjectFactory factory;
+  factory.SetTypeId ("ns3::ConstantRateWifiManager");
+  factory.Set ("DataMode", StringValue ("OfdmRate650KbpsBW2MHz"));
+  factory.Set ("ControlMode", StringValue ("OfdmRate650KbpsBW2MHz"));
+  Ptr<WifiRemoteStationManager> manager = factory.Create<WifiRemoteStationManager> ();
+
+  mobility->SetPosition (pos);
+  node->AggregateObject (mobility);
+  mac->SetAddress (Mac48Address::Allocate ());
+  dev->SetMac (mac);
+  dev->SetPhy (phy);
+  dev->SetRemoteStationManager (manager);
+  node->AddDevice (dev);
+  return mac;
+}
+
+void
+TwtEventTraceTest::SendRequest (void)
+{
+  // Service periods of 10.24 ms every 102.4 ms from 1.5 s
+  TWTHeader request;
+  request.SetAction (TWT_ACTION_FRAMETYPE_SETUP);
+  request.SetSetupCommand (TWT_SETUPCOMMAND_REQUEST);
+  request.SetRequest (true);
+  request.SetImplicit (true);
+  request.SetAnnouncedFlowType (false);
+  request.SetFlowIdentifier (0);
+  request.SetDialogToken (1);
+  request.SetTargetWakeTime (MilliSeconds (1500));
+  request.SetNominalMinimumWakeDuration (MicroSeconds (10240));
+  TwtScheduler::SetWakeInterval (request, MicroSeconds (102400));
+  request.SetLength ();
+  m_requester->SendTwtFrame (request, m_responder->GetAddress ());
+}
+
+void
+TwtEventTraceTest::SendData (void)
+{
+  WifiMacHeader hdr;
+  hdr.SetType (WIFI_MAC_DATA);
+  hdr.SetAddr1 (m_responder->GetAddress ());
+  hdr.SetAddr2 (m_requester->GetAddress ());
+  hdr.SetAddr3 (m_requester->GetBssid ());
+  hdr.SetDsNotFrom ();
+  hdr.SetDsNotTo ();
+  m_requester->QueueWithTwt (Create<Packet> (100), hdr);
+}
+
+void
+TwtEventTraceTest::Teardown (void)
+{
+  m_requester->SendTwtTeardownFrame (m_responder->GetAddress (), 0);
+}
+
+void
+TwtEventTraceTest::DoRun (void)
+{
+  Ptr<YansWifiChannel> channel = CreateObject<YansWifiChannel> ();
+  channel->SetPropagationDelayModel (CreateObject<ConstantSpeedPropagationDelayModel> ());
+  channel->SetPropagationLossModel (CreateObject<LogDistancePropagationLossModel> ());
+  m_requester = CreateOne (Vector (0.0, 0.0, 0.0), channel);
+  m_responder = CreateOne (Vector (5.0, 0.0, 0.0), channel);
+  Mac48Address responder = m_responder->GetAddress ();
+
+  TwtEventRing ring (64);
+  m_requester->TraceConnectWithoutContext ("TwtEvent", MakeCallback (&TwtEventRing::Record, &ring));
+
+  // The first service periods start at 1.5 s, 1.6024 s and 1.7048 s
+  Simulator::Schedule (Seconds (1.0), &TwtEventTraceTest::SendRequest, this);
+  Simulator::Schedule (Seconds (1.55), &TwtEventTraceTest::SendData, this);
+  Simulator::Schedule (Seconds (1.56), &TwtEventTraceTest::SendData, this);
+  Simulator::Schedule (Seconds (1.75), &TwtEventTraceTest::SendData, this);
+  Simulator::Schedule (Seconds (1.76), &TwtEventTraceTest::Teardown, this);
+  Simulator::Stop (Seconds (2.0));
+  Simulator::Run ();
+  bool torn = m_requester->GetTwtAgreements (&responder).empty ();
+  m_requester = 0;
+  m_responder = 0;
+  Simulator::Destroy ();
+
+  NS_TEST_EXPECT_MSG_EQ (torn, true, "the agreement should be torn down");
+  const TwtEventType expected[] = {
+    TWT_EVENT_SETUP,
+    TWT_EVENT_SP_START, TWT_EVENT_SP_END,
+    TWT_EVENT_QUEUED, TWT_EVENT_QUEUED,
+    TWT_EVENT_SP_START, TWT_EVENT_SP_END,
+    TWT_EVENT_SP_START, TWT_EVENT_SP_END,
+    TWT_EVENT_QUEUED, TWT_EVENT_QUEUED,
+    TWT_EVENT_TEARDOWN
+  };
+  uint32_t n = sizeof (expected) / sizeof (expected[0]);
+  NS_TEST_ASSERT_MSG_EQ (ring.GetN (), n, "wrong number of TWT events");
+  for (uint32_t i = 0; i < n; i++)
+    {
+      const TwtEvent &event = ring.Get (i);
+      NS_TEST_EXPECT_MSG_EQ (static_cast<uint32_t> (event.type), static_cast<uint32_t> (expected[i]), "wrong event " << i);
+      NS_TEST_EXPECT_MSG_EQ (event.key.macAddress, responder, "wrong peer of event " << i);
+      if (i > 0)
+        {
+          NS_TEST_EXPECT_MSG_GT_OR_EQ (event.time, ring.Get (i - 1).time, "the events should be in order");
+        }
+    }
+
+  // The setup announces the first service period
+  NS_TEST_EXPECT_MSG_EQ (ring.Get (0).spStart, MilliSeconds (1500).GetNanoSeconds (), "wrong first service period");
+  NS_TEST_EXPECT_MSG_EQ (ring.Get (0).spEnd, MicroSeconds (1510240).GetNanoSeconds (), "wrong first service period");
+  NS_TEST_EXPECT_MSG_EQ (ring.Get (1).time, MilliSeconds (1500).GetNanoSeconds (), "wrong start of the first service period");
+  NS_TEST_EXPECT_MSG_EQ (ring.Get (1).flushed, 0, "nothing was buffered for the first service period");
+  // Frames are buffered between the service periods, then flushed at the next one
+  NS_TEST_EXPECT_MSG_EQ (static_cast<uint32_t> (ring.Get (3).key.flowIdentifier), static_cast<uint32_t> (TwtEvent::TWT_EVENT_ANY_FLOW),
+                         "buffered frames are not tied to an agreement");
+  NS_TEST_EXPECT_MSG_EQ (ring.Get (3).queued, 1, "wrong count of buffered frames");
+  NS_TEST_EXPECT_MSG_EQ (ring.Get (4).queued, 2, "wrong count of buffered frames");
+  NS_TEST_EXPECT_MSG_EQ (ring.Get (5).time, MicroSeconds (1602400).GetNanoSeconds (), "wrong start of the second service period");
+  NS_TEST_EXPECT_MSG_EQ (ring.Get (5).flushed, 2, "the buffered frames should be sent in the second service period");
+  NS_TEST_EXPECT_MSG_EQ (ring.Get (5).queued, 0, "no frame should stay buffered");
+  NS_TEST_EXPECT_MSG_EQ (ring.Get (7).flushed, 0, "nothing was buffered for the third service period");
+  // The teardown frame itself is buffered, then flushed with the data frame by the teardown
+  NS_TEST_EXPECT_MSG_EQ (ring.Get (10).queued, 2, "the teardown frame should be buffered");
+  NS_TEST_EXPECT_MSG_EQ (ring.Get (11).flushed, 2, "the teardown should flush the buffered frames");
+  NS_TEST_EXPECT_MSG_EQ (ring.Get (11).queued, 0, "no frame should stay buffered after the teardown");
+  NS_TEST_EXPECT_MSG_EQ (ring.GetLost (), 0, "no event should be lost");
+}
+
+
 //-----------------------------------------------------------------------------
 class WifiTestSuite : public TestSuite
 {
@@ -495,6 +2431,23 @@ WifiTestSuite::WifiTestSuite ()
   AddTestCase (new WifiTest, TestCase::QUICK);
   AddTestCase (new QosUtilsIsOldPacketTest, TestCase::QUICK);
   AddTestCase (new InterferenceHelperSequenceTest, TestCase::QUICK); //Bug 991
+  AddTestCase (new InterferenceHelperNiChangesTest, TestCase::QUICK);
+  AddTestCase (new YansWifiChannelReceiversTest, TestCase::QUICK);
+#ifdef HAVE_PTHREAD_H
+  AddTestCase (new YansWifiChannelParallelTest, TestCase::QUICK);
+#endif
+  AddTestCase (new TabulatedErrorRateModelTest, TestCase::QUICK);
+  AddTestCase (new TxDurationCacheTest, TestCase::QUICK);
+  AddTestCase (new WifiMacQueueTest, TestCase::QUICK);
+  AddTestCase (new S1gDownlinkSchedulerTest, TestCase::QUICK);
+  AddTestCase (new AidIndexTest, TestCase::QUICK);
+  AddTestCase (new RawScheduleTest, TestCase::QUICK);
+  AddTestCase (new StationIndexTest, TestCase::QUICK);
+  AddTestCase (new TwtTimelineTest, TestCase::QUICK);
+  AddTestCase (new TwtSchedulerTest, TestCase::QUICK);
+  AddTestCase (new TwtSetupAlternateTest, TestCase::QUICK);
+  AddTestCase (new TwtEventRingTest, TestCase::QUICK);
+  AddTestCase (new TwtEventTraceTest, TestCase::QUICK);
   AddTestCase (new Bug555TestCase, TestCase::QUICK); //Bug 555
 }
 
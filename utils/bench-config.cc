@@ -0,0 +1,103 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+/*
+ * Measure the cost of connecting a trace source of every node, as the
+ * scenarios do before the simulation starts: one Config::Connect per
+ * node, one Config::CompiledPath resolved per node, and a single
+ * Config::CompiledPath over a range of nodes.
+ */
+
+#include <iomanip>
+#include <iostream>
+#include <sstream>
+#include <string>
+
+#include "ns3/core-module.h"
+#include "ns3/network-module.h"
+
+using namespace ns3;
+
+/**
+ * The trace sink, never called.
+ *
+ * \param [in] context The context of the trace source.
+ * \param [in] packet The dropped packet.
+ */
+static void
+Drop (std::string context, Ptr<const Packet> packet)
+{
+}
+
+/**
+ * Print the cost of connecting the trace sources.
+ *
+ * \param [in] name The name of the method.
+ * \param [in] ms The time taken, in ms.
+ * \param [in] n The number of nodes.
+ */
+static void
+Report (std::string name, int64_t ms, uint32_t n)
+{
+  std::cout << std::left << std::setw (40) << name << std::right
+            << std::setw (8) << ms << " ms, "
+            << std::setw (8) << std::fixed << std::setprecision (2)
+            << ms * 1e3 / n << " us/node" << std::endl;
+}
+
+int
+main (int argc, char *argv[])
+{
+  uint32_t n = 4096;
+  CommandLine cmd;
+  cmd.AddValue ("n", "number of nodes", n);
+  cmd.Parse (argc, argv);
+
+  NodeContainer nodes;
+  nodes.Create (n);
+  for (uint32_t i = 0; i < n; i++)
+    {
+      nodes.Get (i)->AddDevice (CreateObject<SimpleNetDevice> ());
+    }
+  Callback<void, std::string, Ptr<const Packet> > cb = MakeCallback (&Drop);
+  SystemWallClockMs clock;
+
+  clock.Start ();
+  for (uint32_t i = 0; i < n; i++)
+    {
+      std::ostringstream oss;
+      oss << "/NodeList/" << i << "/DeviceList/0/PhyRxDrop";
+      Config::Connect (oss.str (), cb);
+    }
+  Report ("Config::Connect per node", clock.End (), n);
+
+  clock.Start ();
+  Config::CompiledPath path ("/NodeList/%/DeviceList/0/PhyRxDrop");
+  for (uint32_t i = 0; i < n; i++)
+    {
+      path.Connect (i, cb);
+    }
+  Report ("CompiledPath::Connect per node", clock.End (), n);
+
+  std::ostringstream oss;
+  oss << "/NodeList/[0-" << n - 1 << "]/DeviceList/0/PhyRxDrop";
+  clock.Start ();
+  Config::MatchContainer matches = Config::CompiledPath (oss.str ()).LookupMatches ();
+  matches.Connect ("PhyRxDrop", cb);
+  Report ("CompiledPath over a range", clock.End (), n);
+
+  return matches.GetN () == n ? 0 : 1;
+}
@@ -0,0 +1,213 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+/*
+ * Measure the time producer threads take to hand items over to a
+ * consumer through the MpscQueue, against the list protected by a mutex
+ * it replaced in DefaultSimulatorImpl, and the time taken to run events
+ * scheduled with ScheduleWithContext from producer threads.
+ */
+
+#include <iomanip>
+#include <iostream>
+#include <list>
+#include <utility>
+#include <vector>
+
+#include "ns3/core-module.h"
+#include "ns3/mpsc-queue.h"
+
+using namespace ns3;
+
+/** An item of the queue: the producer and its sequence number. */
+typedef std::pair<uint32_t, uint32_t> Item;
+
+/**
+ * The queue the MpscQueue replaced in DefaultSimulatorImpl: a list
+ * protected by a mutex, drained by swapping.
+ */
+class LockedQueue
+{
+public:
+  void Push (const Item &item)
+  {
+    CriticalSection cs (m_mutex);
+    m_items.push_back (item);
+  }
+  std::size_t PopAll (std::vector<Item> &items)
+  {
+    std::list<Item> batch;
+    {
+      CriticalSection cs (m_mutex);
+      m_items.swap (batch);
+    }
+    items.insert (items.end (), batch.begin (), batch.end ());
+    return batch.size ();
+  }
+private:
+  std::list<Item> m_items;
+  SystemMutex m_mutex;
+};
+
+/** The arguments of a producer thread. */
+template <typename Q>
+struct Producer
+{
+  Q *queue;        //!< The queue to push to
+  uint32_t index;  //!< The index of the producer
+  uint32_t items;  //!< The number of items to push
+};
+
+template <typename Q>
+static void
+Produce (const Producer<Q> *producer)
+{
+  for (uint32_t seq = 0; seq < producer->items; seq++)
+    {
+      producer->queue->Push (Item (producer->index, seq));
+    }
+}
+
+/**
+ * Hand items over from producer threads to the calling thread.
+ *
+ * \param [in] queue The queue.
+ * \param [in] producers The number of producer threads.
+ * \param [in] items The number of items pushed by each producer.
+ * \returns The time until the last item was popped, in ms.
+ */
+template <typename Q>
+static int64_t
+BenchQueue (Q &queue, uint32_t producers, uint32_t items)
+{
+  std::vector<Producer<Q> > args (producers);
+  std::vector<Ptr<SystemThread> > threads;
+  for (uint32_t i = 0; i < producers; i++)
+    {
+      args[i].queue = &queue;
+      args[i].index = i;
+      args[i].items = items;
+      threads.push_back (Create<SystemThread> (MakeBoundCallback (&Produce<Q>,
+                                                                  static_cast<const Producer<Q> *> (&args[i]))));
+    }
+  SystemWallClockMs clock;
+  clock.Start ();
+  for (uint32_t i = 0; i < producers; i++)
+    {
+      threads[i]->Start ();
+    }
+  std::vector<Item> batch;
+  uint64_t total = static_cast<uint64_t> (producers) * items;
+  uint64_t popped = 0;
+  while (popped < total)
+    {
+      batch.clear ();
+      popped += queue.PopAll (batch);
+    }
+  int64_t elapsed = clock.End ();
+  for (uint32_t i = 0; i < producers; i++)
+    {
+      threads[i]->Join ();
+    }
+  return elapsed;
+}
+
+/** Number of events run by BenchScheduleWithContext. */
+static uint64_t g_received = 0;
+/** Number of events BenchScheduleWithContext waits for. */
+static uint64_t g_total = 0;
+
+static void
+Receive (void)
+{
+  g_received++;
+}
+
+static void
+Poll (void)
+{
+  // Keep the simulation alive until the producers are done
+  if (g_received < g_total)
+    {
+      Simulator::Schedule (MicroSeconds (1), &Poll);
+    }
+}
+
+static void
+ScheduleEvents (std::pair<uint32_t, uint32_t> args)
+{
+  for (uint32_t seq = 0; seq < args.second; seq++)
+    {
+      Simulator::ScheduleWithContext (args.first, Time (0), &Receive);
+    }
+}
+
+/**
+ * Run events scheduled with ScheduleWithContext by producer threads.
+ *
+ * \param [in] producers The number of producer threads.
+ * \param [in] events The number of events scheduled by each producer.
+ * \returns The time of the run, in ms.
+ */
+static int64_t
+BenchScheduleWithContext (uint32_t producers, uint32_t events)
+{
+  g_received = 0;
+  g_total = static_cast<uint64_t> (producers) * events;
+  Simulator::Schedule (Time (0), &Poll);
+  std::vector<Ptr<SystemThread> > threads;
+  for (uint32_t i = 0; i < producers; i++)
+    {
+      threads.push_back (Create<SystemThread> (MakeBoundCallback (&ScheduleEvents, std::make_pair (i, events))));
+    }
+  SystemWallClockMs clock;
+  clock.Start ();
+  for (uint32_t i = 0; i < producers; i++)
+    {
+      threads[i]->Start ();
+    }
+  Simulator::Run ();
+  int64_t elapsed = clock.End ();
+  for (uint32_t i = 0; i < producers; i++)
+    {
+      threads[i]->Join ();
+    }
+  Simulator::Destroy ();
+  return elapsed;
+}
+
+int
+main (int argc, char *argv[])
+{
+  uint32_t producers = 4;
+  uint32_t items = 1000000;
+
+  CommandLine cmd;
+  cmd.AddValue ("producers", "number of producer threads", producers);
+  cmd.AddValue ("items", "number of items pushed by each producer", items);
+  cmd.Parse (argc, argv);
+
+  std::cout << producers << " producers, " << items << " items each" << std::endl;
+  MpscQueue<Item> lockFree;
+  std::cout << std::left << std::setw (30) << "MpscQueue" << std::right
+            << std::setw (8) << BenchQueue (lockFree, producers, items) << " ms" << std::endl;
+  LockedQueue locked;
+  std::cout << std::left << std::setw (30) << "locked list" << std::right
+            << std::setw (8) << BenchQueue (locked, producers, items) << " ms" << std::endl;
+  std::cout << std::left << std::setw (30) << "ScheduleWithContext" << std::right
+            << std::setw (8) << BenchScheduleWithContext (producers, items) << " ms" << std::endl;
+  return 0;
+}
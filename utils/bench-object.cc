@@ -0,0 +1,136 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+/*
+ * Measure the cost of Object::GetObject on an aggregation as large as
+ * the one of a wireless node, for the hits in the GetObject cache of the
+ * aggregates and for the lookups which miss it.
+ */
+
+#include <iomanip>
+#include <iostream>
+#include <string>
+
+#include "ns3/core-module.h"
+
+using namespace ns3;
+
+/**
+ * An object type of the benchmark. The types are registered in the
+ * order of N, so that the uids of the types N and N + 8 map to the
+ * same entry of the cache.
+ */
+template <int N>
+class BenchObject : public Object
+{
+public:
+  static TypeId GetTypeId (void)
+  {
+    static TypeId tid = TypeId (("ns3::BenchObject" + std::to_string (N)).c_str ())
+      .SetParent<Object> ()
+      .SetGroupName ("Core")
+      .AddConstructor<BenchObject<N> > ()
+    ;
+    return tid;
+  }
+};
+
+/** Keep the results of the lookups alive. */
+static volatile uintptr_t g_sink;
+
+/**
+ * Print the cost of a lookup loop.
+ *
+ * \param [in] name The name of the lookup.
+ * \param [in] ms The time of the loop, in ms.
+ * \param [in] n The number of lookups of the loop.
+ */
+static void
+Report (std::string name, int64_t ms, uint32_t n)
+{
+  std::cout << std::left << std::setw (40) << name << std::right
+            << std::setw (8) << std::fixed << std::setprecision (2)
+            << ms * 1e6 / n << " ns/lookup" << std::endl;
+}
+
+int
+main (int argc, char *argv[])
+{
+  uint32_t n = 10000000;
+  CommandLine cmd;
+  cmd.AddValue ("n", "number of lookups of each kind", n);
+  cmd.Parse (argc, argv);
+
+  // Register the types in order, before any other lookup
+  BenchObject<0>::GetTypeId ();
+  BenchObject<1>::GetTypeId ();
+  BenchObject<2>::GetTypeId ();
+  BenchObject<3>::GetTypeId ();
+  BenchObject<4>::GetTypeId ();
+  BenchObject<5>::GetTypeId ();
+  BenchObject<6>::GetTypeId ();
+  BenchObject<7>::GetTypeId ();
+  BenchObject<8>::GetTypeId ();
+
+  // An aggregation of the size of a node with mobility, a device and
+  // an IP stack
+  Ptr<Object> head = CreateObject<BenchObject<0> > ();
+  head->AggregateObject (CreateObject<BenchObject<1> > ());
+  head->AggregateObject (CreateObject<BenchObject<2> > ());
+  head->AggregateObject (CreateObject<BenchObject<3> > ());
+  head->AggregateObject (CreateObject<BenchObject<4> > ());
+  head->AggregateObject (CreateObject<BenchObject<5> > ());
+  head->AggregateObject (CreateObject<BenchObject<6> > ());
+  head->AggregateObject (CreateObject<BenchObject<8> > ());
+
+  SystemWallClockMs clock;
+  uintptr_t sink = 0;
+
+  clock.Start ();
+  for (uint32_t i = 0; i < n; i++)
+    {
+      sink += (uintptr_t) PeekPointer (head->GetObject<BenchObject<6> > ());
+    }
+  Report ("hit, GetObject<T> ()", clock.End (), n);
+
+  TypeId tid = BenchObject<5>::GetTypeId ();
+  clock.Start ();
+  for (uint32_t i = 0; i < n; i++)
+    {
+      sink += (uintptr_t) PeekPointer (head->GetObject<Object> (tid));
+    }
+  Report ("hit, GetObject<T> (tid)", clock.End (), n);
+
+  clock.Start ();
+  for (uint32_t i = 0; i < n; i++)
+    {
+      sink += (uintptr_t) PeekPointer (head->GetObject<BenchObject<7> > ());
+    }
+  Report ("hit, type not aggregated", clock.End (), n);
+
+  // BenchObject<0> and BenchObject<8> share an entry of the cache, so
+  // every lookup walks the aggregates
+  clock.Start ();
+  for (uint32_t i = 0; i < n; i += 2)
+    {
+      sink += (uintptr_t) PeekPointer (head->GetObject<BenchObject<0> > ());
+      sink += (uintptr_t) PeekPointer (head->GetObject<BenchObject<8> > ());
+    }
+  Report ("miss, walk of 8 aggregates", clock.End (), n);
+
+  g_sink = sink;
+  return 0;
+}
@@ -0,0 +1,204 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include <chrono>
+#include <cstring>
+#include <iomanip>
+#include <iostream>
+#include <fstream>
+#include <vector>
+
+#include "ns3/core-module.h"
+#include "ns3/default-simulator-impl.h"
+
+using namespace ns3;
+
+/*
+ * Replay an event trace, recorded by setting the
+ * ns3::DefaultSimulatorImpl::EventTraceFile attribute, against the
+ * schedulers.  For instance:
+ *
+ *   ./waf --run "rca --Nsta=1000 --NRawSta=1000 --pageSliceCount=1 --simulationTime=60
+ *                  --ns3::DefaultSimulatorImpl::EventTraceFile=rca.evt"
+ *   ./waf --run "bench-scheduler --file=rca.evt --all"
+ *
+ * Consecutive operations of the same kind are timed together, so the
+ * clock is only read when the kind of operation changes.
+ */
+
+#define LOG(x)   std::cout << x << std::endl
+
+// Output field width
+int g_fwidth = 14;
+
+/** An operation read from the trace. */
+struct Record
+{
+  uint8_t op;               /**< The DefaultSimulatorImpl::EventTraceOp. */
+  Scheduler::Event event;   /**< The event. */
+};
+
+std::vector<Record>
+ReadTrace (std::string filename)
+{
+  std::ifstream input (filename.c_str (), std::ios::in | std::ios::binary);
+  if (!input.is_open ())
+    {
+      NS_FATAL_ERROR ("Could not open " << filename);
+    }
+  char magic[sizeof (DefaultSimulatorImpl::EVENT_TRACE_MAGIC)];
+  if (!input.read (magic, sizeof (magic))
+      || memcmp (magic, DefaultSimulatorImpl::EVENT_TRACE_MAGIC, sizeof (magic)) != 0)
+    {
+      NS_FATAL_ERROR (filename << " is not an event trace");
+    }
+  std::vector<Record> trace;
+  char buffer[DefaultSimulatorImpl::EVENT_TRACE_RECORD_SIZE];
+  while (input.read (buffer, DefaultSimulatorImpl::EVENT_TRACE_RECORD_SIZE))
+    {
+      Record record;
+      record.op = buffer[0];
+      record.event.impl = 0;
+      memcpy (&record.event.key.m_ts, buffer + 9, 8);
+      memcpy (&record.event.key.m_context, buffer + 17, 4);
+      memcpy (&record.event.key.m_uid, buffer + 21, 4);
+      trace.push_back (record);
+    }
+  return trace;
+}
+
+double
+Rate (uint64_t count, double seconds)
+{
+  return count == 0 ? 0 : count / seconds;
+}
+
+void
+Replay (const std::vector<Record> &trace, ObjectFactory factory)
+{
+  typedef std::chrono::steady_clock Clock;
+  Ptr<Scheduler> scheduler = factory.Create<Scheduler> ();
+  // time spent and operations, by EventTraceOp
+  double seconds[3] = { 0, 0, 0 };
+  uint64_t count[3] = { 0, 0, 0 };
+  uint64_t size = 0;
+  uint64_t peak = 0;
+  uint64_t mismatches = 0;
+
+  std::vector<Record>::const_iterator i = trace.begin ();
+  while (i != trace.end ())
+    {
+      uint8_t op = i->op;
+      if (op == DefaultSimulatorImpl::EVENT_TRACE_CANCEL)
+        {
+          // the event stays in the queue
+          ++i;
+          continue;
+        }
+      Clock::time_point start = Clock::now ();
+      std::vector<Record>::const_iterator j = i;
+      for (; j != trace.end () && j->op == op; ++j)
+        {
+          switch (op)
+            {
+            case DefaultSimulatorImpl::EVENT_TRACE_INSERT:
+              scheduler->Insert (j->event);
+              size++;
+              break;
+            case DefaultSimulatorImpl::EVENT_TRACE_REMOVE_NEXT:
+              if (scheduler->RemoveNext ().key.m_uid != j->event.key.m_uid)
+                {
+                  mismatches++;
+                }
+              size--;
+              break;
+            case DefaultSimulatorImpl::EVENT_TRACE_REMOVE:
+              scheduler->Remove (j->event);
+              size--;
+              break;
+            default:
+              NS_FATAL_ERROR ("Unknown operation " << (uint32_t)op << " in the trace");
+            }
+        }
+      seconds[op] += std::chrono::duration<double> (Clock::now () - start).count ();
+      count[op] += j - i;
+      peak = std::max (peak, size);
+      i = j;
+    }
+  while (!scheduler->IsEmpty ())
+    {
+      scheduler->RemoveNext ();
+    }
+
+  LOG (std::left << std::setw (2 * g_fwidth) << factory.GetTypeId ().GetName () <<
+       std::setw (g_fwidth) << Rate (count[0], seconds[0]) <<
+       std::setw (g_fwidth) << Rate (count[1], seconds[1]) <<
+       std::setw (g_fwidth) << Rate (count[2], seconds[2]) <<
+       std::setw (g_fwidth) << peak <<
+       std::setw (g_fwidth) << mismatches);
+}
+
+int main (int argc, char *argv[])
+{
+  bool all = false;
+  std::string scheduler = "ns3::MapScheduler";
+  std::string filename = "";
+
+  CommandLine cmd;
+  cmd.Usage ("Replay an event trace recorded by DefaultSimulatorImpl against the schedulers.\n"
+             "\n"
+             "Record a trace by setting the ns3::DefaultSimulatorImpl::EventTraceFile\n"
+             "attribute in the simulation to benchmark.  The rates are in operations\n"
+             "per second; the events run in a different order than recorded are\n"
+             "counted as mismatches.");
+  cmd.AddValue ("file",      "event trace to replay",               filename);
+  cmd.AddValue ("scheduler", "scheduler to replay the trace with",  scheduler);
+  cmd.AddValue ("all",       "replay the trace with all the schedulers", all);
+  cmd.Parse (argc, argv);
+
+  if (filename == "")
+    {
+      NS_FATAL_ERROR ("No event trace given, use --file");
+    }
+  std::vector<Record> trace = ReadTrace (filename);
+  LOG (cmd.GetName () << ": " << trace.size () << " operations in " << filename);
+
+  std::vector<std::string> schedulers;
+  if (all)
+    {
+      schedulers.push_back ("ns3::ListScheduler");
+      schedulers.push_back ("ns3::HeapScheduler");
+      schedulers.push_back ("ns3::MapScheduler");
+      schedulers.push_back ("ns3::CalendarScheduler");
+      schedulers.push_back ("ns3::LadderScheduler");
+    }
+  else
+    {
+      schedulers.push_back (scheduler);
+    }
+
+  LOG (std::left << std::setw (2 * g_fwidth) << "Scheduler" <<
+       std::setw (g_fwidth) << "Insert/s" <<
+       std::setw (g_fwidth) << "RemoveNext/s" <<
+       std::setw (g_fwidth) << "Remove/s" <<
+       std::setw (g_fwidth) << "Peak size" <<
+       std::setw (g_fwidth) << "Mismatches");
+  for (std::vector<std::string>::const_iterator i = schedulers.begin (); i != schedulers.end (); ++i)
+    {
+      Replay (trace, ObjectFactory (*i));
+    }
+  return 0;
+}
@@ -134,10 +134,21 @@ GetRandomStream (std::string filename)
       LOGME ("using default exponential distribution");
       Ptr<ExponentialRandomVariable> erv = CreateObject<ExponentialRandomVariable> ();
       erv->SetAttribute ("Mean", DoubleValue (100));
+      erv->SetStream (0);
       stream = erv;
     }
   else
     {
+      // standard input can only be read once, so keep what was read
+      // for the following schedulers
+      static std::vector<double> nsValues;
+      if (!nsValues.empty ())
+        {
+          Ptr<DeterministicRandomVariable> drv = CreateObject<DeterministicRandomVariable> ();
+          drv->SetValueArray (&nsValues[0], nsValues.size ());
+          return drv;
+        }
+
       std::istream *input; 
 
       if (filename == "-") 
@@ -152,7 +163,6 @@ GetRandomStream (std::string filename)
         }
 
       double value;
-      std::vector<double> nsValues;
       
       while (!input->eof ()) 
         {
@@ -177,60 +187,57 @@ GetRandomStream (std::string filename)
   return stream;
 }
 
-
-
-int main (int argc, char *argv[])
+/*
+ * Event intervals shaped like those of an 802.11ah simulation: most
+ * events fall on the same timestamp as the previous one (all the stations
+ * waking up for a beacon, or starting their RAW slot), the others are
+ * 160 us backoff postponements, RAW slot boundaries or beacon intervals.
+ */
+Ptr<RandomVariableStream>
+GetBeaconStream (uint32_t count)
 {
+  LOGME ("using beacon periodic event distribution");
+  Ptr<UniformRandomVariable> urv = CreateObject<UniformRandomVariable> ();
+  urv->SetStream (1);
+  std::vector<double> nsValues;
+  nsValues.reserve (count);
+  for (uint32_t i = 0; i < count; ++i)
+    {
+      double kind = urv->GetValue ();
+      if (kind < 0.6)
+        {
+          nsValues.push_back (0);
+        }
+      else if (kind < 0.8)
+        {
+          nsValues.push_back (160000);
+        }
+      else if (kind < 0.95)
+        {
+          nsValues.push_back (urv->GetInteger (1, 8) * 12800000);
+        }
+      else
+        {
+          nsValues.push_back (102400000);
+        }
+    }
+  Ptr<DeterministicRandomVariable> drv = CreateObject<DeterministicRandomVariable> ();
+  drv->SetValueArray (&nsValues[0], nsValues.size ());
+  return drv;
+}
 
-  bool schedCal  = false;
-  bool schedHeap = false;
-  bool schedList = false;
-  bool schedMap  = true;
-
-  uint32_t pop   =  100000;
-  uint32_t total = 1000000;
-  uint32_t runs  =       1;
-  std::string filename = "";
-  
-  CommandLine cmd;
-  cmd.Usage ("Benchmark the simulator scheduler.\n"
-             "\n"
-             "Event intervals are taken from one of:\n"
-             "  an exponential distribution, with mean 100 ns,\n"
-             "  an ascii file, given by the --file=\"<filename>\" argument,\n"
-             "  or standard input, by the argument --file=\"-\"\n"
-             "In the case of either --file form, the input is expected\n"
-             "to be ascii, giving the relative event times in ns.");
-  cmd.AddValue ("cal",   "use CalendarSheduler",          schedCal);
-  cmd.AddValue ("heap",  "use HeapScheduler",             schedHeap);
-  cmd.AddValue ("list",  "use ListSheduler",              schedList);
-  cmd.AddValue ("map",   "use MapScheduler (default)",    schedMap);
-  cmd.AddValue ("debug", "enable debugging output",       g_debug);
-  cmd.AddValue ("pop",   "event population size (default 1E5)",         pop);
-  cmd.AddValue ("total", "total number of events to run (default 1E6)", total);
-  cmd.AddValue ("runs",  "number of runs (default 1)",    runs);
-  cmd.AddValue ("file",  "file of relative event times",  filename);
-  cmd.AddValue ("prec",  "printed output precision",      g_fwidth);
-  cmd.Parse (argc, argv);
-  g_me = cmd.GetName () + ": ";
-  g_fwidth += 6;  // 5 extra chars in '2.000002e+07 ': . e+0 _
-
-  ObjectFactory factory ("ns3::MapScheduler");
-  if (schedCal)  { factory.SetTypeId ("ns3::CalendarScheduler"); }
-  if (schedHeap) { factory.SetTypeId ("ns3::HeapScheduler");     }
-  if (schedList) { factory.SetTypeId ("ns3::ListScheduler");     }  
+/*
+ * Run the benchmark with one scheduler.
+ */
+void
+RunScheduler (Bench *bench, ObjectFactory factory, uint32_t pop, uint32_t total, uint32_t runs)
+{
   Simulator::SetScheduler (factory);
 
-  LOGME (std::setprecision (g_fwidth - 6));
-  DEB ("debugging is ON");
-
   LOGME ("scheduler: " << factory.GetTypeId ().GetName ());
   LOGME ("population: " << pop);
   LOGME ("total events: " << total);
   LOGME ("runs: " << runs);
-  
-  Bench *bench = new Bench (pop, total);
-  bench->SetRandomStream (GetRandomStream (filename));
 
   // table header
   LOG ("");
@@ -270,6 +277,88 @@ int main (int argc, char *argv[])
     }
 
   LOG ("");
+}
+
+
+int main (int argc, char *argv[])
+{
+
+  bool schedCal  = false;
+  bool schedHeap = false;
+  bool schedList = false;
+  bool schedLadder = false;
+  bool schedMap  = true;
+  bool schedAll  = false;
+  bool beacon    = false;
+
+  uint32_t pop   =  100000;
+  uint32_t total = 1000000;
+  uint32_t runs  =       1;
+  std::string filename = "";
+  
+  CommandLine cmd;
+  cmd.Usage ("Benchmark the simulator scheduler.\n"
+             "\n"
+             "Event intervals are taken from one of:\n"
+             "  an exponential distribution, with mean 100 ns,\n"
+             "  a beacon periodic distribution, given by the --beacon argument,\n"
+             "  an ascii file, given by the --file=\"<filename>\" argument,\n"
+             "  or standard input, by the argument --file=\"-\"\n"
+             "In the case of either --file form, the input is expected\n"
+             "to be ascii, giving the relative event times in ns.");
+  cmd.AddValue ("cal",   "use CalendarSheduler",          schedCal);
+  cmd.AddValue ("heap",  "use HeapScheduler",             schedHeap);
+  cmd.AddValue ("list",  "use ListSheduler",              schedList);
+  cmd.AddValue ("ladder", "use LadderScheduler",          schedLadder);
+  cmd.AddValue ("map",   "use MapScheduler (default)",    schedMap);
+  cmd.AddValue ("all",   "compare all the schedulers",    schedAll);
+  cmd.AddValue ("beacon", "use beacon periodic event times, as in 802.11ah", beacon);
+  cmd.AddValue ("debug", "enable debugging output",       g_debug);
+  cmd.AddValue ("pop",   "event population size (default 1E5)",         pop);
+  cmd.AddValue ("total", "total number of events to run (default 1E6)", total);
+  cmd.AddValue ("runs",  "number of runs (default 1)",    runs);
+  cmd.AddValue ("file",  "file of relative event times",  filename);
+  cmd.AddValue ("prec",  "printed output precision",      g_fwidth);
+  cmd.Parse (argc, argv);
+  g_me = cmd.GetName () + ": ";
+  g_fwidth += 6;  // 5 extra chars in '2.000002e+07 ': . e+0 _
+
+  std::vector<std::string> schedulers;
+  if (schedAll)
+    {
+      schedulers.push_back ("ns3::ListScheduler");
+      schedulers.push_back ("ns3::HeapScheduler");
+      schedulers.push_back ("ns3::MapScheduler");
+      schedulers.push_back ("ns3::CalendarScheduler");
+      schedulers.push_back ("ns3::LadderScheduler");
+    }
+  else if (schedCal)    { schedulers.push_back ("ns3::CalendarScheduler"); }
+  else if (schedHeap)   { schedulers.push_back ("ns3::HeapScheduler");     }
+  else if (schedList)   { schedulers.push_back ("ns3::ListScheduler");     }
+  else if (schedLadder) { schedulers.push_back ("ns3::LadderScheduler");   }
+  else                  { schedulers.push_back ("ns3::MapScheduler");      }
+
+  LOGME (std::setprecision (g_fwidth - 6));
+  DEB ("debugging is ON");
+
+  Bench *bench = new Bench (pop, total);
+  for (std::vector<std::string>::const_iterator i = schedulers.begin (); i != schedulers.end (); ++i)
+    {
+      // a fresh stream, restarted at the same fixed stream number or
+      // sequence of values, so every scheduler sees the same event times
+      if (beacon)
+        {
+          bench->SetRandomStream (GetBeaconStream (pop + total));
+        }
+      else
+        {
+          bench->SetRandomStream (GetRandomStream (filename));
+        }
+      ObjectFactory factory (*i);
+      RunScheduler (bench, factory, pop, total, runs);
+    }
+
+  LOG ("");
   return 0;
 
   Simulator::Destroy ();